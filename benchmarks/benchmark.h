@@ -0,0 +1,68 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math::bench
+{
+	/**
+	* @brief Thread counts for sweeps: 1, 2, 4, ... up to hardware concurrency
+	* @details Without OpenMP only single thread is used
+	*/
+	inline std::vector<int64_t> threads()
+	{
+		std::vector<int64_t> out{ 1 };
+#ifdef MATH_OMP_DEFINE
+		int64_t max_threads = static_cast<int64_t>(std::max(1u, std::thread::hardware_concurrency()));
+		for (int64_t t = 2; t <= max_threads; t *= 2)
+		{
+			out.push_back(t);
+		}
+		if (out.back() != max_threads)
+		{
+			out.push_back(max_threads);
+		}
+#endif
+		return out;
+	}
+
+	/**
+	* @brief Apply sweep over problem sizes and thread counts to benchmark
+	* @details Benchmark gets size as range(0) and number of threads as range(1)
+	*/
+	inline void sweep(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+	{
+		b->ArgNames({ "n", "threads" });
+		for (int64_t n : sizes)
+		{
+			for (int64_t t : threads())
+			{
+				b->Args({ n, t });
+			}
+		}
+		b->Unit(benchmark::kMicrosecond);
+		b->UseRealTime();
+	}
+
+	/**
+	* @brief Set number of threads from range(1) of benchmark state
+	*/
+	inline void setThreads(const benchmark::State& state)
+	{
+#ifdef MATH_OMP_DEFINE
+		omp_set_num_threads(static_cast<int>(state.range(1)));
+#endif
+		static_cast<void>(state);
+	}
+}
+
+/// @brief Register benchmark with sweep over sizes and thread counts
+#define MATH_BENCHMARK_SWEEP(func, ...) \
+	BENCHMARK(func)->Apply([](benchmark::internal::Benchmark* b) { math::bench::sweep(b, { __VA_ARGS__ }); })
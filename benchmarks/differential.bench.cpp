@@ -0,0 +1,84 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+#include <libmath/differential.h>
+#include <functional>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	/// @brief Dense vector function of n arguments
+	std::vector<std::function<double(const math::Matrix<double>&)>> sines(size_t n)
+	{
+		std::vector<std::function<double(const math::Matrix<double>&)>> F;
+		for (size_t i = 0; i < n; ++i)
+		{
+			F.push_back(
+				[i, n](const math::Matrix<double>& x)
+				{
+					double sum = 0.0;
+					for (size_t j = 0; j < n; ++j)
+					{
+						sum += std::sin(x(j, 0) * static_cast<double>(i + 1));
+					}
+					return sum;
+				});
+		}
+		return F;
+	}
+}
+
+static void BM_Jacobi(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+
+	auto F = sines(n);
+
+	math::Matrix<double> x(n, 1, 0.5);
+	math::Matrix<double> J(n);
+	for (auto _ : state)
+	{
+		math::jacobi(F, x, J);
+		benchmark::DoNotOptimize(J.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n * n));
+}
+MATH_BENCHMARK_SWEEP(BM_Jacobi, 10, 50, 100);
+
+static void BM_JacobiCentral4(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	auto F = sines(n);
+
+	math::Matrix<double> x(n, 1, 0.5);
+	math::Matrix<double> J(n);
+	for (auto _ : state)
+	{
+		math::jacobi(F, x, J, 4, 1.e-3);
+		benchmark::DoNotOptimize(J.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n * n));
+}
+MATH_BENCHMARK_SWEEP(BM_JacobiCentral4, 10, 50, 100);
+
+static void BM_RichardsonDerivate(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	auto F = sines(n);
+
+	math::Matrix<double> x(n, 1, 0.5);
+	for (auto _ : state)
+	{
+		double sum = 0.0;
+		for (size_t j = 0; j < n; ++j)
+		{
+			sum += math::richardsonDerivate(F[n - 1], x, j);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_RichardsonDerivate, 10, 50, 100);
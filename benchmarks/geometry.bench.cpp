@@ -0,0 +1,186 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+#include <libmath/geometry/mesh.h>
+#include <libmath/geometry/kdtree.h>
+#include <libmath/geometry/bvh.h>
+#include <libmath/geometry/measures.h>
+#include <libmath/geometry/predicates.h>
+#include <vector>
+#include <array>
+#include <memory>
+
+namespace
+{
+	/// @brief Square grid of m x m nodes, every square is split into 2 triangles
+	void gridMesh(size_t m, math::Matrix<double>& points, std::vector<uint32_t>& cells)
+	{
+		points = math::Matrix<double>(m * m, 2);
+		cells.clear();
+		for (size_t i = 0; i < m; ++i)
+		{
+			for (size_t j = 0; j < m; ++j)
+			{
+				points(i * m + j, 0) = static_cast<double>(i);
+				points(i * m + j, 1) = static_cast<double>(j);
+				if (i + 1 < m && j + 1 < m)
+				{
+					uint32_t a = static_cast<uint32_t>(i * m + j);
+					uint32_t b = a + static_cast<uint32_t>(m);
+					cells.insert(cells.end(), { a, b, b + 1, a, b + 1, a + 1 });
+				}
+			}
+		}
+	}
+}
+
+static void BM_MeshBuild(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t m = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points;
+	std::vector<uint32_t> cells;
+	gridMesh(m, points, cells);
+	for (auto _ : state)
+	{
+		math::Mesh<double> mesh(points, cells);
+		benchmark::DoNotOptimize(mesh.edgeCount());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cells.size() / 3));
+}
+MATH_BENCHMARK_SWEEP(BM_MeshBuild, 100, 1000);
+
+static void BM_MeshTopology(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t m = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points;
+	std::vector<uint32_t> cells;
+	gridMesh(m, points, cells);
+	math::Mesh<double> mesh(points, cells);
+	std::vector<std::unique_ptr<math::Node<double>>> nodes;
+	std::vector<std::unique_ptr<math::Edge<double>>> edges;
+	std::vector<std::unique_ptr<math::Polygone<double>>> polygones;
+	for (auto _ : state)
+	{
+		mesh.makeTopology(nodes, edges, polygones);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cells.size() / 3));
+}
+MATH_BENCHMARK_SWEEP(BM_MeshTopology, 100, 1000);
+
+static void BM_KDTreeBuild(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points(n, 3, math::MatRep::Row);
+	points.rfill(1);
+	for (auto _ : state)
+	{
+		math::KDTree<double> tree(points);
+		benchmark::DoNotOptimize(tree.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_KDTreeBuild, 10000, 1000000);
+
+static void BM_KDTreeNearestBatch(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points(n, 3, math::MatRep::Row);
+	points.rfill(1);
+	math::Matrix<double> queries(10000, 3, math::MatRep::Row);
+	queries.rfill(2);
+	math::KDTree<double> tree(points);
+	std::vector<size_t> indices;
+	std::vector<double> dist2;
+	for (auto _ : state)
+	{
+		tree.nearestBatch(queries, 8, indices, dist2);
+		benchmark::DoNotOptimize(indices.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.rows()));
+}
+MATH_BENCHMARK_SWEEP(BM_KDTreeNearestBatch, 10000, 1000000);
+
+static void BM_BVHLocate(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t m = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points;
+	std::vector<uint32_t> cells;
+	gridMesh(m, points, cells);
+	math::Mesh<double> mesh(points, cells);
+	math::BVH<double> bvh(mesh);
+	math::Matrix<double> queries(10000, 2, math::MatRep::Row);
+	queries.rfill(2);
+	queries *= static_cast<double>(m - 1);
+	std::vector<uint32_t> located;
+	for (auto _ : state)
+	{
+		bvh.locateBatch(queries, located);
+		benchmark::DoNotOptimize(located.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.rows()));
+}
+MATH_BENCHMARK_SWEEP(BM_BVHLocate, 100, 1000);
+
+static void BM_MeshMeasures(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t m = static_cast<size_t>(state.range(0));
+	math::Matrix<double> points;
+	std::vector<uint32_t> cells;
+	gridMesh(m, points, cells);
+	math::Mesh<double> mesh(points, cells);
+	std::vector<double> volumes;
+	std::vector<double> centroids;
+	std::vector<double> normals;
+	std::vector<double> areas;
+	std::vector<double> quality;
+	for (auto _ : state)
+	{
+		math::cellVolumes(mesh, volumes);
+		math::cellCentroids(mesh, centroids);
+		math::facetNormals(mesh, normals, areas);
+		math::cellQualities(mesh, quality);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(mesh.cellCount()));
+}
+MATH_BENCHMARK_SWEEP(BM_MeshMeasures, 100, 1000);
+
+static void BM_InsphereGrid(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	// points of integer grid on sphere of radius 5 (all in-sphere tests are degenerate)
+	size_t n = static_cast<size_t>(state.range(0));
+	std::vector<std::array<double, 3>> sphere;
+	for (int x = -5; x <= 5; ++x)
+	{
+		for (int y = -5; y <= 5; ++y)
+		{
+			for (int z = -5; z <= 5; ++z)
+			{
+				if (x * x + y * y + z * z == 25)
+				{
+					sphere.push_back({ static_cast<double>(x), static_cast<double>(y), static_cast<double>(z) });
+				}
+			}
+		}
+	}
+	for (auto _ : state)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			sum += math::predicates::insphere(sphere[i % sphere.size()].data(), sphere[(i + 7) % sphere.size()].data(),
+				sphere[(i + 19) % sphere.size()].data(), sphere[(i + 31) % sphere.size()].data(),
+				sphere[(i + 43) % sphere.size()].data());
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_InsphereGrid, 1000);
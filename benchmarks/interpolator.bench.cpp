@@ -0,0 +1,147 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+#include <libmath/interpolator/polygone_interpolator.h>
+#include <libmath/interpolator/multilinear_interpolator.h>
+#include <libmath/interpolator/mesh_interpolator.h>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	/// @brief dim + 1 random points in dim-dimensional space
+	void randomPoints(size_t dim, math::Matrix<double>& x, math::Matrix<double>& y)
+	{
+		x = math::Matrix<double>(dim + 1, dim);
+		x.rfill(1);
+		for (size_t i = 0; i < dim; ++i)
+		{
+			x(i, i) += static_cast<double>(dim);
+		}
+		y = math::Matrix<double>(dim + 1, 1);
+		y.rfill(2);
+	}
+}
+
+static void BM_PolygoneBuild(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t dim = static_cast<size_t>(state.range(0));
+	math::Matrix<double> x, y;
+	randomPoints(dim, x, y);
+	for (auto _ : state)
+	{
+		math::PolygoneInterpolator<double> interpolator(x, y);
+		interpolator.build();
+		benchmark::ClobberMemory();
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_PolygoneBuild, 2, 3, 16, 64);
+
+static void BM_PolygoneInterpolate(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t dim = static_cast<size_t>(state.range(0));
+	math::Matrix<double> x, y;
+	randomPoints(dim, x, y);
+	math::PolygoneInterpolator<double> interpolator(x, y);
+	interpolator.build();
+
+	math::Matrix<double> point(1, dim, 0.5);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(interpolator.interpolate(point));
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_PolygoneInterpolate, 2, 3, 16, 64);
+
+static void BM_PolygoneBatch(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t points = static_cast<size_t>(state.range(0));
+	size_t dim = 3;
+	math::Matrix<double> x, y;
+	randomPoints(dim, x, y);
+	math::PolygoneInterpolator<double> interpolator(x, y);
+	interpolator.build();
+
+	math::Matrix<double> queries(points, dim);
+	queries.rfill(3);
+	std::vector<double> values(points);
+	for (auto _ : state)
+	{
+		interpolator.interpolateBatch(queries, values.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points));
+}
+MATH_BENCHMARK_SWEEP(BM_PolygoneBatch, 1024, 1048576);
+
+static void BM_MultiLinearBatch(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t points = static_cast<size_t>(state.range(0));
+
+	// 3-dimension table 64 x 64 x 64 on uniform axes
+	std::vector<std::vector<double>> axes(3, std::vector<double>(64));
+	for (auto& axis : axes)
+	{
+		for (size_t i = 0; i < axis.size(); ++i)
+		{
+			axis[i] = static_cast<double>(i);
+		}
+	}
+	std::vector<double> values(64 * 64 * 64);
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		values[i] = static_cast<double>(i % 101);
+	}
+	math::MultiLinearInterpolator<double> interpolator(axes, values);
+
+	math::Matrix<double> x(points, 3);
+	x.rfill(1);
+	x = 63.0 * x;
+	math::Matrix<double> y(points, 1);
+	for (auto _ : state)
+	{
+		interpolator.interpolateBatch(x, y);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points));
+}
+MATH_BENCHMARK_SWEEP(BM_MultiLinearBatch, 1024, 65536);
+
+static void BM_MeshInterpolatorBatch(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t samples = static_cast<size_t>(state.range(0));
+
+	// scattered samples in unit square (Kronecker sequence)
+	math::Matrix<double> x(samples, 2);
+	math::Matrix<double> y(samples, 1);
+	for (size_t i = 0; i < samples; ++i)
+	{
+		x(i, 0) = std::fmod(0.5 + 0.7548776662 * static_cast<double>(i), 1.0);
+		x(i, 1) = std::fmod(0.5 + 0.5698402910 * static_cast<double>(i), 1.0);
+		y(i, 0) = std::sin(3.0 * x(i, 0)) * std::cos(2.0 * x(i, 1));
+	}
+	math::MeshInterpolator<double> interpolator(x, y);
+	interpolator.build();
+
+	// coherent queries along curve
+	size_t points = 65536;
+	math::Matrix<double> q(points, 2);
+	for (size_t i = 0; i < points; ++i)
+	{
+		double t = static_cast<double>(i) / static_cast<double>(points);
+		q(i, 0) = 0.05 + 0.9 * t;
+		q(i, 1) = 0.5 + 0.4 * std::sin(40.0 * t);
+	}
+	math::Matrix<double> values(points, 1);
+	for (auto _ : state)
+	{
+		interpolator.interpolateBatch(q, values);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(points));
+}
+MATH_BENCHMARK_SWEEP(BM_MeshInterpolatorBatch, 1024, 1048576);
@@ -0,0 +1,120 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+
+namespace
+{
+	math::Matrix<double> randomMatrix(size_t rows, size_t cols, unsigned int seed)
+	{
+		math::Matrix<double> M(rows, cols);
+		M.rfill(seed);
+		return M;
+	}
+
+	/// @brief Random diagonally dominant matrix, suitable for unpivoted LU
+	math::Matrix<double> dominantMatrix(size_t n, unsigned int seed)
+	{
+		math::Matrix<double> M = randomMatrix(n, n, seed);
+		for (size_t i = 0; i < n; ++i)
+		{
+			M(i, i) += static_cast<double>(n);
+		}
+		return M;
+	}
+}
+
+static void BM_MatrixGEMM(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = randomMatrix(n, n, 1);
+	math::Matrix<double> B = randomMatrix(n, n, 2);
+	for (auto _ : state)
+	{
+		math::Matrix<double> C = A * B;
+		benchmark::DoNotOptimize(C.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n * n * n));
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixGEMM, 32, 64, 128, 256);
+
+static void BM_MatrixTranspose(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = randomMatrix(n, n, 1);
+	for (auto _ : state)
+	{
+		math::Matrix<double> AT = A.getTr();
+		benchmark::DoNotOptimize(AT.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(2 * n * n * sizeof(double)));
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixTranspose, 64, 256, 1024);
+
+static void BM_MatrixCat(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	std::vector<math::Matrix<double>> parts{ randomMatrix(n, n, 1), randomMatrix(n, 1, 2) };
+	for (auto _ : state)
+	{
+		math::Matrix<double> C = math::cat(parts, math::Dimension::Column);
+		benchmark::DoNotOptimize(C.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(2 * n * (n + 1) * sizeof(double)));
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixCat, 64, 256, 1024);
+
+static void BM_MatrixLU(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = dominantMatrix(n, 1);
+	for (auto _ : state)
+	{
+		math::Matrix<double> LU = A.decompLU();
+		benchmark::DoNotOptimize(LU.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixLU, 32, 64, 128, 256);
+
+static void BM_MatrixDet(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = dominantMatrix(n, 1);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(A.det(1));
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixDet, 32, 64, 128, 256);
+
+static void BM_MatrixInverse(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = dominantMatrix(n, 1);
+	for (auto _ : state)
+	{
+		math::Matrix<double> A_inv = A.inverse();
+		benchmark::DoNotOptimize(A_inv.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixInverse, 16, 32, 64, 256);
+
+static void BM_MatrixInvert(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A = dominantMatrix(n, 1);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		math::Matrix<double> A_inv = A;
+		state.ResumeTiming();
+		A_inv.invert();
+		benchmark::DoNotOptimize(A_inv.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_MatrixInvert, 16, 32, 64, 256);
@@ -0,0 +1,116 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+#include <libmath/solver/las/bicgstab.h>
+#include <libmath/solver/las/kholetsky.h>
+#include <libmath/solver/us/secant.h>
+#include <functional>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+	/// @brief Random diagonally dominant system, all LAS solvers converge on it
+	void randomSystem(size_t n, math::Matrix<double>& A, math::Matrix<double>& b)
+	{
+		A = math::Matrix<double>(n);
+		A.rfill(1);
+		for (size_t i = 0; i < n; ++i)
+		{
+			A(i, i) += static_cast<double>(n);
+		}
+		b = math::Matrix<double>(n, 1);
+		b.rfill(2);
+	}
+
+	/// @brief Broyden tridiagonal system of n unlinear equations
+	std::vector<std::function<double(const math::Matrix<double>&)>> broyden(size_t n)
+	{
+		std::vector<std::function<double(const math::Matrix<double>&)>> F;
+		for (size_t i = 0; i < n; ++i)
+		{
+			F.push_back(
+				[i, n](const math::Matrix<double>& x)
+				{
+					double xl = i > 0 ? x(i - 1, 0) : 0.0;
+					double xr = i + 1 < n ? x(i + 1, 0) : 0.0;
+					return (3.0 - 2.0 * x(i, 0)) * x(i, 0) - xl - 2.0 * xr + 1.0;
+				});
+		}
+		return F;
+	}
+}
+
+static void BM_BicGStab(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A, b;
+	randomSystem(n, A, b);
+	math::BicGStab<double> solver;
+	for (auto _ : state)
+	{
+		math::Matrix<double> x(n, 1, 0.0);
+		solver.solve(A, b, x);
+		benchmark::DoNotOptimize(x.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_BicGStab, 64, 256, 1024);
+
+static void BM_Kholetsky(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::Matrix<double> A, b;
+	randomSystem(n, A, b);
+	math::Kholetsky<double> solver;
+	for (auto _ : state)
+	{
+		math::Matrix<double> x(n, 1, 0.0);
+		solver.solve(A, b, x);
+		benchmark::DoNotOptimize(x.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_Kholetsky, 32, 64, 128, 256);
+
+static void BM_Secant(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	auto F = broyden(n);
+	math::Secant<double> solver;
+	for (auto _ : state)
+	{
+		math::Matrix<double> x(n, 1, -1.0);
+		solver.solve(F, x);
+		benchmark::DoNotOptimize(x.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_Secant, 10, 50, 100);
+
+static void BM_SecantActiveSet(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	auto F = broyden(n);
+
+	// bounds cut off the root for even arguments, so they are frozen on the lower bound
+	math::Matrix<double> x_min(n, 1, -1.5);
+	math::Matrix<double> x_max(n, 1, 1.5);
+	for (size_t i = 0; i < n; i += 2)
+	{
+		x_min(i, 0) = -0.3;
+	}
+
+	math::USsetup setup;
+	setup.criteria = math::USStoppingCriteriaType::iterations;
+	setup.max_iter = 10;
+	setup.bounds_method = math::USBoundsMethod::active_set;
+	math::Secant<double> solver(setup);
+	for (auto _ : state)
+	{
+		math::Matrix<double> x(n, 1, 0.0);
+		solver.solve(F, x, x_min, x_max);
+		benchmark::DoNotOptimize(x.data());
+	}
+}
+MATH_BENCHMARK_SWEEP(BM_SecantActiveSet, 10, 50, 100);
@@ -0,0 +1,111 @@
+#include "benchmark.h"
+#include <libmath/matrix.h>
+#include <libmath/triangulator/iterative.h>
+#include <libmath/triangulator/triang_dynamic_cash.h>
+#include <libmath/triangulator/parallel.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/// @brief Uniformly distributed points in unit cube
+	math::Matrix<double> uniformPoints(size_t n, size_t dim)
+	{
+		std::mt19937 gen(1);
+		std::uniform_real_distribution<double> u(0.0, 1.0);
+		math::Matrix<double> points(n, dim, math::MatRep::Row);
+		for (size_t i = 0; i < n * dim; ++i)
+		{
+			points.data()[i] = u(gen);
+		}
+		return points;
+	}
+}
+
+static void BM_Delaunay2D(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::IterativeTriangulator<double> tr(uniformPoints(n, 2));
+	for (auto _ : state)
+	{
+		tr.triangulate();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_Delaunay2D, 1000, 10000, 100000);
+
+static void BM_Delaunay3D(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::IterativeTriangulator<double> tr(uniformPoints(n, 3));
+	for (auto _ : state)
+	{
+		tr.triangulate();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_Delaunay3D, 1000, 10000, 100000);
+
+static void BM_DelaunayParallel2D(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::ParallelTriangulator<double> tr(uniformPoints(n, 2));
+	for (auto _ : state)
+	{
+		tr.triangulate();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_DelaunayParallel2D, 100000, 1000000);
+
+static void BM_DelaunayParallel3D(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	math::ParallelTriangulator<double> tr(uniformPoints(n, 3));
+	for (auto _ : state)
+	{
+		tr.triangulate();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+MATH_BENCHMARK_SWEEP(BM_DelaunayParallel3D, 100000, 300000);
+
+static void BM_DelaunayMove(benchmark::State& state)
+{
+	math::bench::setThreads(state);
+	size_t n = static_cast<size_t>(state.range(0));
+	size_t moved = 100;
+	math::Matrix<double> points = uniformPoints(n, 2);
+	math::TriangDynamicCash<double> tr(points);
+	tr.triangulate();
+
+	// points oscillate by small steps, as in timestepping
+	std::vector<math::TriangDynamicCash<double>::index_type> indices(moved);
+	math::Matrix<double> positions(moved, 2, math::MatRep::Row);
+	for (size_t i = 0; i < moved; ++i)
+	{
+		indices[i] = static_cast<math::TriangDynamicCash<double>::index_type>(i * (n / moved));
+	}
+	double shift = 1.e-4;
+	for (auto _ : state)
+	{
+		shift = -shift;
+		for (size_t i = 0; i < moved; ++i)
+		{
+			positions(i, 0) = points(indices[i], 0) + shift;
+			positions(i, 1) = points(indices[i], 1) - shift;
+		}
+		tr.movePoints(indices, positions);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moved));
+}
+MATH_BENCHMARK_SWEEP(BM_DelaunayMove, 10000, 100000);
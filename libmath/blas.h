@@ -0,0 +1,544 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math::blas
+{
+	/**
+	* @defgroup Blas Vector kernels
+	* @{
+	* @brief Allocation-free kernels over contiguous arrays
+	* @details Kernels work with raw pointers, so they can be used on the internal storage of
+	* math::Matrix as well as on the work arrays of numerical methods. Loops are parallelized
+	* with OpenMP only for arrays, longer than omp_threshold elements.
+	*/
+
+	/// @brief Minimum array length for parallel execution of kernels
+	inline constexpr long long omp_threshold = 8192;
+
+	/**
+	* @brief Dot product @f$ \mathbf{x}^T \mathbf{y} @f$
+	* @param n: Number of elements
+	* @param x: First array
+	* @param y: Second array
+	*/
+	template <typename T>
+	T dot(size_t n, const T* x, const T* y)
+	{
+		T sum = static_cast<T>(0.0);
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for reduction(+ : sum) schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			sum += x[i] * y[i];
+		}
+		return sum;
+	}
+
+	/**
+	* @brief Euclidean norm @f$ \|\mathbf{x}\|_2 @f$
+	* @param n: Number of elements
+	* @param x: Array
+	*/
+	template <typename T>
+	T nrm2(size_t n, const T* x)
+	{
+		return std::sqrt(dot(n, x, x));
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = a \mathbf{x} + \mathbf{y} @f$
+	*/
+	template <typename T>
+	void axpy(size_t n, T a, const T* x, T* y)
+	{
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			y[i] += a * x[i];
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \mathbf{x} + a \mathbf{y} @f$
+	*/
+	template <typename T>
+	void xpay(size_t n, const T* x, T a, T* y)
+	{
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			y[i] = x[i] + a * y[i];
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{z} = a \mathbf{x} + b \mathbf{y} @f$
+	*/
+	template <typename T>
+	void axpby(size_t n, T a, const T* x, T b, const T* y, T* z)
+	{
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			z[i] = a * x[i] + b * y[i];
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{x} = a \mathbf{x} @f$
+	*/
+	template <typename T>
+	void scal(size_t n, T a, T* x)
+	{
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			x[i] *= a;
+		}
+	}
+
+	/**
+	* @brief @f$ \mathbf{y} = \mathbf{x} @f$
+	*/
+	template <typename T>
+	void copy(size_t n, const T* x, T* y)
+	{
+		long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size > omp_threshold)
+#endif
+		for (long long i = 0; i < size; ++i)
+		{
+			y[i] = x[i];
+		}
+	}
+
+	/**
+	* @brief Matrix-vector product @f$ \mathbf{y} = \mathbf{A}\mathbf{x} @f$
+	* @param rows: Number of rows of A
+	* @param cols: Number of columns of A
+	* @param a: Matrix A storage
+	* @param row_major: True if A is stored row by row, false if column by column
+	* @param x: Array of cols elements
+	* @param y: Array of rows elements
+	*/
+	template <typename T>
+	void gemv(size_t rows, size_t cols, const T* a, bool row_major, const T* x, T* y)
+	{
+		long long m = static_cast<long long>(rows);
+		long long n = static_cast<long long>(cols);
+		if (row_major)
+		{
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (m * n > omp_threshold)
+#endif
+			for (long long i = 0; i < m; ++i)
+			{
+				const T* row = a + i * n;
+				T sum = static_cast<T>(0.0);
+				for (long long j = 0; j < n; ++j)
+				{
+					sum += row[j] * x[j];
+				}
+				y[i] = sum;
+			}
+		}
+		else
+		{
+			for (long long i = 0; i < m; ++i)
+			{
+				y[i] = static_cast<T>(0.0);
+			}
+			for (long long j = 0; j < n; ++j)
+			{
+				axpy(rows, x[j], a + j * m, y);
+			}
+		}
+	}
+
+	/**
+	* @brief Matrix-matrix product @f$ \mathbf{Y} = \mathbf{A}\mathbf{X} @f$ for a block of k vectors
+	* @details Matrix A is streamed from memory once for all k vectors, which makes the product of
+	* k vectors much cheaper, than k calls of gemv for memory bound sizes
+	* @param rows: Number of rows of A
+	* @param cols: Number of columns of A
+	* @param a: Matrix A storage
+	* @param row_major: True if A is stored row by row, false if column by column
+	* @param k: Number of vectors
+	* @param x: Block of k vectors of cols elements, stored one after another (column-major cols x k)
+	* @param y: Block of k vectors of rows elements, stored one after another (column-major rows x k)
+	*/
+	template <typename T>
+	void gemm(size_t rows, size_t cols, const T* a, bool row_major, size_t k, const T* x, T* y)
+	{
+		if (k == 1)
+		{
+			gemv(rows, cols, a, row_major, x, y);
+			return;
+		}
+
+		long long m = static_cast<long long>(rows);
+		long long n = static_cast<long long>(cols);
+		long long nk = static_cast<long long>(k);
+		if (row_major)
+		{
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (m * n > omp_threshold)
+#endif
+			for (long long i = 0; i < m; ++i)
+			{
+				const T* row = a + i * n;
+				for (long long c = 0; c < nk; ++c)
+				{
+					const T* xc = x + c * n;
+					T sum = static_cast<T>(0.0);
+					for (long long j = 0; j < n; ++j)
+					{
+						sum += row[j] * xc[j];
+					}
+					y[i + c * m] = sum;
+				}
+			}
+		}
+		else
+		{
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (m * n > omp_threshold)
+#endif
+			for (long long c = 0; c < nk; ++c)
+			{
+				T* yc = y + c * m;
+				for (long long i = 0; i < m; ++i)
+				{
+					yc[i] = static_cast<T>(0.0);
+				}
+			}
+			for (long long j = 0; j < n; ++j)
+			{
+				const T* col = a + j * m;
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (m * nk > omp_threshold)
+#endif
+				for (long long c = 0; c < nk; ++c)
+				{
+					T xjc = x[j + c * n];
+					T* yc = y + c * m;
+					for (long long i = 0; i < m; ++i)
+					{
+						yc[i] += col[i] * xjc;
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief Rank-k update @f$ \mathbf{C} = \mathbf{C} + \mathbf{A}^T\mathbf{A} @f$
+	* @details Upper triangle of C is accumulated and mirrored to lower one, so C stays symmetric.
+	* Rows of C are updated in parallel.
+	* @param rows: Number of rows of A
+	* @param cols: Number of columns of A
+	* @param a: Matrix A storage, row-major rows x cols
+	* @param[in,out] c: Symmetric matrix C, row-major cols x cols
+	*/
+	template <typename T>
+	void syrk(size_t rows, size_t cols, const T* a, T* c)
+	{
+		long long m = static_cast<long long>(rows);
+		long long n = static_cast<long long>(cols);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic) if (m * n * n > omp_threshold)
+#endif
+		for (long long i = 0; i < n; ++i)
+		{
+			T* c_i = c + i * n;
+			for (long long r = 0; r < m; ++r)
+			{
+				const T* a_r = a + r * n;
+				T a_ri = a_r[i];
+				if (a_ri == static_cast<T>(0.0))
+				{
+					continue;
+				}
+				for (long long j = i; j < n; ++j)
+				{
+					c_i[j] += a_ri * a_r[j];
+				}
+			}
+		}
+		for (long long i = 0; i < n; ++i)
+		{
+			for (long long j = i + 1; j < n; ++j)
+			{
+				c[j * n + i] = c[i * n + j];
+			}
+		}
+	}
+
+	/// @brief Row block size of blocked triangular solvers
+	inline constexpr size_t trsm_block = 64;
+
+	/**
+	* @brief Blocked triangular solve @f$ \mathbf{T}\mathbf{X} = \mathbf{B} @f$ for k right-hand sides
+	* @details Triangle T is taken from packed LU storage (as returned by Matrix::decompLU): lower
+	* triangle with unit diagonal, or upper triangle with diagonal. Rows are processed by blocks of
+	* trsm_block rows: triangle of diagonal block is solved, then contribution of block is
+	* eliminated from all remaining rows. Elimination is a matrix-matrix product and runs in parallel.
+	* @param n: Dimension of T
+	* @param a: Packed LU storage
+	* @param row_major: True if a is stored row by row, false if column by column
+	* @param upper: True to solve with upper triangle, false - with unit lower triangle
+	* @param k: Number of right-hand sides
+	* @param[in,out] b: Right-hand sides on input, solution on output. Row-major n x k
+	*/
+	template <typename T>
+	void trsm(size_t n, const T* a, bool row_major, bool upper, size_t k, T* b)
+	{
+		auto at = [a, n, row_major](size_t i, size_t j)
+		{
+			return row_major ? a[i * n + j] : a[j * n + i];
+		};
+
+		auto eliminate = [b, k](T coef, size_t from, size_t to)
+		{
+			T* dst = b + to * k;
+			const T* src = b + from * k;
+			for (size_t c = 0; c < k; ++c)
+			{
+				dst[c] -= coef * src[c];
+			}
+		};
+
+		for (size_t blk = 0; blk < n; blk += trsm_block)
+		{
+			// forward substitution goes from the first block, backward - from the last one
+			size_t i0 = upper ? (n - std::min(n, blk + trsm_block)) : blk;
+			size_t i1 = upper ? (n - blk) : std::min(n, blk + trsm_block);
+
+			// triangle of diagonal block
+			if (upper)
+			{
+				for (size_t ii = i1; ii > i0; --ii)
+				{
+					size_t i = ii - 1;
+					for (size_t j = i + 1; j < i1; ++j)
+					{
+						eliminate(at(i, j), j, i);
+					}
+					T diag = at(i, i);
+					T* row = b + i * k;
+					for (size_t c = 0; c < k; ++c)
+					{
+						row[c] /= diag;
+					}
+				}
+			}
+			else
+			{
+				for (size_t i = i0; i < i1; ++i)
+				{
+					for (size_t j = i0; j < i; ++j)
+					{
+						eliminate(at(i, j), j, i);
+					}
+				}
+			}
+
+			// remaining rows
+			long long r0 = upper ? 0 : static_cast<long long>(i1);
+			long long r1 = upper ? static_cast<long long>(i0) : static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if ((r1 - r0) * static_cast<long long>((i1 - i0) * k) > omp_threshold)
+#endif
+			for (long long r = r0; r < r1; ++r)
+			{
+				size_t i = static_cast<size_t>(r);
+				for (size_t j = i0; j < i1; ++j)
+				{
+					eliminate(at(i, j), j, i);
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief LU factorization with partial pivoting @f$ \mathbf{P}\mathbf{A} = \mathbf{L}\mathbf{U} @f$
+	* @details Factors are stored in place of A in packed form (unit lower triangle L below diagonal,
+	* U on and above diagonal), so they can be passed to trsm. Elimination of rows below pivot
+	* runs in parallel.
+	* @param n: Dimension of A
+	* @param[in,out] a: Matrix A on input, packed LU on output. Row-major n x n
+	* @param[out] ipiv: Array of n pivot indices: row i was interchanged with row ipiv[i]
+	* @return 0 on success, i+1 if U(i,i) is exactly zero (factorization is completed, but U is singular)
+	*/
+	template <typename T>
+	size_t getrf(size_t n, T* a, size_t* ipiv)
+	{
+		size_t info = 0;
+		for (size_t j = 0; j < n; ++j)
+		{
+			// pivot search
+			size_t p = j;
+			T p_val = std::abs(a[j * n + j]);
+			for (size_t i = j + 1; i < n; ++i)
+			{
+				T val = std::abs(a[i * n + j]);
+				if (val > p_val)
+				{
+					p = i;
+					p_val = val;
+				}
+			}
+			ipiv[j] = p;
+			if (p != j)
+			{
+				std::swap_ranges(a + j * n, a + (j + 1) * n, a + p * n);
+			}
+
+			T pivot = a[j * n + j];
+			if (pivot == static_cast<T>(0.0))
+			{
+				if (info == 0)
+				{
+					info = j + 1;
+				}
+				continue;
+			}
+
+			const T* row_j = a + j * n;
+			long long i0 = static_cast<long long>(j + 1);
+			long long size = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if ((size - i0) * (size - i0) > omp_threshold)
+#endif
+			for (long long i = i0; i < size; ++i)
+			{
+				T* row_i = a + i * size;
+				T l = row_i[j] / pivot;
+				row_i[j] = l;
+				for (long long c = i0; c < size; ++c)
+				{
+					row_i[c] -= l * row_j[c];
+				}
+			}
+		}
+		return info;
+	}
+
+	/**
+	* @brief Solve @f$ \mathbf{A}\mathbf{X} = \mathbf{B} @f$ for k right-hand sides with factors of getrf
+	* @param n: Dimension of A
+	* @param a: Packed LU factors from getrf. Row-major n x n
+	* @param ipiv: Pivot indices from getrf
+	* @param k: Number of right-hand sides
+	* @param[in,out] b: Right-hand sides on input, solution on output. Row-major n x k
+	*/
+	template <typename T>
+	void getrs(size_t n, const T* a, const size_t* ipiv, size_t k, T* b)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (ipiv[i] != i)
+			{
+				std::swap_ranges(b + i * k, b + (i + 1) * k, b + ipiv[i] * k);
+			}
+		}
+		trsm(n, a, true, false, k, b);
+		trsm(n, a, true, true, k, b);
+	}
+
+	/**
+	* @brief Matrix inverse in place from factors of getrf
+	* @details Upper triangle U is inverted in place, then @f$ \mathbf{A}^{-1}\mathbf{L} = \mathbf{U}^{-1} @f$
+	* is solved column by column from the last one, and columns are interchanged back with
+	* respect to pivots. Only n elements of workspace are used. Row updates run in parallel.
+	* @param n: Dimension of A
+	* @param[in,out] a: Packed LU factors from getrf on input, inverse of A on output. Row-major n x n
+	* @param ipiv: Pivot indices from getrf
+	*/
+	template <typename T>
+	void getri(size_t n, T* a, const size_t* ipiv)
+	{
+		long long size = static_cast<long long>(n);
+
+		// inverse of upper triangle, column by column
+		for (size_t j = 0; j < n; ++j)
+		{
+			a[j * n + j] = static_cast<T>(1.0) / a[j * n + j];
+			T ajj = -a[j * n + j];
+			// x = inv(U(0:j,0:j)) * U(0:j,j), rows ascending keep unprocessed x intact
+			for (size_t i = 0; i < j; ++i)
+			{
+				T sum = static_cast<T>(0.0);
+				for (size_t k = i; k < j; ++k)
+				{
+					sum += a[i * n + k] * a[k * n + j];
+				}
+				a[i * n + j] = sum * ajj;
+			}
+		}
+
+		// solve inv(A) * L = inv(U)
+		std::vector<T> work(n);
+		for (long long j = size - 2; j >= 0; --j)
+		{
+			for (long long i = j + 1; i < size; ++i)
+			{
+				work[i] = a[i * size + j];
+				a[i * size + j] = static_cast<T>(0.0);
+			}
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (size * (size - j) > omp_threshold)
+#endif
+			for (long long i = 0; i < size; ++i)
+			{
+				T* row = a + i * size;
+				T sum = static_cast<T>(0.0);
+				for (long long k = j + 1; k < size; ++k)
+				{
+					sum += row[k] * work[k];
+				}
+				row[j] -= sum;
+			}
+		}
+
+		// interchange columns back
+		for (long long j = size - 2; j >= 0; --j)
+		{
+			size_t jp = ipiv[j];
+			if (jp != static_cast<size_t>(j))
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					std::swap(a[i * n + j], a[i * n + jp]);
+				}
+			}
+		}
+	}
+
+	/**
+	* @}
+	*/
+}
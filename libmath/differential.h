@@ -1,17 +1,20 @@
 #pragma once
 
 #include <libmath/matrix.h>
+#include <libmath/profiling.h>
 #include <libmath/math_settings.h>
 #include <libmath/math_exception.h>
 #include <libmath/boolean.h>
 #include <vector>
 #include <functional>
+#include <string>
+#include <complex>
+#include <limits>
 
 #ifdef MATH_OMP_DEFINE
 #include <omp.h>
 #endif
 
-#include <chrono>
 #include <utility>
 #include <numeric>
 #include <algorithm>
@@ -19,6 +22,311 @@
 
 namespace math
 {
+	namespace detail
+	{
+		/**
+		 * @brief Difference scheme
+		 * @details Derivate is @f$ \frac{1}{\Delta x} \sum_l w_l f(x + k_l \Delta x) @f$ with
+		 * offsets @f$ k_l @f$ and weights @f$ w_l @f$. Truncation error of scheme is
+		 * @f$ c_1 \Delta x^{p} + c_2 \Delta x^{p + q} + ... @f$ with order p and increment q
+		 * (q = 2 for symmetric schemes), which is used by Richardson extrapolation.
+		 */
+		struct DiffScheme
+		{
+			/// @brief Number of points of scheme
+			size_t points;
+
+			int offsets[4];
+
+			double weights[4];
+
+			/// @brief Maximum offset, point of derivation is kept reach*stepX away from the bounds
+			int reach;
+
+			/// @brief Leading order of truncation error
+			int order;
+
+			/// @brief Increment of orders in truncation error expansion
+			int order_step;
+		};
+
+		/// @brief Scheme by its number, scheme must be checked by checkBounds()
+		inline const DiffScheme &diffScheme(const int scheme)
+		{
+			static const DiffScheme schemes[4] =
+			{
+				// 1: backward
+				{ 2, { -1, 0 }, { -1.0, 1.0 }, 1, 1, 1 },
+				// 2: one-sided 3-point
+				{ 3, { -1, 0, 1 }, { 0.5, -2.0, 1.5 }, 1, 1, 1 },
+				// 3: central
+				{ 2, { -1, 1 }, { -0.5, 0.5 }, 1, 2, 2 },
+				// 4: central of fourth order
+				{ 4, { -2, -1, 1, 2 }, { 1.0 / 12.0, -8.0 / 12.0, 8.0 / 12.0, -1.0 / 12.0 }, 2, 4, 2 }
+			};
+			return schemes[scheme - 1];
+		}
+
+		/**
+		 * @brief Check scheme of differentiation and bounds of arguments
+		 * @param method: Name of calling function for messages of exceptions
+		 * @param n: Number of arguments
+		 * @throws math::ExceptionIncorrectMatrix if bounds aren't column matrices or their dimensions don't agree
+		 * @throws math::ExceptionInvalidValue if scheme is incorrect, lower bound is greater than upper one or
+		 * distance between them is too small for stencil of scheme
+		 */
+		template <typename T1>
+		void checkBounds(
+			const std::string &method,
+			const size_t n,
+			const int scheme,
+			const T1 stepX,
+			const Matrix<T1> &lower_bound,
+			const Matrix<T1> &upper_bound)
+		{
+			if (scheme < 1 || scheme > 4)
+			{
+				throw(math::ExceptionInvalidValue(method + ": Incorrect scheme argument!"));
+			}
+			if (!lower_bound.empty() && !upper_bound.empty())
+			{
+				if (lower_bound.rows() != upper_bound.rows())
+				{
+					throw(math::ExceptionIncorrectMatrix(method + " with constrained arguments: Dimensions of lower and upper bounds must agree!"));
+				}
+			}
+
+			if (!lower_bound.empty()) // check vector dimension, if defined
+			{
+				if (lower_bound.cols() > 1)
+				{
+					throw(ExceptionIncorrectMatrix(method + " with constrained arguments: Lower bounds must be column matrix!"));
+				}
+				if (lower_bound.rows() > n)
+				{
+					throw(ExceptionIncorrectMatrix(method + " with constrained arguments: Lower bounds can't have more rows, than arguments!"));
+				}
+			}
+
+			if (!upper_bound.empty()) // check vector dimension, if defined
+			{
+				if (upper_bound.cols() > 1)
+				{
+					throw(ExceptionIncorrectMatrix(method + " with constrained arguments: Upper bounds must be column matrix!"));
+				}
+				if (upper_bound.rows() > n)
+				{
+					throw(ExceptionIncorrectMatrix(method + " with constrained arguments: Upper bounds can't have more rows, than arguments!"));
+				}
+			}
+
+			if (!lower_bound.empty() && !upper_bound.empty())
+			{
+				int width = 2 * diffScheme(scheme).reach;
+				for (size_t i = 0; i < lower_bound.rows(); ++i)
+				{
+					if (lower_bound(i, 0) > upper_bound(i, 0))
+					{
+						throw(math::ExceptionInvalidValue(method + " with constrained arguments: Invalid constraints. Lower bound must be lower, than upper bound!"));
+					}
+					if (std::abs(upper_bound(i, 0) - lower_bound(i, 0)) < static_cast<T1>(width) * stepX)
+					{
+						throw(math::ExceptionInvalidValue(method + " with constrained arguments: Distance between lower and upper bounds must greater, than " +
+							std::to_string(width) + "*dX=" + std::to_string(static_cast<T1>(width) * stepX) + "!"));
+					}
+				}
+			}
+		}
+
+		/**
+		 * @brief Point of derivation by xId-th argument
+		 * @details Arguments x are clamped to the bounds, xId-th argument is kept margin away from them,
+		 * so all points of stencil are inside of the bounds. Bounds must be checked by checkBounds().
+		 */
+		template <typename T1>
+		void stencilCenter(
+			const math::Matrix<T1> &x,
+			const size_t xId,
+			const T1 margin,
+			const Matrix<T1> &lower_bound,
+			const Matrix<T1> &upper_bound,
+			math::Matrix<T1> &current_x)
+		{
+			current_x = x;
+
+			// if lower bound defined
+			if (!lower_bound.empty())
+			{
+				for (size_t i = 0; i < lower_bound.rows(); ++i)
+				{
+					current_x(i, 0) = std::max(x(i, 0), lower_bound(i, 0));
+				}
+				if (xId < lower_bound.rows())
+				{
+					current_x(xId, 0) = std::max(x(xId, 0), lower_bound(xId, 0) + margin);
+				}
+			}
+			// if upper bound defined
+			if (!upper_bound.empty())
+			{
+				for (size_t i = 0; i < upper_bound.rows(); ++i)
+				{
+					current_x(i, 0) = std::min(current_x(i, 0), upper_bound(i, 0));
+				}
+				if (xId < upper_bound.rows())
+				{
+					current_x(xId, 0) = std::min(current_x(xId, 0), upper_bound(xId, 0) - margin);
+				}
+			}
+		}
+
+		/// @brief Difference of F by xId-th argument around point of derivation current_x
+		template <typename T, typename T1>
+		T difference(
+			const std::function<T(const Matrix<T1> &)> &F,
+			const DiffScheme &diff_scheme,
+			const math::Matrix<T1> &current_x,
+			const size_t xId,
+			const T1 stepX)
+		{
+			math::Matrix<T1> point = current_x;
+			T dFdX = static_cast<T>(0.0);
+			for (size_t l = 0; l < diff_scheme.points; ++l)
+			{
+				point(xId, 0) = current_x(xId, 0) + static_cast<T1>(diff_scheme.offsets[l]) * stepX;
+				dFdX += static_cast<T>(diff_scheme.weights[l]) * F(point);
+			}
+			return dFdX / static_cast<T>(stepX);
+		}
+
+		/**
+		 * @brief Jacobi matrix without checks of inputs
+		 * @details Every stencil point (argument j, point l of scheme) is a task, which evaluates all
+		 * functions in it. Each thread perturbs its own copy of arguments, so no points are stored.
+		 * Point of derivation itself (offset 0 of schemes 1 and 2) is evaluated once for all arguments,
+		 * if it isn't shifted from the bounds. Inputs must be checked by caller (see checkBounds()),
+		 * so solvers validate them once per solve.
+		 * @return Number of evaluations of functions F
+		 * @see math::jacobi
+		 */
+		template <typename T, typename T1>
+		size_t jacobi(
+			const std::vector<std::function<T(const Matrix<T1> &)>> &F,
+			const math::Matrix<T1> &x,
+			math::Matrix<T> &J,
+			const int scheme,
+			const T1 stepX,
+			const Matrix<T1> &lower_bound,
+			const Matrix<T1> &upper_bound)
+		{
+			const DiffScheme &diff_scheme = diffScheme(scheme);
+			size_t m = F.size();
+			size_t n = x.rows();
+			size_t s = diff_scheme.points;
+			T1 margin = static_cast<T1>(diff_scheme.reach) * stepX;
+
+			// arguments clamped to the bounds and centres of stencils, kept margin away from the bounds
+			// (same as stencilCenter())
+			math::Matrix<T1> base = x;
+			std::vector<T1> centre(n);
+			for (size_t j = 0; j < n; ++j)
+			{
+				centre[j] = x(j, 0);
+				if (j < lower_bound.rows())
+				{
+					base(j, 0) = std::max(base(j, 0), lower_bound(j, 0));
+					centre[j] = std::max(centre[j], lower_bound(j, 0) + margin);
+				}
+				if (j < upper_bound.rows())
+				{
+					base(j, 0) = std::min(base(j, 0), upper_bound(j, 0));
+					centre[j] = std::min(centre[j], upper_bound(j, 0) - margin);
+				}
+			}
+
+			size_t zero = s;
+			for (size_t l = 0; l < s; ++l)
+			{
+				if (diff_scheme.offsets[l] == 0)
+				{
+					zero = l;
+				}
+			}
+
+			// values of F[i] in point l of argument j are values[(j * s + l) * m + i]
+			std::vector<T> values(n * s * m);
+			std::vector<size_t> tasks;
+			tasks.reserve(n * s);
+			std::vector<size_t> shared_centre;
+			for (size_t j = 0; j < n; ++j)
+			{
+				for (size_t l = 0; l < s; ++l)
+				{
+					if (l == zero && centre[j] == base(j, 0))
+					{
+						shared_centre.push_back(j);
+					}
+					else
+					{
+						tasks.push_back(j * s + l);
+					}
+				}
+			}
+
+			if (!shared_centre.empty())
+			{
+				for (size_t i = 0; i < m; ++i)
+				{
+					T f0 = F[i](base);
+					for (size_t j : shared_centre)
+					{
+						values[(j * s + zero) * m + i] = f0;
+					}
+				}
+			}
+
+			long long tasks_cnt = static_cast<long long>(tasks.size());
+			long long evals = tasks_cnt * static_cast<long long>(m);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel if (evals > blas::omp_threshold)
+#endif
+			{
+				// perturbed copy of arguments of current thread
+				math::Matrix<T1> point = base;
+#ifdef MATH_OMP_DEFINE
+#pragma omp for schedule(static)
+#endif
+				for (long long t = 0; t < tasks_cnt; ++t)
+				{
+					size_t p = tasks[static_cast<size_t>(t)];
+					size_t j = p / s;
+					size_t l = p - j * s;
+					point(j, 0) = centre[j] + static_cast<T1>(diff_scheme.offsets[l]) * stepX;
+					for (size_t i = 0; i < m; ++i)
+					{
+						values[p * m + i] = F[i](point);
+					}
+					point(j, 0) = base(j, 0);
+				}
+			}
+
+			for (size_t j = 0; j < n; ++j)
+			{
+				for (size_t i = 0; i < m; ++i)
+				{
+					T dFdX = static_cast<T>(0.0);
+					for (size_t l = 0; l < s; ++l)
+					{
+						dFdX += static_cast<T>(diff_scheme.weights[l]) * values[(j * s + l) * m + i];
+					}
+					J(i, j) = dFdX / static_cast<T>(stepX);
+				}
+			}
+
+			return static_cast<size_t>(evals) + (shared_centre.empty() ? 0 : m);
+		}
+	}
+
 	/**
 	 * @brief Partial derivate of function @f$ f @f$
 	 * @details Calculate @f$ \frac{\partial f}{\partial x} @f$.
@@ -53,6 +361,9 @@ namespace math
 	 *	- 1: Scheme of first order, calculates as @f$ \frac{\partial f}{\partial x} = \frac{f(x_i) - f(x_{i-1})}{x_i-x_{i-1}} @f$
 	 *	- 2: Scheme of second order, calculates as
 	 * @f$ \frac{\partial f}{\partial x} = \frac{\frac{3}{2} f(x_{i+1} - 2 f(x_i) + \frac{1}{2} f(x_{i-1}}{x_i-x_{i-1}} @f$
+	 *	- 3: Central scheme of second order, @f$ \frac{\partial f}{\partial x} = \frac{f(x_{i+1}) - f(x_{i-1})}{2 \Delta x} @f$
+	 *	- 4: Central scheme of fourth order,
+	 * @f$ \frac{\partial f}{\partial x} = \frac{-f(x_{i+2}) + 8 f(x_{i+1}) - 8 f(x_{i-1}) + f(x_{i-2})}{12 \Delta x} @f$
 	 * @param stepX: Step of derivate calculation, @f$ \Delta x = x_i-x_{i-1} @f$ (0.1*math::settings::Settings.targetTolerance by default)
 	 * @param F: Function
 	 * @param x: Column-vector of aruments
@@ -80,87 +391,161 @@ namespace math
 		{
 			throw(math::ExceptionIndexOutOfBounds("partialDerivate: Incorrect xId argument!"));
 		}
-		// check constraints
-		if (!lower_bound.empty() && !upper_bound.empty() )
+		detail::checkBounds("partialDerivate", x.rows(), scheme, stepX, lower_bound, upper_bound);
+
+		const detail::DiffScheme &diff_scheme = detail::diffScheme(scheme);
+		math::Matrix<T1> current_x;
+		detail::stencilCenter(x, xId, static_cast<T1>(diff_scheme.reach) * stepX, lower_bound, upper_bound, current_x);
+
+		return detail::difference(F, diff_scheme, current_x, xId, stepX);
+	}
+
+	/**
+	 * @brief Partial derivate of function @f$ f @f$ by Richardson extrapolation with adaptive step
+	 * @details Differences @f$ D(h_k) @f$ of scheme are evaluated for decreasing steps
+	 * @f$ h_k = h_0 / c^k @f$, c = 1.4, and extrapolated to @f$ h \to 0 @f$ by Neville tableau,
+	 * which cancels terms of truncation error of scheme one by one (Ridders' method):
+	 * @f[
+	 * D_{k,j} = \frac{c^{p + (j - 1) q} D_{k,j-1} - D_{k-1,j-1}}{c^{p + (j - 1) q} - 1},
+	 * @f]
+	 * where p and q are order and increment of orders of truncation error of scheme. Estimate with the
+	 * smallest difference to its neighbours in tableau is returned. Extrapolation stops, when round-off
+	 * error starts to grow, so step is chosen automatically, and result is much less sensitive to noise
+	 * and to choice of @f$ h_0 @f$, than a single difference.
+	 *
+	 * Point of derivation is kept @f$ h_0 @f$ away from the bounds for all steps.
+	 * @param F: Function
+	 * @param x: Column-vector of aruments
+	 * @param xId: index of derivated variable
+	 * @param scheme: Scheme of differentiation (3 by default), see partialDerivate()
+	 * @param stepX: Initial step @f$ h_0 @f$. If it isn't positive, @f$ h_0 = 0.1 \max(|x|, 1) @f$,
+	 * reduced to fit stencil of scheme between bounds
+	 * @param lower_bound: Lower constraints for independent variables. Stay empty, for evaluating without lower constraints.
+	 * @param upper_bound: Upper constraints for independent variables. Stay empty, for evaluating without upper constraints.
+	 * @param[out] error: Estimate of error of derivate, if not nullptr
+	 *
+	 * @return Partial derivate of f with x variable @f$ \frac{\partial f}{\partial x} @f$
+	 */
+	template <typename T, typename T1, class = std::enable_if<isNumeric<T> && isNumeric<T1>>>
+	T richardsonDerivate(const std::function<T(const Matrix<T1> &)> &F,
+						 const math::Matrix<T1> &x,
+						 const size_t xId = 0,
+						 const int scheme = 3,
+						 T1 stepX = static_cast<T1>(0.0),
+						 const Matrix<T1> &lower_bound = Matrix<T1>(),
+						 const Matrix<T1> &upper_bound = Matrix<T1>(),
+						 T *error = nullptr)
+	{
+		// check inputs
+		if (x.cols() > 1)
 		{
-			if (lower_bound.rows() != upper_bound.rows())
-			{
-				throw(math::ExceptionIncorrectMatrix("partialDerivate with constrained arguments: Dimensions of lower and upper bounds must agree!"));
-			}
+			throw(math::ExceptionIncorrectMatrix("richardsonDerivate: Matrix x argument must be column matrix!"));
 		}
-
-		if (!lower_bound.empty()) // check vector dimension, if defined
+		if (xId >= x.rows())
 		{
-			if (lower_bound.cols() > 1)
-			{
-				throw(ExceptionIncorrectMatrix("partialDerivate with constrained arguments: Lower bounds must be column matrix!"));
-			}
+			throw(math::ExceptionIndexOutOfBounds("richardsonDerivate: Incorrect xId argument!"));
+		}
+		if (scheme < 1 || scheme > 4)
+		{
+			throw(math::ExceptionInvalidValue("richardsonDerivate: Incorrect scheme argument!"));
 		}
 
-		if (!upper_bound.empty()) // check vector dimension, if defined
+		const detail::DiffScheme &diff_scheme = detail::diffScheme(scheme);
+		if (!(stepX > static_cast<T1>(0.0)))
 		{
-			if (upper_bound.cols() > 1)
+			stepX = static_cast<T1>(0.1) * std::max(std::abs(x(xId, 0)), static_cast<T1>(1.0));
+			if (xId < lower_bound.rows() && xId < upper_bound.rows() && lower_bound.cols() == 1 && upper_bound.cols() == 1)
 			{
-				throw(ExceptionIncorrectMatrix("partialDerivate with constrained arguments: Upper bounds must be column matrix!"));
+				T1 width = static_cast<T1>(2 * diff_scheme.reach);
+				stepX = std::min(stepX, std::abs(upper_bound(xId, 0) - lower_bound(xId, 0)) / width);
 			}
 		}
+		detail::checkBounds("richardsonDerivate", x.rows(), scheme, stepX, lower_bound, upper_bound);
+
+		math::Matrix<T1> current_x;
+		detail::stencilCenter(x, xId, static_cast<T1>(diff_scheme.reach) * stepX, lower_bound, upper_bound, current_x);
+
+		constexpr size_t levels = 10;
+		const T shrink = static_cast<T>(1.4);
+		const T safe = static_cast<T>(2.0);
 
-		if (!lower_bound.empty() && !upper_bound.empty())
+		// Neville tableau, row k is extrapolation of differences with steps h_0 ... h_k
+		T a[levels][levels];
+		T err = std::numeric_limits<T>::max();
+		T1 h = stepX;
+		a[0][0] = detail::difference(F, diff_scheme, current_x, xId, h);
+		T dFdX = a[0][0];
+		for (size_t k = 1; k < levels; ++k)
 		{
-			for (size_t i = 0; i < lower_bound.rows(); ++i)
+			h /= static_cast<T1>(shrink);
+			a[k][0] = detail::difference(F, diff_scheme, current_x, xId, h);
+			T fac = std::pow(shrink, static_cast<T>(diff_scheme.order));
+			const T fac_step = std::pow(shrink, static_cast<T>(diff_scheme.order_step));
+			for (size_t j = 1; j <= k; ++j)
 			{
-				if (lower_bound(i, 0) > upper_bound(i, 0))
+				a[k][j] = (fac * a[k][j - 1] - a[k - 1][j - 1]) / (fac - static_cast<T>(1.0));
+				fac *= fac_step;
+				T errt = std::max(std::abs(a[k][j] - a[k][j - 1]), std::abs(a[k][j] - a[k - 1][j - 1]));
+				if (errt <= err)
 				{
-					throw(math::ExceptionInvalidValue("partialDerivate with constrained arguments: Invalid constraints. Lower bound must be lower, than upper bound!"));
-				}
-				if (std::abs(upper_bound(i, 0) - lower_bound(i, 0)) < static_cast<T1>(2.) * stepX)
-				{
-					throw(math::ExceptionInvalidValue("partialDerivate with constrained arguments: Distance between lower and upper bounds must greater, than 2*dX=" + std::to_string(static_cast<T1>(2.) * stepX) + "!"));
+					err = errt;
+					dFdX = a[k][j];
 				}
 			}
+			// higher order makes error worse, round-off dominates
+			if (std::abs(a[k][k] - a[k - 1][k - 1]) >= safe * err)
+			{
+				break;
+			}
 		}
 
-		T dFdX = static_cast<T>(0.0);
-		math::Matrix<T1> current_x = x;
+		if (error != nullptr)
+		{
+			*error = err;
+		}
+		return dFdX;
+	}
 
-		// if lower bound defined
-		if (!lower_bound.empty())
+	/**
+	 * @brief Partial derivate of function @f$ f @f$ by complex step
+	 * @details Calculate @f$ \frac{\partial f}{\partial x} = \frac{\mathrm{Im} f(x + i \Delta x)}{\Delta x} @f$.
+	 * There is no subtraction of close values, so step can be arbitrary small, and derivate is exact up to
+	 * round-off for analytic f, which must be evaluated for complex arguments. Takes one evaluation of f.
+	 * @param F: Function of complex arguments
+	 * @param x: Column-vector of aruments
+	 * @param xId: index of derivated variable
+	 * @param stepX: Imaginary step @f$ \Delta x @f$ (1e-20 by default)
+	 *
+	 * @return Partial derivate of f with x variable @f$ \frac{\partial f}{\partial x} @f$
+	 */
+	template <typename T, class = std::enable_if<isNumeric<T>>>
+	T complexStepDerivate(const std::function<std::complex<T>(const Matrix<std::complex<T>> &)> &F,
+						  const math::Matrix<T> &x,
+						  const size_t xId = 0,
+						  const T stepX = static_cast<T>(1.e-20))
+	{
+		// check inputs
+		if (x.cols() > 1)
 		{
-			for (size_t i = 0; i < lower_bound.rows(); ++i)
-			{
-				current_x(i, 0) = std::max(x(i, 0), lower_bound(i, 0));
-			}
-			current_x(xId, 0) = std::max(x(xId, 0), lower_bound(xId, 0) + stepX);
+			throw(math::ExceptionIncorrectMatrix("complexStepDerivate: Matrix x argument must be column matrix!"));
 		}
-		// if upper bound defined
-		if (!upper_bound.empty())
+		if (xId >= x.rows())
 		{
-			for (size_t i = 0; i < upper_bound.rows(); ++i)
-			{
-				current_x(i, 0) = std::min(current_x(i, 0), upper_bound(i, 0));
-			}
-			current_x(xId, 0) = std::min(current_x(xId, 0), upper_bound(xId, 0) - stepX);
+			throw(math::ExceptionIndexOutOfBounds("complexStepDerivate: Incorrect xId argument!"));
+		}
+		if (!(stepX > static_cast<T>(0.0)))
+		{
+			throw(math::ExceptionInvalidValue("complexStepDerivate: Step must be positive!"));
 		}
 
-		math::Matrix<T1> previous_x = current_x;
-		math::Matrix<T1> next_x = current_x;
-
-		previous_x(xId, 0) = current_x(xId, 0) - stepX;
-		next_x(xId, 0) = current_x(xId, 0) + stepX;
-
-		switch (scheme)
+		math::Matrix<std::complex<T>> z(x.rows(), 1);
+		for (size_t i = 0; i < x.rows(); ++i)
 		{
-		case 1:
-			dFdX = (F(current_x) - F(previous_x)) / static_cast<T>(stepX);
-			break;
-		case 2:
-			dFdX = ((3.0 / 2.0) * F(next_x) - 2.0 * F(current_x) + 0.5 * F(previous_x)) / static_cast<T>(stepX);
-			break;
-		default:
-			throw(math::ExceptionInvalidValue("partialDerivate: Incorrect scheme argument!"));
+			z(i, 0) = std::complex<T>(x(i, 0), static_cast<T>(0.0));
 		}
+		z(xId, 0) = std::complex<T>(x(xId, 0), stepX);
 
-		return dFdX;
+		return F(z).imag() / stepX;
 	}
 
 	/**
@@ -188,7 +573,10 @@ namespace math
 	 * @param scheme: Scheme of differentiation (1 by default)
 	 *	- 1: Scheme of first order, calculates as @f$ \frac{df}{dx} = \frac{f(x_i) - f(x_{i-1})}{x_i-x_{i-1}} @f$
 	 *	- 2: Scheme of second order, calculates as
-	 * @f$ \frac{df}{dx} = \frac{\frac{3}{2} f(x_{i+1} - 2 f(x_i) + \frac{1}{2} f(x_{i-1}}{x_i-x_{i-1}} @f$.
+	 * @f$ \frac{df}{dx} = \frac{\frac{3}{2} f(x_{i+1} - 2 f(x_i) + \frac{1}{2} f(x_{i-1}}{x_i-x_{i-1}} @f$
+	 *	- 3: Central scheme of second order, @f$ \frac{df}{dx} = \frac{f(x_{i+1}) - f(x_{i-1})}{2 \Delta x} @f$
+	 *	- 4: Central scheme of fourth order,
+	 * @f$ \frac{df}{dx} = \frac{-f(x_{i+2}) + 8 f(x_{i+1}) - 8 f(x_{i-1}) + f(x_{i-2})}{12 \Delta x} @f$.
 	 * @param stepX: Step of derivate calculation, @f$ \Delta x = x_i-x_{i-1} @f$ (0.1*math::settings::Settings.targetTolerance by default)
 	 * @param F: Function
 	 * @param x: Argument
@@ -301,6 +689,9 @@ namespace math
 	 *	- 1: Scheme of first order, calculates as @f$ \frac{\partial f}{\partial x} = \frac{f(x_i) - f(x_{i-1})}{x_i-x_{i-1}} @f$
 	 *	- 2: Scheme of second order, calculates as
 	 * @f$ \frac{\partial f}{\partial x} = \frac{\frac{3}{2} f(x_{i+1} - 2 f(x_i) + \frac{1}{2} f(x_{i-1}}{x_i-x_{i-1}} @f$
+	 *	- 3: Central scheme of second order, @f$ \frac{\partial f}{\partial x} = \frac{f(x_{i+1}) - f(x_{i-1})}{2 \Delta x} @f$
+	 *	- 4: Central scheme of fourth order,
+	 * @f$ \frac{\partial f}{\partial x} = \frac{-f(x_{i+2}) + 8 f(x_{i+1}) - 8 f(x_{i-1}) + f(x_{i-2})}{12 \Delta x} @f$
 	 * @param stepX: Step of derivate calculation, @f$ \Delta x = x_i-x_{i-1} @f$ (0.001*math::settings::Settings.targetTolerance by default)
 	 * @param[in] F: Vector of functions (F = vector function @f$ \mathbf{u} @f$)
 	 * @param[in] x: Column matrix of arguments of F, for which Jakobian calculates
@@ -328,29 +719,8 @@ namespace math
 			throw(math::ExceptionIncorrectMatrix("jacobi: Dimensions of input argument F and output x didn't agree!"));
 		}
 
-		// check constraints
-		if (!lower_bound.empty() && !upper_bound.empty() )
-		{
-			if (lower_bound.rows() != upper_bound.rows())
-			{
-				throw(math::ExceptionIncorrectMatrix("jacobi with constrained arguments: Dimensions of lower and upper bounds must agree!"));
-			}
-		}
-		if (!lower_bound.empty()) // check vector dimension, if defined
-		{
-			if (lower_bound.cols() > 1)
-			{
-				throw(ExceptionIncorrectMatrix("jacobi with constrained arguments: Lower bounds must be column matrix!"));
-			}
-		}
-
-		if (!upper_bound.empty()) // check vector dimension, if defined
-		{
-			if (upper_bound.cols() > 1)
-			{
-				throw(ExceptionIncorrectMatrix("jacobi with constrained arguments: Upper bounds must be column matrix!"));
-			}
-		}
+		// bounds are checked once per Jacobian, not for every element
+		detail::checkBounds("jacobi", x.rows(), scheme, stepX, lower_bound, upper_bound);
 
 		size_t m = F.size();
 		size_t n = x.rows();
@@ -361,30 +731,8 @@ namespace math
 			throw(ExceptionIncorrectMatrix("jacobi: Output matrix J must be " + std::to_string(m) + "x" + std::to_string(n) + " matrix!"));
 		}
 
-		size_t n_els = J.numel();
-
-		// auto start = std::chrono::steady_clock::now();
-
-#ifdef MATH_OMP_DEFINE
-#pragma omp parallel for shared(J, n_els, lower_bound, upper_bound) schedule(static)
-#endif
-		for (int pos = 0; pos < n_els; ++pos)
-		{
-			size_t row = 0;
-			size_t col = 0;
-			if (J.representation() == math::MatRep::Row) // row repr
-			{
-				row = (size_t)std::floor(pos / J.cols());
-				col = pos - row * J.cols();
-			}
-			else if (J.representation() == math::MatRep::Column) // column repr
-			{
-				col = (size_t)std::floor(pos / J.rows());
-				row = pos - J.rows() * col;
-			}
-			J(col, row) = math::partialDerivate<T, T1>(F[col], x, row, scheme, stepX, lower_bound, upper_bound);
-		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
+		MATH_PROFILE_SCOPE("jacobi");
+		[[maybe_unused]] size_t evals = detail::jacobi(F, x, J, scheme, stepX, lower_bound, upper_bound);
+		MATH_PROFILE_COUNTER("jacobi.f_evals", evals);
 	}
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include <iostream>
 #include <libmath/differential.h>
 #include <libmath/boolean.h>
+#include <complex>
+#include <cmath>
+#include <limits>
+#include <atomic>
 
 TEST(partialDerivate, DiffSchemes)
 {
@@ -263,6 +267,102 @@ TEST(partialDerivate, IncorrectConstraints)
 	}
 }
 
+TEST(partialDerivate, CentralSchemes)
+{
+	std::function<double(const math::Matrix<double> &)> f1(
+		[](const math::Matrix<double> &x)
+		{
+			return std::sin(x(0, 0)) * std::exp(x(1, 0));
+		});
+	math::Matrix<double> x = {{0.7}, {0.3}};
+	double exact = std::cos(0.7) * std::exp(0.3);
+
+	double d1 = math::partialDerivate(f1, x, 0, 1, 1.e-3);
+	double d3 = math::partialDerivate(f1, x, 0, 3, 1.e-3);
+	double d4 = math::partialDerivate(f1, x, 0, 4, 1.e-3);
+	EXPECT_NEAR(d3, exact, 1.e-6);
+	EXPECT_NEAR(d4, exact, 1.e-11);
+	EXPECT_LT(std::abs(d3 - exact), std::abs(d1 - exact));
+	EXPECT_LT(std::abs(d4 - exact), std::abs(d3 - exact));
+
+	// stencil of 4th order scheme stays inside of bounds
+	std::function<double(const math::Matrix<double> &)> f2(
+		[](const math::Matrix<double> &x)
+		{
+			if (x(0, 0) < 0.0 || x(0, 0) > 1.0)
+			{
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			return x(0, 0) * x(0, 0);
+		});
+	double d_low = math::partialDerivate(f2, {{0.0}}, 0, 4, 1.e-3, {{0.0}}, {{1.0}});
+	EXPECT_NEAR(d_low, 4.e-3, 1.e-10);
+
+	// stencil of 4th order scheme needs 4*dX between bounds
+	try
+	{
+		math::partialDerivate(f2, {{0.0}}, 0, 4, 0.1, {{0.0}}, {{0.3}});
+		FAIL();
+	}
+	catch (const math::ExceptionInvalidValue &exc)
+	{
+		EXPECT_EQ(exc.what(), std::string("partialDerivate with constrained arguments: Distance between lower and upper bounds must greater, than 4*dX=" + std::to_string(4.0 * 0.1) + "!"));
+	}
+}
+
+TEST(partialDerivate, Richardson)
+{
+	std::function<double(const math::Matrix<double> &)> f1(
+		[](const math::Matrix<double> &x)
+		{
+			return std::sin(x(0, 0)) * std::exp(x(1, 0));
+		});
+	math::Matrix<double> x = {{0.7}, {0.3}};
+	double exact = std::exp(0.3) * std::sin(0.7);
+
+	// automatic step
+	double error = 0.0;
+	double d = math::richardsonDerivate(f1, x, 1, 3, 0.0, math::Matrix<double>(), math::Matrix<double>(), &error);
+	EXPECT_NEAR(d, exact, 1.e-12);
+	EXPECT_LT(error, 1.e-10);
+
+	// extrapolation of one-sided scheme is much better, than single difference with the same step
+	double d1 = math::partialDerivate(f1, x, 1, 1, 0.01);
+	double r1 = math::richardsonDerivate(f1, x, 1, 1, 0.01);
+	EXPECT_LT(std::abs(r1 - exact), 1.e-3 * std::abs(d1 - exact));
+
+	// large initial step is reduced to fit between bounds
+	std::function<double(const math::Matrix<double> &)> f2(
+		[](const math::Matrix<double> &x)
+		{
+			if (x(0, 0) < 0.0 || x(0, 0) > 0.2)
+			{
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			return std::exp(x(0, 0));
+		});
+	double d2 = math::richardsonDerivate(f2, {{0.1}}, 0, 4, 0.0, {{0.0}}, {{0.2}});
+	EXPECT_NEAR(d2, std::exp(0.1), 1.e-12);
+
+	EXPECT_THROW(math::richardsonDerivate(f1, x, 0, 5), math::ExceptionInvalidValue);
+}
+
+TEST(partialDerivate, ComplexStep)
+{
+	std::function<std::complex<double>(const math::Matrix<std::complex<double>> &)> f1(
+		[](const math::Matrix<std::complex<double>> &x)
+		{
+			return std::sin(x(0, 0)) * std::exp(x(1, 0));
+		});
+	math::Matrix<double> x = {{0.7}, {0.3}};
+
+	EXPECT_NEAR(math::complexStepDerivate(f1, x, 0), std::cos(0.7) * std::exp(0.3), 1.e-15);
+	EXPECT_NEAR(math::complexStepDerivate(f1, x, 1), std::sin(0.7) * std::exp(0.3), 1.e-15);
+
+	EXPECT_THROW(math::complexStepDerivate(f1, x, 2), math::ExceptionIndexOutOfBounds);
+	EXPECT_THROW(math::complexStepDerivate(f1, x, 0, 0.0), math::ExceptionInvalidValue);
+}
+
 TEST(diff, Calculation)
 {
 	// define function
@@ -381,4 +481,120 @@ TEST(jakobi, Constraints)
 		0.001 * math::settings::CurrentSettings.targetTolerance,
 		x_min,
 		x_max);
-}
\ No newline at end of file
+}
+
+TEST(jakobi, Evaluations)
+{
+#ifdef MATH_OMP_DEFINE
+	omp_set_num_threads(4);
+#endif
+
+	std::atomic<size_t> evals = 0;
+
+	// vector function F
+	std::vector<std::function<double(const math::Matrix<double> &)>> F;
+
+	F.push_back(
+		[&evals](const math::Matrix<double> &x)
+		{
+			++evals;
+			return (pow(x(0, 0), 2.0) + pow(x(1, 0), 2.0) - x(2, 0) - 6.0);
+		});
+	F.push_back(
+		[&evals](const math::Matrix<double> &x)
+		{
+			++evals;
+			return (x(0, 0) + x(1, 0) * x(2, 0) - 2.0);
+		});
+	F.push_back(
+		[&evals](const math::Matrix<double> &x)
+		{
+			++evals;
+			return (x(0, 0) + x(1, 0) + x(2, 0) - 3.0);
+		});
+
+	math::Matrix<double> x0 =
+		{
+			{1.0},
+			{1.0},
+			{1.0}};
+
+	math::Matrix<double> J(3);
+
+	// point of derivation is shared by all arguments
+	math::jacobi(F, x0, J, 1, 1.e-6);
+	EXPECT_EQ(evals.load(), 3 * 3 + 3);
+
+	// central scheme doesn't use point of derivation
+	evals = 0;
+	math::jacobi(F, x0, J, 3, 1.e-6);
+	EXPECT_EQ(evals.load(), 3 * 3 * 2);
+
+	// first argument is on the upper bound, so its point of derivation is shifted
+	evals = 0;
+	math::jacobi(F, x0, J, 1, 1.e-6, math::Matrix<double>(), {{1.0}, {2.0}, {2.0}});
+	EXPECT_EQ(evals.load(), 3 * 3 + 3 + 3);
+
+	math::Matrix<double> J_t =
+		{
+			{2.0, 2.0, -1.0},
+			{1.0, 1.0, 1.0},
+			{1.0, 1.0, 1.0}};
+
+	EXPECT_EQ(J.compare(J_t), true);
+}
+
+TEST(jakobi, IncorrectConstraints)
+{
+	std::vector<std::function<double(const math::Matrix<double> &)>> F;
+	F.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) * x(1, 0);
+		});
+	F.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) + x(1, 0);
+		});
+
+	math::Matrix<double> x0 = {{1.0}, {1.0}};
+	math::Matrix<double> J(2);
+
+	// bounds are checked once for the whole matrix
+	try
+	{
+		math::jacobi(F, x0, J, 1, 1.e-6, {{1.0}, {0.0}}, {{0.0}, {1.0}});
+		FAIL();
+	}
+	catch (const math::ExceptionInvalidValue &exc)
+	{
+		EXPECT_EQ(exc.what(), std::string("jacobi with constrained arguments: Invalid constraints. Lower bound must be lower, than upper bound!"));
+	}
+
+	// incorrect scheme is reported before evaluation
+	try
+	{
+		math::jacobi(F, x0, J, 5);
+		FAIL();
+	}
+	catch (const math::ExceptionInvalidValue &exc)
+	{
+		EXPECT_EQ(exc.what(), std::string("jacobi: Incorrect scheme argument!"));
+	}
+
+	// all schemes are evaluated by the same stencil tasks
+	for (int scheme = 1; scheme <= 4; ++scheme)
+	{
+		math::jacobi(F, x0, J, scheme, 1.e-4);
+		EXPECT_NEAR(J(0, 0), 1.0, 1.e-3);
+		EXPECT_NEAR(J(0, 1), 1.0, 1.e-3);
+		EXPECT_NEAR(J(1, 0), 1.0, 1.e-3);
+		EXPECT_NEAR(J(1, 1), 1.0, 1.e-3);
+	}
+
+	// bounds of the first arguments only
+	math::jacobi(F, x0, J, 1, 1.e-6, {{0.0}}, {{0.5}});
+	EXPECT_EQ(math::isEqual(J(0, 0), 1.0), true);
+	EXPECT_EQ(math::isEqual(J(0, 1), 0.5), true);
+}
@@ -0,0 +1,429 @@
+#pragma once
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <libmath/geometry/mesh.h>
+#include <libmath/geometry/predicates.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cstdint>
+
+namespace math
+{
+	/**
+	* @brief Bounding volume hierarchy over simplices
+	* @details Cells (triangles in 2D, tetrahedrons in 3D) are split recursively by median of
+	* centroids along the widest dimension until leaf_size cells remain, every tree node keeps
+	* bounding box of its cells. Vertices of cells are copied to the tree in leaf order, so cells
+	* of one leaf are contiguous in memory. Cells of one tree level are split in parallel.
+	*
+	* Point location descends into nodes, whose boxes contain point, and tests cells of leaves
+	* with exact orientation predicates, so points on shared facets and vertices are always
+	* located in one of their cells. Location takes O(log N) for meshes without long cells.
+	*/
+	template <typename T>
+	class BVH
+	{
+	public:
+		/// @brief Type of cell indices
+		using index_type = uint32_t;
+
+		/// @brief Result of location of point outside of all cells
+		static constexpr index_type no_cell = std::numeric_limits<index_type>::max();
+
+		/// @brief Maximum number of cells in leaf
+		static constexpr size_t leaf_size = 4;
+
+	private:
+		struct TreeNode
+		{
+			/// @brief Range of cells in tree order
+			size_t begin = 0;
+			size_t end = 0;
+
+			/// @brief Children indices, 0 for leaf (root is never a child)
+			size_t left = 0;
+			size_t right = 0;
+		};
+
+		size_t dim_ = 0;
+
+		/// @brief Vertices of cells in tree order, (dim_ + 1) * dim_ values per cell
+		std::vector<double> vertices_;
+
+		/// @brief Orientation of cells in tree order: orient(v0, ..., vD), 0 for degenerate cells
+		std::vector<double> volumes_;
+
+		/// @brief Original indices of cells in tree order
+		std::vector<index_type> index_;
+
+		std::vector<TreeNode> nodes_;
+
+		/// @brief Bounding boxes of nodes: lower corner followed by upper one (2 * dim_ values per node)
+		std::vector<double> boxes_;
+
+		/// @brief Orientation of simplex, dim_ + 1 points
+		double orient(const double* const* p) const
+		{
+			return dim_ == 2 ? predicates::orient2d(p[0], p[1], p[2]) : predicates::orient3d(p[0], p[1], p[2], p[3]);
+		}
+
+		bool inBox(size_t node, const double* point) const
+		{
+			const double* lo = boxes_.data() + node * 2 * dim_;
+			const double* hi = lo + dim_;
+			for (size_t k = 0; k < dim_; ++k)
+			{
+				if (point[k] < lo[k] || point[k] > hi[k])
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Check that cell at tree position pos contains point, compute barycentric coordinates
+		bool contains(size_t pos, const double* point, T* bary) const
+		{
+			double volume = volumes_[pos];
+			if (volume == 0.0)
+			{
+				return false;
+			}
+			size_t v = dim_ + 1;
+			const double* vertices = vertices_.data() + pos * v * dim_;
+			const double* p[4];
+			for (size_t l = 0; l < v; ++l)
+			{
+				p[l] = vertices + l * dim_;
+			}
+			double weights[4];
+			for (size_t l = 0; l < v; ++l)
+			{
+				// simplex with point in place of vertex l
+				const double* vertex = p[l];
+				p[l] = point;
+				weights[l] = orient(p);
+				p[l] = vertex;
+				if ((volume > 0.0 && weights[l] < 0.0) || (volume < 0.0 && weights[l] > 0.0))
+				{
+					return false;
+				}
+			}
+			if (bary != nullptr)
+			{
+				for (size_t l = 0; l < v; ++l)
+				{
+					bary[l] = static_cast<T>(weights[l] / volume);
+				}
+			}
+			return true;
+		}
+
+		index_type find(const double* point, T* bary) const
+		{
+			if (nodes_.empty())
+			{
+				return no_cell;
+			}
+			size_t stack[128];
+			size_t top = 0;
+			stack[top++] = 0;
+			while (top > 0)
+			{
+				const TreeNode& n = nodes_[stack[--top]];
+				if (n.left == 0)
+				{
+					for (size_t pos = n.begin; pos < n.end; ++pos)
+					{
+						if (contains(pos, point, bary))
+						{
+							return index_[pos];
+						}
+					}
+					continue;
+				}
+				if (inBox(n.right, point))
+				{
+					stack[top++] = n.right;
+				}
+				if (inBox(n.left, point))
+				{
+					stack[top++] = n.left;
+				}
+			}
+			return no_cell;
+		}
+
+		/**
+		* @brief Build tree
+		* @param cells: Number of cells
+		* @param vertex: Callable vertex(c, l, k), k-th coordinate of l-th vertex of cell c
+		*/
+		template <typename Vertex>
+		void build(size_t cells, Vertex&& vertex)
+		{
+			if (dim_ != 2 && dim_ != 3)
+			{
+				throw(ExceptionInvalidValue("BVH<T>::build: Only 2D and 3D cells are supported!"));
+			}
+			if (cells >= static_cast<size_t>(no_cell))
+			{
+				throw(ExceptionInvalidValue("BVH<T>::build: Too many cells!"));
+			}
+			size_t v = dim_ + 1;
+			long long n = static_cast<long long>(cells);
+
+			// boxes of cells: lower corner, upper corner and doubled centroid
+			std::vector<double> cell_boxes(cells * 3 * dim_);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (n > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < n; ++c)
+			{
+				double* lo = cell_boxes.data() + static_cast<size_t>(c) * 3 * dim_;
+				double* hi = lo + dim_;
+				for (size_t k = 0; k < dim_; ++k)
+				{
+					lo[k] = std::numeric_limits<double>::max();
+					hi[k] = std::numeric_limits<double>::lowest();
+					for (size_t l = 0; l < v; ++l)
+					{
+						double x = static_cast<double>(vertex(static_cast<size_t>(c), l, k));
+						lo[k] = std::min(lo[k], x);
+						hi[k] = std::max(hi[k], x);
+					}
+					hi[dim_ + k] = lo[k] + hi[k];
+				}
+			}
+
+			index_.resize(cells);
+			std::iota(index_.begin(), index_.end(), index_type(0));
+			nodes_.clear();
+			boxes_.clear();
+			if (cells != 0)
+			{
+				nodes_.reserve(2 * (cells / leaf_size + 1));
+				nodes_.push_back(TreeNode{ 0, cells, 0, 0 });
+			}
+
+			// nodes of one level have disjoint ranges of cells and are split in parallel
+			std::vector<size_t> level;
+			if (cells != 0)
+			{
+				level.push_back(0);
+			}
+			std::vector<size_t> mids;
+			while (!level.empty())
+			{
+				boxes_.resize(nodes_.size() * 2 * dim_);
+				mids.assign(level.size(), 0);
+				long long level_size = static_cast<long long>(level.size());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic) if (level_size > 1 && n > blas::omp_threshold)
+#endif
+				for (long long j = 0; j < level_size; ++j)
+				{
+					size_t node = level[j];
+					size_t begin = nodes_[node].begin;
+					size_t end = nodes_[node].end;
+
+					// bounding boxes of cells and of centroids
+					double* lo = boxes_.data() + node * 2 * dim_;
+					double* hi = lo + dim_;
+					double centre_lo[3];
+					double centre_hi[3];
+					for (size_t k = 0; k < dim_; ++k)
+					{
+						lo[k] = centre_lo[k] = std::numeric_limits<double>::max();
+						hi[k] = centre_hi[k] = std::numeric_limits<double>::lowest();
+					}
+					for (size_t i = begin; i < end; ++i)
+					{
+						const double* box = cell_boxes.data() + static_cast<size_t>(index_[i]) * 3 * dim_;
+						for (size_t k = 0; k < dim_; ++k)
+						{
+							lo[k] = std::min(lo[k], box[k]);
+							hi[k] = std::max(hi[k], box[dim_ + k]);
+							centre_lo[k] = std::min(centre_lo[k], box[2 * dim_ + k]);
+							centre_hi[k] = std::max(centre_hi[k], box[2 * dim_ + k]);
+						}
+					}
+
+					if (end - begin <= leaf_size)
+					{
+						continue;
+					}
+
+					size_t axis = 0;
+					for (size_t k = 1; k < dim_; ++k)
+					{
+						if (centre_hi[k] - centre_lo[k] > centre_hi[axis] - centre_lo[axis])
+						{
+							axis = k;
+						}
+					}
+					if (!(centre_hi[axis] > centre_lo[axis]))
+					{
+						// coincident centroids
+						continue;
+					}
+
+					size_t mid = begin + (end - begin) / 2;
+					size_t offset = 2 * dim_ + axis;
+					std::nth_element(index_.begin() + begin, index_.begin() + mid, index_.begin() + end,
+						[&](index_type a, index_type b)
+						{
+							return cell_boxes[static_cast<size_t>(a) * 3 * dim_ + offset] <
+								cell_boxes[static_cast<size_t>(b) * 3 * dim_ + offset];
+						});
+					mids[j] = mid;
+				}
+
+				std::vector<size_t> next;
+				next.reserve(2 * level.size());
+				for (size_t j = 0; j < level.size(); ++j)
+				{
+					if (mids[j] == 0)
+					{
+						continue;
+					}
+					size_t node = level[j];
+					size_t left = nodes_.size();
+					nodes_.push_back(TreeNode{ nodes_[node].begin, mids[j], 0, 0 });
+					nodes_.push_back(TreeNode{ mids[j], nodes_[node].end, 0, 0 });
+					nodes_[node].left = left;
+					nodes_[node].right = left + 1;
+					next.push_back(left);
+					next.push_back(left + 1);
+				}
+				level.swap(next);
+			}
+
+			vertices_.resize(cells * v * dim_);
+			volumes_.resize(cells);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (n > blas::omp_threshold)
+#endif
+			for (long long i = 0; i < n; ++i)
+			{
+				double* vertices = vertices_.data() + static_cast<size_t>(i) * v * dim_;
+				const double* p[4];
+				for (size_t l = 0; l < v; ++l)
+				{
+					for (size_t k = 0; k < dim_; ++k)
+					{
+						vertices[l * dim_ + k] = static_cast<double>(vertex(index_[i], l, k));
+					}
+					p[l] = vertices + l * dim_;
+				}
+				volumes_[i] = orient(p);
+			}
+		}
+
+	public:
+		BVH() {};
+
+		/**
+		* @brief BVH constructor
+		* @param mesh: Mesh, tree is built over its cells
+		* @throws math::ExceptionInvalidValue if mesh isn't 2D or 3D
+		*/
+		explicit BVH(const Mesh<T>& mesh) : dim_(mesh.dim())
+		{
+			build(mesh.cellCount(), [&mesh](size_t c, size_t l, size_t k)
+				{
+					return mesh.coordinate(mesh.cellNodes(static_cast<index_type>(c))[l], k);
+				});
+		}
+
+		/**
+		* @brief BVH constructor
+		* @param points: Points, one per row
+		* @param cells: Point indices of cells, points.cols() + 1 per cell
+		* @throws math::ExceptionInvalidValue if points aren't 2D or 3D, or number of cell indices
+		* isn't multiple of points.cols() + 1
+		* @throws math::ExceptionIndexOutOfBounds if cell refers to missing point
+		*/
+		BVH(const Matrix<T>& points, const std::vector<index_type>& cells) : dim_(points.cols())
+		{
+			size_t v = dim_ + 1;
+			if (cells.size() % v != 0)
+			{
+				throw(ExceptionInvalidValue("BVH<T>::BVH: Number of cell indices " + std::to_string(cells.size()) +
+					" isn't multiple of " + std::to_string(v) + "!"));
+			}
+			for (index_type i : cells)
+			{
+				if (i >= points.rows())
+				{
+					throw(ExceptionIndexOutOfBounds("BVH<T>::BVH: Point index " + std::to_string(i) + " out of bounds!"));
+				}
+			}
+			build(cells.size() / v, [&](size_t c, size_t l, size_t k)
+				{
+					return points(cells[c * v + l], k);
+				});
+		}
+
+		/// @brief Number of cells
+		size_t size() const
+		{
+			return index_.size();
+		}
+
+		size_t dim() const
+		{
+			return dim_;
+		}
+
+		/**
+		* @brief Find cell, containing point
+		* @param point: Point of dim() coordinates
+		* @param[out] bary: Barycentric coordinates of point in found cell, dim() + 1 values
+		* (not used if nullptr)
+		* @return Original index of cell, no_cell if point is outside of all cells
+		*/
+		index_type locate(const T* point, T* bary = nullptr) const
+		{
+			double p[3];
+			for (size_t k = 0; k < dim_; ++k)
+			{
+				p[k] = static_cast<double>(point[k]);
+			}
+			return find(p, bary);
+		}
+
+		/**
+		* @brief Find cells, containing many points
+		* @param points: Points, one per row
+		* @param[out] cells: Original indices of cells (no_cell for points outside of all cells)
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns of points isn't equal to dim()
+		*/
+		void locateBatch(const Matrix<T>& points, std::vector<index_type>& cells) const
+		{
+			if (points.cols() != dim_)
+			{
+				throw(ExceptionNonEqualColumnsNum("BVH<T>::locateBatch: Matrix of points must have " +
+					std::to_string(dim_) + " columns!"));
+			}
+			long long rows = static_cast<long long>(points.rows());
+			cells.resize(points.rows());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic, 256) if (rows > blas::omp_threshold)
+#endif
+			for (long long i = 0; i < rows; ++i)
+			{
+				double p[3];
+				for (size_t k = 0; k < dim_; ++k)
+				{
+					p[k] = static_cast<double>(points(static_cast<size_t>(i), k));
+				}
+				cells[i] = find(p, nullptr);
+			}
+		}
+	};
+}
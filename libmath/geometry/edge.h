@@ -18,6 +18,7 @@ namespace math
 	{
 	protected:
 		friend Polygone<T>;
+		friend Mesh<T>;
 
 		/// @brief Vector of nodes, contains this edge
 		std::vector<Node<T>*> nodes_;
@@ -46,6 +47,9 @@ namespace math
 			}
 		};
 
+		/// @brief Empty edge, filled by Mesh<T>::makeTopology()
+		Edge() {};
+
 	public:
 		/**
 		* @brief Edge constructor
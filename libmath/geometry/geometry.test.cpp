@@ -2,6 +2,18 @@
 #include <libmath/geometry/node.h>
 #include <libmath/geometry/edge.h>
 #include <libmath/geometry/polygone.h>
+#include <libmath/geometry/kdtree.h>
+#include <libmath/geometry/bvh.h>
+#include <libmath/geometry/predicates.h>
+#include <libmath/geometry/spatial_sort.h>
+#include <libmath/geometry/mesh.h>
+#include <libmath/geometry/measures.h>
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <memory>
+#include <algorithm>
+#include <random>
 
 
 TEST(Geometry, CreateNode)
@@ -91,4 +103,546 @@ TEST(Geometry, CreatePolygone)
 	math::Edge<double> BC({ &B,&C });
 
 	math::Polygone<double> ABC({ &AB,&AC,&BC });
-}
\ No newline at end of file
+}
+TEST(Geometry, KDTree)
+{
+	size_t n = 2000;
+	size_t dim = 3;
+	math::Matrix<double> points(n, dim, math::MatRep::Column);
+	points.rfill(5);
+
+	math::KDTree<double> tree(points);
+	EXPECT_EQ(tree.size(), n);
+
+	auto dist2 = [&](size_t i, const double* q)
+	{
+		double d2 = 0.0;
+		for (size_t k = 0; k < dim; ++k)
+		{
+			double d = points(i, k) - q[k];
+			d2 += d * d;
+		}
+		return d2;
+	};
+
+	for (size_t t = 0; t < 20; ++t)
+	{
+		double q[3] = { 0.05 * t, 1.0 - 0.05 * t, 0.5 };
+
+		// radius query against brute force
+		std::vector<size_t> found;
+		tree.radius(q, 0.2, found);
+		std::sort(found.begin(), found.end());
+		std::vector<size_t> gold;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (dist2(i, q) <= 0.04)
+			{
+				gold.push_back(i);
+			}
+		}
+		EXPECT_EQ(found == gold, true);
+
+		// k nearest against brute force
+		std::vector<size_t> nearest;
+		std::vector<double> nearest_d2;
+		tree.nearest(q, 5, nearest, nearest_d2);
+		std::vector<size_t> order(n);
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::partial_sort(order.begin(), order.begin() + 5, order.end(), [&](size_t a, size_t b)
+			{
+				return dist2(a, q) < dist2(b, q);
+			});
+		ASSERT_EQ(nearest.size(), 5);
+		for (size_t k = 0; k < 5; ++k)
+		{
+			EXPECT_EQ(nearest[k], order[k]);
+			EXPECT_EQ(math::isEqual(nearest_d2[k], dist2(order[k], q), 1.e-14), true);
+		}
+	}
+
+	// batched queries against single ones
+	math::Matrix<double> queries(300, dim, math::MatRep::Row);
+	queries.rfill(7);
+	std::vector<size_t> batch_nearest;
+	std::vector<double> batch_d2;
+	tree.nearestBatch(queries, 4, batch_nearest, batch_d2);
+	std::vector<size_t> offsets;
+	std::vector<size_t> batch_found;
+	tree.radiusBatch(queries, 0.15, offsets, batch_found);
+	ASSERT_EQ(batch_nearest.size(), 4 * queries.rows());
+	ASSERT_EQ(offsets.size(), queries.rows() + 1);
+	for (size_t q = 0; q < queries.rows(); ++q)
+	{
+		double point[3] = { queries(q, 0), queries(q, 1), queries(q, 2) };
+		std::vector<size_t> nearest;
+		std::vector<double> nearest_d2;
+		tree.nearest(point, 4, nearest, nearest_d2);
+		EXPECT_EQ(std::equal(nearest.begin(), nearest.end(), batch_nearest.begin() + 4 * q), true);
+		EXPECT_EQ(std::equal(nearest_d2.begin(), nearest_d2.end(), batch_d2.begin() + 4 * q), true);
+
+		std::vector<size_t> found;
+		tree.radius(point, 0.15, found);
+		std::vector<size_t> batch(batch_found.begin() + offsets[q], batch_found.begin() + offsets[q + 1]);
+		std::sort(found.begin(), found.end());
+		std::sort(batch.begin(), batch.end());
+		EXPECT_EQ(found == batch, true);
+	}
+	EXPECT_THROW(tree.nearestBatch(math::Matrix<double>(2, 2), 1, batch_nearest, batch_d2), math::ExceptionNonEqualColumnsNum);
+
+	// coincident points
+	math::Matrix<double> same(100, 2, 1.0);
+	math::KDTree<double> same_tree(same);
+	std::vector<size_t> found;
+	double q[2] = { 1.0, 1.0 };
+	same_tree.radius(q, 0.0, found);
+	EXPECT_EQ(found.size(), 100);
+}
+
+TEST(Geometry, Predicates)
+{
+	// points near line y = x, where naive determinant fails
+	double a[2] = { 0.5, 0.5 };
+	double b[2] = { 12.0, 12.0 };
+	double c[2] = { 24.0, 24.0 };
+	EXPECT_EQ(math::predicates::orient2d(a, b, c), 0.0);
+	double step = std::nextafter(0.5, 1.0) - 0.5;
+	for (size_t i = 0; i < 16; ++i)
+	{
+		double p[2] = { 0.5 + step * static_cast<double>(i), 0.5 };
+		// sign of (b - a) x (p - a) with p to the right of line
+		double o = math::predicates::orient2d(a, b, p);
+		EXPECT_EQ(i == 0 ? o == 0.0 : o < 0.0, true);
+	}
+
+	// cocircular and cospherical points
+	double s0[2] = { 1.0, 0.0 }, s1[2] = { 0.0, 1.0 }, s2[2] = { -1.0, 0.0 }, s3[2] = { 0.0, -1.0 };
+	EXPECT_EQ(math::predicates::incircle(s0, s1, s2, s3), 0.0);
+	double inside[2] = { 0.0, 1.e-100 };
+	EXPECT_GT(math::predicates::incircle(s0, s1, s2, inside), 0.0);
+
+	double t0[3] = { 1.0, 0.0, 0.0 }, t1[3] = { 0.0, 1.0, 0.0 }, t2[3] = { -1.0, 0.0, 0.0 };
+	double t3[3] = { 0.0, 0.0, 1.0 }, t4[3] = { 0.0, -1.0, 0.0 };
+	// apex above counterclockwise base is negative (Shewchuk convention)
+	EXPECT_LT(math::predicates::orient3d(t0, t1, t2, t3), 0.0);
+	EXPECT_EQ(math::predicates::insphere(t0, t1, t2, t3, t4), 0.0);
+	EXPECT_EQ(math::predicates::orient3d(t0, t1, t2, t4), 0.0);
+
+	// perturbation lifts lexicographically smaller points more: s2 is outside of circle through
+	// s0, s1, s3, s1 is inside of circle through s2, s3, s0
+	EXPECT_LT(math::predicates::incirclePerturbed(s0, s1, s3, s2), 0.0);
+	EXPECT_GT(math::predicates::incirclePerturbed(s2, s3, s0, s1), 0.0);
+	EXPECT_EQ(math::predicates::incirclePerturbed(s0, s1, s3, inside), math::predicates::incircle(s0, s1, s3, inside));
+	double ts = math::predicates::inspherePerturbed(t0, t1, t2, t3, t4);
+	EXPECT_NE(ts, 0.0);
+	EXPECT_EQ(math::predicates::inspherePerturbed(t1, t0, t2, t3, t4) * ts < 0.0, true);
+	// t2 is lexicographically the smallest
+	EXPECT_EQ(math::predicates::inspherePerturbed(t0, t1, t3, t4, t2) * math::predicates::orient3d(t0, t1, t3, t4) < 0.0, true);
+
+	// adaptive stages against exact evaluation: nearly degenerate points, perturbed by a few ulps,
+	// with coordinates on coarse grid (exact differences) and arbitrary ones
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+	std::uniform_int_distribution<int> ulps(-4, 4);
+	auto perturb = [&](double x)
+	{
+		for (int i = ulps(gen); i != 0; i += i > 0 ? -1 : 1)
+		{
+			x = std::nextafter(x, i > 0 ? 2.0 * std::abs(x) + 1.0 : -2.0 * std::abs(x) - 1.0);
+		}
+		return x;
+	};
+	auto sign = [](double x)
+	{
+		return (x > 0.0) - (x < 0.0);
+	};
+	for (size_t t = 0; t < 2000; ++t)
+	{
+		double scale = t % 2 == 0 ? 1.0 : 1024.0;
+		auto coord = [&]()
+		{
+			return t % 2 == 0 ? uniform(gen) : std::round(scale * uniform(gen)) / scale;
+		};
+		// points near line through p and q, near plane through p, q, r
+		double p[3] = { coord(), coord(), coord() };
+		double q[3] = { coord(), coord(), coord() };
+		double r[3] = { coord(), coord(), coord() };
+		double u = uniform(gen), v = uniform(gen);
+		double on_line[2] = { perturb(p[0] + u * (q[0] - p[0])), perturb(p[1] + u * (q[1] - p[1])) };
+		double on_plane[3];
+		for (size_t k = 0; k < 3; ++k)
+		{
+			on_plane[k] = perturb(p[k] + u * (q[k] - p[k]) + v * (r[k] - p[k]));
+		}
+		EXPECT_EQ(sign(math::predicates::orient2d(p, q, on_line)), sign(math::predicates::detail::orient2dExact(p, q, on_line)));
+		EXPECT_EQ(sign(math::predicates::orient3d(p, q, r, on_plane)),
+			sign(math::predicates::detail::orient3dExact(p, q, r, on_plane)));
+
+		// points near unit circle and sphere
+		double angle = 3.0 * uniform(gen);
+		double s2[4][2];
+		double s3[5][3];
+		for (size_t i = 0; i < 4; ++i)
+		{
+			double phi = angle + 1.5 * static_cast<double>(i);
+			s2[i][0] = perturb(std::cos(phi));
+			s2[i][1] = perturb(std::sin(phi));
+		}
+		for (size_t i = 0; i < 5; ++i)
+		{
+			double phi = angle + 1.3 * static_cast<double>(i), theta = 0.6 * static_cast<double>(i) + 0.2;
+			s3[i][0] = perturb(std::sin(theta) * std::cos(phi));
+			s3[i][1] = perturb(std::sin(theta) * std::sin(phi));
+			s3[i][2] = perturb(std::cos(theta));
+		}
+		EXPECT_EQ(sign(math::predicates::incircle(s2[0], s2[1], s2[2], s2[3])),
+			sign(math::predicates::detail::incircleExact(s2[0], s2[1], s2[2], s2[3])));
+		EXPECT_EQ(sign(math::predicates::insphere(s3[0], s3[1], s3[2], s3[3], s3[4])),
+			sign(math::predicates::detail::insphereExact(s3[0], s3[1], s3[2], s3[3], s3[4])));
+	}
+
+	// cospherical points of integer grid are decided by exact stage B
+	double g0[3] = { 3.0, 0.0, 4.0 }, g1[3] = { 0.0, 5.0, 0.0 }, g2[3] = { -5.0, 0.0, 0.0 }, g3[3] = { 0.0, -3.0, 4.0 };
+	double g4[3] = { 4.0, 3.0, 0.0 };
+	EXPECT_EQ(math::predicates::insphere(g0, g1, g2, g3, g4), 0.0);
+	double g5[3] = { 4.0, 3.0, std::nextafter(0.0, 1.0) };
+	EXPECT_EQ(sign(math::predicates::insphere(g0, g1, g2, g3, g5)), sign(math::predicates::detail::insphereExact(g0, g1, g2, g3, g5)));
+}
+
+TEST(Geometry, SpatialSort)
+{
+	size_t n = 1000;
+	math::Matrix<double> points(n, 2, math::MatRep::Row);
+	points.rfill(7);
+
+	std::vector<uint32_t> order;
+	math::brioOrder(points.data(), n, 2, order, 1);
+	std::vector<uint32_t> sorted(order);
+	std::sort(sorted.begin(), sorted.end());
+	std::vector<uint32_t> gold(n);
+	std::iota(gold.begin(), gold.end(), 0u);
+	EXPECT_EQ(sorted == gold, true);
+
+	// Hilbert order keeps consecutive points close
+	std::vector<uint32_t> hilbert(gold);
+	math::hilbertSort(points.data(), 2, hilbert.data(), hilbert.data() + n);
+	auto length = [&](const std::vector<uint32_t>& path)
+	{
+		double sum = 0.0;
+		for (size_t i = 1; i < path.size(); ++i)
+		{
+			sum += std::hypot(points(path[i], 0) - points(path[i - 1], 0), points(path[i], 1) - points(path[i - 1], 1));
+		}
+		return sum;
+	};
+	EXPECT_LT(length(hilbert), 0.2 * length(gold));
+
+	EXPECT_THROW(math::hilbertSort(points.data(), 4, hilbert.data(), hilbert.data() + n), math::ExceptionInvalidValue);
+}
+
+TEST(Geometry, Mesh)
+{
+	// 3 x 3 grid of nodes, every square is split by diagonal (i, j) - (i + 1, j + 1)
+	size_t m = 3;
+	math::Matrix<double> points(m * m, 2);
+	std::vector<uint32_t> cells;
+	for (size_t i = 0; i < m; ++i)
+	{
+		for (size_t j = 0; j < m; ++j)
+		{
+			points(i * m + j, 0) = static_cast<double>(i);
+			points(i * m + j, 1) = static_cast<double>(j);
+			if (i + 1 < m && j + 1 < m)
+			{
+				uint32_t a = static_cast<uint32_t>(i * m + j);
+				uint32_t b = a + static_cast<uint32_t>(m);
+				cells.insert(cells.end(), { a, b, b + 1 });
+				cells.insert(cells.end(), { a, b + 1, a + 1 });
+			}
+		}
+	}
+	math::Mesh<double> mesh(points, cells);
+	EXPECT_EQ(mesh.nodeCount(), 9);
+	EXPECT_EQ(mesh.cellCount(), 8);
+	EXPECT_EQ(mesh.edgeCount(), 16);
+	EXPECT_EQ(mesh.coordinate(5, 0), 1.0);
+	EXPECT_EQ(mesh.coordinates(1)[5], 2.0);
+
+	// central node: 6 triangles and 6 edges
+	EXPECT_EQ(mesh.nodeCells(4).size(), 6);
+	EXPECT_EQ(mesh.nodeEdges(4).size(), 6);
+	EXPECT_NE(mesh.findEdge(4, 0), math::Mesh<double>::no_neighbour);
+	EXPECT_EQ(mesh.findEdge(2, 4), math::Mesh<double>::no_neighbour);
+
+	// neighbours are symmetric and share facet, 8 boundary facets
+	size_t boundary = 0;
+	for (uint32_t c = 0; c < mesh.cellCount(); ++c)
+	{
+		auto nodes = mesh.cellNodes(c);
+		auto neighbours = mesh.cellNeighbours(c);
+		for (size_t k = 0; k < 3; ++k)
+		{
+			uint32_t d = neighbours[k];
+			if (d == math::Mesh<double>::no_neighbour)
+			{
+				++boundary;
+				continue;
+			}
+			auto back = mesh.cellNeighbours(d);
+			EXPECT_NE(std::find(back.begin(), back.end(), c), back.end());
+			auto other = mesh.cellNodes(d);
+			EXPECT_EQ(std::find(other.begin(), other.end(), nodes[k]), other.end());
+		}
+		auto edges = mesh.cellEdges(c);
+		for (size_t e = 0; e < 3; ++e)
+		{
+			auto cells_of_edge = mesh.edgeCells(edges[e]);
+			EXPECT_NE(std::find(cells_of_edge.begin(), cells_of_edge.end(), c), cells_of_edge.end());
+		}
+	}
+	EXPECT_EQ(boundary, 8);
+
+	// views
+	std::vector<std::unique_ptr<math::Node<double>>> nodes;
+	std::vector<std::unique_ptr<math::Edge<double>>> edges;
+	std::vector<std::unique_ptr<math::Polygone<double>>> polygones;
+	mesh.makeTopology(nodes, edges, polygones);
+	ASSERT_EQ(nodes.size(), 9);
+	ASSERT_EQ(edges.size(), 16);
+	ASSERT_EQ(polygones.size(), 8);
+	std::vector<math::Polygone<double>*> node_polygones;
+	nodes[4]->getPolygones(node_polygones);
+	EXPECT_EQ(node_polygones.size(), 6);
+	std::vector<math::Node<double>*> edge_nodes;
+	edges[mesh.findEdge(0, 4)]->getNodes(edge_nodes);
+	EXPECT_EQ(edge_nodes[0], nodes[0].get());
+	EXPECT_EQ(edge_nodes[1], nodes[4].get());
+	math::Matrix<double> coord;
+	nodes[7]->getCoordinates(coord);
+	EXPECT_EQ(coord(0, 0), 2.0);
+	EXPECT_EQ(coord(1, 0), 1.0);
+
+	// cube split into 6 tetrahedrons around the main diagonal
+	math::Matrix<double> cube(8, 3);
+	for (size_t i = 0; i < 8; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			cube(i, k) = static_cast<double>((i >> k) & 1);
+		}
+	}
+	std::vector<uint32_t> tets{ 0, 1, 3, 7, 0, 3, 2, 7, 0, 2, 6, 7, 0, 6, 4, 7, 0, 4, 5, 7, 0, 5, 1, 7 };
+	math::Mesh<double> cube_mesh(cube, tets);
+	EXPECT_EQ(cube_mesh.edgeCount(), 19);
+	EXPECT_EQ(cube_mesh.edgeCells(cube_mesh.findEdge(0, 7)).size(), 6);
+	EXPECT_EQ(cube_mesh.nodeNodes(0).size(), 7);
+
+	// 1D mesh of 3 segments, facets are nodes
+	math::Matrix<double> line = { {0.0}, {1.0}, {2.0}, {3.0} };
+	math::Mesh<double> line_mesh(line, std::vector<uint32_t>{ 0, 1, 1, 2, 2, 3 });
+	EXPECT_EQ(line_mesh.edgeCount(), 3);
+	auto middle = line_mesh.cellNeighbours(1);
+	EXPECT_EQ(middle[0], 2);
+	EXPECT_EQ(middle[1], 0);
+	EXPECT_EQ(line_mesh.cellNeighbours(0)[0], 1);
+	EXPECT_EQ(line_mesh.cellNeighbours(0)[1], math::Mesh<double>::no_neighbour);
+	EXPECT_EQ(line_mesh.cellNeighbours(2)[1], 1);
+	EXPECT_EQ(line_mesh.cellNeighbours(2)[0], math::Mesh<double>::no_neighbour);
+
+	EXPECT_THROW(math::Mesh<double>(points, std::vector<uint32_t>{ 0, 1 }), math::ExceptionInvalidValue);
+	EXPECT_THROW(math::Mesh<double>(points, std::vector<uint32_t>{ 0, 1, 9 }), math::ExceptionIndexOutOfBounds);
+}
+
+TEST(Geometry, BVH)
+{
+	// 20 x 20 grid of nodes on unit square
+	size_t m = 20;
+	math::Matrix<double> points(m * m, 2);
+	std::vector<uint32_t> cells;
+	for (size_t i = 0; i < m; ++i)
+	{
+		for (size_t j = 0; j < m; ++j)
+		{
+			points(i * m + j, 0) = static_cast<double>(i) / static_cast<double>(m - 1);
+			points(i * m + j, 1) = static_cast<double>(j) / static_cast<double>(m - 1);
+			if (i + 1 < m && j + 1 < m)
+			{
+				uint32_t a = static_cast<uint32_t>(i * m + j);
+				uint32_t b = a + static_cast<uint32_t>(m);
+				cells.insert(cells.end(), { a, b, b + 1, a, b + 1, a + 1 });
+			}
+		}
+	}
+	math::Mesh<double> mesh(points, cells);
+	math::BVH<double> bvh(mesh);
+	EXPECT_EQ(bvh.size(), mesh.cellCount());
+
+	// located cell contains point: barycentric coordinates are non-negative and reproduce point
+	math::Matrix<double> queries(500, 2, math::MatRep::Row);
+	queries.rfill(3);
+	std::vector<uint32_t> located;
+	bvh.locateBatch(queries, located);
+	for (size_t q = 0; q < queries.rows(); ++q)
+	{
+		double point[2] = { queries(q, 0), queries(q, 1) };
+		double bary[3];
+		uint32_t c = bvh.locate(point, bary);
+		ASSERT_NE(c, math::BVH<double>::no_cell);
+		EXPECT_EQ(c, located[q]);
+		double x[2] = { 0.0, 0.0 };
+		double sum = 0.0;
+		for (size_t l = 0; l < 3; ++l)
+		{
+			EXPECT_GE(bary[l], 0.0);
+			sum += bary[l];
+			x[0] += bary[l] * mesh.coordinate(mesh.cellNodes(c)[l], 0);
+			x[1] += bary[l] * mesh.coordinate(mesh.cellNodes(c)[l], 1);
+		}
+		EXPECT_EQ(math::isEqual(sum, 1.0, 1.e-12), true);
+		EXPECT_EQ(math::isEqual(x[0], point[0], 1.e-12), true);
+		EXPECT_EQ(math::isEqual(x[1], point[1], 1.e-12), true);
+	}
+
+	// nodes and points on shared edges are located, points outside are not
+	for (uint32_t i = 0; i < mesh.nodeCount(); ++i)
+	{
+		double node[2] = { mesh.coordinate(i, 0), mesh.coordinate(i, 1) };
+		uint32_t c = bvh.locate(node);
+		ASSERT_NE(c, math::BVH<double>::no_cell);
+		auto nodes = mesh.cellNodes(c);
+		EXPECT_NE(std::find(nodes.begin(), nodes.end(), i), nodes.end());
+	}
+	double diagonal[2] = { 0.5 / static_cast<double>(m - 1), 0.5 / static_cast<double>(m - 1) };
+	EXPECT_NE(bvh.locate(diagonal), math::BVH<double>::no_cell);
+	double outside[2] = { 1.0, 1.0 + 1.e-12 };
+	EXPECT_EQ(bvh.locate(outside), math::BVH<double>::no_cell);
+
+	// cube split into 6 tetrahedrons around the main diagonal
+	math::Matrix<double> cube(8, 3);
+	for (size_t i = 0; i < 8; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			cube(i, k) = static_cast<double>((i >> k) & 1);
+		}
+	}
+	std::vector<uint32_t> tets{ 0, 1, 3, 7, 0, 3, 2, 7, 0, 2, 6, 7, 0, 6, 4, 7, 0, 4, 5, 7, 0, 5, 1, 7 };
+	math::BVH<double> cube_bvh(cube, tets);
+	double inside[3] = { 0.7, 0.2, 0.1 };
+	uint32_t t = cube_bvh.locate(inside);
+	ASSERT_NE(t, math::BVH<double>::no_cell);
+	EXPECT_EQ(t, 0);
+	double centre[3] = { 0.5, 0.5, 0.5 };
+	EXPECT_NE(cube_bvh.locate(centre), math::BVH<double>::no_cell);
+	double above[3] = { 0.5, 0.5, 1.5 };
+	EXPECT_EQ(cube_bvh.locate(above), math::BVH<double>::no_cell);
+
+	// nearest node of mesh
+	math::KDTree<double> nodes_tree(mesh);
+	std::vector<size_t> nearest;
+	std::vector<double> nearest_d2;
+	double near_node[2] = { 1.0 / static_cast<double>(m - 1) + 1.e-3, 1.e-3 };
+	nodes_tree.nearest(near_node, 1, nearest, nearest_d2);
+	ASSERT_EQ(nearest.size(), 1);
+	EXPECT_EQ(nearest[0], m);
+
+	EXPECT_THROW(math::BVH<double>(cube, std::vector<uint32_t>{ 0, 1 }), math::ExceptionInvalidValue);
+	EXPECT_THROW(math::BVH<double>(cube, std::vector<uint32_t>{ 0, 1, 2, 8 }), math::ExceptionIndexOutOfBounds);
+	EXPECT_THROW(bvh.locateBatch(cube, located), math::ExceptionNonEqualColumnsNum);
+}
+
+TEST(Geometry, Measures)
+{
+	// right triangle, inverted one, equilateral one and collinear one
+	double h = std::sqrt(3.0) / 2.0;
+	math::Matrix<double> points =
+	{
+		{ 0.0, 0.0 }, { 1.0, 0.0 }, { 0.0, 1.0 },
+		{ 2.0, 0.0 }, { 3.0, 0.0 }, { 2.5, h },
+		{ 4.0, 0.0 }, { 5.0, 0.0 }, { 6.0, 0.0 }
+	};
+	std::vector<uint32_t> cells{ 0, 1, 2, 0, 2, 1, 3, 4, 5, 6, 7, 8 };
+	math::Mesh<double> mesh(points, cells);
+
+	std::vector<double> volumes;
+	math::cellVolumes(mesh, volumes);
+	ASSERT_EQ(volumes.size(), 4);
+	EXPECT_EQ(volumes[0], 0.5);
+	EXPECT_EQ(volumes[1], -0.5);
+	EXPECT_EQ(math::isEqual(volumes[2], 0.5 * h, 1.e-15), true);
+	EXPECT_EQ(volumes[3], 0.0);
+
+	std::vector<double> centroids;
+	math::cellCentroids(mesh, centroids);
+	EXPECT_EQ(math::isEqual(centroids[2], 2.5, 1.e-15), true);
+	EXPECT_EQ(math::isEqual(centroids[4 + 2], h / 3.0, 1.e-15), true);
+
+	std::vector<double> quality;
+	math::cellQualities(mesh, quality);
+	EXPECT_EQ(math::isEqual(quality[0], 2.0 / (1.0 + std::sqrt(2.0)), 1.e-12), true);
+	EXPECT_EQ(math::isEqual(quality[1], -quality[0], 1.e-15), true);
+	EXPECT_EQ(math::isEqual(quality[2], 1.0, 1.e-12), true);
+	EXPECT_EQ(quality[3], 0.0);
+
+	// outward normals: hypotenuse of right triangle is opposite to node 0
+	std::vector<double> normals;
+	std::vector<double> areas;
+	math::facetNormals(mesh, normals, areas);
+	size_t n = mesh.cellCount();
+	EXPECT_EQ(math::isEqual(normals[(0 * 3 + 0) * n], 1.0 / std::sqrt(2.0), 1.e-15), true);
+	EXPECT_EQ(math::isEqual(normals[(1 * 3 + 0) * n], 1.0 / std::sqrt(2.0), 1.e-15), true);
+	EXPECT_EQ(math::isEqual(areas[0], std::sqrt(2.0), 1.e-15), true);
+	EXPECT_EQ(normals[(1 * 3 + 2) * n], -1.0);
+
+	// cube split into 6 tetrahedrons and regular tetrahedron
+	math::Matrix<double> cube(12, 3);
+	for (size_t i = 0; i < 8; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			cube(i, k) = static_cast<double>((i >> k) & 1);
+		}
+	}
+	double regular[4][3] = { { 1.0, 1.0, 1.0 }, { 1.0, -1.0, -1.0 }, { -1.0, 1.0, -1.0 }, { -1.0, -1.0, 1.0 } };
+	for (size_t i = 0; i < 4; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			cube(8 + i, k) = regular[i][k];
+		}
+	}
+	std::vector<uint32_t> tets{ 0, 1, 3, 7, 0, 3, 2, 7, 0, 2, 6, 7, 0, 6, 4, 7, 0, 4, 5, 7, 0, 5, 1, 7, 8, 9, 10, 11 };
+	math::Mesh<double> cube_mesh(cube, tets);
+	math::cellVolumes(cube_mesh, volumes);
+	double total = 0.0;
+	for (size_t c = 0; c < 6; ++c)
+	{
+		EXPECT_EQ(math::isEqual(std::abs(volumes[c]), 1.0 / 6.0, 1.e-15), true);
+		total += std::abs(volumes[c]);
+	}
+	EXPECT_EQ(math::isEqual(total, 1.0, 1.e-14), true);
+	EXPECT_EQ(math::isEqual(std::abs(volumes[6]), 8.0 / 3.0, 1.e-14), true);
+
+	math::cellQualities(cube_mesh, quality);
+	EXPECT_EQ(math::isEqual(std::abs(quality[6]), 1.0, 1.e-12), true);
+	EXPECT_LT(std::abs(quality[0]), 1.0);
+
+	// sum of area-weighted outward normals of closed cell is zero
+	math::facetNormals(cube_mesh, normals, areas);
+	n = cube_mesh.cellCount();
+	for (size_t c = 0; c < n; ++c)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			double sum = 0.0;
+			for (size_t l = 0; l < 4; ++l)
+			{
+				sum += normals[(k * 4 + l) * n + c] * areas[l * n + c];
+			}
+			EXPECT_EQ(math::isEqual(sum, 0.0, 1.e-14), true);
+		}
+	}
+
+	math::Mesh<double> line(math::Matrix<double>({ { 0.0 }, { 1.0 } }), std::vector<uint32_t>{ 0, 1 });
+	EXPECT_THROW(math::cellVolumes(line, volumes), math::ExceptionInvalidValue);
+}
@@ -0,0 +1,483 @@
+#pragma once
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <libmath/geometry/mesh.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <utility>
+
+namespace math
+{
+	/**
+	* @brief k-d tree over n-dimension points
+	* @details Points are split recursively by median along the widest dimension of bounding box
+	* until leaf_size points remain. Points are copied to the tree in leaf order, so points of one
+	* leaf are contiguous in memory, and every node keeps its bounding box for exact pruning.
+	* Build takes O(N log N), radius and nearest neighbours queries take O(log N) for
+	* uniformly distributed points. Build splits nodes of one tree level in parallel, batched
+	* queries process points in parallel (with OpenMP).
+	*/
+	template <typename T>
+	class KDTree
+	{
+	public:
+		/// @brief Maximum number of points in leaf
+		static constexpr size_t leaf_size = 16;
+
+	private:
+		struct TreeNode
+		{
+			/// @brief Range of points in tree order
+			size_t begin = 0;
+			size_t end = 0;
+
+			/// @brief Children indices, 0 for leaf (root is never a child)
+			size_t left = 0;
+			size_t right = 0;
+		};
+
+		size_t dim_ = 0;
+
+		/// @brief Points in tree order, row-major
+		std::vector<T> points_;
+
+		/// @brief Original indices of points in tree order
+		std::vector<size_t> index_;
+
+		std::vector<TreeNode> nodes_;
+
+		/// @brief Bounding boxes of nodes: lower corner followed by upper one (2 * dim_ values per node)
+		std::vector<T> boxes_;
+
+		/// @brief Squared distance from point to bounding box of node
+		T boxDistance2(size_t node, const T* point) const
+		{
+			const T* lo = boxes_.data() + node * 2 * dim_;
+			const T* hi = lo + dim_;
+			T d2 = static_cast<T>(0.0);
+			for (size_t k = 0; k < dim_; ++k)
+			{
+				T d = point[k] < lo[k] ? lo[k] - point[k] : (point[k] > hi[k] ? point[k] - hi[k] : static_cast<T>(0.0));
+				d2 += d * d;
+			}
+			return d2;
+		}
+
+		T distance2(size_t pos, const T* point) const
+		{
+			const T* p = points_.data() + pos * dim_;
+			T d2 = static_cast<T>(0.0);
+			for (size_t k = 0; k < dim_; ++k)
+			{
+				T d = p[k] - point[k];
+				d2 += d * d;
+			}
+			return d2;
+		}
+
+		void build(const T* data, size_t count, bool row_major)
+		{
+			auto coord = [=, this](size_t i, size_t k)
+			{
+				return row_major ? data[i * dim_ + k] : data[k * count + i];
+			};
+
+			index_.resize(count);
+			std::iota(index_.begin(), index_.end(), size_t(0));
+			nodes_.clear();
+			boxes_.clear();
+			if (count == 0)
+			{
+				points_.clear();
+				return;
+			}
+			nodes_.reserve(2 * (count / leaf_size + 1));
+
+			// nodes of one level have disjoint ranges of points and are split in parallel
+			std::vector<size_t> level{ 0 };
+			std::vector<size_t> mids;
+			nodes_.push_back(TreeNode{ 0, count, 0, 0 });
+			while (!level.empty())
+			{
+				boxes_.resize(nodes_.size() * 2 * dim_);
+				mids.assign(level.size(), 0);
+				long long level_size = static_cast<long long>(level.size());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic) if (level_size > 1 && static_cast<long long>(count) > blas::omp_threshold)
+#endif
+				for (long long j = 0; j < level_size; ++j)
+				{
+					size_t node = level[j];
+					size_t begin = nodes_[node].begin;
+					size_t end = nodes_[node].end;
+
+					// bounding box
+					T* lo = boxes_.data() + node * 2 * dim_;
+					T* hi = lo + dim_;
+					for (size_t k = 0; k < dim_; ++k)
+					{
+						lo[k] = std::numeric_limits<T>::max();
+						hi[k] = std::numeric_limits<T>::lowest();
+					}
+					for (size_t i = begin; i < end; ++i)
+					{
+						for (size_t k = 0; k < dim_; ++k)
+						{
+							T c = coord(index_[i], k);
+							lo[k] = std::min(lo[k], c);
+							hi[k] = std::max(hi[k], c);
+						}
+					}
+
+					if (end - begin <= leaf_size)
+					{
+						continue;
+					}
+
+					size_t axis = 0;
+					for (size_t k = 1; k < dim_; ++k)
+					{
+						if (hi[k] - lo[k] > hi[axis] - lo[axis])
+						{
+							axis = k;
+						}
+					}
+					if (!(hi[axis] > lo[axis]))
+					{
+						// coincident points
+						continue;
+					}
+
+					size_t mid = begin + (end - begin) / 2;
+					std::nth_element(index_.begin() + begin, index_.begin() + mid, index_.begin() + end,
+						[&](size_t a, size_t b)
+						{
+							return coord(a, axis) < coord(b, axis);
+						});
+					mids[j] = mid;
+				}
+
+				std::vector<size_t> next;
+				next.reserve(2 * level.size());
+				for (size_t j = 0; j < level.size(); ++j)
+				{
+					if (mids[j] == 0)
+					{
+						continue;
+					}
+					size_t node = level[j];
+					size_t left = nodes_.size();
+					nodes_.push_back(TreeNode{ nodes_[node].begin, mids[j], 0, 0 });
+					nodes_.push_back(TreeNode{ mids[j], nodes_[node].end, 0, 0 });
+					nodes_[node].left = left;
+					nodes_[node].right = left + 1;
+					next.push_back(left);
+					next.push_back(left + 1);
+				}
+				level.swap(next);
+			}
+
+			points_.resize(count * dim_);
+			long long n = static_cast<long long>(count);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (n > blas::omp_threshold)
+#endif
+			for (long long i = 0; i < n; ++i)
+			{
+				for (size_t k = 0; k < dim_; ++k)
+				{
+					points_[i * dim_ + k] = coord(index_[i], k);
+				}
+			}
+		}
+
+		void nearest(size_t node, const T* point, size_t k, std::vector<std::pair<T, size_t>>& heap) const
+		{
+			const TreeNode& n = nodes_[node];
+			if (n.left == 0)
+			{
+				for (size_t pos = n.begin; pos < n.end; ++pos)
+				{
+					T d2 = distance2(pos, point);
+					if (heap.size() < k)
+					{
+						heap.emplace_back(d2, pos);
+						std::push_heap(heap.begin(), heap.end());
+					}
+					else if (d2 < heap.front().first)
+					{
+						std::pop_heap(heap.begin(), heap.end());
+						heap.back() = { d2, pos };
+						std::push_heap(heap.begin(), heap.end());
+					}
+				}
+				return;
+			}
+
+			T d_left = boxDistance2(n.left, point);
+			T d_right = boxDistance2(n.right, point);
+			size_t first = d_left <= d_right ? n.left : n.right;
+			size_t second = d_left <= d_right ? n.right : n.left;
+			T d_second = std::max(d_left, d_right);
+
+			nearest(first, point, k, heap);
+			if (heap.size() < k || d_second < heap.front().first)
+			{
+				nearest(second, point, k, heap);
+			}
+		}
+
+		/// @brief Number of query points, processed by one task of batched queries
+		static constexpr size_t batch_block = 256;
+
+		void checkQueries(const Matrix<T>& queries, const std::string& method) const
+		{
+			if (queries.cols() != dim_)
+			{
+				throw(ExceptionNonEqualColumnsNum("KDTree<T>::" + method + ": Matrix of query points must have " +
+					std::to_string(dim_) + " columns!"));
+			}
+		}
+
+		static void queryPoint(const Matrix<T>& queries, size_t q, std::vector<T>& point)
+		{
+			for (size_t k = 0; k < point.size(); ++k)
+			{
+				point[k] = queries(q, k);
+			}
+		}
+
+		/// @brief Call process(first, last, point) for blocks of query points in parallel
+		template <typename Process>
+		void forEachQuery(const Matrix<T>& queries, Process&& process) const
+		{
+			size_t rows = queries.rows();
+			long long blocks = static_cast<long long>((rows + batch_block - 1) / batch_block);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel if (static_cast<long long>(rows) > blas::omp_threshold)
+#endif
+			{
+				std::vector<T> point(dim_);
+#ifdef MATH_OMP_DEFINE
+#pragma omp for schedule(dynamic)
+#endif
+				for (long long b = 0; b < blocks; ++b)
+				{
+					size_t first = static_cast<size_t>(b) * batch_block;
+					process(first, std::min(first + batch_block, rows), point);
+				}
+			}
+		}
+
+	public:
+		KDTree() {};
+
+		/**
+		* @brief KDTree constructor
+		* @param points: Points, one per row
+		*/
+		explicit KDTree(const Matrix<T>& points) : dim_(points.cols())
+		{
+			build(points.data(), points.rows(), points.representation() == MatRep::Row);
+		}
+
+		/**
+		* @brief KDTree constructor
+		* @param points: Points, row-major count x dim
+		* @param count: Number of points
+		* @param dim: Dimension of points
+		*/
+		KDTree(const T* points, size_t count, size_t dim) : dim_(dim)
+		{
+			build(points, count, true);
+		}
+
+		/**
+		* @brief KDTree constructor
+		* @param mesh: Mesh, tree is built over its nodes
+		*/
+		explicit KDTree(const Mesh<T>& mesh) : dim_(mesh.dim())
+		{
+			build(mesh.coordinates(0), mesh.nodeCount(), false);
+		}
+
+		/// @brief Number of points
+		size_t size() const
+		{
+			return index_.size();
+		}
+
+		size_t dim() const
+		{
+			return dim_;
+		}
+
+		/**
+		* @brief Visit all points within radius
+		* @param point: Query point of dim() coordinates
+		* @param r: Radius
+		* @param visit: Callable visit(index, dist2), called with original index of point and
+		* squared distance to it for every point with @f$ |\mathbf{p} - \mathbf{x}| \le r @f$
+		*/
+		template <typename Visitor>
+		void forEachInRadius(const T* point, T r, Visitor&& visit) const
+		{
+			if (nodes_.empty())
+			{
+				return;
+			}
+			T r2 = r * r;
+			size_t stack[128];
+			size_t top = 0;
+			stack[top++] = 0;
+			while (top > 0)
+			{
+				const TreeNode& n = nodes_[stack[--top]];
+				if (n.left == 0)
+				{
+					for (size_t pos = n.begin; pos < n.end; ++pos)
+					{
+						T d2 = distance2(pos, point);
+						if (d2 <= r2)
+						{
+							visit(index_[pos], d2);
+						}
+					}
+					continue;
+				}
+				if (boxDistance2(n.right, point) <= r2)
+				{
+					stack[top++] = n.right;
+				}
+				if (boxDistance2(n.left, point) <= r2)
+				{
+					stack[top++] = n.left;
+				}
+			}
+		}
+
+		/**
+		* @brief Find all points within radius
+		* @param point: Query point of dim() coordinates
+		* @param r: Radius
+		* @param[out] indices: Original indices of points (unordered)
+		*/
+		void radius(const T* point, T r, std::vector<size_t>& indices) const
+		{
+			indices.clear();
+			forEachInRadius(point, r, [&indices](size_t i, T)
+				{
+					indices.push_back(i);
+				});
+		}
+
+		/**
+		* @brief Find k nearest points
+		* @param point: Query point of dim() coordinates
+		* @param k: Number of points
+		* @param[out] indices: Original indices of min(k, size()) nearest points, sorted by distance
+		* @param[out] dist2: Squared distances to points
+		*/
+		void nearest(const T* point, size_t k, std::vector<size_t>& indices, std::vector<T>& dist2) const
+		{
+			indices.clear();
+			dist2.clear();
+			if (nodes_.empty() || k == 0)
+			{
+				return;
+			}
+			std::vector<std::pair<T, size_t>> heap;
+			heap.reserve(k);
+			nearest(0, point, k, heap);
+			std::sort_heap(heap.begin(), heap.end());
+			for (const auto& [d2, pos] : heap)
+			{
+				indices.push_back(index_[pos]);
+				dist2.push_back(d2);
+			}
+		}
+
+		/**
+		* @brief Find k nearest points for many query points
+		* @param queries: Query points, one per row
+		* @param k: Number of points
+		* @param[out] indices: Original indices of m = min(k, size()) nearest points of each query,
+		* m values per query sorted by distance
+		* @param[out] dist2: Squared distances to points, m values per query
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns of queries isn't equal to dim()
+		*/
+		void nearestBatch(const Matrix<T>& queries, size_t k, std::vector<size_t>& indices, std::vector<T>& dist2) const
+		{
+			checkQueries(queries, "nearestBatch");
+			size_t m = std::min(k, size());
+			size_t rows = queries.rows();
+			indices.resize(rows * m);
+			dist2.resize(rows * m);
+			if (m == 0)
+			{
+				return;
+			}
+			forEachQuery(queries, [&](size_t first, size_t last, std::vector<T>& point)
+				{
+					std::vector<std::pair<T, size_t>> heap;
+					heap.reserve(m);
+					for (size_t q = first; q < last; ++q)
+					{
+						queryPoint(queries, q, point);
+						heap.clear();
+						nearest(0, point.data(), m, heap);
+						std::sort_heap(heap.begin(), heap.end());
+						for (size_t j = 0; j < m; ++j)
+						{
+							indices[q * m + j] = index_[heap[j].second];
+							dist2[q * m + j] = heap[j].first;
+						}
+					}
+				});
+		}
+
+		/**
+		* @brief Find all points within radius for many query points
+		* @param queries: Query points, one per row
+		* @param r: Radius
+		* @param[out] offsets: CSR offsets, points of query q are indices[offsets[q]] ... indices[offsets[q + 1] - 1]
+		* @param[out] indices: Original indices of points (unordered within query)
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns of queries isn't equal to dim()
+		*/
+		void radiusBatch(const Matrix<T>& queries, T r, std::vector<size_t>& offsets, std::vector<size_t>& indices) const
+		{
+			checkQueries(queries, "radiusBatch");
+			size_t rows = queries.rows();
+			size_t blocks = (rows + batch_block - 1) / batch_block;
+			std::vector<std::vector<size_t>> found(blocks);
+			offsets.assign(rows + 1, 0);
+			forEachQuery(queries, [&](size_t first, size_t last, std::vector<T>& point)
+				{
+					std::vector<size_t>& block = found[first / batch_block];
+					for (size_t q = first; q < last; ++q)
+					{
+						queryPoint(queries, q, point);
+						size_t before = block.size();
+						forEachInRadius(point.data(), r, [&block](size_t i, T)
+							{
+								block.push_back(i);
+							});
+						offsets[q + 1] = block.size() - before;
+					}
+				});
+			for (size_t q = 0; q < rows; ++q)
+			{
+				offsets[q + 1] += offsets[q];
+			}
+			indices.resize(offsets.back());
+			for (size_t b = 0; b < blocks; ++b)
+			{
+				std::copy(found[b].begin(), found[b].end(), indices.begin() + offsets[b * batch_block]);
+			}
+		}
+	};
+}
@@ -0,0 +1,312 @@
+#pragma once
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <libmath/geometry/mesh.h>
+#include <libmath/geometry/predicates.h>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <type_traits>
+
+namespace math
+{
+	namespace detail
+	{
+		/// @brief Gather vertices of cell c from coordinate arrays to p[l][k]
+		template <size_t D, typename T>
+		void gatherCell(const Mesh<T>& mesh, const T* const* coords, size_t c, double (&p)[D + 1][D])
+		{
+			const auto nodes = mesh.cellNodes(static_cast<typename Mesh<T>::index_type>(c));
+			for (size_t l = 0; l <= D; ++l)
+			{
+				for (size_t k = 0; k < D; ++k)
+				{
+					p[l][k] = static_cast<double>(coords[k][nodes[l]]);
+				}
+			}
+		}
+
+		/// @brief Signed measure of simplex: area of triangle, volume of tetrahedron
+		template <size_t D>
+		double simplexVolume(const double (&p)[D + 1][D])
+		{
+			if constexpr (D == 2)
+			{
+				return 0.5 * predicates::orient2d(p[0], p[1], p[2]);
+			}
+			else
+			{
+				return predicates::orient3d(p[0], p[1], p[2], p[3]) / 6.0;
+			}
+		}
+
+		inline void cross(const double* a, const double* b, double* c)
+		{
+			c[0] = a[1] * b[2] - a[2] * b[1];
+			c[1] = a[2] * b[0] - a[0] * b[2];
+			c[2] = a[0] * b[1] - a[1] * b[0];
+		}
+
+		/// @brief Unscaled outward normal of facet opposite to vertex l, its length is measure of facet
+		template <size_t D>
+		void facetNormal(const double (&p)[D + 1][D], size_t l, double* n)
+		{
+			const double* a = p[(l + 1) % (D + 1)];
+			const double* b = p[(l + 2) % (D + 1)];
+			double outward = 0.0;
+			if constexpr (D == 2)
+			{
+				n[0] = b[1] - a[1];
+				n[1] = a[0] - b[0];
+			}
+			else
+			{
+				const double* c = p[(l + 3) % (D + 1)];
+				double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+				cross(ab, ac, n);
+				n[0] *= 0.5;
+				n[1] *= 0.5;
+				n[2] *= 0.5;
+			}
+			for (size_t k = 0; k < D; ++k)
+			{
+				outward += n[k] * (p[l][k] - a[k]);
+			}
+			if (outward > 0.0)
+			{
+				for (size_t k = 0; k < D; ++k)
+				{
+					n[k] = -n[k];
+				}
+			}
+		}
+
+		/// @brief Radius ratio D r / R of simplex with sign of its volume
+		template <size_t D>
+		double simplexQuality(const double (&p)[D + 1][D])
+		{
+			double volume = simplexVolume<D>(p);
+			if (volume == 0.0)
+			{
+				return 0.0;
+			}
+			// sum of facet measures
+			double facets = 0.0;
+			for (size_t l = 0; l <= D; ++l)
+			{
+				double n[D];
+				facetNormal<D>(p, l, n);
+				double n2 = 0.0;
+				for (size_t k = 0; k < D; ++k)
+				{
+					n2 += n[k] * n[k];
+				}
+				facets += std::sqrt(n2);
+			}
+			double e[D][D];
+			double e2[D];
+			for (size_t j = 0; j < D; ++j)
+			{
+				e2[j] = 0.0;
+				for (size_t k = 0; k < D; ++k)
+				{
+					e[j][k] = p[j + 1][k] - p[0][k];
+					e2[j] += e[j][k] * e[j][k];
+				}
+			}
+			double q = 0.0;
+			if constexpr (D == 2)
+			{
+				// r = 2 A / P, R = a b c / (4 A)
+				double c2 = (e[0][0] - e[1][0]) * (e[0][0] - e[1][0]) + (e[0][1] - e[1][1]) * (e[0][1] - e[1][1]);
+				double abc = std::sqrt(e2[0] * e2[1] * c2);
+				q = 16.0 * volume * volume / (facets * abc);
+			}
+			else
+			{
+				// r = 3 V / S, R = |a^2 (b x c) + b^2 (c x a) + c^2 (a x b)| / (12 V)
+				double bc[3], ca[3], ab[3];
+				cross(e[1], e[2], bc);
+				cross(e[2], e[0], ca);
+				cross(e[0], e[1], ab);
+				double r2 = 0.0;
+				for (size_t k = 0; k < 3; ++k)
+				{
+					double s = e2[0] * bc[k] + e2[1] * ca[k] + e2[2] * ab[k];
+					r2 += s * s;
+				}
+				q = 108.0 * volume * volume / (facets * std::sqrt(r2));
+			}
+			return volume > 0.0 ? q : -q;
+		}
+
+		/// @brief Call kernel(c, p) for every cell in parallel, p are vertices of cell c
+		template <size_t D, typename T, typename Kernel>
+		void forEachCell(const Mesh<T>& mesh, Kernel&& kernel)
+		{
+			const T* coords[D];
+			for (size_t k = 0; k < D; ++k)
+			{
+				coords[k] = mesh.coordinates(k);
+			}
+			long long cells = static_cast<long long>(mesh.cellCount());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (cells > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < cells; ++c)
+			{
+				double p[D + 1][D];
+				gatherCell<D>(mesh, coords, static_cast<size_t>(c), p);
+				kernel(static_cast<size_t>(c), p);
+			}
+		}
+
+		/// @brief Dispatch kernel by dimension of mesh
+		template <typename T, typename Kernel2, typename Kernel3>
+		void forEachCell(const Mesh<T>& mesh, const std::string& method, Kernel2&& kernel2, Kernel3&& kernel3)
+		{
+			switch (mesh.dim())
+			{
+			case 2:
+				forEachCell<2>(mesh, kernel2);
+				break;
+			case 3:
+				forEachCell<3>(mesh, kernel3);
+				break;
+			default:
+				throw(ExceptionInvalidValue(method + ": Only 2D and 3D meshes are supported!"));
+			}
+		}
+	}
+
+	/**
+	* @brief Signed measures of cells: areas of triangles, volumes of tetrahedrons
+	* @details Measure is determinant of cell, evaluated by adaptive orientation predicates (see
+	* predicates::orient2d, predicates::orient3d), so its sign is exact: measure is positive for
+	* positively oriented cells (as cells of Triangulator), negative for inverted ones and
+	* exactly zero for degenerate ones. Cells are processed in parallel.
+	* @param mesh: 2D or 3D mesh
+	* @param[out] volumes: Measures, one per cell
+	* @throws math::ExceptionInvalidValue if mesh isn't 2D or 3D
+	*/
+	template <typename T>
+	void cellVolumes(const Mesh<T>& mesh, std::vector<T>& volumes)
+	{
+		volumes.resize(mesh.cellCount());
+		T* out = volumes.data();
+		detail::forEachCell(mesh, "cellVolumes",
+			[out](size_t c, const double (&p)[3][2])
+			{
+				out[c] = static_cast<T>(detail::simplexVolume<2>(p));
+			},
+			[out](size_t c, const double (&p)[4][3])
+			{
+				out[c] = static_cast<T>(detail::simplexVolume<3>(p));
+			});
+	}
+
+	/**
+	* @brief Centroids of cells
+	* @param mesh: Mesh
+	* @param[out] centroids: Coordinates of centroids as structure of arrays,
+	* centroids[k * mesh.cellCount() + c] is k-th coordinate of centroid of cell c
+	*/
+	template <typename T>
+	void cellCentroids(const Mesh<T>& mesh, std::vector<T>& centroids)
+	{
+		size_t cells = mesh.cellCount();
+		size_t v = mesh.cellSize();
+		centroids.resize(cells * mesh.dim());
+		T scale = static_cast<T>(1.0) / static_cast<T>(v);
+		for (size_t k = 0; k < mesh.dim(); ++k)
+		{
+			const T* x = mesh.coordinates(k);
+			T* out = centroids.data() + k * cells;
+			long long n = static_cast<long long>(cells);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (n > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < n; ++c)
+			{
+				const auto nodes = mesh.cellNodes(static_cast<typename Mesh<T>::index_type>(c));
+				T sum = static_cast<T>(0.0);
+				for (size_t l = 0; l < v; ++l)
+				{
+					sum += x[nodes[l]];
+				}
+				out[c] = sum * scale;
+			}
+		}
+	}
+
+	/**
+	* @brief Outward unit normals of cell facets
+	* @details Facet l of cell is opposite to its node l (as in Mesh::cellNeighbours()). Normals of
+	* degenerate facets are zero.
+	* @param mesh: 2D or 3D mesh
+	* @param[out] normals: Normals as structure of arrays, normals[(k * (dim + 1) + l) * mesh.cellCount() + c]
+	* is k-th coordinate of normal of facet l of cell c
+	* @param[out] areas: Measures of facets (lengths of edges in 2D, areas of triangles in 3D),
+	* areas[l * mesh.cellCount() + c] for facet l of cell c
+	* @throws math::ExceptionInvalidValue if mesh isn't 2D or 3D
+	*/
+	template <typename T>
+	void facetNormals(const Mesh<T>& mesh, std::vector<T>& normals, std::vector<T>& areas)
+	{
+		size_t cells = mesh.cellCount();
+		size_t v = mesh.cellSize();
+		normals.resize(cells * v * mesh.dim());
+		areas.resize(cells * v);
+		T* out = normals.data();
+		T* out_areas = areas.data();
+		auto kernel = [=](size_t c, const auto& p)
+		{
+			constexpr size_t D = std::extent_v<std::remove_reference_t<decltype(p)>, 1>;
+			for (size_t l = 0; l <= D; ++l)
+			{
+				double n[D];
+				detail::facetNormal<D>(p, l, n);
+				double n2 = 0.0;
+				for (size_t k = 0; k < D; ++k)
+				{
+					n2 += n[k] * n[k];
+				}
+				double area = std::sqrt(n2);
+				double scale = area > 0.0 ? 1.0 / area : 0.0;
+				for (size_t k = 0; k < D; ++k)
+				{
+					out[(k * (D + 1) + l) * cells + c] = static_cast<T>(n[k] * scale);
+				}
+				out_areas[l * cells + c] = static_cast<T>(area);
+			}
+		};
+		detail::forEachCell(mesh, "facetNormals", kernel, kernel);
+	}
+
+	/**
+	* @brief Quality of cells: normalized radius ratio
+	* @details Quality is @f$ q = n r / R @f$ for n-dimension simplex with inscribed radius r and
+	* circumscribed radius R, it's 1 for equilateral triangle and regular tetrahedron and tends to 0
+	* for flat (sliver, needle) cells. Quality takes sign of cell measure (see cellVolumes()), so
+	* inverted cells have negative quality and degenerate ones exactly zero.
+	* @param mesh: 2D or 3D mesh
+	* @param[out] quality: Quality, one per cell
+	* @throws math::ExceptionInvalidValue if mesh isn't 2D or 3D
+	*/
+	template <typename T>
+	void cellQualities(const Mesh<T>& mesh, std::vector<T>& quality)
+	{
+		quality.resize(mesh.cellCount());
+		T* out = quality.data();
+		detail::forEachCell(mesh, "cellQualities",
+			[out](size_t c, const double (&p)[3][2])
+			{
+				out[c] = static_cast<T>(detail::simplexQuality<2>(p));
+			},
+			[out](size_t c, const double (&p)[4][3])
+			{
+				out[c] = static_cast<T>(detail::simplexQuality<3>(p));
+			});
+	}
+}
@@ -0,0 +1,534 @@
+#pragma once
+#include <libmath/matrix.h>
+#include <libmath/boolean.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <libmath/geometry/node.h>
+#include <libmath/geometry/edge.h>
+#include <libmath/geometry/polygone.h>
+#include <vector>
+#include <span>
+#include <memory>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
+namespace math
+{
+	/**
+	* @brief Simplicial mesh in flat index-based storage
+	* @details Mesh consists of nodes of dimension dim() and simplex cells with dim() + 1 nodes
+	* (triangles in 2D, tetrahedrons in 3D). Coordinates are stored as structure of arrays (one
+	* array per coordinate), all connectivity is stored in flat arrays of 32-bit indices:
+	* - cell nodes and cell edges with fixed stride;
+	* - cell neighbours: neighbour k shares the facet opposite to node k (half-facet adjacency,
+	* which is half-edge structure in 2D), no_neighbour on the boundary;
+	* - edges as sorted node pairs, ordered by nodes;
+	* - node cells, node edges, node adjacent nodes and edge cells in CSR format.
+	*
+	* Build takes O(N) for bounded node degree: edges are deduplicated by sorting small lists of
+	* node neighbours, nodes and cells are processed in parallel with OpenMP. Owning copies of
+	* mesh as Node, Edge and Polygone objects can be created with makeTopology().
+	*/
+	template <typename T>
+	class Mesh
+	{
+		static_assert(isNumeric<T>, "Mesh<T>: T must be numeric type");
+
+	public:
+		/// @brief Type of node, edge and cell indices
+		using index_type = uint32_t;
+
+		/// @brief Neighbour of boundary facet, missing edge
+		static constexpr index_type no_neighbour = std::numeric_limits<index_type>::max();
+
+	private:
+		size_t dim_ = 0;
+		size_t nodes_num_ = 0;
+
+		/// @brief Coordinates, coords_[k * nodes + i] is k-th coordinate of node i
+		std::vector<T> coords_;
+
+		/// @brief Nodes, edges and neighbours of cells with fixed stride
+		std::vector<index_type> cell_nodes_;
+		std::vector<index_type> cell_edges_;
+		std::vector<index_type> cell_neighbours_;
+
+		/// @brief Sorted node pairs of edges, edges of node i with larger second node start at edge_first_[i]
+		std::vector<index_type> edge_nodes_;
+		std::vector<size_t> edge_first_;
+
+		/// @brief CSR: cells of edge
+		std::vector<size_t> edge_cell_offsets_;
+		std::vector<index_type> edge_cells_;
+
+		/// @brief CSR: cells of node
+		std::vector<size_t> node_cell_offsets_;
+		std::vector<index_type> node_cells_;
+
+		/// @brief CSR: edges of node and their other nodes (the same offsets)
+		std::vector<size_t> node_edge_offsets_;
+		std::vector<index_type> node_edges_;
+		std::vector<index_type> node_nodes_;
+
+		/// @brief CSR by counting sort: row of value j is keys[j], value is j / stride
+		static void csr(size_t rows, const std::vector<index_type>& keys, size_t stride,
+			std::vector<size_t>& offsets, std::vector<index_type>& values)
+		{
+			offsets.assign(rows + 1, 0);
+			for (index_type k : keys)
+			{
+				++offsets[static_cast<size_t>(k) + 1];
+			}
+			for (size_t i = 0; i < rows; ++i)
+			{
+				offsets[i + 1] += offsets[i];
+			}
+			values.resize(keys.size());
+			std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+			for (size_t j = 0; j < keys.size(); ++j)
+			{
+				values[pos[keys[j]]++] = static_cast<index_type>(j / stride);
+			}
+		}
+
+		/// @brief Nodes, connected with node a by cell edges, which are greater than a, sorted
+		void upperNodes(index_type a, std::vector<index_type>& out) const
+		{
+			size_t v = cellSize();
+			out.clear();
+			for (size_t j = node_cell_offsets_[a]; j < node_cell_offsets_[a + 1]; ++j)
+			{
+				const index_type* c = cell_nodes_.data() + static_cast<size_t>(node_cells_[j]) * v;
+				for (size_t l = 0; l < v; ++l)
+				{
+					if (c[l] > a)
+					{
+						out.push_back(c[l]);
+					}
+				}
+			}
+			std::sort(out.begin(), out.end());
+			out.erase(std::unique(out.begin(), out.end()), out.end());
+		}
+
+		void buildEdges()
+		{
+			long long n = static_cast<long long>(nodes_num_);
+			std::vector<size_t> counts(nodes_num_ + 1, 0);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel if (n > blas::omp_threshold)
+#endif
+			{
+				std::vector<index_type> upper;
+#ifdef MATH_OMP_DEFINE
+#pragma omp for schedule(static)
+#endif
+				for (long long a = 0; a < n; ++a)
+				{
+					upperNodes(static_cast<index_type>(a), upper);
+					counts[static_cast<size_t>(a) + 1] = upper.size();
+				}
+			}
+			edge_first_.assign(nodes_num_ + 1, 0);
+			for (size_t a = 0; a < nodes_num_; ++a)
+			{
+				edge_first_[a + 1] = edge_first_[a] + counts[a + 1];
+			}
+			if (edge_first_.back() >= static_cast<size_t>(no_neighbour))
+			{
+				throw(ExceptionInvalidValue("Mesh<T>::build: Too many edges!"));
+			}
+			edge_nodes_.resize(2 * edge_first_.back());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel if (n > blas::omp_threshold)
+#endif
+			{
+				std::vector<index_type> upper;
+#ifdef MATH_OMP_DEFINE
+#pragma omp for schedule(static)
+#endif
+				for (long long a = 0; a < n; ++a)
+				{
+					upperNodes(static_cast<index_type>(a), upper);
+					size_t e = edge_first_[a];
+					for (index_type b : upper)
+					{
+						edge_nodes_[2 * e] = static_cast<index_type>(a);
+						edge_nodes_[2 * e + 1] = b;
+						++e;
+					}
+				}
+			}
+		}
+
+		void buildCellEdges()
+		{
+			size_t v = cellSize();
+			size_t ev = cellEdgesSize();
+			long long cells = static_cast<long long>(cellCount());
+			cell_edges_.resize(cellCount() * ev);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (cells > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < cells; ++c)
+			{
+				const index_type* cn = cell_nodes_.data() + static_cast<size_t>(c) * v;
+				index_type* ce = cell_edges_.data() + static_cast<size_t>(c) * ev;
+				for (size_t l = 0, e = 0; l < v; ++l)
+				{
+					for (size_t m = l + 1; m < v; ++m)
+					{
+						ce[e++] = findEdge(cn[l], cn[m]);
+					}
+				}
+			}
+		}
+
+		void buildNeighbours()
+		{
+			size_t v = cellSize();
+			long long cells = static_cast<long long>(cellCount());
+			cell_neighbours_.resize(cellCount() * v);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (cells > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < cells; ++c)
+			{
+				const index_type* cn = cell_nodes_.data() + static_cast<size_t>(c) * v;
+				const index_type* ce = cell_edges_.data() + static_cast<size_t>(c) * cellEdgesSize();
+				index_type* cnb = cell_neighbours_.data() + static_cast<size_t>(c) * v;
+				for (size_t k = 0; k < v; ++k)
+				{
+					// the other cell of facet edge (1, 2) or (0, 1) of cell, containing the whole facet
+					// (facet is node in 1D)
+					std::span<const index_type> candidates = v == 2 ? nodeCells(cn[1 - k]) :
+						edgeCells(k == 0 ? ce[v - 1] : ce[k == 1 ? 1 : 0]);
+					cnb[k] = no_neighbour;
+					for (index_type d : candidates)
+					{
+						if (d == static_cast<index_type>(c))
+						{
+							continue;
+						}
+						const index_type* dn = cell_nodes_.data() + static_cast<size_t>(d) * v;
+						bool shared = true;
+						for (size_t l = 0; l < v && shared; ++l)
+						{
+							shared = l == k || std::find(dn, dn + v, cn[l]) != dn + v;
+						}
+						if (shared)
+						{
+							cnb[k] = d;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+	public:
+		Mesh() {};
+
+		/**
+		* @brief Mesh constructor
+		* @param points: Node coordinates, one node per row
+		* @param cells: Node indices of cells, points.cols() + 1 per cell
+		*/
+		Mesh(const Matrix<T>& points, const std::vector<index_type>& cells)
+		{
+			std::vector<T> coords(points.rows() * points.cols());
+			for (size_t i = 0; i < points.rows(); ++i)
+			{
+				for (size_t k = 0; k < points.cols(); ++k)
+				{
+					coords[i * points.cols() + k] = points(i, k);
+				}
+			}
+			build(coords.data(), points.rows(), points.cols(), cells);
+		}
+
+		/**
+		* @brief Build mesh
+		* @param points: Node coordinates, row-major (dim values per node)
+		* @param count: Number of nodes
+		* @param dim: Dimension of nodes
+		* @param cells: Node indices of cells, dim + 1 per cell
+		* @throws math::ExceptionInvalidValue if number of cell indices isn't multiple of dim + 1
+		* or mesh is too large for 32-bit indices
+		* @throws math::ExceptionIndexOutOfBounds if cell refers to missing node
+		*/
+		void build(const T* points, size_t count, size_t dim, const std::vector<index_type>& cells)
+		{
+			if (dim == 0 || cells.size() % (dim + 1) != 0)
+			{
+				throw(ExceptionInvalidValue("Mesh<T>::build: Number of cell indices " + std::to_string(cells.size()) +
+					" isn't multiple of " + std::to_string(dim + 1) + "!"));
+			}
+			if (count >= static_cast<size_t>(no_neighbour) || cells.size() / (dim + 1) >= static_cast<size_t>(no_neighbour))
+			{
+				throw(ExceptionInvalidValue("Mesh<T>::build: Too many nodes or cells!"));
+			}
+			for (index_type i : cells)
+			{
+				if (i >= count)
+				{
+					throw(ExceptionIndexOutOfBounds("Mesh<T>::build: Node index " + std::to_string(i) + " out of bounds!"));
+				}
+			}
+
+			dim_ = dim;
+			nodes_num_ = count;
+			coords_.resize(count * dim);
+			for (size_t i = 0; i < count; ++i)
+			{
+				for (size_t k = 0; k < dim; ++k)
+				{
+					coords_[k * count + i] = points[i * dim + k];
+				}
+			}
+			cell_nodes_ = cells;
+
+			csr(nodes_num_, cell_nodes_, cellSize(), node_cell_offsets_, node_cells_);
+			buildEdges();
+			buildCellEdges();
+			csr(edgeCount(), cell_edges_, cellEdgesSize(), edge_cell_offsets_, edge_cells_);
+			buildNeighbours();
+			csr(nodes_num_, edge_nodes_, 2, node_edge_offsets_, node_edges_);
+			node_nodes_.resize(node_edges_.size());
+			for (size_t i = 0; i < nodes_num_; ++i)
+			{
+				for (size_t j = node_edge_offsets_[i]; j < node_edge_offsets_[i + 1]; ++j)
+				{
+					const index_type* e = edge_nodes_.data() + 2 * static_cast<size_t>(node_edges_[j]);
+					node_nodes_[j] = e[0] == i ? e[1] : e[0];
+				}
+			}
+		}
+
+		/// @brief Dimension of nodes
+		size_t dim() const
+		{
+			return dim_;
+		}
+
+		/// @brief Nodes per cell
+		size_t cellSize() const
+		{
+			return dim_ + 1;
+		}
+
+		/// @brief Edges per cell
+		size_t cellEdgesSize() const
+		{
+			return dim_ * (dim_ + 1) / 2;
+		}
+
+		size_t nodeCount() const
+		{
+			return nodes_num_;
+		}
+
+		size_t edgeCount() const
+		{
+			return edge_nodes_.size() / 2;
+		}
+
+		size_t cellCount() const
+		{
+			return dim_ == 0 ? 0 : cell_nodes_.size() / cellSize();
+		}
+
+		/**
+		* @brief Coordinates of all nodes along axis
+		* @param k: Axis
+		* @return Array of nodeCount() values
+		*/
+		const T* coordinates(size_t k) const
+		{
+			return coords_.data() + k * nodes_num_;
+		}
+
+		/// @brief k-th coordinate of node i
+		T coordinate(index_type i, size_t k) const
+		{
+			return coords_[k * nodes_num_ + i];
+		}
+
+		/// @brief Nodes of cell
+		std::span<const index_type> cellNodes(index_type c) const
+		{
+			return { cell_nodes_.data() + static_cast<size_t>(c) * cellSize(), cellSize() };
+		}
+
+		/// @brief Edges of cell, pairs of cell nodes (0, 1), (0, 2), ..., (1, 2), ...
+		std::span<const index_type> cellEdges(index_type c) const
+		{
+			return { cell_edges_.data() + static_cast<size_t>(c) * cellEdgesSize(), cellEdgesSize() };
+		}
+
+		/// @brief Neighbours of cell, neighbour k is opposite to node k
+		std::span<const index_type> cellNeighbours(index_type c) const
+		{
+			return { cell_neighbours_.data() + static_cast<size_t>(c) * cellSize(), cellSize() };
+		}
+
+		/// @brief Nodes of edge, the first is smaller
+		std::span<const index_type> edgeNodes(index_type e) const
+		{
+			return { edge_nodes_.data() + 2 * static_cast<size_t>(e), 2 };
+		}
+
+		/// @brief Cells, containing edge
+		std::span<const index_type> edgeCells(index_type e) const
+		{
+			return { edge_cells_.data() + edge_cell_offsets_[e], edge_cell_offsets_[e + 1] - edge_cell_offsets_[e] };
+		}
+
+		/// @brief Cells, containing node
+		std::span<const index_type> nodeCells(index_type i) const
+		{
+			return { node_cells_.data() + node_cell_offsets_[i], node_cell_offsets_[i + 1] - node_cell_offsets_[i] };
+		}
+
+		/// @brief Edges, containing node
+		std::span<const index_type> nodeEdges(index_type i) const
+		{
+			return { node_edges_.data() + node_edge_offsets_[i], node_edge_offsets_[i + 1] - node_edge_offsets_[i] };
+		}
+
+		/// @brief Nodes, connected with node by edges (in order of nodeEdges())
+		std::span<const index_type> nodeNodes(index_type i) const
+		{
+			return { node_nodes_.data() + node_edge_offsets_[i], node_edge_offsets_[i + 1] - node_edge_offsets_[i] };
+		}
+
+		/**
+		* @brief Find edge by nodes
+		* @return Edge index, or no_neighbour if nodes aren't connected
+		*/
+		index_type findEdge(index_type a, index_type b) const
+		{
+			if (a > b)
+			{
+				std::swap(a, b);
+			}
+			if (a >= nodes_num_)
+			{
+				return no_neighbour;
+			}
+			size_t first = edge_first_[a];
+			size_t last = edge_first_[a + 1];
+			size_t lo = first, hi = last;
+			while (lo < hi)
+			{
+				size_t mid = (lo + hi) / 2;
+				if (edge_nodes_[2 * mid + 1] < b)
+				{
+					lo = mid + 1;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
+			return lo < last && edge_nodes_[2 * lo + 1] == b ? static_cast<index_type>(lo) : no_neighbour;
+		}
+
+		/**
+		* @brief Create Node, Edge and Polygone copies of mesh
+		* @details Objects own their coordinates and adjacency and are not updated if mesh changes.
+		* Objects are indexed as mesh nodes, edges and cells, adjacency is copied from the flat
+		* arrays without search. Adjacent polygones are cells, sharing an edge.
+		* @param[out] nodes: Nodes
+		* @param[out] edges: Edges
+		* @param[out] polygones: Polygones
+		*/
+		void makeTopology(std::vector<std::unique_ptr<Node<T>>>& nodes, std::vector<std::unique_ptr<Edge<T>>>& edges,
+			std::vector<std::unique_ptr<Polygone<T>>>& polygones) const
+		{
+			polygones.clear();
+			edges.clear();
+			nodes.clear();
+			nodes.reserve(nodes_num_);
+			edges.reserve(edgeCount());
+			polygones.reserve(cellCount());
+			for (size_t i = 0; i < nodes_num_; ++i)
+			{
+				Matrix<T> coord(dim_, 1);
+				for (size_t k = 0; k < dim_; ++k)
+				{
+					coord(k, 0) = coordinate(static_cast<index_type>(i), k);
+				}
+				nodes.push_back(std::make_unique<Node<T>>(coord));
+			}
+			for (size_t e = 0; e < edgeCount(); ++e)
+			{
+				edges.push_back(std::unique_ptr<Edge<T>>(new Edge<T>()));
+			}
+			for (size_t c = 0; c < cellCount(); ++c)
+			{
+				polygones.push_back(std::unique_ptr<Polygone<T>>(new Polygone<T>()));
+			}
+
+			for (index_type i = 0; i < nodes_num_; ++i)
+			{
+				Node<T>& n = *nodes[i];
+				for (index_type c : nodeCells(i))
+				{
+					n.polygones_.push_back(polygones[c].get());
+				}
+				for (index_type e : nodeEdges(i))
+				{
+					n.edges_.push_back(edges[e].get());
+				}
+				for (index_type j : nodeNodes(i))
+				{
+					n.adj_nodes_.push_back(nodes[j].get());
+				}
+			}
+			for (index_type e = 0; e < edgeCount(); ++e)
+			{
+				Edge<T>& edge = *edges[e];
+				edge.dim_ = dim_;
+				for (index_type i : edgeNodes(e))
+				{
+					edge.nodes_.push_back(nodes[i].get());
+				}
+				for (index_type c : edgeCells(e))
+				{
+					edge.polygones_.push_back(polygones[c].get());
+				}
+			}
+			std::vector<index_type> adjacent;
+			for (index_type c = 0; c < cellCount(); ++c)
+			{
+				Polygone<T>& p = *polygones[c];
+				p.dim_ = dim_;
+				adjacent.clear();
+				for (index_type i : cellNodes(c))
+				{
+					p.nodes_.push_back(nodes[i].get());
+				}
+				for (index_type e : cellEdges(c))
+				{
+					p.edges_.push_back(edges[e].get());
+					for (index_type d : edgeCells(e))
+					{
+						if (d != c)
+						{
+							adjacent.push_back(d);
+						}
+					}
+				}
+				std::sort(adjacent.begin(), adjacent.end());
+				adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+				for (index_type d : adjacent)
+				{
+					p.adj_polygones_.push_back(polygones[d].get());
+				}
+			}
+		}
+	};
+}
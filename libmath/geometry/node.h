@@ -14,6 +14,9 @@ namespace math
 	template<typename T>
 	class Edge;
 
+	template<typename T>
+	class Mesh;
+
 	/**
 	* @brief Class for n-dimension node (point)
 	*/
@@ -23,6 +26,7 @@ namespace math
 	protected:
 		friend Polygone<T>;
 		friend Edge<T>;
+		friend Mesh<T>;
 
 		/// @brief Node dimension
 		size_t dim_ = 0;
@@ -17,6 +17,8 @@ namespace math
 	class Polygone
 	{
 	protected:
+		friend Mesh<T>;
+
 		/// @brief vector of nodes in this polygone
 		std::vector<Node<T>*> nodes_;
 
@@ -66,6 +68,9 @@ namespace math
 			}
 		};
 
+		/// @brief Empty polygone, filled by Mesh<T>::makeTopology()
+		Polygone() {};
+
 	public:
 		Polygone(const std::vector<Edge<T>*>& edges) : edges_(edges)
 		{
@@ -0,0 +1,869 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace math::predicates
+{
+	namespace detail
+	{
+		/// @brief Unit roundoff of double
+		inline constexpr double epsilon = std::numeric_limits<double>::epsilon() * 0.5;
+
+		/// @brief Error bounds of floating-point filters (J. R. Shewchuk, 1997)
+		inline constexpr double ccw_bound = (3.0 + 16.0 * epsilon) * epsilon;
+		inline constexpr double o3d_bound = (7.0 + 56.0 * epsilon) * epsilon;
+		inline constexpr double icc_bound = (10.0 + 96.0 * epsilon) * epsilon;
+		inline constexpr double isp_bound = (16.0 + 224.0 * epsilon) * epsilon;
+
+		/// @brief Error bounds of adaptive stages B and C and of stage C result
+		inline constexpr double result_bound = (3.0 + 8.0 * epsilon) * epsilon;
+		inline constexpr double ccw_bound_b = (2.0 + 12.0 * epsilon) * epsilon;
+		inline constexpr double ccw_bound_c = (9.0 + 64.0 * epsilon) * epsilon * epsilon;
+		inline constexpr double o3d_bound_b = (3.0 + 28.0 * epsilon) * epsilon;
+		inline constexpr double o3d_bound_c = (26.0 + 288.0 * epsilon) * epsilon * epsilon;
+		inline constexpr double icc_bound_b = (4.0 + 48.0 * epsilon) * epsilon;
+		inline constexpr double icc_bound_c = (44.0 + 576.0 * epsilon) * epsilon * epsilon;
+		inline constexpr double isp_bound_b = (5.0 + 72.0 * epsilon) * epsilon;
+
+		/**
+		* @brief Floating-point expansion: exact sum of nonoverlapping components, sorted by
+		* increasing magnitude, without zero components
+		*/
+		using Expansion = std::vector<double>;
+
+		/// @brief x + y = a + b exactly, x = fl(a + b)
+		inline void twoSum(double a, double b, double& x, double& y)
+		{
+			x = a + b;
+			double b_virt = x - a;
+			double a_virt = x - b_virt;
+			y = (a - a_virt) + (b - b_virt);
+		}
+
+		/// @brief x + y = a + b exactly for |a| >= |b|
+		inline void fastTwoSum(double a, double b, double& x, double& y)
+		{
+			x = a + b;
+			y = b - (x - a);
+		}
+
+		/// @brief x + y = a * b exactly
+		inline void twoProduct(double a, double b, double& x, double& y)
+		{
+			x = a * b;
+			y = std::fma(a, b, -x);
+		}
+
+		/// @brief x + y = a - b exactly
+		inline void twoDiff(double a, double b, double& x, double& y)
+		{
+			x = a - b;
+			double b_virt = a - x;
+			double a_virt = x + b_virt;
+			y = (a - a_virt) + (b_virt - b);
+		}
+
+		/// @brief Roundoff error of x = fl(a - b)
+		inline double diffTail(double a, double b, double x)
+		{
+			double b_virt = a - x;
+			double a_virt = x + b_virt;
+			return (a - a_virt) + (b_virt - b);
+		}
+
+		/// @brief Exact difference (a1 + a0) - (b1 + b0) of two-component values, 4 components x
+		inline void twoTwoDiff(double a1, double a0, double b1, double b0, double* x)
+		{
+			double i, j, k;
+			twoDiff(a0, b0, i, x[0]);
+			twoSum(a1, i, j, k);
+			twoDiff(k, b1, i, x[1]);
+			twoSum(j, i, x[3], x[2]);
+		}
+
+		/// @brief Exact a * b - c * d, 4 components x
+		inline void crossProduct(double a, double b, double c, double d, double* x)
+		{
+			double ab1, ab0, cd1, cd0;
+			twoProduct(a, b, ab1, ab0);
+			twoProduct(c, d, cd1, cd0);
+			twoTwoDiff(ab1, ab0, cd1, cd0, x);
+		}
+
+		/**
+		* @brief h = e + f for expansions on stack (h has elen + flen capacity)
+		* @return Length of h without zero components (at least 1)
+		*/
+		inline size_t sumExpansion(size_t elen, const double* e, size_t flen, const double* f, double* h)
+		{
+			size_t i = 0, j = 0, hlen = 0;
+			double q, h_i;
+			auto takeE = [&]()
+			{
+				return j >= flen || (i < elen && ((f[j] > e[i]) == (f[j] > -e[i])));
+			};
+			q = takeE() ? e[i++] : f[j++];
+			while (i < elen || j < flen)
+			{
+				double next = takeE() ? e[i++] : f[j++];
+				twoSum(q, next, q, h_i);
+				if (h_i != 0.0)
+				{
+					h[hlen++] = h_i;
+				}
+			}
+			if (q != 0.0 || hlen == 0)
+			{
+				h[hlen++] = q;
+			}
+			return hlen;
+		}
+
+		/**
+		* @brief h = e * b for expansion on stack (h has 2 * elen capacity)
+		* @return Length of h without zero components (at least 1)
+		*/
+		inline size_t scaleExpansion(size_t elen, const double* e, double b, double* h)
+		{
+			size_t hlen = 0;
+			double q, h_i;
+			twoProduct(e[0], b, q, h_i);
+			if (h_i != 0.0)
+			{
+				h[hlen++] = h_i;
+			}
+			for (size_t i = 1; i < elen; ++i)
+			{
+				double p1, p0, s;
+				twoProduct(e[i], b, p1, p0);
+				twoSum(q, p0, s, h_i);
+				if (h_i != 0.0)
+				{
+					h[hlen++] = h_i;
+				}
+				fastTwoSum(p1, s, q, h_i);
+				if (h_i != 0.0)
+				{
+					h[hlen++] = h_i;
+				}
+			}
+			if (q != 0.0 || hlen == 0)
+			{
+				h[hlen++] = q;
+			}
+			return hlen;
+		}
+
+		/**
+		* @brief h = e * f for expansions on stack (h has 2 * elen * flen capacity)
+		* @param work: Buffer of 2 * elen * (flen + 1) values
+		* @return Length of h
+		*/
+		inline size_t mulExpansion(size_t elen, const double* e, size_t flen, const double* f, double* h, double* work)
+		{
+			size_t hlen = scaleExpansion(elen, e, f[0], h);
+			double* scaled = work;
+			double* total = work + 2 * elen;
+			for (size_t j = 1; j < flen; ++j)
+			{
+				size_t slen = scaleExpansion(elen, e, f[j], scaled);
+				hlen = sumExpansion(hlen, h, slen, scaled, total);
+				std::copy(total, total + hlen, h);
+			}
+			return hlen;
+		}
+
+		inline void negate(size_t elen, double* e)
+		{
+			for (size_t i = 0; i < elen; ++i)
+			{
+				e[i] = -e[i];
+			}
+		}
+
+		/// @brief Approximate value of expansion on stack
+		inline double approximate(size_t elen, const double* e)
+		{
+			double value = e[0];
+			for (size_t i = 1; i < elen; ++i)
+			{
+				value += e[i];
+			}
+			return value;
+		}
+
+		/// @brief Exact difference a - b
+		inline Expansion diff(double a, double b)
+		{
+			double x, y;
+			twoSum(a, -b, x, y);
+			Expansion e;
+			if (y != 0.0)
+			{
+				e.push_back(y);
+			}
+			if (x != 0.0)
+			{
+				e.push_back(x);
+			}
+			return e;
+		}
+
+		/// @brief e + b
+		inline Expansion grow(const Expansion& e, double b)
+		{
+			Expansion h;
+			h.reserve(e.size() + 1);
+			double q = b;
+			for (double e_i : e)
+			{
+				double h_i;
+				twoSum(q, e_i, q, h_i);
+				if (h_i != 0.0)
+				{
+					h.push_back(h_i);
+				}
+			}
+			if (q != 0.0)
+			{
+				h.push_back(q);
+			}
+			return h;
+		}
+
+		/// @brief e + f
+		inline Expansion sum(const Expansion& e, const Expansion& f)
+		{
+			Expansion h = e;
+			for (double f_i : f)
+			{
+				h = grow(h, f_i);
+			}
+			return h;
+		}
+
+		/// @brief e - f
+		inline Expansion sub(const Expansion& e, const Expansion& f)
+		{
+			Expansion h = e;
+			for (double f_i : f)
+			{
+				h = grow(h, -f_i);
+			}
+			return h;
+		}
+
+		/// @brief e * b
+		inline Expansion scale(const Expansion& e, double b)
+		{
+			Expansion h;
+			if (e.empty() || b == 0.0)
+			{
+				return h;
+			}
+			h.reserve(2 * e.size());
+			double q, h_i;
+			twoProduct(e[0], b, q, h_i);
+			if (h_i != 0.0)
+			{
+				h.push_back(h_i);
+			}
+			for (size_t i = 1; i < e.size(); ++i)
+			{
+				double p1, p0, s;
+				twoProduct(e[i], b, p1, p0);
+				twoSum(q, p0, s, h_i);
+				if (h_i != 0.0)
+				{
+					h.push_back(h_i);
+				}
+				fastTwoSum(p1, s, q, h_i);
+				if (h_i != 0.0)
+				{
+					h.push_back(h_i);
+				}
+			}
+			if (q != 0.0)
+			{
+				h.push_back(q);
+			}
+			return h;
+		}
+
+		/// @brief e * f
+		inline Expansion mul(const Expansion& e, const Expansion& f)
+		{
+			Expansion h;
+			for (double f_i : f)
+			{
+				h = sum(h, scale(e, f_i));
+			}
+			return h;
+		}
+
+		/// @brief Approximation of expansion with exact sign
+		inline double estimate(const Expansion& e)
+		{
+			return e.empty() ? 0.0 : e.back();
+		}
+
+		inline double orient2dExact(const double* a, const double* b, const double* c)
+		{
+			Expansion acx = diff(a[0], c[0]), acy = diff(a[1], c[1]);
+			Expansion bcx = diff(b[0], c[0]), bcy = diff(b[1], c[1]);
+			return estimate(sub(mul(acx, bcy), mul(acy, bcx)));
+		}
+
+		inline double orient3dExact(const double* a, const double* b, const double* c, const double* d)
+		{
+			Expansion adx = diff(a[0], d[0]), ady = diff(a[1], d[1]), adz = diff(a[2], d[2]);
+			Expansion bdx = diff(b[0], d[0]), bdy = diff(b[1], d[1]), bdz = diff(b[2], d[2]);
+			Expansion cdx = diff(c[0], d[0]), cdy = diff(c[1], d[1]), cdz = diff(c[2], d[2]);
+			Expansion det = mul(adz, sub(mul(bdx, cdy), mul(cdx, bdy)));
+			det = sum(det, mul(bdz, sub(mul(cdx, ady), mul(adx, cdy))));
+			det = sum(det, mul(cdz, sub(mul(adx, bdy), mul(bdx, ady))));
+			return estimate(det);
+		}
+
+		inline double incircleExact(const double* a, const double* b, const double* c, const double* d)
+		{
+			Expansion adx = diff(a[0], d[0]), ady = diff(a[1], d[1]);
+			Expansion bdx = diff(b[0], d[0]), bdy = diff(b[1], d[1]);
+			Expansion cdx = diff(c[0], d[0]), cdy = diff(c[1], d[1]);
+			Expansion alift = sum(mul(adx, adx), mul(ady, ady));
+			Expansion blift = sum(mul(bdx, bdx), mul(bdy, bdy));
+			Expansion clift = sum(mul(cdx, cdx), mul(cdy, cdy));
+			Expansion det = mul(alift, sub(mul(bdx, cdy), mul(cdx, bdy)));
+			det = sum(det, mul(blift, sub(mul(cdx, ady), mul(adx, cdy))));
+			det = sum(det, mul(clift, sub(mul(adx, bdy), mul(bdx, ady))));
+			return estimate(det);
+		}
+
+		inline double insphereExact(const double* a, const double* b, const double* c, const double* d, const double* e)
+		{
+			Expansion aex = diff(a[0], e[0]), aey = diff(a[1], e[1]), aez = diff(a[2], e[2]);
+			Expansion bex = diff(b[0], e[0]), bey = diff(b[1], e[1]), bez = diff(b[2], e[2]);
+			Expansion cex = diff(c[0], e[0]), cey = diff(c[1], e[1]), cez = diff(c[2], e[2]);
+			Expansion dex = diff(d[0], e[0]), dey = diff(d[1], e[1]), dez = diff(d[2], e[2]);
+
+			Expansion ab = sub(mul(aex, bey), mul(bex, aey));
+			Expansion bc = sub(mul(bex, cey), mul(cex, bey));
+			Expansion cd = sub(mul(cex, dey), mul(dex, cey));
+			Expansion da = sub(mul(dex, aey), mul(aex, dey));
+			Expansion ac = sub(mul(aex, cey), mul(cex, aey));
+			Expansion bd = sub(mul(bex, dey), mul(dex, bey));
+
+			Expansion abc = sum(sub(mul(aez, bc), mul(bez, ac)), mul(cez, ab));
+			Expansion bcd = sum(sub(mul(bez, cd), mul(cez, bd)), mul(dez, bc));
+			Expansion cda = sum(sum(mul(cez, da), mul(dez, ac)), mul(aez, cd));
+			Expansion dab = sum(sum(mul(dez, ab), mul(aez, bd)), mul(bez, da));
+
+			Expansion alift = sum(sum(mul(aex, aex), mul(aey, aey)), mul(aez, aez));
+			Expansion blift = sum(sum(mul(bex, bex), mul(bey, bey)), mul(bez, bez));
+			Expansion clift = sum(sum(mul(cex, cex), mul(cey, cey)), mul(cez, cez));
+			Expansion dlift = sum(sum(mul(dex, dex), mul(dey, dey)), mul(dez, dez));
+
+			Expansion det = sub(mul(dlift, abc), mul(clift, dab));
+			det = sum(det, sub(mul(blift, cda), mul(alift, bcd)));
+			return estimate(det);
+		}
+
+		/// @brief Stages B, C and D of orient2d (detsum is permanent of stage A)
+		inline double orient2dAdapt(const double* a, const double* b, const double* c, double detsum)
+		{
+			double acx = a[0] - c[0], bcx = b[0] - c[0];
+			double acy = a[1] - c[1], bcy = b[1] - c[1];
+
+			// stage B: exact determinant of rounded differences
+			double det_b[4];
+			crossProduct(acx, bcy, acy, bcx, det_b);
+			double det = approximate(4, det_b);
+			double errbound = ccw_bound_b * detsum;
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			double acxtail = diffTail(a[0], c[0], acx), bcxtail = diffTail(b[0], c[0], bcx);
+			double acytail = diffTail(a[1], c[1], acy), bcytail = diffTail(b[1], c[1], bcy);
+			if (acxtail == 0.0 && acytail == 0.0 && bcxtail == 0.0 && bcytail == 0.0)
+			{
+				return det;
+			}
+
+			// stage C: first order correction by roundoff of differences
+			errbound = ccw_bound_c * detsum + result_bound * std::abs(det);
+			det += (acx * bcytail + bcy * acxtail) - (acy * bcxtail + bcx * acytail);
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			// stage D: exact sum of all terms
+			double u[4], c1[8], c2[12], d[16];
+			crossProduct(acxtail, bcy, acytail, bcx, u);
+			size_t c1len = sumExpansion(4, det_b, 4, u, c1);
+			crossProduct(acx, bcytail, acy, bcxtail, u);
+			size_t c2len = sumExpansion(c1len, c1, 4, u, c2);
+			crossProduct(acxtail, bcytail, acytail, bcxtail, u);
+			size_t dlen = sumExpansion(c2len, c2, 4, u, d);
+			return d[dlen - 1];
+		}
+
+		/// @brief Stages B, C and D of orient3d (permanent of stage A)
+		inline double orient3dAdapt(const double* a, const double* b, const double* c, const double* d, double permanent)
+		{
+			double adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+			double ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+			double adz = a[2] - d[2], bdz = b[2] - d[2], cdz = c[2] - d[2];
+
+			// stage B: exact determinant of rounded differences
+			double bc[4], ca[4], ab[4];
+			double adet[8], bdet[8], cdet[8], abdet[16], fin[24];
+			crossProduct(bdx, cdy, cdx, bdy, bc);
+			size_t alen = scaleExpansion(4, bc, adz, adet);
+			crossProduct(cdx, ady, adx, cdy, ca);
+			size_t blen = scaleExpansion(4, ca, bdz, bdet);
+			crossProduct(adx, bdy, bdx, ady, ab);
+			size_t clen = scaleExpansion(4, ab, cdz, cdet);
+			size_t ablen = sumExpansion(alen, adet, blen, bdet, abdet);
+			size_t finlen = sumExpansion(ablen, abdet, clen, cdet, fin);
+			double det = approximate(finlen, fin);
+			double errbound = o3d_bound_b * permanent;
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			double adxtail = diffTail(a[0], d[0], adx), bdxtail = diffTail(b[0], d[0], bdx), cdxtail = diffTail(c[0], d[0], cdx);
+			double adytail = diffTail(a[1], d[1], ady), bdytail = diffTail(b[1], d[1], bdy), cdytail = diffTail(c[1], d[1], cdy);
+			double adztail = diffTail(a[2], d[2], adz), bdztail = diffTail(b[2], d[2], bdz), cdztail = diffTail(c[2], d[2], cdz);
+			if (adxtail == 0.0 && bdxtail == 0.0 && cdxtail == 0.0 &&
+				adytail == 0.0 && bdytail == 0.0 && cdytail == 0.0 &&
+				adztail == 0.0 && bdztail == 0.0 && cdztail == 0.0)
+			{
+				return det;
+			}
+
+			// stage C: first order correction by roundoff of differences
+			errbound = o3d_bound_c * permanent + result_bound * std::abs(det);
+			det += (adz * ((bdx * cdytail + cdy * bdxtail) - (bdy * cdxtail + cdx * bdytail)) +
+				adztail * (bdx * cdy - bdy * cdx)) +
+				(bdz * ((cdx * adytail + ady * cdxtail) - (cdy * adxtail + adx * cdytail)) +
+				bdztail * (cdx * ady - cdy * adx)) +
+				(cdz * ((adx * bdytail + bdy * adxtail) - (ady * bdxtail + bdx * adytail)) +
+				cdztail * (adx * bdy - ady * bdx));
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			// stage D
+			return orient3dExact(a, b, c, d);
+		}
+
+		/// @brief Stages B, C and D of incircle (permanent of stage A)
+		inline double incircleAdapt(const double* a, const double* b, const double* c, const double* d, double permanent)
+		{
+			double adx = a[0] - d[0], bdx = b[0] - d[0], cdx = c[0] - d[0];
+			double ady = a[1] - d[1], bdy = b[1] - d[1], cdy = c[1] - d[1];
+
+			// stage B: exact determinant of rounded differences
+			double minor[4], x[8], xx[16], y[8], yy[16];
+			double adet[32], bdet[32], cdet[32], abdet[64], fin[96];
+			auto lifted = [&](double dx, double dy, double* out)
+			{
+				size_t xlen = scaleExpansion(4, minor, dx, x);
+				size_t xxlen = scaleExpansion(xlen, x, dx, xx);
+				size_t ylen = scaleExpansion(4, minor, dy, y);
+				size_t yylen = scaleExpansion(ylen, y, dy, yy);
+				return sumExpansion(xxlen, xx, yylen, yy, out);
+			};
+			crossProduct(bdx, cdy, cdx, bdy, minor);
+			size_t alen = lifted(adx, ady, adet);
+			crossProduct(cdx, ady, adx, cdy, minor);
+			size_t blen = lifted(bdx, bdy, bdet);
+			crossProduct(adx, bdy, bdx, ady, minor);
+			size_t clen = lifted(cdx, cdy, cdet);
+			size_t ablen = sumExpansion(alen, adet, blen, bdet, abdet);
+			size_t finlen = sumExpansion(ablen, abdet, clen, cdet, fin);
+			double det = approximate(finlen, fin);
+			double errbound = icc_bound_b * permanent;
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			double adxtail = diffTail(a[0], d[0], adx), bdxtail = diffTail(b[0], d[0], bdx), cdxtail = diffTail(c[0], d[0], cdx);
+			double adytail = diffTail(a[1], d[1], ady), bdytail = diffTail(b[1], d[1], bdy), cdytail = diffTail(c[1], d[1], cdy);
+			if (adxtail == 0.0 && bdxtail == 0.0 && cdxtail == 0.0 &&
+				adytail == 0.0 && bdytail == 0.0 && cdytail == 0.0)
+			{
+				return det;
+			}
+
+			// stage C: first order correction by roundoff of differences
+			errbound = icc_bound_c * permanent + result_bound * std::abs(det);
+			det += ((adx * adx + ady * ady) * ((bdx * cdytail + cdy * bdxtail) - (bdy * cdxtail + cdx * bdytail)) +
+				2.0 * (adx * adxtail + ady * adytail) * (bdx * cdy - bdy * cdx)) +
+				((bdx * bdx + bdy * bdy) * ((cdx * adytail + ady * cdxtail) - (cdy * adxtail + adx * cdytail)) +
+				2.0 * (bdx * bdxtail + bdy * bdytail) * (cdx * ady - cdy * adx)) +
+				((cdx * cdx + cdy * cdy) * ((adx * bdytail + bdy * adxtail) - (ady * bdxtail + bdx * adytail)) +
+				2.0 * (cdx * cdxtail + cdy * cdytail) * (adx * bdy - ady * bdx));
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+
+			// stage D
+			return incircleExact(a, b, c, d);
+		}
+
+		/// @brief Stages B and D of insphere (permanent of stage A)
+		inline double insphereAdapt(const double* a, const double* b, const double* c, const double* d, const double* e,
+			double permanent)
+		{
+			const double* p[4] = { a, b, c, d };
+			double dx[4], dy[4], dz[4];
+			for (size_t i = 0; i < 4; ++i)
+			{
+				dx[i] = p[i][0] - e[0];
+				dy[i] = p[i][1] - e[1];
+				dz[i] = p[i][2] - e[2];
+			}
+
+			// stage B: exact determinant of rounded differences, det = sum_i (-1)^i lift_i * minor_i,
+			// where minor_i is 3 x 3 determinant of differences without row i
+			double xy[4][4][4];
+			for (size_t i = 0; i < 4; ++i)
+			{
+				for (size_t j = i + 1; j < 4; ++j)
+				{
+					crossProduct(dx[i], dy[j], dx[j], dy[i], xy[i][j]);
+				}
+			}
+			double fin[1152], acc[1152], term[288], work[336];
+			size_t finlen = 0;
+			for (size_t i = 0; i < 4; ++i)
+			{
+				// rows j < k < l without i
+				size_t r[3];
+				for (size_t m = 0, n = 0; m < 4; ++m)
+				{
+					if (m != i)
+					{
+						r[n++] = m;
+					}
+				}
+				double t0[8], t1[8], t2[8], s01[16], minor[24];
+				size_t len0 = scaleExpansion(4, xy[r[1]][r[2]], dz[r[0]], t0);
+				size_t len1 = scaleExpansion(4, xy[r[0]][r[2]], -dz[r[1]], t1);
+				size_t len2 = scaleExpansion(4, xy[r[0]][r[1]], dz[r[2]], t2);
+				size_t len01 = sumExpansion(len0, t0, len1, t1, s01);
+				size_t minorlen = sumExpansion(len01, s01, len2, t2, minor);
+
+				double sq[3][2], sq01[4], lift[6];
+				twoProduct(dx[i], dx[i], sq[0][1], sq[0][0]);
+				twoProduct(dy[i], dy[i], sq[1][1], sq[1][0]);
+				twoProduct(dz[i], dz[i], sq[2][1], sq[2][0]);
+				size_t len = sumExpansion(2, sq[0], 2, sq[1], sq01);
+				size_t liftlen = sumExpansion(len, sq01, 2, sq[2], lift);
+
+				size_t termlen = mulExpansion(minorlen, minor, liftlen, lift, term, work);
+				if (i % 2 == 0)
+				{
+					negate(termlen, term);
+				}
+				if (finlen == 0)
+				{
+					std::copy(term, term + termlen, fin);
+					finlen = termlen;
+				}
+				else
+				{
+					finlen = sumExpansion(finlen, fin, termlen, term, acc);
+					std::copy(acc, acc + finlen, fin);
+				}
+			}
+			double det = approximate(finlen, fin);
+			double errbound = isp_bound_b * permanent;
+			if (det >= errbound || -det >= errbound)
+			{
+				return det;
+			}
+			bool exact = true;
+			for (size_t i = 0; i < 4 && exact; ++i)
+			{
+				exact = diffTail(p[i][0], e[0], dx[i]) == 0.0 && diffTail(p[i][1], e[1], dy[i]) == 0.0 &&
+					diffTail(p[i][2], e[2], dz[i]) == 0.0;
+			}
+			if (exact)
+			{
+				return fin[finlen - 1];
+			}
+
+			// stage D
+			return insphereExact(a, b, c, d, e);
+		}
+	}
+
+	/**
+	* @defgroup Predicates Geometric predicates
+	* @{
+	* @brief Robust orientation and in-sphere tests
+	* @details Determinant is evaluated adaptively (J. R. Shewchuk, "Adaptive Precision
+	* Floating-Point Arithmetic and Fast Robust Geometric Predicates", 1997), every stage returns
+	* as soon as its result exceeds the stage error bound:
+	* - A: floating-point determinant, a few flops, decides almost all calls;
+	* - B: exact determinant of rounded coordinate differences with expansions on stack, it's exact
+	* if differences are exact (e.g. for points on integer or coarse grids);
+	* - C: first order correction by roundoff of differences (orient2d, orient3d, incircle);
+	* - D: exact determinant of original coordinates.
+	*
+	* Sign of result is always exact, magnitude is approximate.
+	*/
+
+	/**
+	* @brief Orientation of 2D points
+	* @return Positive if a, b, c are in counterclockwise order, negative if clockwise,
+	* zero if points are collinear
+	*/
+	inline double orient2d(const double* a, const double* b, const double* c)
+	{
+		double detleft = (a[0] - c[0]) * (b[1] - c[1]);
+		double detright = (a[1] - c[1]) * (b[0] - c[0]);
+		double det = detleft - detright;
+		double detsum;
+		if (detleft > 0.0)
+		{
+			if (detright <= 0.0)
+			{
+				return det;
+			}
+			detsum = detleft + detright;
+		}
+		else if (detleft < 0.0)
+		{
+			if (detright >= 0.0)
+			{
+				return det;
+			}
+			detsum = -detleft - detright;
+		}
+		else
+		{
+			return det;
+		}
+		double errbound = detail::ccw_bound * detsum;
+		if (det >= errbound || -det >= errbound)
+		{
+			return det;
+		}
+		return detail::orient2dAdapt(a, b, c, detsum);
+	}
+
+	/**
+	* @brief Orientation of 3D points
+	* @return Positive if d lies below plane through a, b, c (a, b, c are counterclockwise
+	* viewed from above), negative if above, zero if points are coplanar
+	*/
+	inline double orient3d(const double* a, const double* b, const double* c, const double* d)
+	{
+		double adx = a[0] - d[0], ady = a[1] - d[1], adz = a[2] - d[2];
+		double bdx = b[0] - d[0], bdy = b[1] - d[1], bdz = b[2] - d[2];
+		double cdx = c[0] - d[0], cdy = c[1] - d[1], cdz = c[2] - d[2];
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+		double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+		double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+			(std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+			(std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+		double errbound = detail::o3d_bound * permanent;
+		if (det > errbound || -det > errbound)
+		{
+			return det;
+		}
+		return detail::orient3dAdapt(a, b, c, d, permanent);
+	}
+
+	/**
+	* @brief In-circle test
+	* @return Positive if d lies inside circle through a, b, c, negative if outside, zero if
+	* points are cocircular. Sign is reversed if a, b, c are clockwise
+	*/
+	inline double incircle(const double* a, const double* b, const double* c, const double* d)
+	{
+		double adx = a[0] - d[0], ady = a[1] - d[1];
+		double bdx = b[0] - d[0], bdy = b[1] - d[1];
+		double cdx = c[0] - d[0], cdy = c[1] - d[1];
+
+		double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+		double alift = adx * adx + ady * ady;
+		double cdxady = cdx * ady, adxcdy = adx * cdy;
+		double blift = bdx * bdx + bdy * bdy;
+		double adxbdy = adx * bdy, bdxady = bdx * ady;
+		double clift = cdx * cdx + cdy * cdy;
+
+		double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+		double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+			(std::abs(cdxady) + std::abs(adxcdy)) * blift +
+			(std::abs(adxbdy) + std::abs(bdxady)) * clift;
+		double errbound = detail::icc_bound * permanent;
+		if (det > errbound || -det > errbound)
+		{
+			return det;
+		}
+		return detail::incircleAdapt(a, b, c, d, permanent);
+	}
+
+	/**
+	* @brief In-sphere test
+	* @return Positive if e lies inside sphere through a, b, c, d, negative if outside, zero if
+	* points are cospherical. Sign is reversed if orient3d(a, b, c, d) is negative
+	*/
+	inline double insphere(const double* a, const double* b, const double* c, const double* d, const double* e)
+	{
+		double aex = a[0] - e[0], aey = a[1] - e[1], aez = a[2] - e[2];
+		double bex = b[0] - e[0], bey = b[1] - e[1], bez = b[2] - e[2];
+		double cex = c[0] - e[0], cey = c[1] - e[1], cez = c[2] - e[2];
+		double dex = d[0] - e[0], dey = d[1] - e[1], dez = d[2] - e[2];
+
+		double aexbey = aex * bey, bexaey = bex * aey;
+		double bexcey = bex * cey, cexbey = cex * bey;
+		double cexdey = cex * dey, dexcey = dex * cey;
+		double dexaey = dex * aey, aexdey = aex * dey;
+		double aexcey = aex * cey, cexaey = cex * aey;
+		double bexdey = bex * dey, dexbey = dex * bey;
+
+		double ab = aexbey - bexaey;
+		double bc = bexcey - cexbey;
+		double cd = cexdey - dexcey;
+		double da = dexaey - aexdey;
+		double ac = aexcey - cexaey;
+		double bd = bexdey - dexbey;
+
+		double abc = aez * bc - bez * ac + cez * ab;
+		double bcd = bez * cd - cez * bd + dez * bc;
+		double cda = cez * da + dez * ac + aez * cd;
+		double dab = dez * ab + aez * bd + bez * da;
+
+		double alift = aex * aex + aey * aey + aez * aez;
+		double blift = bex * bex + bey * bey + bez * bez;
+		double clift = cex * cex + cey * cey + cez * cez;
+		double dlift = dex * dex + dey * dey + dez * dez;
+
+		double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+		double aezplus = std::abs(aez), bezplus = std::abs(bez);
+		double cezplus = std::abs(cez), dezplus = std::abs(dez);
+		double aexbeyplus = std::abs(aexbey), bexaeyplus = std::abs(bexaey);
+		double bexceyplus = std::abs(bexcey), cexbeyplus = std::abs(cexbey);
+		double cexdeyplus = std::abs(cexdey), dexceyplus = std::abs(dexcey);
+		double dexaeyplus = std::abs(dexaey), aexdeyplus = std::abs(aexdey);
+		double aexceyplus = std::abs(aexcey), cexaeyplus = std::abs(cexaey);
+		double bexdeyplus = std::abs(bexdey), dexbeyplus = std::abs(dexbey);
+		double permanent =
+			((cexdeyplus + dexceyplus) * bezplus + (dexbeyplus + bexdeyplus) * cezplus + (bexceyplus + cexbeyplus) * dezplus) * alift +
+			((dexaeyplus + aexdeyplus) * cezplus + (aexceyplus + cexaeyplus) * dezplus + (cexdeyplus + dexceyplus) * aezplus) * blift +
+			((aexbeyplus + bexaeyplus) * dezplus + (bexdeyplus + dexbeyplus) * aezplus + (dexaeyplus + aexdeyplus) * bezplus) * clift +
+			((bexceyplus + cexbeyplus) * aezplus + (cexaeyplus + aexceyplus) * bezplus + (aexbeyplus + bexaeyplus) * cezplus) * dlift;
+		double errbound = detail::isp_bound * permanent;
+		if (det > errbound || -det > errbound)
+		{
+			return det;
+		}
+		return detail::insphereAdapt(a, b, c, d, e, permanent);
+	}
+
+	namespace detail
+	{
+		/// @brief Sign of perturbed in-circle determinant of cocircular points, see incirclePerturbed
+		inline double incircleTie(const double* a, const double* b, const double* c, const double* d)
+		{
+			const double* p[4] = { a, b, c, d };
+			size_t order[4] = { 0, 1, 2, 3 };
+			std::sort(order, order + 4, [&p](size_t i, size_t j)
+				{
+					return std::lexicographical_compare(p[i], p[i] + 2, p[j], p[j] + 2);
+				});
+			for (size_t i : order)
+			{
+				const double* q[3];
+				for (size_t l = 0, m = 0; l < 4; ++l)
+				{
+					if (l != i)
+					{
+						q[m++] = p[l];
+					}
+				}
+				double o = orient2d(q[0], q[1], q[2]);
+				if (o != 0.0)
+				{
+					return i % 2 == 0 ? o : -o;
+				}
+			}
+			return 0.0;
+		}
+
+		/// @brief Sign of perturbed in-sphere determinant of cospherical points, see inspherePerturbed
+		inline double insphereTie(const double* a, const double* b, const double* c, const double* d, const double* e)
+		{
+			const double* p[5] = { a, b, c, d, e };
+			size_t order[5] = { 0, 1, 2, 3, 4 };
+			std::sort(order, order + 5, [&p](size_t i, size_t j)
+				{
+					return std::lexicographical_compare(p[i], p[i] + 3, p[j], p[j] + 3);
+				});
+			for (size_t i : order)
+			{
+				const double* q[4];
+				for (size_t l = 0, m = 0; l < 5; ++l)
+				{
+					if (l != i)
+					{
+						q[m++] = p[l];
+					}
+				}
+				double o = orient3d(q[0], q[1], q[2], q[3]);
+				if (o != 0.0)
+				{
+					return i % 2 == 0 ? -o : o;
+				}
+			}
+			return 0.0;
+		}
+	}
+
+	/**
+	* @brief In-circle test with symbolic perturbation of cocircular points
+	* @details Lifted coordinate @f$ |x|^2 @f$ of every point is raised by infinitesimal, which is
+	* larger for lexicographically smaller point (simulation of simplicity, H. Edelsbrunner,
+	* E. P. Mucke, 1990). Determinant is linear in lifted coordinates, so zero determinant is
+	* decided by the cofactor of the most perturbed point, which isn't zero. Delaunay triangulation
+	* of distinct points with this test is unique and doesn't depend on insertion order.
+	* @return incircle(a, b, c, d) if it isn't zero, otherwise value of the sign of perturbed
+	* determinant. Zero only if all points are collinear
+	*/
+	inline double incirclePerturbed(const double* a, const double* b, const double* c, const double* d)
+	{
+		double det = incircle(a, b, c, d);
+		return det != 0.0 ? det : detail::incircleTie(a, b, c, d);
+	}
+
+	/**
+	* @brief In-sphere test with symbolic perturbation of cospherical points, see incirclePerturbed
+	* @return insphere(a, b, c, d, e) if it isn't zero, otherwise value of the sign of perturbed
+	* determinant. Zero only if all points are coplanar
+	*/
+	inline double inspherePerturbed(const double* a, const double* b, const double* c, const double* d, const double* e)
+	{
+		double det = insphere(a, b, c, d, e);
+		return det != 0.0 ? det : detail::insphereTie(a, b, c, d, e);
+	}
+	/** @} */
+}
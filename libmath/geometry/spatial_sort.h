@@ -0,0 +1,180 @@
+#pragma once
+#include <libmath/math_exception.h>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cstdint>
+#include <utility>
+
+namespace math
+{
+	namespace detail
+	{
+		/// @brief Point coordinates with index, sorted by value to keep coordinates in cache
+		template <size_t D, typename I>
+		struct SortEntry
+		{
+			std::array<double, D> x;
+			I index;
+		};
+
+		/// @brief Split range at median along axis (descending order if up)
+		template <size_t axis, bool up, size_t D, typename I>
+		SortEntry<D, I>* hilbertSplit(SortEntry<D, I>* first, SortEntry<D, I>* last)
+		{
+			if (first >= last)
+			{
+				return first;
+			}
+			SortEntry<D, I>* middle = first + (last - first) / 2;
+			std::nth_element(first, middle, last, [](const SortEntry<D, I>& a, const SortEntry<D, I>& b)
+				{
+					return up ? a.x[axis] > b.x[axis] : a.x[axis] < b.x[axis];
+				});
+			return middle;
+		}
+
+		/// @brief Median Hilbert sort of 2D points: quadrants in order of Hilbert curve
+		template <size_t x, bool upx, bool upy, typename I>
+		void hilbertSort2(SortEntry<2, I>* m0, SortEntry<2, I>* m4)
+		{
+			constexpr size_t y = (x + 1) % 2;
+			if (m4 - m0 <= 1)
+			{
+				return;
+			}
+			SortEntry<2, I>* m2 = hilbertSplit<x, upx>(m0, m4);
+			SortEntry<2, I>* m1 = hilbertSplit<y, upy>(m0, m2);
+			SortEntry<2, I>* m3 = hilbertSplit<y, !upy>(m2, m4);
+			hilbertSort2<y, upy, upx>(m0, m1);
+			hilbertSort2<x, upx, upy>(m1, m2);
+			hilbertSort2<x, upx, upy>(m2, m3);
+			hilbertSort2<y, !upy, !upx>(m3, m4);
+		}
+
+		/// @brief Median Hilbert sort of 3D points: octants in order of Hilbert curve
+		template <size_t x, bool upx, bool upy, bool upz, typename I>
+		void hilbertSort3(SortEntry<3, I>* m0, SortEntry<3, I>* m8)
+		{
+			constexpr size_t y = (x + 1) % 3;
+			constexpr size_t z = (x + 2) % 3;
+			if (m8 - m0 <= 1)
+			{
+				return;
+			}
+			SortEntry<3, I>* m4 = hilbertSplit<x, upx>(m0, m8);
+			SortEntry<3, I>* m2 = hilbertSplit<y, upy>(m0, m4);
+			SortEntry<3, I>* m1 = hilbertSplit<z, upz>(m0, m2);
+			SortEntry<3, I>* m3 = hilbertSplit<z, !upz>(m2, m4);
+			SortEntry<3, I>* m6 = hilbertSplit<y, !upy>(m4, m8);
+			SortEntry<3, I>* m5 = hilbertSplit<z, upz>(m4, m6);
+			SortEntry<3, I>* m7 = hilbertSplit<z, !upz>(m6, m8);
+			hilbertSort3<z, upz, upx, upy>(m0, m1);
+			hilbertSort3<y, upy, upz, upx>(m1, m2);
+			hilbertSort3<y, upy, upz, upx>(m2, m3);
+			hilbertSort3<x, upx, !upy, !upz>(m3, m4);
+			hilbertSort3<x, upx, !upy, !upz>(m4, m5);
+			hilbertSort3<y, upy, upz, upx>(m5, m6);
+			hilbertSort3<y, upy, upz, upx>(m6, m7);
+			hilbertSort3<z, !upz, upx, !upy>(m7, m8);
+		}
+
+		template <size_t D, typename T, typename I>
+		void hilbertSort(const T* points, I* first, I* last)
+		{
+			size_t count = static_cast<size_t>(last - first);
+			std::vector<SortEntry<D, I>> entries(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const T* p = points + static_cast<size_t>(first[i]) * D;
+				for (size_t k = 0; k < D; ++k)
+				{
+					entries[i].x[k] = static_cast<double>(p[k]);
+				}
+				entries[i].index = first[i];
+			}
+			if constexpr (D == 2)
+			{
+				hilbertSort2<0, false, false>(entries.data(), entries.data() + count);
+			}
+			else
+			{
+				hilbertSort3<0, false, false, false>(entries.data(), entries.data() + count);
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				first[i] = entries[i].index;
+			}
+		}
+	}
+
+	/**
+	* @brief Sort point indices along Hilbert curve
+	* @details Points are split recursively at medians into quadrants (octants in 3D), which are
+	* visited in order of Hilbert curve (as CGAL::hilbert_sort with median policy). Medians adapt
+	* sort to distribution of points, and consecutive points are close to each other, which keeps
+	* walks of point location short. Cost is O(N log N).
+	* @param points: Points, row-major (dim values per point)
+	* @param dim: Dimension of points (2 or 3)
+	* @param first, last: Range of point indices to sort
+	* @throws math::ExceptionInvalidValue if dim isn't 2 or 3
+	*/
+	template <typename T, typename I>
+	void hilbertSort(const T* points, size_t dim, I* first, I* last)
+	{
+		switch (dim)
+		{
+		case 2:
+			detail::hilbertSort<2>(points, first, last);
+			break;
+		case 3:
+			detail::hilbertSort<3>(points, first, last);
+			break;
+		default:
+			throw(ExceptionInvalidValue("hilbertSort: Only 2D and 3D points are supported!"));
+		}
+	}
+
+	/**
+	* @brief Biased randomized insertion order (BRIO) of points
+	* @details Points are shuffled and split into rounds of geometrically growing size (each round
+	* is twice the previous one, the last round holds half of points), every round is sorted
+	* along Hilbert curve (N. Amenta, S. Choi, G. Rote, "Incremental constructions con BRIO", 2003).
+	* Randomness keeps expected cost of incremental constructions optimal, spatial sort keeps
+	* point location local.
+	* @param points: Points, row-major (dim values per point)
+	* @param count: Number of points
+	* @param dim: Dimension of points (2 or 3)
+	* @param[out] order: Permutation of point indices
+	* @param seed: Seed of shuffle, order is deterministic for fixed seed
+	*/
+	template <typename T, typename I>
+	void brioOrder(const T* points, size_t count, size_t dim, std::vector<I>& order, unsigned seed = 0)
+	{
+		/// @brief Size of the first round
+		constexpr size_t min_round = 64;
+
+		order.resize(count);
+		std::iota(order.begin(), order.end(), I(0));
+		std::mt19937 gen(seed);
+		for (size_t i = count; i > 1; --i)
+		{
+			size_t j = static_cast<size_t>(gen() % i);
+			std::swap(order[i - 1], order[j]);
+		}
+
+		std::vector<size_t> ends{ count };
+		while (ends.back() > min_round)
+		{
+			ends.push_back(ends.back() / 2);
+		}
+		size_t begin = 0;
+		for (size_t r = ends.size(); r-- > 0;)
+		{
+			hilbertSort(points, dim, order.data() + begin, order.data() + ends[r]);
+			begin = ends[r];
+		}
+	}
+}
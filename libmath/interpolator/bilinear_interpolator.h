@@ -1,56 +1,55 @@
 #pragma once
-#include <libmath/interpolator/interpolator.h>
-#include <algorithm>
-#include <cmath>
-
-#ifdef MATH_OMP_DEFINE
-#include <omp.h>
-#endif
+#include <libmath/interpolator/multilinear_interpolator.h>
+#include <vector>
+#include <string>
 
 namespace math
 {
+	/**
+	 * @brief Bilinear interpolation on 2-dimension rectilinear grid
+	 * @details Two-dimension case of MultiLinearInterpolator: value in point of cell
+	 * @f$ [x_{0,i}, x_{0,i+1}] \times [x_{1,j}, x_{1,j+1}] @f$ is
+	 * @f[
+	 * y = (1 - t_0)(1 - t_1) y_{i,j} + t_0 (1 - t_1) y_{i+1,j} + (1 - t_0) t_1 y_{i,j+1} + t_0 t_1 y_{i+1,j+1}.
+	 * @f]
+	 */
 	template <typename T>
-	class BiLinearInterpolator : public Interpolator<T>
+	class BiLinearInterpolator : public MultiLinearInterpolator<T>
 	{
 	private:
-        /// @brief Matrix of data coefficients (from independent variables points)
-        Matrix<T> A_;
-
-        /// @brief Vector of data free terms (dependent variables points)
-        Matrix<T> b_;
-
-        /// @brief Vector of interpolation coefficients
-        Matrix<T> c_;
-	public:
-        BiLinearInterpolator() : Interpolator<T>("BiLinear") {};
-
-        BiLinearInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) : Interpolator<T>("BiLinear", x, y)
-        {
-			A_ = Matrix<T>(std::pow(2,Interpolator<T>::dim_));
-            b_ = static_cast<T>(-1.0) * y;
-            c_ = Matrix<T>(std::pow(2,Interpolator<T>::dim_), 1);
-        };
-
-		virtual ~BiLinearInterpolator(){};
-
-        virtual void build() override
-        {
-			for (int pos = 0; pos < A_.numel(); ++pos)
+		void checkDimension() const
+		{
+			if (Interpolator<T>::dim_ != 2)
 			{
-				size_t row { 0 };
-				size_t col { 0 };
-
-				// A_ has row representation by default
-				row = (size_t)std::floor(pos / A_.cols());
-				col = pos - row * A_.cols();
-
-				
+				throw(ExceptionInvalidValue("BiLinearInterpolator<T>: Points must be 2-dimension!"));
 			}
 		}
-		
-		virtual T interpolate(const Matrix<T>& x) const override
+
+	public:
+		BiLinearInterpolator() : MultiLinearInterpolator<T>("BiLinear") {};
+
+		/**
+		* @brief Constructor from scattered points, forming rectilinear grid
+		* @param x: Points, one per row (2 columns)
+		* @param y: Values in points, column vector
+		*/
+		BiLinearInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) :
+			MultiLinearInterpolator<T>("BiLinear", x, y)
 		{
-			return 1.0;
-		}
+			checkDimension();
+		};
+
+		/**
+		* @brief Constructor from grid
+		* @param x0: Nodes of the first axis
+		* @param x1: Nodes of the second axis
+		* @param values: Values in grid nodes, row-major (x1 is contiguous)
+		*/
+		BiLinearInterpolator(const std::vector<T>& x0, const std::vector<T>& x1, const std::vector<T>& values) :
+			MultiLinearInterpolator<T>("BiLinear", std::vector<std::vector<T>>{ x0, x1 }, values)
+		{
+		};
+
+		virtual ~BiLinearInterpolator() {};
 	};
-}
\ No newline at end of file
+}
@@ -6,6 +6,7 @@
 #include <libmath/solver/las/kholetsky.h>
 #include <libmath/solver/las/bicgstab.h>
 #include <libmath/math_exception.h>
+#include <libmath/blas.h>
 
 #ifdef MATH_OMP_DEFINE
 #include <omp.h>
@@ -14,6 +15,7 @@
 #include <string>
 #include <memory>
 #include <iostream>
+#include <algorithm>
 
 namespace math
 {
@@ -40,6 +42,27 @@ namespace math
 		/// @brief Dimension
 		size_t dim_ = 0;
 
+		/**
+		* @brief Check, that interpolator is ready for interpolation
+		* @param method: Name of calling method for exception message
+		* @throws math::Exception if interpolator isn't built
+		*/
+		virtual void checkBuilt(const std::string&) const {};
+
+		/**
+		* @brief Interpolate values in rows [first, last) of points matrix
+		* @details Called by interpolateBatch() once per thread after inputs are checked, so
+		* derived interpolators implement whole loop over points without virtual calls and checks.
+		* Called inside of parallel region, so must not throw.
+		* @param x: Points matrix storage, rows x dim_
+		* @param rows: Number of points
+		* @param row_major: True if points are stored row by row, false if column by column
+		* @param first: First point
+		* @param last: Point after the last one
+		* @param[out] y: Interpolated values of all points
+		*/
+		virtual void interpolateRows(const T* x, size_t rows, bool row_major, size_t first, size_t last, T* y) const = 0;
+
 	public:
 		Interpolator(const std::string& method) : method_(method) {};
 
@@ -68,5 +91,54 @@ namespace math
 		virtual void build() = 0;
 
 		virtual T interpolate(const Matrix<T>& x) const = 0;
+
+		/**
+		* @brief Interpolate values in many points
+		* @details Inputs are checked once, points are split to contiguous ranges, which are
+		* interpolated in parallel by interpolateRows()
+		* @param x: Points, one per row
+		* @param[out] y: Buffer of x.rows() interpolated values
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns of x isn't equal to dimension
+		*/
+		void interpolateBatch(const Matrix<T>& x, T* y) const
+		{
+			if (x.cols() != dim_)
+			{
+				throw(ExceptionNonEqualColumnsNum(
+					"Interpolator<T> (" + method_ + ")::interpolateBatch: Matrix x of independent variables must have " +
+					std::to_string(dim_) + " columns!"));
+			}
+			checkBuilt("interpolateBatch");
+
+			const T* x_data = x.data();
+			size_t rows = x.rows();
+			bool row_major = x.representation() == MatRep::Row;
+
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel if (static_cast<long long>(rows * std::max<size_t>(dim_, 1)) > blas::omp_threshold)
+			{
+				size_t threads = static_cast<size_t>(omp_get_num_threads());
+				size_t thread = static_cast<size_t>(omp_get_thread_num());
+				interpolateRows(x_data, rows, row_major, rows * thread / threads, rows * (thread + 1) / threads, y);
+			}
+#else
+			interpolateRows(x_data, rows, row_major, 0, rows, y);
+#endif
+		}
+
+		/**
+		* @brief Interpolate values in many points
+		* @param x: Points, one per row
+		* @param[out] y: Interpolated values, column vector. Reallocated, if size doesn't match
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns of x isn't equal to dimension
+		*/
+		void interpolateBatch(const Matrix<T>& x, Matrix<T>& y) const
+		{
+			if (y.rows() != x.rows() || y.cols() != 1)
+			{
+				y = Matrix<T>(x.rows(), 1);
+			}
+			interpolateBatch(x, y.data());
+		}
 	};
 }
\ No newline at end of file
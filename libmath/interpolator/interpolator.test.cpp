@@ -1,6 +1,16 @@
 #include <gtest/gtest.h>
 #include <libmath/interpolator/bilinear_interpolator.h>
+#include <libmath/interpolator/multilinear_interpolator.h>
 #include <libmath/interpolator/polygone_interpolator.h>
+#include <libmath/interpolator/rbf_interpolator.h>
+#include <libmath/solver/las/cg.h>
+#include <libmath/interpolator/mesh_interpolator.h>
+#include <vector>
+#include <cmath>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
 
 
 TEST(Interpolator, Polygone)
@@ -90,32 +100,399 @@ TEST(Interpolator, Polygone)
 	EXPECT_EQ(math::isEqual(y_3d3, 5.), true);
 }
 
-// TEST(Interpolator, BiLinear)
-// {
-// 	math::Matrix<double> x =
-// 	{
-// 		{1.,1.},
-// 		{2.,1.},
-// 		{1.,2.},
-// 		{2.,2.}
-// 	};
-
-// 	math::Matrix<double> y =
-// 	{
-// 		{1.},
-// 		{1.},
-// 		{1.},
-// 		{1.}
-// 	};
-
-// 	math::BiLinearInterpolator<double> bilinear(x, y);
-// 	bilinear.build();
-
-// 	math::Matrix<double> new_x = 
-// 	{
-// 		{2., 1.}
-// 	};
-// 	double y_int = bilinear.interpolate(new_x);
-
-// 	std::cout << y_int << std::endl;
-// }
\ No newline at end of file
+TEST(Interpolator, PolygoneLeastSquares)
+{
+	// points on hyperplane y = 1 + 2 x0 - x1 + 0.5 x2
+	size_t points = 10000;
+	math::Matrix<double> x(points, 3);
+	math::Matrix<double> y(points, 1);
+	for (size_t i = 0; i < points; ++i)
+	{
+		x(i, 0) = std::sin(static_cast<double>(i));
+		x(i, 1) = std::cos(0.7 * static_cast<double>(i));
+		x(i, 2) = static_cast<double>(i % 17);
+		y(i, 0) = 1.0 + 2.0 * x(i, 0) - x(i, 1) + 0.5 * x(i, 2);
+	}
+
+	math::PolygoneInterpolator<double> polygone(x, y);
+	polygone.build();
+	EXPECT_EQ(math::isEqual(polygone.interpolate({{0.5, 0.5, 1.0}}), 2.0, 1.e-10), true);
+
+	// noisy data is fitted in least squares sense
+	for (size_t i = 0; i < points; ++i)
+	{
+		y(i, 0) += (i % 2 == 0 ? 1.e-3 : -1.e-3);
+	}
+	math::PolygoneInterpolator<double> noisy(x, y);
+	noisy.build();
+	EXPECT_EQ(math::isEqual(noisy.interpolate({{0.5, 0.5, 1.0}}), 2.0, 1.e-4), true);
+
+	// not enough points
+	math::PolygoneInterpolator<double> underdetermined(
+		math::Matrix<double>{ {1.0, 2.0}, {2.0, 1.0} },
+		math::Matrix<double>{ {1.0}, {2.0} });
+	EXPECT_THROW(underdetermined.build(), math::ExceptionDegenerateMatrix);
+
+	// interpolator isn't built
+	math::Matrix<double> y_batch;
+	EXPECT_THROW(underdetermined.interpolate({{1.0, 1.0}}), math::ExceptionInvalidValue);
+	EXPECT_THROW(underdetermined.interpolateBatch(math::Matrix<double>(5, 2), y_batch), math::ExceptionInvalidValue);
+}
+
+TEST(Interpolator, BiLinear)
+{
+	math::Matrix<double> x =
+	{
+		{1.,1.},
+		{2.,1.},
+		{1.,2.},
+		{2.,2.}
+	};
+
+	math::Matrix<double> y =
+	{
+		{1.},
+		{2.},
+		{3.},
+		{5.}
+	};
+
+	math::BiLinearInterpolator<double> bilinear(x, y);
+	bilinear.build();
+
+	EXPECT_EQ(math::isEqual(bilinear.interpolate({{2., 1.}}), 2.0), true);
+	EXPECT_EQ(math::isEqual(bilinear.interpolate({{1.5, 1.5}}), 2.75), true);
+	EXPECT_EQ(math::isEqual(bilinear.interpolate({{1.5, 1.}}), 1.5), true);
+
+	// extrapolation from boundary cell
+	EXPECT_EQ(math::isEqual(bilinear.interpolate({{3., 1.}}), 3.0), true);
+
+	// grid constructor
+	math::BiLinearInterpolator<double> grid({ 1., 2. }, { 1., 2. }, { 1., 3., 2., 5. });
+	EXPECT_EQ(math::isEqual(grid.interpolate({{1.5, 1.5}}), 2.75), true);
+
+	EXPECT_THROW(math::BiLinearInterpolator<double>(math::Matrix<double>{ {1.}, {2.} }, math::Matrix<double>{ {1.}, {2.} }), math::ExceptionInvalidValue);
+	EXPECT_THROW(bilinear.interpolate({{1., 1., 1.}}), math::ExceptionNonRowVector);
+}
+
+TEST(Interpolator, MultiLinear)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+	// multilinear function is reproduced exactly on uniform and non-uniform axes
+	auto f = [](double x0, double x1, double x2)
+	{
+		return 1.0 + 2.0 * x0 - x1 + 0.5 * x2 + x0 * x1 - 0.25 * x0 * x1 * x2;
+	};
+
+	std::vector<std::vector<double>> axes =
+	{
+		{ 0.0, 0.5, 1.0, 1.5, 2.0 },
+		{ -1.0, 0.0, 0.3, 2.0 },
+		{ 0.0, 1.0, 2.0 }
+	};
+	std::vector<double> values;
+	for (double x0 : axes[0])
+	{
+		for (double x1 : axes[1])
+		{
+			for (double x2 : axes[2])
+			{
+				values.push_back(f(x0, x1, x2));
+			}
+		}
+	}
+
+	math::MultiLinearInterpolator<double> grid(axes, values);
+	EXPECT_EQ(math::isEqual(grid.interpolate({{0.7, 0.1, 1.3}}), f(0.7, 0.1, 1.3), 1.e-12), true);
+
+	// points outside of grid are extrapolated from the boundary cells, NaN is propagated
+	EXPECT_EQ(math::isEqual(grid.interpolate({{3.0, 0.1, -0.5}}), f(3.0, 0.1, -0.5), 1.e-12), true);
+	EXPECT_EQ(std::isfinite(grid.interpolate({{1.e300, 0.1, 1.3}})), true);
+	EXPECT_EQ(std::isnan(grid.interpolate({{std::nan(""), 0.1, 1.3}})), true);
+
+	// the same grid from shuffled scattered points
+	size_t n = values.size();
+	math::Matrix<double> x(n, 3);
+	math::Matrix<double> y(n, 1);
+	for (size_t p = 0; p < n; ++p)
+	{
+		size_t q = (p * 7) % n;
+		size_t i0 = q / 12;
+		size_t i1 = (q / 3) % 4;
+		size_t i2 = q % 3;
+		x(p, 0) = axes[0][i0];
+		x(p, 1) = axes[1][i1];
+		x(p, 2) = axes[2][i2];
+		y(p, 0) = values[q];
+	}
+	math::MultiLinearInterpolator<double> scattered(x, y);
+	EXPECT_THROW(scattered.interpolate({{0.7, 0.1, 1.3}}), math::ExceptionInvalidValue);
+	scattered.build();
+
+	// batch interpolation with row and column representation of points
+	size_t queries = 5000;
+	math::Matrix<double> q_row(queries, 3);
+	math::Matrix<double> q_col(queries, 3, math::MatRep::Column);
+	for (size_t i = 0; i < queries; ++i)
+	{
+		double s = static_cast<double>(i) / static_cast<double>(queries);
+		double p[3] = { 2.0 * s, -1.0 + 3.0 * std::fmod(7.0 * s, 1.0), 2.0 * std::fmod(13.0 * s, 1.0) };
+		for (size_t k = 0; k < 3; ++k)
+		{
+			q_row(i, k) = p[k];
+			q_col(i, k) = p[k];
+		}
+	}
+	math::Matrix<double> y_row;
+	math::Matrix<double> y_col;
+	scattered.interpolateBatch(q_row, y_row);
+	scattered.interpolateBatch(q_col, y_col);
+	EXPECT_EQ(y_row.rows(), queries);
+	for (size_t i = 0; i < queries; i += 37)
+	{
+		double gold = f(q_row(i, 0), q_row(i, 1), q_row(i, 2));
+		EXPECT_EQ(math::isEqual(y_row(i, 0), gold, 1.e-12), true);
+		EXPECT_EQ(math::isEqual(y_col(i, 0), gold, 1.e-12), true);
+	}
+
+	// incomplete grid
+	math::Matrix<double> x_bad = { {0., 0.}, {1., 0.}, {0., 1.} };
+	math::Matrix<double> y_bad = { {0.}, {1.}, {1.} };
+	math::MultiLinearInterpolator<double> bad(x_bad, y_bad);
+	EXPECT_THROW(bad.build(), math::ExceptionInvalidValue);
+
+	// duplicate point, grid is rejected after values are filled
+	math::Matrix<double> x_dup = { {0., 0.}, {1., 0.}, {0., 1.}, {0., 1.} };
+	math::Matrix<double> y_dup = { {0.}, {1.}, {1.}, {1.} };
+	math::MultiLinearInterpolator<double> dup(x_dup, y_dup);
+	EXPECT_THROW(dup.build(), math::ExceptionInvalidValue);
+	EXPECT_THROW(dup.interpolate({{0.5, 0.5}}), math::ExceptionInvalidValue);
+	math::Matrix<double> y_dup_batch;
+	EXPECT_THROW(dup.interpolateBatch(x_dup, y_dup_batch), math::ExceptionInvalidValue);
+}
+
+TEST(Interpolator, Batch)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+	math::Matrix<double> x =
+	{
+		{1.,1.,1.},
+		{2.,1.,2.},
+		{1.,2.,2.},
+		{3.,1.,2.}
+	};
+	math::Matrix<double> y = { {1.}, {2.}, {2.}, {3.} };
+
+	math::PolygoneInterpolator<double> polygone(x, y);
+	polygone.build();
+
+	size_t queries = 10000;
+	math::Matrix<double> q_row(queries, 3);
+	q_row.rfill(3);
+	math::Matrix<double> q_col(queries, 3, math::MatRep::Column);
+	for (size_t i = 0; i < queries; ++i)
+	{
+		for (size_t j = 0; j < 3; ++j)
+		{
+			q_col(i, j) = q_row(i, j);
+		}
+	}
+
+	// caller-provided buffer and matrix output
+	std::vector<double> y_row(queries);
+	polygone.interpolateBatch(q_row, y_row.data());
+	math::Matrix<double> y_col;
+	polygone.interpolateBatch(q_col, y_col);
+	EXPECT_EQ(y_col.rows(), queries);
+
+	for (size_t i = 0; i < queries; i += 101)
+	{
+		double gold = polygone.interpolate({{q_row(i, 0), q_row(i, 1), q_row(i, 2)}});
+		EXPECT_EQ(math::isEqual(y_row[i], gold, 1.e-12), true);
+		EXPECT_EQ(math::isEqual(y_col(i, 0), gold, 1.e-12), true);
+	}
+
+	EXPECT_THROW(polygone.interpolateBatch(math::Matrix<double>(5, 2), y_col), math::ExceptionNonEqualColumnsNum);
+}
+
+TEST(Interpolator, RBF)
+{
+	// scattered distinct centers in unit square (Kronecker sequence)
+	size_t n = 200;
+	math::Matrix<double> x(n, 2);
+	for (size_t i = 0; i < n; ++i)
+	{
+		x(i, 0) = std::fmod(0.5 + 0.7548776662 * static_cast<double>(i), 1.0);
+		x(i, 1) = std::fmod(0.5 + 0.5698402910 * static_cast<double>(i), 1.0);
+	}
+	auto f = [](double x0, double x1)
+	{
+		return std::sin(3.0 * x0) * std::cos(2.0 * x1);
+	};
+	auto g = [](double x0, double x1)
+	{
+		return 1.0 + 2.0 * x0 - 3.0 * x1;
+	};
+	math::Matrix<double> y(n, 1);
+	math::Matrix<double> y_linear(n, 1);
+	for (size_t i = 0; i < n; ++i)
+	{
+		y(i, 0) = f(x(i, 0), x(i, 1));
+		y_linear(i, 0) = g(x(i, 0), x(i, 1));
+	}
+
+	struct Case
+	{
+		math::RBFKernel kernel;
+		double shape;
+	};
+	std::vector<Case> cases =
+	{
+		{ math::RBFKernel::thin_plate, 1.0 },
+		{ math::RBFKernel::multiquadric, 3.0 },
+		{ math::RBFKernel::gaussian, 6.0 },
+		{ math::RBFKernel::wendland, 0.4 }
+	};
+
+	for (const Case& c : cases)
+	{
+		math::RBFInterpolator<double> rbf(x, y, c.kernel, c.shape);
+		rbf.build();
+
+		// interpolation conditions
+		math::Matrix<double> y_centers;
+		rbf.interpolateBatch(x, y_centers);
+		for (size_t i = 0; i < n; i += 7)
+		{
+			EXPECT_EQ(math::isEqual(y_centers(i, 0), y(i, 0), 1.e-6), true);
+		}
+
+		// approximation between centers
+		EXPECT_EQ(math::isEqual(rbf.interpolate({{0.5, 0.5}}), f(0.5, 0.5), 5.e-2), true);
+	}
+
+	// linear polynomial is reproduced exactly by thin plate spline
+	math::RBFInterpolator<double> tps(x, y_linear);
+	tps.build();
+	EXPECT_EQ(math::isEqual(tps.interpolate({{0.3, 0.8}}), g(0.3, 0.8), 1.e-8), true);
+	EXPECT_EQ(math::isEqual(tps.interpolate({{1.5, -0.5}}), g(1.5, -0.5), 1.e-8), true);
+
+	// Gaussian kernel gives symmetric positive definite system, so it can be solved by CG
+	math::LASsetup cg_setup;
+	cg_setup.targetTolerance = 1.e-10;
+	cg_setup.abort_iter = 10 * n;
+	math::CG<double> cg(cg_setup);
+	math::RBFInterpolator<double> gaussian(x, y, math::RBFKernel::gaussian, 12.0);
+	gaussian.setSolver(&cg);
+	gaussian.build();
+	for (size_t i = 0; i < n; i += 7)
+	{
+		EXPECT_EQ(math::isEqual(gaussian.interpolate({{x(i, 0), x(i, 1)}}), y(i, 0), 1.e-6), true);
+	}
+
+	EXPECT_THROW(math::RBFInterpolator<double>(x, y, math::RBFKernel::gaussian, 0.0), math::ExceptionInvalidValue);
+	math::RBFInterpolator<double> not_built(x, y);
+	EXPECT_THROW(not_built.interpolate({{0.5, 0.5}}), math::ExceptionInvalidValue);
+
+	// coincident centers make system singular
+	math::Matrix<double> x_twice = { {0.0, 0.0}, {1.0, 0.0}, {0.0, 1.0}, {1.0, 1.0}, {1.0, 1.0} };
+	math::Matrix<double> y_twice = { {0.0}, {1.0}, {1.0}, {2.0}, {2.0} };
+	math::RBFInterpolator<double> singular(x_twice, y_twice, math::RBFKernel::multiquadric, 1.0);
+	EXPECT_THROW(singular.build(), math::ExceptionDegenerateMatrix);
+}
+
+TEST(Interpolator, Mesh)
+{
+	// scattered points in unit square (Kronecker sequence) and its corners
+	size_t n = 300;
+	math::Matrix<double> x(n, 2);
+	for (size_t i = 0; i < n; ++i)
+	{
+		x(i, 0) = i < 4 ? static_cast<double>(i & 1) : std::fmod(0.5 + 0.7548776662 * static_cast<double>(i), 1.0);
+		x(i, 1) = i < 4 ? static_cast<double>(i >> 1) : std::fmod(0.5 + 0.5698402910 * static_cast<double>(i), 1.0);
+	}
+	auto f = [](double x0, double x1)
+	{
+		return std::sin(3.0 * x0) * std::cos(2.0 * x1);
+	};
+	auto g = [](double x0, double x1)
+	{
+		return 1.0 + 2.0 * x0 - 3.0 * x1;
+	};
+	math::Matrix<double> y(n, 1);
+	math::Matrix<double> y_linear(n, 1);
+	for (size_t i = 0; i < n; ++i)
+	{
+		y(i, 0) = f(x(i, 0), x(i, 1));
+		y_linear(i, 0) = g(x(i, 0), x(i, 1));
+	}
+
+	math::MeshInterpolator<double> mesh(x, y);
+	mesh.build();
+
+	// values in points and approximation between them
+	math::Matrix<double> y_points;
+	mesh.interpolateBatch(x, y_points);
+	for (size_t i = 0; i < n; ++i)
+	{
+		EXPECT_EQ(math::isEqual(y_points(i, 0), y(i, 0), 1.e-12), true);
+	}
+	EXPECT_EQ(math::isEqual(mesh.interpolate({{0.5, 0.5}}), f(0.5, 0.5), 2.e-2), true);
+
+	// coherent queries along line and random ones give the same values in batch and one by one
+	size_t queries = 2000;
+	math::Matrix<double> q_row(queries, 2);
+	math::Matrix<double> q_col(queries, 2, math::MatRep::Column);
+	for (size_t i = 0; i < queries; ++i)
+	{
+		double t = static_cast<double>(i) / static_cast<double>(queries);
+		q_row(i, 0) = i < queries / 2 ? 2.0 * t : std::fmod(0.3 + 0.618034 * static_cast<double>(i), 1.0);
+		q_row(i, 1) = i < queries / 2 ? 0.5 + 0.3 * std::sin(10.0 * t) : std::fmod(0.1 + 0.414214 * static_cast<double>(i), 1.0);
+		q_col(i, 0) = q_row(i, 0);
+		q_col(i, 1) = q_row(i, 1);
+	}
+	math::Matrix<double> y_row;
+	math::Matrix<double> y_col;
+	mesh.interpolateBatch(q_row, y_row);
+	mesh.interpolateBatch(q_col, y_col);
+	for (size_t i = 0; i < queries; i += 7)
+	{
+		double single = mesh.interpolate({{q_row(i, 0), q_row(i, 1)}});
+		EXPECT_EQ(math::isEqual(y_row(i, 0), single, 1.e-12), true);
+		EXPECT_EQ(math::isEqual(y_col(i, 0), single, 1.e-12), true);
+	}
+
+	// linear function is reproduced inside and outside of convex hull
+	math::MeshInterpolator<double> linear(x, y_linear);
+	linear.build();
+	EXPECT_EQ(math::isEqual(linear.interpolate({{0.3, 0.8}}), g(0.3, 0.8), 1.e-12), true);
+	EXPECT_EQ(math::isEqual(linear.interpolate({{1.5, -0.5}}), g(1.5, -0.5), 1.e-12), true);
+	EXPECT_EQ(math::isEqual(linear.interpolate({{-2.0, 0.5}}), g(-2.0, 0.5), 1.e-12), true);
+
+	// 3D: cube corners and interior points
+	size_t n3 = 60;
+	math::Matrix<double> x3(n3, 3);
+	math::Matrix<double> y3(n3, 1);
+	for (size_t i = 0; i < n3; ++i)
+	{
+		for (size_t k = 0; k < 3; ++k)
+		{
+			x3(i, k) = i < 8 ? static_cast<double>((i >> k) & 1) :
+				std::fmod(0.5 + (0.8191725134 + 0.1518 * static_cast<double>(k)) * static_cast<double>(i * (k + 1)), 1.0);
+		}
+		y3(i, 0) = 2.0 - x3(i, 0) + 0.5 * x3(i, 1) + 4.0 * x3(i, 2);
+	}
+	math::MeshInterpolator<double> mesh3(x3, y3);
+	mesh3.build();
+	EXPECT_EQ(math::isEqual(mesh3.interpolate({{0.25, 0.5, 0.75}}), 2.0 - 0.25 + 0.25 + 3.0, 1.e-12), true);
+	EXPECT_EQ(math::isEqual(mesh3.interpolate({{1.0, 1.0, 1.0}}), 5.5, 1.e-12), true);
+
+	math::MeshInterpolator<double> line(math::Matrix<double>(5, 1), math::Matrix<double>(5, 1));
+	EXPECT_THROW(line.build(), math::ExceptionInvalidValue);
+	math::MeshInterpolator<double> not_built(x, y);
+	EXPECT_THROW(not_built.interpolate({{0.5, 0.5}}), math::ExceptionInvalidValue);
+}
@@ -0,0 +1,321 @@
+#pragma once
+#include <libmath/interpolator/interpolator.h>
+#include <libmath/triangulator/iterative.h>
+#include <libmath/geometry/bvh.h>
+#include <libmath/geometry/kdtree.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <algorithm>
+
+namespace math
+{
+	/**
+	 * @brief Piecewise-linear interpolation on Delaunay triangulation of scattered points
+	 * @details Points x are triangulated in build() (see IterativeTriangulator), value in simplex with
+	 * vertices @f$ \mathbf{v}_0, ..., \mathbf{v}_n @f$ is
+	 * @f[
+	 * y(\mathbf{x}) = \sum_{l=0}^{n} \lambda_l(\mathbf{x}) y_l, \quad
+	 * \lambda_l(\mathbf{x}) = b_{l,0} + \sum_{k=1}^{n} b_{l,k} x_{k-1},
+	 * @f]
+	 * where @f$ \lambda_l @f$ are barycentric coordinates. Coefficients @f$ b @f$ and linear form of
+	 * y are precomputed for every simplex in flat arrays, so evaluation in found simplex takes
+	 * O(n) operations. Interpolant is continuous and reproduces linear functions exactly.
+	 *
+	 * Simplex is located by visibility walk from the last found one (across facet with the most
+	 * negative barycentric coordinate), so coherent queries take amortized O(1). Walks longer than
+	 * max_walk steps fall back to BVH location in O(log N). Points outside of convex hull of x are
+	 * extrapolated linearly from the boundary simplex, reached by walk from simplex of the nearest point.
+	 *
+	 * Only 2D and 3D points are supported.
+	 */
+	template <typename T>
+	class MeshInterpolator : public Interpolator<T>
+	{
+	public:
+		using index_type = uint32_t;
+
+		/// @brief Maximum length of walk from cached simplex
+		static constexpr size_t max_walk = 16;
+
+	private:
+		static constexpr index_type no_cell = std::numeric_limits<index_type>::max();
+
+		/// @brief Point indices of simplices, dim + 1 per simplex
+		std::vector<index_type> cells_;
+
+		/// @brief Neighbours of simplices, neighbour l is opposite to vertex l
+		std::vector<index_type> neighbours_;
+
+		/// @brief Barycentric coefficients b_{l,k}, (dim + 1) x (dim + 1) per simplex, row l is vertex l
+		std::vector<T> bary_;
+
+		/// @brief Linear form of value: free term followed by gradient, dim + 1 per simplex
+		std::vector<T> linear_;
+
+		/// @brief Simplex of every point, start of walk for points outside of hull
+		std::vector<index_type> start_;
+
+		/// @brief Spatial indices of simplices and points
+		BVH<T> bvh_;
+		KDTree<T> tree_;
+
+		/// @brief Simplex of the last interpolated point
+		mutable std::atomic<index_type> last_{ 0 };
+
+		size_t cellCount() const
+		{
+			return linear_.size() / (Interpolator<T>::dim_ + 1);
+		}
+
+		/// @brief Vertex with the smallest barycentric coordinate of point in simplex and this coordinate
+		T minBarycentric(index_type c, const T* x, size_t& vertex) const
+		{
+			size_t dim = Interpolator<T>::dim_;
+			const T* b = bary_.data() + static_cast<size_t>(c) * (dim + 1) * (dim + 1);
+			T min_lambda = std::numeric_limits<T>::max();
+			for (size_t l = 0; l <= dim; ++l)
+			{
+				const T* b_l = b + l * (dim + 1);
+				T lambda = b_l[0];
+				for (size_t k = 0; k < dim; ++k)
+				{
+					lambda += b_l[k + 1] * x[k];
+				}
+				if (lambda < min_lambda)
+				{
+					min_lambda = lambda;
+					vertex = l;
+				}
+			}
+			return min_lambda;
+		}
+
+		/**
+		* @brief Visibility walk
+		* @param[in, out] c: Start simplex, found simplex or boundary simplex, if point is outside of hull
+		* @param steps: Maximum number of steps
+		* @return True if point is in simplex c
+		*/
+		bool walk(const T* x, index_type& c, size_t steps) const
+		{
+			// linear interpolant is continuous, so points slightly outside of simplex are accepted
+			const T tolerance = static_cast<T>(64.0) * std::numeric_limits<T>::epsilon();
+			size_t dim = Interpolator<T>::dim_;
+			for (size_t s = 0; s < steps; ++s)
+			{
+				size_t vertex = 0;
+				if (minBarycentric(c, x, vertex) >= -tolerance)
+				{
+					return true;
+				}
+				index_type next = neighbours_[static_cast<size_t>(c) * (dim + 1) + vertex];
+				if (next == no_cell)
+				{
+					return false;
+				}
+				c = next;
+			}
+			return false;
+		}
+
+		/// @brief Find simplex of point, starting from hint, set hint to found simplex
+		index_type locate(const T* x, index_type& hint) const
+		{
+			index_type c = hint < cellCount() ? hint : 0;
+			if (!walk(x, c, max_walk))
+			{
+				c = bvh_.locate(x);
+				if (c == BVH<T>::no_cell)
+				{
+					// outside of hull: walk from simplex of the nearest point to boundary
+					std::vector<size_t> nearest;
+					std::vector<T> dist2;
+					tree_.nearest(x, 1, nearest, dist2);
+					c = start_[nearest[0]];
+					walk(x, c, cellCount());
+					return c;
+				}
+			}
+			hint = c;
+			return c;
+		}
+
+		T evaluate(const T* x, index_type& hint) const
+		{
+			size_t dim = Interpolator<T>::dim_;
+			const T* a = linear_.data() + static_cast<size_t>(locate(x, hint)) * (dim + 1);
+			T y = a[0];
+			for (size_t k = 0; k < dim; ++k)
+			{
+				y += a[k + 1] * x[k];
+			}
+			return y;
+		}
+
+	protected:
+		virtual void checkBuilt(const std::string& method) const override
+		{
+			if (linear_.empty())
+			{
+				throw(ExceptionInvalidValue("MeshInterpolator<T>::" + method + ": Interpolator isn't built!"));
+			}
+		}
+
+		virtual void interpolateRows(const T* x, size_t rows, bool row_major, size_t first, size_t last, T* y) const override
+		{
+			size_t dim = Interpolator<T>::dim_;
+			index_type hint = last_.load(std::memory_order_relaxed);
+			T point[3];
+			for (size_t i = first; i < last; ++i)
+			{
+				for (size_t k = 0; k < dim; ++k)
+				{
+					point[k] = row_major ? x[i * dim + k] : x[k * rows + i];
+				}
+				y[i] = evaluate(point, hint);
+			}
+			last_.store(hint, std::memory_order_relaxed);
+		}
+
+	public:
+		MeshInterpolator() : Interpolator<T>("Mesh") {};
+
+		/**
+		* @brief MeshInterpolator constructor
+		* @param x: Points, one per row (2 or 3 columns)
+		* @param y: Values in points, column vector
+		*/
+		MeshInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) : Interpolator<T>("Mesh", x, y) {};
+
+		virtual ~MeshInterpolator() {};
+
+		/**
+		* @brief Triangulate points and evaluate coefficients of simplices
+		* @throws math::ExceptionInvalidValue if points aren't 2D or 3D or lie in hyperplane
+		*/
+		virtual void build() override
+		{
+			const Matrix<T>& x = Interpolator<T>::x_;
+			const Matrix<T>& y = Interpolator<T>::y_;
+			size_t dim = Interpolator<T>::dim_;
+			if (dim != 2 && dim != 3)
+			{
+				throw(ExceptionInvalidValue("MeshInterpolator<T>::build: Only 2D and 3D points are supported!"));
+			}
+
+			IterativeTriangulator<T> triangulator(x);
+			triangulator.triangulate();
+			triangulator.getSimplices(cells_);
+			triangulator.getNeighbours(neighbours_);
+
+			size_t v = dim + 1;
+			size_t cells = cells_.size() / v;
+			bary_.resize(cells * v * v);
+			linear_.resize(cells * v);
+			long long n = static_cast<long long>(cells);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (n > blas::omp_threshold)
+#endif
+			for (long long c = 0; c < n; ++c)
+			{
+				const index_type* nodes = cells_.data() + static_cast<size_t>(c) * v;
+
+				// edges e_k = v_k - v_0, lambda_{1..n} = E^{-1} (x - v_0), E^{-1} by adjugate
+				T e[3][3];
+				for (size_t k = 0; k < dim; ++k)
+				{
+					for (size_t j = 0; j < dim; ++j)
+					{
+						e[j][k] = x(nodes[k + 1], j) - x(nodes[0], j);
+					}
+				}
+				T inv[3][3];
+				if (dim == 2)
+				{
+					T det = e[0][0] * e[1][1] - e[0][1] * e[1][0];
+					inv[0][0] = e[1][1] / det;
+					inv[0][1] = -e[0][1] / det;
+					inv[1][0] = -e[1][0] / det;
+					inv[1][1] = e[0][0] / det;
+				}
+				else
+				{
+					T det = e[0][0] * (e[1][1] * e[2][2] - e[1][2] * e[2][1]) -
+						e[0][1] * (e[1][0] * e[2][2] - e[1][2] * e[2][0]) +
+						e[0][2] * (e[1][0] * e[2][1] - e[1][1] * e[2][0]);
+					for (size_t r = 0; r < 3; ++r)
+					{
+						for (size_t s = 0; s < 3; ++s)
+						{
+							// cofactor of e[s][r]
+							size_t s1 = (s + 1) % 3, s2 = (s + 2) % 3;
+							size_t r1 = (r + 1) % 3, r2 = (r + 2) % 3;
+							inv[r][s] = (e[s1][r1] * e[s2][r2] - e[s1][r2] * e[s2][r1]) / det;
+						}
+					}
+				}
+
+				T* b = bary_.data() + static_cast<size_t>(c) * v * v;
+				T* a = linear_.data() + static_cast<size_t>(c) * v;
+				std::fill(b, b + v * v, static_cast<T>(0.0));
+				b[0] = static_cast<T>(1.0);
+				for (size_t l = 1; l < v; ++l)
+				{
+					T* b_l = b + l * v;
+					for (size_t k = 0; k < dim; ++k)
+					{
+						b_l[k + 1] = inv[l - 1][k];
+						b_l[0] -= inv[l - 1][k] * x(nodes[0], k);
+						b[k + 1] -= b_l[k + 1];
+					}
+					b[0] -= b_l[0];
+				}
+				std::fill(a, a + v, static_cast<T>(0.0));
+				for (size_t l = 0; l < v; ++l)
+				{
+					T y_l = y(nodes[l], 0);
+					for (size_t k = 0; k < v; ++k)
+					{
+						a[k] += b[l * v + k] * y_l;
+					}
+				}
+			}
+
+			start_.assign(x.rows(), 0);
+			for (size_t c = 0; c < cells; ++c)
+			{
+				for (size_t l = 0; l < v; ++l)
+				{
+					start_[cells_[c * v + l]] = static_cast<index_type>(c);
+				}
+			}
+			bvh_ = BVH<T>(x, cells_);
+			tree_ = KDTree<T>(x);
+			last_.store(0, std::memory_order_relaxed);
+		}
+
+		virtual T interpolate(const Matrix<T>& x) const override
+		{
+			if (x.cols() != Interpolator<T>::dim_ || x.rows() != 1)
+			{
+				throw(ExceptionNonRowVector(
+					"MeshInterpolator<T>::interpolate: Vector x of independent variables must be the row-vector of " +
+					std::to_string(Interpolator<T>::dim_) + " elements!"));
+			}
+			checkBuilt("interpolate");
+			T point[3];
+			for (size_t k = 0; k < x.cols(); ++k)
+			{
+				point[k] = x(0, k);
+			}
+			index_type hint = last_.load(std::memory_order_relaxed);
+			T y = evaluate(point, hint);
+			last_.store(hint, std::memory_order_relaxed);
+			return y;
+		}
+	};
+}
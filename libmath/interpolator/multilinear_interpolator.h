@@ -0,0 +1,365 @@
+#pragma once
+#include <libmath/interpolator/interpolator.h>
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math
+{
+	/**
+	 * @brief Multilinear interpolation on N-dimension rectilinear grid
+	 * @details Grid is defined by N axes with @f$ n_k \ge 2 @f$ sorted nodes each, values are given in
+	 * all @f$ \prod n_k @f$ grid nodes. Point @f$ \mathbf{x} @f$ is located in the grid cell
+	 * @f$ [a_{k,i_k}, a_{k,i_k+1}] @f$ on each axis, and value is interpolated by successive linear
+	 * interpolation along axes between @f$ 2^N @f$ cell corners
+	 * @f[
+	 * y = \sum_{\mathbf{c} \in \{0,1\}^N} y_{\mathbf{i}+\mathbf{c}} \prod_k \left( c_k t_k + (1 - c_k)(1 - t_k) \right),
+	 * \quad t_k = \frac{x_k - a_{k,i_k}}{a_{k,i_k+1} - a_{k,i_k}}.
+	 * @f]
+	 * Cell on uniform axis is found in O(1), on non-uniform one by binary search in O(log n_k).
+	 * Points outside of the grid are extrapolated linearly from boundary cells.
+	 *
+	 * Values are stored in row-major order of grid nodes (the last axis is contiguous), so
+	 * corners of cell along the last axis are adjacent in memory.
+	 *
+	 * Grid can be given explicitly (axes and values) or by scattered points x, y, which must
+	 * cover all nodes of a rectilinear grid in any order.
+	 */
+	template <typename T>
+	class MultiLinearInterpolator : public Interpolator<T>
+	{
+	private:
+		/// @brief Nodes of grid axes
+		std::vector<std::vector<T>> axes_;
+
+		/// @brief Values in grid nodes, row-major
+		std::vector<T> values_;
+
+		/// @brief Strides of axes in values_
+		std::vector<size_t> strides_;
+
+		/// @brief Uniform axes flags
+		std::vector<char> uniform_;
+
+		/// @brief Inverse steps of uniform axes
+		std::vector<T> inv_step_;
+
+		/// @brief True, if grid is defined by scattered points
+		bool from_points_ = false;
+
+		/// @brief Maximum number of dimensions, which cell corners are kept on stack by interpolate()
+		static constexpr size_t stack_dim = 8;
+
+		/// @brief Build axes and values from scattered points
+		void gridFromPoints()
+		{
+			const Matrix<T>& x = Interpolator<T>::x_;
+			const Matrix<T>& y = Interpolator<T>::y_;
+			size_t dim = Interpolator<T>::dim_;
+			size_t points = x.rows();
+
+			axes_.assign(dim, std::vector<T>());
+			size_t nodes = 1;
+			for (size_t k = 0; k < dim; ++k)
+			{
+				std::vector<T>& axis = axes_[k];
+				axis.resize(points);
+				for (size_t i = 0; i < points; ++i)
+				{
+					axis[i] = x(i, k);
+				}
+				std::sort(axis.begin(), axis.end());
+				axis.erase(std::unique(axis.begin(), axis.end()), axis.end());
+				nodes *= axis.size();
+			}
+			if (nodes != points)
+			{
+				throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+					")::build: Points don't form rectilinear grid!"));
+			}
+
+			size_t stride = 1;
+			strides_.assign(dim, 0);
+			for (size_t k = dim; k-- > 0;)
+			{
+				strides_[k] = stride;
+				stride *= axes_[k].size();
+			}
+
+			values_.assign(nodes, static_cast<T>(0.0));
+			std::vector<char> filled(nodes, 0);
+			for (size_t i = 0; i < points; ++i)
+			{
+				size_t pos = 0;
+				for (size_t k = 0; k < dim; ++k)
+				{
+					const std::vector<T>& axis = axes_[k];
+					pos += strides_[k] * static_cast<size_t>(
+						std::lower_bound(axis.begin(), axis.end(), x(i, k)) - axis.begin());
+				}
+				if (filled[pos])
+				{
+					throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+						")::build: Points don't form rectilinear grid!"));
+				}
+				filled[pos] = 1;
+				values_[pos] = y(i, 0);
+			}
+		}
+
+		/// @brief Check grid and precompute strides and uniform steps
+		void prepare()
+		{
+			size_t dim = axes_.size();
+			size_t nodes = 1;
+			strides_.assign(dim, 0);
+			uniform_.assign(dim, 0);
+			inv_step_.assign(dim, static_cast<T>(0.0));
+			for (size_t k = dim; k-- > 0;)
+			{
+				const std::vector<T>& axis = axes_[k];
+				if (axis.size() < 2)
+				{
+					throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+						"): Each axis must have at least 2 nodes!"));
+				}
+				for (size_t i = 1; i < axis.size(); ++i)
+				{
+					if (!(axis[i] > axis[i - 1]))
+					{
+						throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+							"): Axis nodes must be strictly increasing!"));
+					}
+				}
+
+				T step = (axis.back() - axis.front()) / static_cast<T>(axis.size() - 1);
+				T tol = static_cast<T>(8.0) * std::numeric_limits<T>::epsilon() *
+					(std::abs(axis.front()) + std::abs(axis.back()));
+				bool uniform = true;
+				for (size_t i = 1; i + 1 < axis.size() && uniform; ++i)
+				{
+					uniform = std::abs(axis[i] - (axis.front() + static_cast<T>(i) * step)) <= tol;
+				}
+				uniform_[k] = uniform;
+				inv_step_[k] = static_cast<T>(1.0) / step;
+
+				strides_[k] = nodes;
+				nodes *= axis.size();
+			}
+			if (values_.size() != nodes)
+			{
+				throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+					"): Number of values must be equal to number of grid nodes (" + std::to_string(nodes) + ")!"));
+			}
+		}
+
+		/**
+		* @brief Interpolate value in point
+		* @param x: Point coordinates, coordinate k is x[k * stride]
+		* @param stride: Stride of coordinates
+		* @param corners: Workspace of 2^N values
+		*/
+		T evaluate(const T* x, size_t stride, T* corners) const
+		{
+			size_t dim = axes_.size();
+			size_t base = 0;
+
+			// local coordinates in cell
+			T t[max_dim];
+			for (size_t k = 0; k < dim; ++k)
+			{
+				const std::vector<T>& axis = axes_[k];
+				T xk = x[k * stride];
+				size_t last = axis.size() - 2;
+				size_t i = 0;
+				if (uniform_[k])
+				{
+					T s = (xk - axis.front()) * inv_step_[k];
+					// clamp before conversion, which is undefined for NaN and out of range values,
+					// NaN goes to the first cell
+					if (s >= static_cast<T>(last))
+					{
+						i = last;
+					}
+					else if (s > static_cast<T>(0.0))
+					{
+						i = static_cast<size_t>(s);
+					}
+					t[k] = s - static_cast<T>(i);
+				}
+				else
+				{
+					size_t ub = static_cast<size_t>(std::upper_bound(axis.begin(), axis.end(), xk) - axis.begin());
+					i = ub == 0 ? 0 : std::min(ub - 1, last);
+					t[k] = (xk - axis[i]) / (axis[i + 1] - axis[i]);
+				}
+				base += i * strides_[k];
+			}
+
+			// corner c has bit k set if it's upper node on axis k
+			size_t n_corners = size_t(1) << dim;
+			for (size_t c = 0; c < n_corners; ++c)
+			{
+				size_t pos = base;
+				for (size_t k = 0; k < dim; ++k)
+				{
+					pos += ((c >> k) & 1) * strides_[k];
+				}
+				corners[c] = values_[pos];
+			}
+
+			// successive linear interpolation from the highest axis
+			for (size_t k = dim; k-- > 0;)
+			{
+				size_t half = size_t(1) << k;
+				T tk = t[k];
+				for (size_t c = 0; c < half; ++c)
+				{
+					corners[c] += tk * (corners[c + half] - corners[c]);
+				}
+			}
+			return corners[0];
+		}
+
+	protected:
+		virtual void checkBuilt(const std::string& method) const override
+		{
+			if (values_.empty())
+			{
+				throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+					")::" + method + ": Interpolator isn't built!"));
+			}
+		}
+
+		virtual void interpolateRows(const T* x, size_t rows, bool row_major, size_t first, size_t last, T* y) const override
+		{
+			size_t dim = axes_.size();
+			size_t stride = row_major ? 1 : rows;
+			std::vector<T> corners(size_t(1) << dim);
+			for (size_t i = first; i < last; ++i)
+			{
+				const T* point = row_major ? x + i * dim : x + i;
+				y[i] = evaluate(point, stride, corners.data());
+			}
+		}
+
+		MultiLinearInterpolator(const std::string& method) : Interpolator<T>(method) {};
+
+		MultiLinearInterpolator(const std::string& method, const math::Matrix<T>& x, const math::Matrix<T>& y) :
+			Interpolator<T>(method, x, y),
+			from_points_(true)
+		{
+		};
+
+		MultiLinearInterpolator(const std::string& method, const std::vector<std::vector<T>>& axes, const std::vector<T>& values) :
+			Interpolator<T>(method),
+			axes_(axes),
+			values_(values)
+		{
+			Interpolator<T>::dim_ = axes_.size();
+			if (axes_.empty() || axes_.size() > max_dim)
+			{
+				throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + method + "): Number of axes must be in [1, " +
+					std::to_string(max_dim) + "]!"));
+			}
+			prepare();
+		};
+
+	public:
+		/// @brief Maximum number of dimensions
+		static constexpr size_t max_dim = 20;
+
+		MultiLinearInterpolator() : MultiLinearInterpolator("MultiLinear") {};
+
+		/**
+		* @brief Constructor from scattered points, forming rectilinear grid
+		* @param x: Points, one per row
+		* @param y: Values in points, column vector
+		*/
+		MultiLinearInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) :
+			MultiLinearInterpolator("MultiLinear", x, y)
+		{
+		};
+
+		/**
+		* @brief Constructor from grid
+		* @param axes: Strictly increasing nodes of each axis
+		* @param values: Values in grid nodes, row-major (the last axis is contiguous)
+		*/
+		MultiLinearInterpolator(const std::vector<std::vector<T>>& axes, const std::vector<T>& values) :
+			MultiLinearInterpolator("MultiLinear", axes, values)
+		{
+		};
+
+		virtual ~MultiLinearInterpolator() {};
+
+		/**
+		* @brief Build grid
+		* @throws math::ExceptionInvalidValue if points don't form rectilinear grid
+		*/
+		virtual void build() override
+		{
+			if (from_points_)
+			{
+				if (Interpolator<T>::dim_ == 0 || Interpolator<T>::dim_ > max_dim)
+				{
+					throw(ExceptionInvalidValue("MultiLinearInterpolator<T> (" + Interpolator<T>::method_ +
+						")::build: Number of dimensions must be in [1, " + std::to_string(max_dim) + "]!"));
+				}
+			}
+			try
+			{
+				if (from_points_)
+				{
+					gridFromPoints();
+				}
+				prepare();
+			}
+			catch (...)
+			{
+				// interpolator isn't built after failed build
+				values_.clear();
+				throw;
+			}
+		}
+
+		virtual T interpolate(const Matrix<T>& x) const override
+		{
+			if (x.cols() != Interpolator<T>::dim_ || x.rows() != 1)
+			{
+				throw(ExceptionNonRowVector(
+					"MultiLinearInterpolator<T> (" + Interpolator<T>::method_ + ")::interpolate: Vector x of independent variables must be the row-vector of " +
+					std::to_string(Interpolator<T>::dim_) + " elements!"));
+			}
+			checkBuilt("interpolate");
+
+			T stack_corners[size_t(1) << stack_dim];
+			if (axes_.size() <= stack_dim)
+			{
+				return evaluate(x.data(), 1, stack_corners);
+			}
+			std::vector<T> corners(size_t(1) << axes_.size());
+			return evaluate(x.data(), 1, corners.data());
+		}
+
+		/**
+		* @brief Get grid
+		* @param[out] axes: Nodes of axes
+		* @param[out] values: Values in grid nodes, row-major
+		*/
+		void getGrid(std::vector<std::vector<T>>& axes, std::vector<T>& values) const
+		{
+			axes = axes_;
+			values = values_;
+		}
+	};
+}
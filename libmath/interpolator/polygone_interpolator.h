@@ -1,7 +1,9 @@
 #pragma once
 #include <libmath/interpolator/interpolator.h>
 #include <libmath/matrix.h>
+#include <libmath/solver/las/tsqr.h>
 #include <libmath/math_exception.h>
+#include <algorithm>
 
 namespace math
 {
@@ -31,39 +33,102 @@ namespace math
      * @f]
      * Solution of this system with respect to the @f$ \mathbf{C} @f$ produce vector of interpolation coeeficients.
      * Finally, interpolated value of @f$ y @f$ may be calculated, using @f$ \mathbf{C} @f$ and equation (3).
+     *
+     * If number of points exceeds @f$ n + 1 @f$, system (4) is overdetermined and @f$ \mathbf{C} @f$ is
+     * found in least squares sense by tall-skinny QR (see TSQR), rows of (4) are streamed from
+     * points without forming the system matrix. Cost is @f$ O(N n^2) @f$ for @f$ N @f$ points.
      * @author Ilya Konovalov
      */
     template <typename T>
     class PolygoneInterpolator : public Interpolator<T>
     {
     private:
-        /// @brief Matrix of data coefficients (independent variables points)
-        Matrix<T> A_;
-
-        /// @brief Vector of data free terms (dependent variables points)
-        Matrix<T> b_;
-
         /// @brief Vector of interpolation coefficients
         Matrix<T> c_;
 
-    public:
-        PolygoneInterpolator() : Interpolator<T>("Polygone") {};
+    protected:
+        virtual void checkBuilt(const std::string& method) const override
+        {
+            if (c_.empty())
+            {
+                throw(ExceptionInvalidValue("PolygoneInterpolator<T>::" + method + ": Interpolator isn't built!"));
+            }
+        }
 
-        PolygoneInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) : Interpolator<T>("Polygone", x, y)
+        virtual void interpolateRows(const T* x, size_t rows, bool row_major, size_t first, size_t last, T* y) const override
         {
+            size_t dim = Interpolator<T>::dim_;
+            const T* c = c_.data();
+            T free_term = -c[dim];
+
+            if (row_major)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const T* x_i = x + i * dim;
+                    T y_i = free_term;
+                    for (size_t j = 0; j < dim; ++j)
+                    {
+                        y_i -= x_i[j] * c[j];
+                    }
+                    y[i] = y_i;
+                }
+            }
+            else
+            {
+                // points are contiguous along each coordinate, loop over points is vectorized
+                std::fill(y + first, y + last, free_term);
+                for (size_t j = 0; j < dim; ++j)
+                {
+                    const T* x_j = x + j * rows;
+                    T c_j = c[j];
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        y[i] -= x_j[i] * c_j;
+                    }
+                }
+            }
+        }
 
-            size_t rows = x.rows();
+    public:
+        PolygoneInterpolator() : Interpolator<T>("Polygone") {};
 
-            A_ = cat(std::vector<math::Matrix<T>>{x, static_cast<T>(1.0) + Matrix<T>(rows, 1)}, Dimension::Column);
-            b_ = static_cast<T>(-1.0) * y;
-            c_ = Matrix<T>(rows, 1);
-        };
+        PolygoneInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y) : Interpolator<T>("Polygone", x, y) {};
 
         virtual ~PolygoneInterpolator(){};
 
+        /**
+         * @brief Evaluate interpolation coefficients
+         * @throws math::ExceptionDegenerateMatrix if points don't define unique hyperplane
+         * (less than dimension + 1 points or points lie in lower dimension plane)
+         */
         virtual void build() override
         {
-            Interpolator<T>::solver_->solve(A_, b_, c_);
+            const Matrix<T>& x = Interpolator<T>::x_;
+            const Matrix<T>& y = Interpolator<T>::y_;
+            size_t dim = Interpolator<T>::dim_;
+
+            if (x.rows() < dim + 1)
+            {
+                throw(ExceptionDegenerateMatrix(
+                    "PolygoneInterpolator<T>::build: At least " + std::to_string(dim + 1) + " points are required!"));
+            }
+
+            // rows of system (4): [x_i, 1 | -y_i]
+            const T* x_data = x.data();
+            const T* y_data = y.data();
+            size_t points = x.rows();
+            bool row_major = x.representation() == MatRep::Row;
+            TSQR<T> qr = TSQR<T>::factorize(points, dim + 1, 1, [=](size_t i, T* row)
+                {
+                    for (size_t j = 0; j < dim; ++j)
+                    {
+                        row[j] = row_major ? x_data[i * dim + j] : x_data[j * points + i];
+                    }
+                    row[dim] = static_cast<T>(1.0);
+                    row[dim + 1] = -y_data[i];
+                });
+            c_ = qr.solve();
         }
 
 		virtual T interpolate(const Matrix<T>& x) const override
@@ -74,6 +139,7 @@ namespace math
                     "PolygoneInterpolator<T>::interpolate: Vector x of independent variables must be the row-vector of " +
                     std::to_string(Interpolator<T>::dim_) + " elements!"));
             }
+            checkBuilt("interpolate");
 
             T y{-c_(c_.rows() - 1, 0)};
             for (size_t j = 0; j < x.cols(); ++j)
@@ -0,0 +1,438 @@
+#pragma once
+#include <libmath/interpolator/interpolator.h>
+#include <libmath/geometry/kdtree.h>
+#include <libmath/solver/las/krylov.h>
+#include <libmath/solver/las/gmres.h>
+#include <libmath/blas.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <algorithm>
+
+namespace math
+{
+	/// @brief Radial basis functions @f$ \varphi(r) @f$
+	enum class RBFKernel
+	{
+		/// @brief Thin plate spline @f$ r^2 \ln r @f$
+		thin_plate,
+
+		/// @brief Multiquadric @f$ \sqrt{1 + (\varepsilon r)^2} @f$
+		multiquadric,
+
+		/// @brief Gaussian @f$ e^{-(\varepsilon r)^2} @f$
+		gaussian,
+
+		/// @brief Compactly supported Wendland @f$ C^2 @f$ function @f$ (1 - r/\rho)_+^4 (4 r/\rho + 1) @f$
+		wendland
+	};
+
+	/**
+	 * @brief Scattered data interpolation with radial basis functions
+	 * @details Interpolant is
+	 * @f[
+	 * s(\mathbf{x}) = \sum_{i=1}^{N} w_i \varphi(|\mathbf{x} - \mathbf{x}_i|) + p(\mathbf{x}),
+	 * @f]
+	 * where @f$ p @f$ is linear polynomial for conditionally positive definite kernels (thin plate
+	 * spline, multiquadric) and zero for positive definite ones (Gaussian, Wendland). Weights are
+	 * found from interpolation conditions @f$ s(\mathbf{x}_i) = y_i @f$ and orthogonality of
+	 * weights to polynomials:
+	 * @f[
+	 * \begin{bmatrix} \mathbf{\Phi} & \mathbf{P} \\ \mathbf{P}^T & 0 \end{bmatrix}
+	 * \begin{bmatrix} \mathbf{w} \\ \mathbf{c} \end{bmatrix} =
+	 * \begin{bmatrix} \mathbf{y} \\ 0 \end{bmatrix}.
+	 * @f]
+	 * Dense system of global kernels is solved by interpolator's LAS solver. By default it's full GMRES
+	 * (restart equal to system dimension), because the polynomial block makes system indefinite with
+	 * zero diagonal, so Cholesky and CG are not applicable. Other solver can be set by setSolver(),
+	 * e.g. CG for Gaussian kernel, which gives symmetric positive definite system. For Wendland
+	 * kernel @f$ \mathbf{\Phi} @f$ is sparse and symmetric positive definite: it's assembled in CSR
+	 * form from k-d tree radius queries and solved by krylov::cg directly, because LAS solvers take
+	 * dense matrices only, which would cost O(N^2) memory.
+	 *
+	 * Evaluation uses k-d tree for kernels with bounded support: Wendland (support radius
+	 * @f$ \rho @f$) and Gaussian (truncated where @f$ \varphi @f$ falls below machine epsilon), so
+	 * it takes O(log N + m) for m centers in support. Thin plate spline and multiquadric grow with
+	 * distance, they are evaluated directly in O(N).
+	 */
+	template <typename T>
+	class RBFInterpolator : public Interpolator<T>
+	{
+	private:
+		RBFKernel kernel_ = RBFKernel::thin_plate;
+
+		/// @brief Shape parameter: @f$ \varepsilon @f$ for multiquadric and Gaussian, support radius @f$ \rho @f$ for Wendland
+		T shape_ = static_cast<T>(1.0);
+
+		/// @brief Centers, row-major
+		std::vector<T> centers_;
+
+		/// @brief Weights of centers
+		std::vector<T> weights_;
+
+		/// @brief Coefficients of linear polynomial: free term followed by coefficients of coordinates
+		std::vector<T> poly_;
+
+		/// @brief Spatial index of centers
+		KDTree<T> tree_;
+
+		/// @brief Radius of kernel support for evaluation (0 if unbounded)
+		T support_ = static_cast<T>(0.0);
+
+		/// @brief Relative tolerance of iterative solvers
+		T tolerance_ = static_cast<T>(1.e-10);
+
+		/// @brief LAS solver was set by setSolver(), so its settings are kept
+		bool user_solver_ = false;
+
+		bool hasPolynomial() const
+		{
+			return kernel_ == RBFKernel::thin_plate || kernel_ == RBFKernel::multiquadric;
+		}
+
+		/// @brief Kernel of squared distance
+		T phi(T r2) const
+		{
+			switch (kernel_)
+			{
+			case RBFKernel::thin_plate:
+				return r2 > static_cast<T>(0.0) ? static_cast<T>(0.5) * r2 * std::log(r2) : static_cast<T>(0.0);
+			case RBFKernel::multiquadric:
+				return std::sqrt(static_cast<T>(1.0) + shape_ * shape_ * r2);
+			case RBFKernel::gaussian:
+				return std::exp(-shape_ * shape_ * r2);
+			case RBFKernel::wendland:
+			default:
+			{
+				T q = std::sqrt(r2) / shape_;
+				if (q >= static_cast<T>(1.0))
+				{
+					return static_cast<T>(0.0);
+				}
+				T a = static_cast<T>(1.0) - q;
+				T a2 = a * a;
+				return a2 * a2 * (static_cast<T>(4.0) * q + static_cast<T>(1.0));
+			}
+			}
+		}
+
+		/// @brief Evaluate interpolant in point with contiguous coordinates
+		T evaluate(const T* x) const
+		{
+			size_t dim = Interpolator<T>::dim_;
+			T y = static_cast<T>(0.0);
+			if (support_ > static_cast<T>(0.0))
+			{
+				tree_.forEachInRadius(x, support_, [this, &y](size_t i, T r2)
+					{
+						y += weights_[i] * phi(r2);
+					});
+			}
+			else
+			{
+				size_t n = weights_.size();
+				for (size_t i = 0; i < n; ++i)
+				{
+					const T* c = centers_.data() + i * dim;
+					T r2 = static_cast<T>(0.0);
+					for (size_t k = 0; k < dim; ++k)
+					{
+						T d = x[k] - c[k];
+						r2 += d * d;
+					}
+					y += weights_[i] * phi(r2);
+				}
+			}
+			if (!poly_.empty())
+			{
+				y += poly_[0];
+				for (size_t k = 0; k < dim; ++k)
+				{
+					y += poly_[k + 1] * x[k];
+				}
+			}
+			return y;
+		}
+
+		void buildDense()
+		{
+			size_t n = weights_.size();
+			size_t dim = Interpolator<T>::dim_;
+			size_t p = hasPolynomial() ? dim + 1 : 0;
+			size_t size = n + p;
+
+			Matrix<T> A(size, size, static_cast<T>(0.0), MatRep::Row);
+			T* a = A.data();
+			for (size_t i = 0; i < n; ++i)
+			{
+				const T* x_i = centers_.data() + i * dim;
+				for (size_t j = i; j < n; ++j)
+				{
+					const T* x_j = centers_.data() + j * dim;
+					T r2 = static_cast<T>(0.0);
+					for (size_t k = 0; k < dim; ++k)
+					{
+						T d = x_i[k] - x_j[k];
+						r2 += d * d;
+					}
+					a[i * size + j] = a[j * size + i] = phi(r2);
+				}
+				if (p > 0)
+				{
+					a[i * size + n] = a[n * size + i] = static_cast<T>(1.0);
+					for (size_t k = 0; k < dim; ++k)
+					{
+						a[i * size + n + 1 + k] = a[(n + 1 + k) * size + i] = x_i[k];
+					}
+				}
+			}
+
+			Matrix<T> b(size, 1);
+			Matrix<T> c(size, 1);
+			for (size_t i = 0; i < n; ++i)
+			{
+				b(i, 0) = Interpolator<T>::y_(i, 0);
+			}
+
+			LASsolver<T>& solver = *Interpolator<T>::solver_;
+			if (!user_solver_)
+			{
+				LASsetup setup;
+				setup.targetTolerance = tolerance_ * std::max(blas::nrm2(n, b.data()), static_cast<T>(1.0));
+				setup.restart = size;
+				setup.abort_iter = 2 * size;
+				solver.setupSolver(setup);
+			}
+			solver.solve(A, b, c);
+
+			for (size_t i = 0; i < n; ++i)
+			{
+				weights_[i] = c(i, 0);
+			}
+			poly_.assign(p, static_cast<T>(0.0));
+			for (size_t i = 0; i < p; ++i)
+			{
+				poly_[i] = c(n + i, 0);
+			}
+		}
+
+		void buildSparse()
+		{
+			size_t n = weights_.size();
+			size_t dim = Interpolator<T>::dim_;
+
+			// CSR matrix of kernel values within support radius
+			std::vector<size_t> row_ptr(n + 1, 0);
+			std::vector<size_t> cols;
+			std::vector<T> vals;
+			for (size_t i = 0; i < n; ++i)
+			{
+				tree_.forEachInRadius(centers_.data() + i * dim, shape_, [&](size_t j, T r2)
+					{
+						cols.push_back(j);
+						vals.push_back(phi(r2));
+					});
+				row_ptr[i + 1] = cols.size();
+			}
+
+			auto op = [&](const T* in, T* out)
+			{
+				long long rows = static_cast<long long>(n);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (static_cast<long long>(vals.size()) > blas::omp_threshold)
+#endif
+				for (long long i = 0; i < rows; ++i)
+				{
+					T sum = static_cast<T>(0.0);
+					for (size_t e = row_ptr[i]; e < row_ptr[i + 1]; ++e)
+					{
+						sum += vals[e] * in[cols[e]];
+					}
+					out[i] = sum;
+				}
+			};
+
+			std::vector<T> b(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				b[i] = Interpolator<T>::y_(i, 0);
+			}
+			T tol = tolerance_ * std::max(blas::nrm2(n, b.data()), static_cast<T>(1.0));
+			std::fill(weights_.begin(), weights_.end(), static_cast<T>(0.0));
+			krylov::Result<T> res = krylov::cg(op, n, b.data(), weights_.data(), tol, std::max<size_t>(n, 100));
+			if (!res.converged)
+			{
+				throw(ExceptionTooManyIterations("RBFInterpolator<T>::build: Conjugate gradient method didn't converge!"));
+			}
+			poly_.clear();
+		}
+
+	protected:
+		virtual void checkBuilt(const std::string& method) const override
+		{
+			if (weights_.empty())
+			{
+				throw(ExceptionInvalidValue("RBFInterpolator<T>::" + method + ": Interpolator isn't built!"));
+			}
+		}
+
+		virtual void interpolateRows(const T* x, size_t rows, bool row_major, size_t first, size_t last, T* y) const override
+		{
+			size_t dim = Interpolator<T>::dim_;
+			std::vector<T> point(dim);
+			for (size_t i = first; i < last; ++i)
+			{
+				if (row_major)
+				{
+					y[i] = evaluate(x + i * dim);
+					continue;
+				}
+				for (size_t k = 0; k < dim; ++k)
+				{
+					point[k] = x[k * rows + i];
+				}
+				y[i] = evaluate(point.data());
+			}
+		}
+
+	public:
+		RBFInterpolator() : Interpolator<T>("RBF")
+		{
+			Interpolator<T>::solver_.reset(new GMRES<T>());
+		};
+
+		/**
+		* @brief RBFInterpolator constructor
+		* @param x: Centers, one per row
+		* @param y: Values in centers, column vector
+		* @param kernel: Radial basis function
+		* @param shape: @f$ \varepsilon @f$ for multiquadric and Gaussian kernels, support radius
+		* @f$ \rho @f$ for Wendland kernel, not used by thin plate spline
+		* @throws math::ExceptionInvalidValue if shape isn't positive
+		*/
+		RBFInterpolator(const math::Matrix<T>& x, const math::Matrix<T>& y,
+			RBFKernel kernel = RBFKernel::thin_plate, T shape = static_cast<T>(1.0)) :
+			Interpolator<T>("RBF", x, y),
+			kernel_(kernel),
+			shape_(shape)
+		{
+			if (!(shape_ > static_cast<T>(0.0)))
+			{
+				throw(ExceptionInvalidValue("RBFInterpolator<T>: Shape parameter must be positive!"));
+			}
+			Interpolator<T>::solver_.reset(new GMRES<T>());
+		};
+
+		virtual ~RBFInterpolator() {};
+
+		/**
+		* @brief Set LAS solver of dense system (global kernels)
+		* @details Solver is copied, its settings are used as is. Solver must handle indefinite
+		* systems for thin plate spline and multiquadric kernels.
+		* @param solver: LAS solver
+		*/
+		void setSolver(LASsolver<T>* solver)
+		{
+			Interpolator<T>::solver_.reset(solver->copy());
+			user_solver_ = true;
+		}
+
+		/**
+		* @brief Set relative tolerance of iterative solvers
+		* @details Used for Wendland kernel and for default LAS solver of dense system
+		* @param tolerance: Tolerance, relative to norm of values
+		*/
+		void setTolerance(T tolerance)
+		{
+			if (!(tolerance > static_cast<T>(0.0)))
+			{
+				throw(ExceptionInvalidValue("RBFInterpolator<T>::setTolerance: Tolerance must be positive!"));
+			}
+			tolerance_ = tolerance;
+		}
+
+		/**
+		* @brief Evaluate weights
+		* @throws math::ExceptionDegenerateMatrix if centers coincide, or there are not enough centers
+		* for polynomial term
+		* @throws math::ExceptionTooManyIterations if iterative solver doesn't converge
+		*/
+		virtual void build() override
+		{
+			const Matrix<T>& x = Interpolator<T>::x_;
+			size_t n = x.rows();
+			size_t dim = Interpolator<T>::dim_;
+			if (n == 0 || (hasPolynomial() && n < dim + 1))
+			{
+				throw(ExceptionDegenerateMatrix("RBFInterpolator<T>::build: Not enough centers!"));
+			}
+
+			centers_.resize(n * dim);
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t k = 0; k < dim; ++k)
+				{
+					centers_[i * dim + k] = x(i, k);
+				}
+			}
+			tree_ = KDTree<T>(centers_.data(), n, dim);
+
+			// coincident centers give equal rows of system
+			for (size_t i = 0; i < n; ++i)
+			{
+				bool coincident = false;
+				tree_.forEachInRadius(centers_.data() + i * dim, static_cast<T>(0.0), [i, &coincident](size_t j, T)
+					{
+						coincident = coincident || j != i;
+					});
+				if (coincident)
+				{
+					throw(ExceptionDegenerateMatrix("RBFInterpolator<T>::build: Coincident centers!"));
+				}
+			}
+			weights_.assign(n, static_cast<T>(0.0));
+
+			switch (kernel_)
+			{
+			case RBFKernel::wendland:
+				support_ = shape_;
+				buildSparse();
+				break;
+			case RBFKernel::gaussian:
+				support_ = std::sqrt(-std::log(std::numeric_limits<T>::epsilon())) / shape_;
+				buildDense();
+				break;
+			default:
+				support_ = static_cast<T>(0.0);
+				buildDense();
+				break;
+			}
+		}
+
+		virtual T interpolate(const Matrix<T>& x) const override
+		{
+			if (x.cols() != Interpolator<T>::dim_ || x.rows() != 1)
+			{
+				throw(ExceptionNonRowVector(
+					"RBFInterpolator<T>::interpolate: Vector x of independent variables must be the row-vector of " +
+					std::to_string(Interpolator<T>::dim_) + " elements!"));
+			}
+			checkBuilt("interpolate");
+			return evaluate(x.data());
+		}
+
+		/**
+		* @brief Get weights of interpolant
+		* @param[out] weights: Weights of centers
+		* @param[out] poly: Coefficients of linear polynomial (free term first), empty for positive definite kernels
+		*/
+		void getWeights(std::vector<T>& weights, std::vector<T>& poly) const
+		{
+			weights = weights_;
+			poly = poly_;
+		}
+	};
+}
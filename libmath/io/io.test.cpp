@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <libmath/io/matrix_file.h>
+#include <libmath/io/out_of_core.h>
+#include <libmath/matrix.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <cstddef>
+
+static std::string tempPath(const std::string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(IO, WriteReadMatrix)
+{
+    std::string path = tempPath("libmath_io_write_read.bin");
+
+    math::Matrix<double> M(3, 4, math::MatRep::Column);
+    for (size_t i = 0; i < M.rows(); ++i)
+    {
+        for (size_t j = 0; j < M.cols(); ++j)
+        {
+            M(i, j) = static_cast<double>(10 * i + j);
+        }
+    }
+
+    math::io::writeMatrix(path, M, 4096);
+
+    math::io::MatrixFileHeader header = math::io::readHeader(path);
+    EXPECT_EQ(header.rows, 3);
+    EXPECT_EQ(header.cols, 4);
+    EXPECT_EQ(header.repr, 1);
+    EXPECT_EQ(header.data_offset, 4096);
+    EXPECT_EQ(header.dtype, static_cast<uint32_t>(math::io::DType::float64));
+
+    math::Matrix<double> R = math::io::readMatrix<double>(path);
+    EXPECT_EQ(R.representation() == math::MatRep::Column, true);
+    EXPECT_EQ(R.compare(M, 1.e-12), true);
+
+    EXPECT_THROW(math::io::readMatrix<float>(path), math::ExceptionFileIO);
+
+    std::filesystem::remove(path);
+}
+
+TEST(IO, MappedMatrix)
+{
+    std::string path = tempPath("libmath_io_mapped.bin");
+
+    math::Matrix<float> M(5, 2);
+    for (size_t i = 0; i < M.rows(); ++i)
+    {
+        M(i, 0) = static_cast<float>(i);
+        M(i, 1) = static_cast<float>(i) * 0.5f;
+    }
+    math::io::writeMatrix(path, M);
+
+    {
+        math::io::MappedMatrix<float> mapped(path);
+        EXPECT_EQ(mapped.rows(), 5);
+        EXPECT_EQ(mapped.cols(), 2);
+        EXPECT_EQ(mapped.representation() == math::MatRep::Row, true);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.data()) % 64, 0);
+        EXPECT_EQ(mapped(4, 1), 2.0f);
+        EXPECT_EQ(mapped.data()[3], 0.5f);
+        EXPECT_THROW(mapped(5, 0), math::ExceptionIndexOutOfBounds);
+
+        math::io::MappedMatrix<float> moved(std::move(mapped));
+        EXPECT_EQ(moved.toMatrix().compare(M, 1.e-6f), true);
+
+        EXPECT_THROW(math::io::MappedMatrix<double> wrong(path), math::ExceptionFileIO);
+    }
+
+    // misaligned data offset and alignment, which isn't a power of two
+    auto patch = [&path](std::streamoff offset, uint64_t value)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    patch(offsetof(math::io::MatrixFileHeader, data_offset), 66);
+    EXPECT_THROW(math::io::MappedMatrix<float> misaligned(path), math::ExceptionInvalidValue);
+    EXPECT_THROW(math::io::readMatrix<float>(path), math::ExceptionInvalidValue);
+    patch(offsetof(math::io::MatrixFileHeader, data_offset), 64);
+    patch(offsetof(math::io::MatrixFileHeader, alignment), 48);
+    EXPECT_THROW(math::io::MappedMatrix<float> odd_alignment(path), math::ExceptionInvalidValue);
+    patch(offsetof(math::io::MatrixFileHeader, alignment), 64);
+    EXPECT_EQ(math::io::readMatrix<float>(path).compare(M, 1.e-6f), true);
+
+    // truncated file
+    std::filesystem::resize_file(path, 64 + 3 * sizeof(float));
+    EXPECT_THROW(math::io::MappedMatrix<float> truncated(path), math::ExceptionFileIO);
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(math::io::MappedMatrix<float> missing(path), math::ExceptionFileIO);
+}
+
+TEST(IO, MatrixFileWriter)
+{
+    std::string path = tempPath("libmath_io_writer.bin");
+
+    math::Matrix<double> gold(7, 3);
+    for (size_t i = 0; i < gold.rows(); ++i)
+    {
+        for (size_t j = 0; j < gold.cols(); ++j)
+        {
+            gold(i, j) = static_cast<double>(i) - static_cast<double>(j) * 0.25;
+        }
+    }
+
+    {
+        math::io::MatrixFileWriter<double> writer(path, 3);
+
+        // single row
+        writer.append(gold.data(), 1);
+
+        // block of rows in row representation
+        math::Matrix<double> block(2, 3);
+        // block of rows in column representation
+        math::Matrix<double> block_col(4, 3, math::MatRep::Column);
+        for (size_t j = 0; j < 3; ++j)
+        {
+            for (size_t i = 0; i < 2; ++i)
+            {
+                block(i, j) = gold(1 + i, j);
+            }
+            for (size_t i = 0; i < 4; ++i)
+            {
+                block_col(i, j) = gold(3 + i, j);
+            }
+        }
+        writer.append(block);
+        writer.append(block_col);
+        EXPECT_EQ(writer.rows(), 7);
+
+        EXPECT_THROW(writer.append(math::Matrix<double>(1, 2)), math::ExceptionNonEqualColumnsNum);
+    }
+
+    {
+        math::io::MappedMatrix<double> mapped(path);
+        EXPECT_EQ(mapped.rows(), 7);
+        EXPECT_EQ(mapped.toMatrix().compare(gold, 1.e-12), true);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(IO, OutOfCoreLeastSquares)
+{
+    std::string path_a = tempPath("libmath_io_ooc_a.bin");
+    std::string path_b = tempPath("libmath_io_ooc_b.bin");
+
+    // y = 2 x0 - 3 x1 + 0.5, written by blocks
+    size_t rows = 1000;
+    {
+        math::io::MatrixFileWriter<double> writer_a(path_a, 3);
+        math::io::MatrixFileWriter<double> writer_b(path_b, 1);
+        for (size_t i = 0; i < rows; ++i)
+        {
+            double x0 = std::sin(static_cast<double>(i));
+            double x1 = std::cos(0.3 * static_cast<double>(i));
+            double a[3] = { x0, x1, 1.0 };
+            double b = 2.0 * x0 - 3.0 * x1 + 0.5;
+            writer_a.append(a);
+            writer_b.append(&b);
+        }
+    }
+
+    math::Matrix<double> gold = { {2.0}, {-3.0}, {0.5} };
+
+    math::io::RowPanelStream<double> A(path_a, 64);
+    math::io::RowPanelStream<double> b(path_b, 64);
+    math::Matrix<double> x = math::io::leastSquares(A, b);
+    EXPECT_EQ(x.compare(gold, 1.e-10), true);
+
+    // repeated pass and mapped source give the same normal equations
+    math::Matrix<double> AtA;
+    math::io::normalEquations(A, AtA);
+    math::io::MappedMatrix<double> mapped(path_a);
+    math::io::RowPanelStream<double> A_mapped(mapped, 100);
+    math::Matrix<double> AtA_mapped;
+    math::io::normalEquations(A_mapped, AtA_mapped);
+    EXPECT_EQ(AtA.compare(AtA_mapped, 1.e-10), true);
+    EXPECT_NEAR(AtA(2, 2), static_cast<double>(rows), 1.e-10);
+
+    math::io::RowPanelStream<double> b_other(path_b, 100);
+    math::Matrix<double> Atb;
+    EXPECT_THROW(math::io::normalEquations(A, b_other, AtA, Atb), math::ExceptionNonEqualRowsNum);
+
+    // rank deficient A
+    math::Matrix<double> A_rd = { {1.0, 0.0}, {2.0, 0.0}, {3.0, 0.0} };
+    math::Matrix<double> b_rd = { {1.0}, {2.0}, {3.0} };
+    math::io::RowPanelStream<double> A_rd_stream(A_rd, 2);
+    math::io::RowPanelStream<double> b_rd_stream(b_rd, 2);
+    EXPECT_THROW(math::io::leastSquares(A_rd_stream, b_rd_stream), math::ExceptionDegenerateMatrix);
+
+    std::filesystem::remove(path_a);
+    std::filesystem::remove(path_b);
+}
+
+TEST(IO, OutOfCoreGemmTranspose)
+{
+    std::string path_c = tempPath("libmath_io_ooc_c.bin");
+    std::string path_t = tempPath("libmath_io_ooc_t.bin");
+
+    math::Matrix<double> A(37, 4, math::MatRep::Column);
+    for (size_t i = 0; i < A.rows(); ++i)
+    {
+        for (size_t j = 0; j < A.cols(); ++j)
+        {
+            A(i, j) = static_cast<double>(i) * 0.1 + static_cast<double>(j);
+        }
+    }
+    math::Matrix<double> B =
+    {
+        {1.0, 0.0},
+        {2.0, -1.0},
+        {0.0, 3.0},
+        {-1.0, 1.0}
+    };
+
+    math::io::RowPanelStream<double> stream(A, 8);
+    {
+        math::io::MatrixFileWriter<double> C(path_c, 2);
+        math::io::gemm(stream, B, C);
+    }
+    EXPECT_EQ(math::io::readMatrix<double>(path_c).compare(A * B, 1.e-10), true);
+
+    math::io::transpose(stream, path_t);
+    math::Matrix<double> At = math::io::readMatrix<double>(path_t);
+    EXPECT_EQ(At.rows(), 4);
+    EXPECT_EQ(At.cols(), 37);
+    EXPECT_EQ(At.compare(A.getTr(), 1.e-10), true);
+
+    std::filesystem::remove(path_c);
+    std::filesystem::remove(path_t);
+}
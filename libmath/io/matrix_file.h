@@ -0,0 +1,588 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+* @brief Binary matrix file format
+* @details File consists of 64 bytes header (MatrixFileHeader) followed by matrix elements,
+* stored in native byte order with respect to matrix representation (row by row for
+* MatRep::Row, column by column for MatRep::Column) without gaps. Elements start at
+* data_offset - first multiple of alignment not less than header size. Alignment is a power
+* of two, 64 by default (cache line, enough for SIMD loads); page size alignment (4096) allows
+* to map elements directly to page boundary.
+*
+* | Offset | Size | Field       | Description                                      |
+* |--------|------|-------------|--------------------------------------------------|
+* | 0      | 8    | magic       | "LIBMATH\0"                                      |
+* | 8      | 4    | version     | Format version (1)                               |
+* | 12     | 4    | endian      | 0x01020304 written in native byte order          |
+* | 16     | 4    | dtype       | Type of elements (math::io::DType)               |
+* | 20     | 4    | repr        | Representation: 0 - MatRep::Row, 1 - MatRep::Column |
+* | 24     | 8    | rows        | Number of rows                                   |
+* | 32     | 8    | cols        | Number of columns                                |
+* | 40     | 8    | data_offset | Offset of the first element                      |
+* | 48     | 8    | alignment   | Alignment of data_offset                         |
+* | 56     | 8    | reserved    | Zeros                                            |
+*/
+namespace math::io
+{
+	/// @brief Type of matrix elements in binary file
+	enum class DType : uint32_t
+	{
+		int32 = 1,
+		int64 = 2,
+		float32 = 3,
+		float64 = 4
+	};
+
+	/// @brief DType of C++ type T
+	template <typename T>
+	constexpr DType dtypeOf()
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			return DType::float32;
+		}
+		else if constexpr (std::is_same_v<T, double>)
+		{
+			return DType::float64;
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4)
+		{
+			return DType::int32;
+		}
+		else
+		{
+			static_assert(std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8,
+				"math::io: Unsupported type of matrix elements");
+			return DType::int64;
+		}
+	}
+
+	/// @brief Header of binary matrix file
+	struct MatrixFileHeader
+	{
+		char magic[8] = { 'L', 'I', 'B', 'M', 'A', 'T', 'H', '\0' };
+		uint32_t version = 1;
+		uint32_t endian = 0x01020304;
+		uint32_t dtype = 0;
+		uint32_t repr = 0;
+		uint64_t rows = 0;
+		uint64_t cols = 0;
+		uint64_t data_offset = 64;
+		uint64_t alignment = 64;
+		uint64_t reserved = 0;
+	};
+	static_assert(sizeof(MatrixFileHeader) == 64, "math::io: MatrixFileHeader must be 64 bytes");
+	static_assert(std::is_trivially_copyable_v<MatrixFileHeader>, "math::io: MatrixFileHeader must be trivially copyable");
+
+	namespace detail
+	{
+		template <typename T>
+		MatrixFileHeader makeHeader(size_t rows, size_t cols, MatRep repr, size_t alignment, const std::string& method)
+		{
+			if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+			{
+				throw(ExceptionInvalidValue(method + ": Alignment must be a power of two!"));
+			}
+
+			MatrixFileHeader header;
+			header.dtype = static_cast<uint32_t>(dtypeOf<T>());
+			header.repr = repr == MatRep::Row ? 0 : 1;
+			header.rows = rows;
+			header.cols = cols;
+			header.alignment = alignment;
+			header.data_offset = (sizeof(MatrixFileHeader) + alignment - 1) / alignment * alignment;
+			return header;
+		}
+
+		template <typename T>
+		void checkHeader(const MatrixFileHeader& header, uint64_t file_size, const std::string& method)
+		{
+			MatrixFileHeader reference;
+			if (std::memcmp(header.magic, reference.magic, sizeof(reference.magic)) != 0)
+			{
+				throw(ExceptionFileIO(method + ": File is not a libmath binary matrix!"));
+			}
+			if (header.version != reference.version)
+			{
+				throw(ExceptionFileIO(method + ": Unsupported format version " + std::to_string(header.version) + "!"));
+			}
+			if (header.endian != reference.endian)
+			{
+				throw(ExceptionFileIO(method + ": File was written with different byte order!"));
+			}
+			if (header.dtype != static_cast<uint32_t>(dtypeOf<T>()))
+			{
+				throw(ExceptionFileIO(method + ": Type of elements in file doesn't match requested matrix type!"));
+			}
+			if (header.repr > 1 || header.data_offset < sizeof(MatrixFileHeader))
+			{
+				throw(ExceptionFileIO(method + ": Corrupted header!"));
+			}
+			if (header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0)
+			{
+				throw(ExceptionInvalidValue(method + ": Alignment must be a power of two!"));
+			}
+			if (header.data_offset % alignof(T) != 0)
+			{
+				throw(ExceptionInvalidValue(method + ": Data offset isn't aligned for type of elements!"));
+			}
+			if (file_size < header.data_offset ||
+				(header.cols != 0 && header.rows > (file_size - header.data_offset) / sizeof(T) / header.cols))
+			{
+				throw(ExceptionFileIO(method + ": File is truncated!"));
+			}
+		}
+
+		inline MatRep toMatRep(uint32_t repr)
+		{
+			return repr == 0 ? MatRep::Row : MatRep::Column;
+		}
+	}
+
+	/**
+	* @brief Read header of binary matrix file
+	* @param path: File path
+	* @throws math::ExceptionFileIO if file can't be read or isn't a libmath binary matrix
+	*/
+	inline MatrixFileHeader readHeader(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			throw(ExceptionFileIO("math::io::readHeader: Can't open file " + path));
+		}
+		MatrixFileHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		{
+			throw(ExceptionFileIO("math::io::readHeader: File " + path + " is truncated!"));
+		}
+		if (std::memcmp(header.magic, MatrixFileHeader().magic, sizeof(header.magic)) != 0)
+		{
+			throw(ExceptionFileIO("math::io::readHeader: File " + path + " is not a libmath binary matrix!"));
+		}
+		return header;
+	}
+
+	/**
+	* @brief Write matrix to binary file
+	* @param path: File path
+	* @param M: Matrix. Elements are written in representation of M
+	* @param alignment: Alignment of elements offset in file, power of two
+	* @throws math::ExceptionFileIO if file can't be written
+	*/
+	template <typename T>
+	void writeMatrix(const std::string& path, const Matrix<T>& M, size_t alignment = 64)
+	{
+		MatrixFileHeader header = detail::makeHeader<T>(M.rows(), M.cols(), M.representation(), alignment, "math::io::writeMatrix");
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			throw(ExceptionFileIO("math::io::writeMatrix: Can't open file " + path));
+		}
+		std::vector<char> padding(header.data_offset - sizeof(header), 0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(padding.data(), padding.size());
+		file.write(reinterpret_cast<const char*>(M.data()), M.numel() * sizeof(T));
+		if (!file)
+		{
+			throw(ExceptionFileIO("math::io::writeMatrix: Error while writing file " + path));
+		}
+	}
+
+	/**
+	* @brief Read matrix from binary file to memory
+	* @details For large files prefer MappedMatrix, which doesn't copy elements
+	* @param path: File path
+	* @return Matrix with representation, stored in file
+	* @throws math::ExceptionFileIO if file can't be read or doesn't match type T
+	* @throws math::ExceptionInvalidValue if data offset is misaligned for T or alignment isn't a power of two
+	*/
+	template <typename T>
+	Matrix<T> readMatrix(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			throw(ExceptionFileIO("math::io::readMatrix: Can't open file " + path));
+		}
+		uint64_t file_size = static_cast<uint64_t>(file.tellg());
+		file.seekg(0);
+
+		MatrixFileHeader header;
+		if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		{
+			throw(ExceptionFileIO("math::io::readMatrix: File " + path + " is truncated!"));
+		}
+		detail::checkHeader<T>(header, file_size, "math::io::readMatrix");
+
+		Matrix<T> M(header.rows, header.cols, detail::toMatRep(header.repr));
+		file.seekg(header.data_offset);
+		if (!file.read(reinterpret_cast<char*>(M.data()), M.numel() * sizeof(T)))
+		{
+			throw(ExceptionFileIO("math::io::readMatrix: Error while reading file " + path));
+		}
+		return M;
+	}
+
+	/**
+	* @brief Streaming writer of binary matrix file
+	* @details Matrix is written row by row (MatRep::Row), number of columns is fixed on creation
+	* and number of rows grows with appended data. Header is finalized on close() (called by
+	* destructor), so matrices larger than memory can be written by blocks of rows.
+	*/
+	template <typename T>
+	class MatrixFileWriter
+	{
+	private:
+		std::ofstream file_;
+
+		std::string path_;
+
+		MatrixFileHeader header_;
+
+		/// @brief Buffer for rows of column matrices
+		std::vector<T> buffer_;
+
+		void writeHeader()
+		{
+			file_.seekp(0);
+			file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+			file_.seekp(0, std::ios::end);
+		}
+
+	public:
+		/**
+		* @brief MatrixFileWriter constructor
+		* @param path: File path
+		* @param cols: Number of columns
+		* @param alignment: Alignment of elements offset in file, power of two
+		* @throws math::ExceptionFileIO if file can't be opened
+		*/
+		MatrixFileWriter(const std::string& path, size_t cols, size_t alignment = 64) :
+			path_(path),
+			header_(detail::makeHeader<T>(0, cols, MatRep::Row, alignment, "MatrixFileWriter<T>"))
+		{
+			file_.open(path_, std::ios::binary | std::ios::trunc);
+			if (!file_)
+			{
+				throw(ExceptionFileIO("MatrixFileWriter<T>: Can't open file " + path_));
+			}
+			std::vector<char> padding(header_.data_offset - sizeof(header_), 0);
+			file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+			file_.write(padding.data(), padding.size());
+		}
+
+		MatrixFileWriter(const MatrixFileWriter&) = delete;
+		MatrixFileWriter& operator=(const MatrixFileWriter&) = delete;
+
+		~MatrixFileWriter()
+		{
+			try
+			{
+				close();
+			}
+			catch (...)
+			{
+			}
+		}
+
+		/// @brief Number of written rows
+		size_t rows() const
+		{
+			return header_.rows;
+		}
+
+		size_t cols() const
+		{
+			return header_.cols;
+		}
+
+		/**
+		* @brief Append rows, stored contiguously
+		* @param data: Elements of rows, rows * cols() values
+		* @param rows: Number of rows
+		*/
+		void append(const T* data, size_t rows = 1)
+		{
+			if (!file_.is_open())
+			{
+				throw(ExceptionFileIO("MatrixFileWriter<T>::append: File " + path_ + " is closed!"));
+			}
+			file_.write(reinterpret_cast<const char*>(data), rows * header_.cols * sizeof(T));
+			if (!file_)
+			{
+				throw(ExceptionFileIO("MatrixFileWriter<T>::append: Error while writing file " + path_));
+			}
+			header_.rows += rows;
+		}
+
+		/**
+		* @brief Append rows of matrix
+		* @param M: Matrix of any representation with cols() columns
+		* @throws math::ExceptionNonEqualColumnsNum
+		*/
+		void append(const Matrix<T>& M)
+		{
+			if (M.cols() != header_.cols)
+			{
+				throw(ExceptionNonEqualColumnsNum("MatrixFileWriter<T>::append: Matrix must have " +
+					std::to_string(header_.cols) + " columns!"));
+			}
+			if (M.representation() == MatRep::Row)
+			{
+				append(M.data(), M.rows());
+				return;
+			}
+			buffer_.resize(M.numel());
+			for (size_t i = 0; i < M.rows(); ++i)
+			{
+				for (size_t j = 0; j < M.cols(); ++j)
+				{
+					buffer_[i * M.cols() + j] = M.data()[j * M.rows() + i];
+				}
+			}
+			append(buffer_.data(), M.rows());
+		}
+
+		/// @brief Finalize header and close file
+		void close()
+		{
+			if (!file_.is_open())
+			{
+				return;
+			}
+			writeHeader();
+			file_.close();
+			if (file_.fail())
+			{
+				throw(ExceptionFileIO("MatrixFileWriter<T>::close: Error while writing file " + path_));
+			}
+		}
+	};
+
+	/**
+	* @brief Read-only matrix, mapped from binary file to memory
+	* @details Elements aren't copied or read on opening: pages of file are loaded by OS on the first
+	* access, so multi-GB files open instantly and don't occupy heap. Elements are accessed in place
+	* through data() and operator(), toMatrix() copies them to heap matrix.
+	*/
+	template <typename T>
+	class MappedMatrix
+	{
+	private:
+		std::string path_;
+
+		MatrixFileHeader header_;
+
+		/// @brief Beginning of mapped file
+		void* base_ = nullptr;
+
+		/// @brief Size of mapped file
+		size_t size_ = 0;
+
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+
+		void unmap()
+		{
+#ifdef _WIN32
+			if (base_)
+			{
+				UnmapViewOfFile(base_);
+			}
+			if (mapping_)
+			{
+				CloseHandle(mapping_);
+			}
+			if (file_ != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file_);
+			}
+			mapping_ = nullptr;
+			file_ = INVALID_HANDLE_VALUE;
+#else
+			if (base_)
+			{
+				munmap(base_, size_);
+			}
+#endif
+			base_ = nullptr;
+			size_ = 0;
+		}
+
+	public:
+		/**
+		* @brief MappedMatrix constructor
+		* @param path: File path
+		* @throws math::ExceptionFileIO if file can't be mapped or doesn't match type T
+		* @throws math::ExceptionInvalidValue if data offset is misaligned for T or alignment isn't a power of two
+		*/
+		explicit MappedMatrix(const std::string& path) : path_(path)
+		{
+#ifdef _WIN32
+			file_ = CreateFileA(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE)
+			{
+				throw(ExceptionFileIO("MappedMatrix<T>: Can't open file " + path_));
+			}
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(MatrixFileHeader)))
+			{
+				unmap();
+				throw(ExceptionFileIO("MappedMatrix<T>: File " + path_ + " is truncated!"));
+			}
+			size_ = static_cast<size_t>(file_size.QuadPart);
+			mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			base_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (!base_)
+			{
+				unmap();
+				throw(ExceptionFileIO("MappedMatrix<T>: Can't map file " + path_));
+			}
+#else
+			int fd = open(path_.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				throw(ExceptionFileIO("MappedMatrix<T>: Can't open file " + path_));
+			}
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(MatrixFileHeader)))
+			{
+				::close(fd);
+				throw(ExceptionFileIO("MappedMatrix<T>: File " + path_ + " is truncated!"));
+			}
+			size_ = static_cast<size_t>(st.st_size);
+			base_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (base_ == MAP_FAILED)
+			{
+				base_ = nullptr;
+				size_ = 0;
+				throw(ExceptionFileIO("MappedMatrix<T>: Can't map file " + path_));
+			}
+#endif
+			std::memcpy(&header_, base_, sizeof(header_));
+			try
+			{
+				detail::checkHeader<T>(header_, size_, "MappedMatrix<T>");
+			}
+			catch (...)
+			{
+				unmap();
+				throw;
+			}
+		}
+
+		MappedMatrix(const MappedMatrix&) = delete;
+		MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+		MappedMatrix(MappedMatrix&& other) noexcept
+		{
+			*this = std::move(other);
+		}
+
+		MappedMatrix& operator=(MappedMatrix&& other) noexcept
+		{
+			if (this != &other)
+			{
+				unmap();
+				path_ = std::move(other.path_);
+				header_ = other.header_;
+				base_ = other.base_;
+				size_ = other.size_;
+				other.base_ = nullptr;
+				other.size_ = 0;
+#ifdef _WIN32
+				file_ = other.file_;
+				mapping_ = other.mapping_;
+				other.file_ = INVALID_HANDLE_VALUE;
+				other.mapping_ = nullptr;
+#endif
+			}
+			return *this;
+		}
+
+		~MappedMatrix()
+		{
+			unmap();
+		}
+
+		size_t rows() const
+		{
+			return header_.rows;
+		}
+
+		size_t cols() const
+		{
+			return header_.cols;
+		}
+
+		size_t numel() const
+		{
+			return header_.rows * header_.cols;
+		}
+
+		MatRep representation() const
+		{
+			return detail::toMatRep(header_.repr);
+		}
+
+		/// @brief Pointer to mapped elements, stored with respect to representation()
+		const T* data() const
+		{
+			return reinterpret_cast<const T*>(static_cast<const char*>(base_) + header_.data_offset);
+		}
+
+		/**
+		* @brief Access to element
+		* @throws math::ExceptionIndexOutOfBounds
+		*/
+		T operator()(size_t row, size_t col) const
+		{
+			if (row >= header_.rows || col >= header_.cols)
+			{
+				throw(ExceptionIndexOutOfBounds("MappedMatrix<T>: Index out of bounds!"));
+			}
+			return header_.repr == 0 ?
+				data()[row * header_.cols + col] :
+				data()[col * header_.rows + row];
+		}
+
+		/// @brief Copy mapped elements to heap matrix of the same representation
+		Matrix<T> toMatrix() const
+		{
+			Matrix<T> M(rows(), cols(), representation());
+			std::copy(data(), data() + numel(), M.data());
+			return M;
+		}
+	};
+}
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <libmath/io/matrix_file.h>
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <future>
+#include <functional>
+#include <memory>
+#include <filesystem>
+#include <algorithm>
+
+namespace math::io
+{
+	/**
+	* @brief Panel of consecutive matrix rows, stored row by row
+	*/
+	template <typename T>
+	struct RowPanel
+	{
+		/// @brief Index of the first row of panel in matrix
+		size_t first_row = 0;
+
+		/// @brief Number of rows in panel
+		size_t rows = 0;
+
+		/// @brief Number of columns
+		size_t cols = 0;
+
+		/// @brief Elements of panel, row-major rows x cols
+		const T* data = nullptr;
+	};
+
+	namespace detail
+	{
+		/// @brief Copy rows [first, first + count) of matrix storage to row-major panel
+		template <typename T>
+		void gatherRows(const T* data, MatRep repr, size_t rows, size_t cols, size_t first, size_t count, T* dst)
+		{
+			if (repr == MatRep::Row)
+			{
+				std::copy(data + first * cols, data + (first + count) * cols, dst);
+				return;
+			}
+			for (size_t j = 0; j < cols; ++j)
+			{
+				const T* col = data + j * rows + first;
+				for (size_t i = 0; i < count; ++i)
+				{
+					dst[i * cols + j] = col[i];
+				}
+			}
+		}
+	}
+
+	/**
+	* @brief Double-buffered stream of row panels of matrix
+	* @details Matrix is read by panels of panel_rows rows. While caller processes current panel,
+	* the next one is loaded to the second buffer asynchronously (std::async), so reading of
+	* file overlaps with computations and only two panels are held in memory.
+	* Source may be binary matrix file (read by chunks, without mapping), MappedMatrix
+	* (pages are faulted in by prefetching thread) or Matrix.
+	*
+	* Panel, returned by next(), stays valid until the following call of next() or reset().
+	*/
+	template <typename T>
+	class RowPanelStream
+	{
+	public:
+		/// @brief Loader of rows [first_row, first_row + rows) to row-major buffer
+		using Loader = std::function<void(size_t first_row, size_t rows, T* dst)>;
+
+	private:
+		size_t rows_ = 0;
+
+		size_t cols_ = 0;
+
+		size_t panel_rows_ = 0;
+
+		Loader loader_;
+
+		/// @brief Current and prefetched panels
+		std::vector<T> buffers_[2];
+
+		/// @brief Index of buffer, which is filled by prefetch
+		size_t fill_ = 0;
+
+		/// @brief First row of prefetched panel
+		size_t next_row_ = 0;
+
+		/// @brief Number of rows in prefetched panel
+		size_t next_count_ = 0;
+
+		std::future<void> prefetch_;
+
+		void launch()
+		{
+			if (next_row_ >= rows_)
+			{
+				return;
+			}
+			next_count_ = std::min(panel_rows_, rows_ - next_row_);
+			T* dst = buffers_[fill_].data();
+			size_t first = next_row_;
+			size_t count = next_count_;
+			prefetch_ = std::async(std::launch::async, [this, first, count, dst]()
+				{
+					loader_(first, count, dst);
+				});
+		}
+
+		void wait()
+		{
+			if (prefetch_.valid())
+			{
+				prefetch_.wait();
+			}
+		}
+
+		void init(size_t rows, size_t cols, size_t panel_rows)
+		{
+			if (panel_rows == 0)
+			{
+				throw(ExceptionInvalidValue("RowPanelStream<T>: Number of rows in panel must be positive!"));
+			}
+			rows_ = rows;
+			cols_ = cols;
+			panel_rows_ = std::min(panel_rows, std::max<size_t>(rows, 1));
+			buffers_[0].resize(panel_rows_ * cols_);
+			buffers_[1].resize(panel_rows_ * cols_);
+			launch();
+		}
+
+	public:
+		/**
+		* @brief Stream over binary matrix file, read by chunks
+		* @param path: Path to binary matrix file (see matrix_file.h)
+		* @param panel_rows: Number of rows in panel
+		* @throws math::ExceptionFileIO if file can't be read or doesn't match type T
+		*/
+		RowPanelStream(const std::string& path, size_t panel_rows)
+		{
+			auto file = std::make_shared<std::ifstream>(path, std::ios::binary | std::ios::ate);
+			if (!*file)
+			{
+				throw(ExceptionFileIO("RowPanelStream<T>: Can't open file " + path));
+			}
+			uint64_t file_size = static_cast<uint64_t>(file->tellg());
+			file->seekg(0);
+			MatrixFileHeader header;
+			if (!file->read(reinterpret_cast<char*>(&header), sizeof(header)))
+			{
+				throw(ExceptionFileIO("RowPanelStream<T>: File " + path + " is truncated!"));
+			}
+			detail::checkHeader<T>(header, file_size, "RowPanelStream<T>");
+
+			size_t rows = header.rows;
+			size_t cols = header.cols;
+			uint64_t offset = header.data_offset;
+			bool row_major = header.repr == 0;
+			auto column = std::make_shared<std::vector<T>>();
+
+			loader_ = [file, column, path, rows, cols, offset, row_major](size_t first, size_t count, T* dst)
+				{
+					if (row_major)
+					{
+						file->seekg(offset + first * cols * sizeof(T));
+						file->read(reinterpret_cast<char*>(dst), count * cols * sizeof(T));
+					}
+					else
+					{
+						column->resize(count);
+						for (size_t j = 0; j < cols && *file; ++j)
+						{
+							file->seekg(offset + (j * rows + first) * sizeof(T));
+							file->read(reinterpret_cast<char*>(column->data()), count * sizeof(T));
+							for (size_t i = 0; i < count; ++i)
+							{
+								dst[i * cols + j] = (*column)[i];
+							}
+						}
+					}
+					if (!*file)
+					{
+						throw(ExceptionFileIO("RowPanelStream<T>: Error while reading file " + path));
+					}
+				};
+			init(rows, cols, panel_rows);
+		}
+
+		/**
+		* @brief Stream over mapped matrix
+		* @param A: Mapped matrix. Must outlive stream
+		* @param panel_rows: Number of rows in panel
+		*/
+		RowPanelStream(const MappedMatrix<T>& A, size_t panel_rows)
+		{
+			const MappedMatrix<T>* source = &A;
+			loader_ = [source](size_t first, size_t count, T* dst)
+				{
+					detail::gatherRows(source->data(), source->representation(), source->rows(), source->cols(), first, count, dst);
+				};
+			init(A.rows(), A.cols(), panel_rows);
+		}
+
+		/**
+		* @brief Stream over matrix in memory
+		* @param A: Matrix. Must outlive stream
+		* @param panel_rows: Number of rows in panel
+		*/
+		RowPanelStream(const Matrix<T>& A, size_t panel_rows)
+		{
+			const Matrix<T>* source = &A;
+			loader_ = [source](size_t first, size_t count, T* dst)
+				{
+					detail::gatherRows(source->data(), source->representation(), source->rows(), source->cols(), first, count, dst);
+				};
+			init(A.rows(), A.cols(), panel_rows);
+		}
+
+		/**
+		* @brief Stream over custom source (chunked reader)
+		* @param rows: Number of rows
+		* @param cols: Number of columns
+		* @param loader: Loader of rows to row-major buffer. Called from prefetching thread,
+		* one call at a time
+		* @param panel_rows: Number of rows in panel
+		*/
+		RowPanelStream(size_t rows, size_t cols, Loader loader, size_t panel_rows) :
+			loader_(std::move(loader))
+		{
+			init(rows, cols, panel_rows);
+		}
+
+		RowPanelStream(const RowPanelStream&) = delete;
+		RowPanelStream& operator=(const RowPanelStream&) = delete;
+
+		~RowPanelStream()
+		{
+			wait();
+		}
+
+		size_t rows() const
+		{
+			return rows_;
+		}
+
+		size_t cols() const
+		{
+			return cols_;
+		}
+
+		size_t panelRows() const
+		{
+			return panel_rows_;
+		}
+
+		/**
+		* @brief Get next panel and start prefetch of the following one
+		* @param[out] panel: Next panel
+		* @return False if all rows are streamed
+		* @throws Exception of loader (math::ExceptionFileIO for files)
+		*/
+		bool next(RowPanel<T>& panel)
+		{
+			if (!prefetch_.valid())
+			{
+				return false;
+			}
+			prefetch_.get();
+
+			panel.first_row = next_row_;
+			panel.rows = next_count_;
+			panel.cols = cols_;
+			panel.data = buffers_[fill_].data();
+
+			fill_ = 1 - fill_;
+			next_row_ += next_count_;
+			launch();
+			return true;
+		}
+
+		/// @brief Restart streaming from the first row
+		void reset()
+		{
+			wait();
+			prefetch_ = std::future<void>();
+			next_row_ = 0;
+			launch();
+		}
+	};
+
+	/**
+	* @brief Out-of-core matrix product @f$ \mathbf{C} = \mathbf{A}\mathbf{B} @f$
+	* @details A is streamed by row panels, B is held in memory, rows of C are written to file
+	* panel by panel
+	* @param A: Stream of rows of A (rows x n)
+	* @param B: Matrix B (n x m)
+	* @param C: Writer of C with m columns
+	* @throws math::ExceptionInvalidValue if sizes don't match
+	*/
+	template <typename T>
+	void gemm(RowPanelStream<T>& A, const Matrix<T>& B, MatrixFileWriter<T>& C)
+	{
+		if (B.rows() != A.cols() || C.cols() != B.cols())
+		{
+			throw(ExceptionInvalidValue("math::io::gemm: Matrices can't be multiplied!"));
+		}
+
+		size_t n = B.rows();
+		size_t m = B.cols();
+
+		// B by columns for blas::gemm
+		std::vector<T> Bc(n * m);
+		for (size_t j = 0; j < m; ++j)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				Bc[j * n + i] = B(i, j);
+			}
+		}
+
+		std::vector<T> Yc(A.panelRows() * m);
+		std::vector<T> Yr(A.panelRows() * m);
+		RowPanel<T> panel;
+		A.reset();
+		while (A.next(panel))
+		{
+			blas::gemm(panel.rows, n, panel.data, true, m, Bc.data(), Yc.data());
+			for (size_t i = 0; i < panel.rows; ++i)
+			{
+				for (size_t j = 0; j < m; ++j)
+				{
+					Yr[i * m + j] = Yc[j * panel.rows + i];
+				}
+			}
+			C.append(Yr.data(), panel.rows);
+		}
+	}
+
+	/**
+	* @brief Out-of-core transpose
+	* @details Each panel of rows of A is a block of columns of @f$ \mathbf{A}^T @f$, which is
+	* written to row-major output file by segments
+	* @param A: Stream of rows of A
+	* @param path: Path to output binary matrix file, representation MatRep::Row
+	* @throws math::ExceptionFileIO if file can't be written
+	*/
+	template <typename T>
+	void transpose(RowPanelStream<T>& A, const std::string& path)
+	{
+		size_t rows = A.cols();
+		size_t cols = A.rows();
+		MatrixFileHeader header = detail::makeHeader<T>(rows, cols, MatRep::Row, 64, "math::io::transpose");
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file)
+			{
+				throw(ExceptionFileIO("math::io::transpose: Can't open file " + path));
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		}
+		std::error_code ec;
+		std::filesystem::resize_file(path, header.data_offset + rows * cols * sizeof(T), ec);
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		if (ec || !file)
+		{
+			throw(ExceptionFileIO("math::io::transpose: Can't allocate file " + path));
+		}
+
+		std::vector<T> segment(A.panelRows());
+		RowPanel<T> panel;
+		A.reset();
+		while (A.next(panel))
+		{
+			for (size_t j = 0; j < rows; ++j)
+			{
+				for (size_t i = 0; i < panel.rows; ++i)
+				{
+					segment[i] = panel.data[i * panel.cols + j];
+				}
+				file.seekp(header.data_offset + (j * cols + panel.first_row) * sizeof(T));
+				file.write(reinterpret_cast<const char*>(segment.data()), panel.rows * sizeof(T));
+			}
+			if (!file)
+			{
+				throw(ExceptionFileIO("math::io::transpose: Error while writing file " + path));
+			}
+		}
+	}
+
+	/**
+	* @brief Out-of-core accumulation of Gram matrix @f$ \mathbf{A}^T\mathbf{A} @f$
+	* @param A: Stream of rows of A (rows x n)
+	* @param[out] AtA: Matrix n x n
+	*/
+	template <typename T>
+	void normalEquations(RowPanelStream<T>& A, Matrix<T>& AtA)
+	{
+		size_t n = A.cols();
+		std::vector<T> G(n * n, static_cast<T>(0.0));
+		RowPanel<T> panel;
+		A.reset();
+		while (A.next(panel))
+		{
+			blas::syrk(panel.rows, n, panel.data, G.data());
+		}
+		AtA = Matrix<T>(n, n);
+		std::copy(G.begin(), G.end(), AtA.data());
+	}
+
+	/**
+	* @brief Out-of-core accumulation of normal equations
+	* @f$ \mathbf{A}^T\mathbf{A}\mathbf{x} = \mathbf{A}^T\mathbf{b} @f$
+	* @details Streams of A and b are read simultaneously, so both of them prefetch the next panel
+	* @param A: Stream of rows of A (rows x n)
+	* @param b: Stream of rows of right-hand sides (rows x k) with the same panel size as A
+	* @param[out] AtA: Matrix n x n
+	* @param[out] Atb: Matrix n x k
+	* @throws math::ExceptionNonEqualRowsNum if streams don't match
+	*/
+	template <typename T>
+	void normalEquations(RowPanelStream<T>& A, RowPanelStream<T>& b, Matrix<T>& AtA, Matrix<T>& Atb)
+	{
+		if (A.rows() != b.rows() || A.panelRows() != b.panelRows())
+		{
+			throw(ExceptionNonEqualRowsNum("math::io::normalEquations: Streams of A and b must have equal number of rows and panel size!"));
+		}
+
+		size_t n = A.cols();
+		size_t k = b.cols();
+		std::vector<T> G(n * n, static_cast<T>(0.0));
+		std::vector<T> R(n * k, static_cast<T>(0.0));
+		RowPanel<T> panel_a;
+		RowPanel<T> panel_b;
+		A.reset();
+		b.reset();
+		while (A.next(panel_a) && b.next(panel_b))
+		{
+			blas::syrk(panel_a.rows, n, panel_a.data, G.data());
+			for (size_t r = 0; r < panel_a.rows; ++r)
+			{
+				const T* a_r = panel_a.data + r * n;
+				const T* b_r = panel_b.data + r * k;
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t c = 0; c < k; ++c)
+					{
+						R[i * k + c] += a_r[i] * b_r[c];
+					}
+				}
+			}
+		}
+		AtA = Matrix<T>(n, n);
+		std::copy(G.begin(), G.end(), AtA.data());
+		Atb = Matrix<T>(n, k);
+		std::copy(R.begin(), R.end(), Atb.data());
+	}
+
+	/**
+	* @brief Out-of-core linear least squares @f$ \min \|\mathbf{A}\mathbf{x} - \mathbf{b}\| @f$
+	* @details Normal equations are accumulated in one pass over the streams and solved with
+	* pivoted LU. Memory is bounded by two panels of each stream and n x n Gram matrix.
+	* Condition number of normal equations is squared condition number of A.
+	* @param A: Stream of rows of A (rows x n)
+	* @param b: Stream of rows of right-hand sides (rows x k)
+	* @return Solution n x k
+	* @throws math::ExceptionDegenerateMatrix if A has linearly dependent columns
+	*/
+	template <typename T>
+	Matrix<T> leastSquares(RowPanelStream<T>& A, RowPanelStream<T>& b)
+	{
+		Matrix<T> AtA;
+		Matrix<T> Atb;
+		normalEquations(A, b, AtA, Atb);
+
+		size_t n = AtA.rows();
+		std::vector<size_t> ipiv(n);
+		if (blas::getrf(n, AtA.data(), ipiv.data()) != 0)
+		{
+			throw(ExceptionDegenerateMatrix("math::io::leastSquares: Columns of A are linearly dependent!"));
+		}
+		blas::getrs(n, AtA.data(), ipiv.data(), Atb.cols(), Atb.data());
+		return Atb;
+	}
+}
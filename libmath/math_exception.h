@@ -167,4 +167,18 @@ namespace math
 		}
 	};
 
+	/**
+	* @brief Exception file input/output
+	*/
+	class ExceptionFileIO :
+		public Exception
+	{
+	public:
+		ExceptionFileIO(const std::string& m)
+			: Exception(m)
+		{
+			type_ = "FileIO";
+		}
+	};
+
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <libmath/math_settings.h>
 #include <libmath/boolean.h>
 #include <libmath/arithmetic.h>
+#include <libmath/profiling.h>
+#include <libmath/blas.h>
 
 #include <vector>
 #include <iostream>
@@ -17,8 +19,6 @@
 #include <omp.h>
 #endif
 
-#include <chrono>
-
 namespace math
 {
 	//! Enum class for matrix representation definition
@@ -132,7 +132,7 @@ namespace math
 		/**
 		 * @brief Matrix representation
 		 */
-		MatRep representation()
+		MatRep representation() const
 		{
 			return repr_;
 		}
@@ -177,6 +177,23 @@ namespace math
 			return mvec_;
 		}
 
+		/**
+		 * @brief pointer to internal contiguous storage
+		 * @details Elements are stored with respect to matrix representation (see representation())
+		 */
+		T *data()
+		{
+			return mvec_.data();
+		}
+
+		/**
+		 * @brief const version of data()
+		 */
+		const T *data() const
+		{
+			return mvec_.data();
+		}
+
 		/**
 		 * @brief get reference to element at specified position (i,j)
 		 * @param row row number (starting from 0)
@@ -606,9 +623,22 @@ namespace math
 
 		/**
 		 * @brief calculate inversed matrix
+		 * @details Matrix is factored with pivoted LU, then blocked triangular solves with
+		 * columns of identity matrix are performed. Blocks of columns are solved in parallel.
+		 * @throws math::ExceptionDegenerateMatrix if matrix is singular
 		 * @return inversed matrix
 		 */
-		Matrix<T> inverse();
+		Matrix<T> inverse() const;
+
+		/**
+		 * @brief Inverse matrix in place
+		 * @details Matrix is factored with pivoted LU and inverted inside its own storage
+		 * (see blas::getri), so no additional matrices are allocated.
+		 * If matrix is singular, exception is thrown and content of matrix is undefined.
+		 * @throws math::ExceptionDegenerateMatrix if matrix is singular
+		 * @return reference to this matrix
+		 */
+		Matrix<T> &invert();
 
 		/**
 		 * @brief Compare this matrix with another with defined precision
@@ -830,8 +860,6 @@ namespace math
 		// int pos = 0;
 		size_t n = this->numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(M_T, n) schedule(static)
 #endif
@@ -851,8 +879,6 @@ namespace math
 			}
 			M_T(col, row) = this->mvec_.at(pos);
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return M_T;
 	}
 
@@ -862,8 +888,6 @@ namespace math
 		Matrix<T> M_T(this->cols_, this->rows_);
 		size_t n = this->numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(M_T, n) schedule(static)
 #endif
@@ -883,8 +907,6 @@ namespace math
 			}
 			M_T(col, row) = this->mvec_.at(pos);
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
 		this->rows_ = M_T.rows();
 		this->cols_ = M_T.cols();
@@ -914,135 +936,121 @@ namespace math
 			   (m1.mvec_ == m2.mvec_);
 	}
 
-	template <typename T>
-	Matrix<T> cat(
-		const std::vector<Matrix<T>> &Mv,
-		Dimension dim,
-		MatRep out_repr)
+	namespace detail
 	{
-		size_t cols = 0;
-		size_t rows = 0;
-		size_t n = 0;
-
-		if (dim == Dimension::Row)
-		{
-			cols = Mv.at(0).cols_;
-		}
-		if (dim == Dimension::Column)
+		/**
+		* @brief Cat matrices along specified dimension by contiguous blocks
+		* @details Each source matrix is copied into output by rows (Row output representation) or
+		* by columns (Column output representation). If source representation matches output one,
+		* whole row (column) is copied as a contiguous block, otherwise it's gathered with stride.
+		* @param Mv Pointers to input matrices
+		* @param dim Dimension, along which matrices will be cat
+		* @param out_repr Representation of outer matrix
+		* @return Matrix, build from Mv matrices
+		*/
+		template <typename T>
+		Matrix<T> catBlocks(
+			const std::vector<const Matrix<T> *> &Mv,
+			Dimension dim,
+			MatRep out_repr)
 		{
-			rows = Mv.at(0).rows_;
-		}
-
-		// vector store accumalate values of matrix sizes
-		std::vector<size_t> num_elements_accum(Mv.size());
-
-		// vector store accumalate values of matrix rows
-		std::vector<size_t> num_rows_accum(Mv.size());
+			if (Mv.empty())
+			{
+				throw(ExceptionInvalidValue("Matrix<T> cat: Nothing to cat!"));
+			}
 
-		// vector store accumalate values of matrix cols
-		std::vector<size_t> num_cols_accum(Mv.size());
+			size_t cols = dim == Dimension::Row ? Mv.front()->cols() : 0;
+			size_t rows = dim == Dimension::Column ? Mv.front()->rows() : 0;
 
-		num_elements_accum.at(0) = Mv.at(0).numel();
-		num_rows_accum.at(0) = Mv.at(0).rows();
-		num_cols_accum.at(0) = Mv.at(0).cols();
-		for (size_t i = 1; i < Mv.size(); ++i)
-		{
-			num_elements_accum.at(i) = num_elements_accum.at(i - 1) + Mv.at(i).numel();
-			num_rows_accum.at(i) = num_rows_accum.at(i - 1) + Mv.at(i).rows();
-			num_cols_accum.at(i) = num_cols_accum.at(i - 1) + Mv.at(i).cols();
-		}
-
-		// check inputs and define output matrix dimension
-		for (const auto &M : Mv)
-		{
-			if (dim == Dimension::Row)
+			// check inputs and define output matrix dimension
+			for (const Matrix<T> *M : Mv)
 			{
-				if (cols != M.cols_)
+				if (dim == Dimension::Row)
 				{
-					throw(ExceptionNonEqualColumnsNum("Matrix<T> cat: Trying to cat matrices with different number of rows by rows"));
+					if (cols != M->cols())
+					{
+						throw(ExceptionNonEqualColumnsNum("Matrix<T> cat: Trying to cat matrices with different number of rows by rows"));
+					}
+					rows += M->rows();
 				}
-				rows += M.rows_;
-			}
-			if (dim == Dimension::Column)
-			{
-				if (rows != M.rows_)
+				if (dim == Dimension::Column)
 				{
-					throw(ExceptionNonEqualRowsNum("Matrix<T> cat: Trying to cat matrices with different number of columns by columns"));
+					if (rows != M->rows())
+					{
+						throw(ExceptionNonEqualRowsNum("Matrix<T> cat: Trying to cat matrices with different number of columns by columns"));
+					}
+					cols += M->cols();
 				}
-				cols += M.cols_;
 			}
-			n += M.numel();
-		}
 
-		Matrix<T> Mout(rows, cols);
-		// fill output matrix
-
-		// auto start = std::chrono::steady_clock::now();
-
-#ifdef MATH_OMP_DEFINE
-#pragma omp parallel for shared(Mv, Mout, n, out_repr, dim, num_elements_accum, num_rows_accum, num_cols_accum, rows, cols) schedule(static)
-#endif
-		for (int pos = 0; pos < n; ++pos)
-		{
-			size_t row = 0;
-			size_t col = 0;
-
-			// iterate on matrices vector
-			size_t src_matrix_iter = 0;
-
-			size_t src_matrix_row = 0;
-			size_t src_matrix_col = 0;
-
-			if (out_repr == math::MatRep::Row) // row repr
-			{
-				row = (size_t)std::floor(pos / cols);
-				col = pos - row * cols;
-			}
-			else if (out_repr == math::MatRep::Column) // column repr
-			{
-				col = (size_t)std::floor(pos / rows);
-				row = pos - rows * col;
-			}
+			Matrix<T> Mout(rows, cols, out_repr);
+			T *out = Mout.data();
 
-			if (dim == Dimension::Row)
+			// offset of current source matrix along cat dimension
+			size_t offset = 0;
+			for (const Matrix<T> *M : Mv)
 			{
-				src_matrix_iter =
-					std::distance(
-						num_elements_accum.begin(),
-						std::upper_bound(num_elements_accum.begin(), num_elements_accum.end(), pos));
-
-				if (src_matrix_iter > 0)
-				{
-					src_matrix_row = row - num_rows_accum.at(src_matrix_iter - 1);
-				}
-				else
+				const T *src = M->data();
+				size_t m_rows = M->rows();
+				size_t m_cols = M->cols();
+				size_t row_off = dim == Dimension::Row ? offset : 0;
+				size_t col_off = dim == Dimension::Column ? offset : 0;
+				offset += dim == Dimension::Row ? m_rows : m_cols;
+
+				bool same_repr = M->representation() == out_repr;
+
+				// lines of source matrix, contiguous in output, and their length
+				size_t lines = out_repr == MatRep::Row ? m_rows : m_cols;
+				size_t length = out_repr == MatRep::Row ? m_cols : m_rows;
+				size_t out_length = out_repr == MatRep::Row ? cols : rows;
+				T *dst = out_repr == MatRep::Row ?
+					out + row_off * cols + col_off :
+					out + col_off * rows + row_off;
+
+				if (same_repr && length == out_length)
 				{
-					src_matrix_row = row;
+					// source is a single contiguous block of output
+					std::copy(src, src + M->numel(), dst);
+					continue;
 				}
-				Mout(row, col) = Mv.at(src_matrix_iter)(src_matrix_row, col);
-			}
-			if (dim == Dimension::Column)
-			{
-				src_matrix_iter =
-					std::distance(
-						num_cols_accum.begin(),
-						std::upper_bound(num_cols_accum.begin(), num_cols_accum.end(), col));
 
-				if (src_matrix_iter > 0)
-				{
-					src_matrix_col = col - num_cols_accum.at(src_matrix_iter - 1);
-				}
-				else
+				long long lines_ll = static_cast<long long>(lines);
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) if (M->numel() > blas::omp_threshold)
+#endif
+				for (long long l = 0; l < lines_ll; ++l)
 				{
-					src_matrix_col = col;
+					T *dst_line = dst + l * out_length;
+					if (same_repr)
+					{
+						std::copy(src + l * length, src + (l + 1) * length, dst_line);
+					}
+					else
+					{
+						for (size_t e = 0; e < length; ++e)
+						{
+							dst_line[e] = src[e * lines + l];
+						}
+					}
 				}
-				Mout(row, col) = Mv.at(src_matrix_iter)(row, src_matrix_col);
 			}
+
+			return Mout;
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
+	}
 
-		return Mout;
+	template <typename T>
+	Matrix<T> cat(
+		const std::vector<Matrix<T>> &Mv,
+		Dimension dim,
+		MatRep out_repr)
+	{
+		std::vector<const Matrix<T> *> parts(Mv.size());
+		for (size_t i = 0; i < Mv.size(); ++i)
+		{
+			parts[i] = &Mv[i];
+		}
+		return detail::catBlocks(parts, dim, out_repr);
 	}
 
 	template <typename T>
@@ -1065,7 +1073,6 @@ namespace math
 
 		// omp_set_num_threads(std::max(settings::CurrentSettings.numThreads, 1));
 
-		// auto start = std::chrono::steady_clock::now();
 		//  #ifdef MATH_OMP_DEFINE
 		// #pragma omp parallel for shared(Matrix_L) schedule(static)
 		//  #endif
@@ -1118,10 +1125,7 @@ namespace math
 		//	} // if (i > j)
 		//
 		// }
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
-		// auto start = std::chrono::steady_clock::now();
 		for (size_t i = 0; i < cols_; i++)
 		{
 			Matrix_L(i, i) = static_cast<T>(1);
@@ -1154,14 +1158,13 @@ namespace math
 				} // if (i > j)
 			} // for (size_t j = 0; j < cols_; j++)
 		} // for (size_t i = 0; i < cols_; i++)
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
 	} // Matrix<T>::decompLU
 
 	template <typename T>
 	Matrix<T> Matrix<T>::decompLU() const
 	{
+		MATH_PROFILE_SCOPE("Matrix::decompLU");
 		if (cols_ != rows_)
 		{
 			throw(math::ExceptionNonSquareMatrix("decompLU: matrix must be square!"));
@@ -1321,8 +1324,6 @@ namespace math
 		Matrix<T> mul_M(M.rows(), M.cols());
 		size_t el = M.numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(mul_M, el) schedule(static)
 #endif
@@ -1330,8 +1331,6 @@ namespace math
 		{
 			mul_M.mvec_.at(pos) = M.mvec_.at(pos) * n;
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return mul_M;
 	};
 
@@ -1340,8 +1339,6 @@ namespace math
 	{
 		size_t el = this->numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(el) schedule(static)
 #endif
@@ -1349,14 +1346,13 @@ namespace math
 		{
 			this->mvec_.at(pos) *= n;
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return *this;
 	};
 
 	template <typename T>
 	Matrix<T> operator*(const Matrix<T> &A, const Matrix<T> &B)
 	{
+		MATH_PROFILE_SCOPE("Matrix::operator*");
 		if (A.cols() != B.rows())
 		{
 			throw(math::ExceptionInvalidValue("Matrix<T>::operator*: Matrices can't be multiplied!"));
@@ -1364,8 +1360,6 @@ namespace math
 
 		Matrix<T> C(A.rows(), B.cols());
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(A, B, C) schedule(static)
 #endif
@@ -1380,8 +1374,6 @@ namespace math
 				C.mvec_[pos] += A(row, k) * B(k, col);
 			}
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
 		return C;
 	};
@@ -1400,8 +1392,6 @@ namespace math
 		Matrix<T> sum_M(M.rows(), M.cols());
 		size_t el = sum_M.numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(sum_M, M, n, el) schedule(static)
 #endif
@@ -1409,8 +1399,6 @@ namespace math
 		{
 			sum_M.mvec_.at(i) = M.mvec_.at(i) + n;
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return sum_M;
 	};
 
@@ -1426,8 +1414,6 @@ namespace math
 		Matrix<T> C(A.rows(), A.cols());
 		size_t el = C.numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(A, B, C, el) schedule(static)
 #endif
@@ -1435,8 +1421,6 @@ namespace math
 		{
 			C.mvec_.at(i) = A.mvec_.at(i) + B.mvec_.at(i);
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 
 		return C;
 	};
@@ -1455,8 +1439,6 @@ namespace math
 		Matrix<T> diff_M(M.rows(), M.cols());
 		size_t el = diff_M.numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(diff_M, M, n, el) schedule(static)
 #endif
@@ -1464,8 +1446,6 @@ namespace math
 		{
 			diff_M.mvec_.at(i) = M.mvec_.at(i) - n;
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return diff_M;
 	};
 
@@ -1481,8 +1461,6 @@ namespace math
 		Matrix<T> C(A.rows(), A.cols());
 		size_t el = C.numel();
 
-		// auto start = std::chrono::steady_clock::now();
-
 #ifdef MATH_OMP_DEFINE
 #pragma omp parallel for shared(A, B, C, el) schedule(static)
 #endif
@@ -1490,8 +1468,6 @@ namespace math
 		{
 			C.mvec_.at(i) = A.mvec_.at(i) - B.mvec_.at(i);
 		}
-		// auto end = std::chrono::steady_clock::now();
-		// std::cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << std::endl;
 		return C;
 	};
 
@@ -1504,62 +1480,70 @@ namespace math
 	}
 
 	template <typename T>
-	Matrix<T> Matrix<T>::inverse()
+	Matrix<T> Matrix<T>::inverse() const
 	{
+		MATH_PROFILE_SCOPE("Matrix::inverse");
 		if (this->rows_ != this->cols_)
 		{
 			throw(math::ExceptionNonSquareMatrix("inverse:Inverse of non square matrix!"));
 		}
-		Matrix<T> X(this->rows(), this->cols()), // inverse matrix
-			L(this->rows(), this->cols()),		 // L matrix
-			U(this->rows(), this->cols());		 // U matrix
-		this->decompLU(L, U);
-		long long n = static_cast<long long>(this->rows_ - 1); // size of matrix
-		long long d = n;									   // from right lower corner
-		long long i = d;
-		long long j = d;
-		while (true)
-		{
-			i = d;
-			j = d;
-			// diagonal element of X calculation
-			X(d, d) = static_cast<T>(1.);
-			for (long long k = j + 1; k <= n; ++k)
-			{
-				// formula (2.15) p 71
-				X(j, j) -= U(j, k) * X(k, j);
-			}
-			X(j, j) *= static_cast<T>(1.) / U(j, j);
-			// column walk up from jj
-			for (i = d - 1; i >= 0; --i)
+		// storage of column matrix is row storage of transposed matrix, and inverse of
+		// transposed matrix is transposed inverse, so storage is inverted as row matrix
+		// for both representations
+		size_t n = this->rows_;
+		std::vector<T> LU = this->mvec_;
+		std::vector<size_t> ipiv(n);
+		if (blas::getrf(n, LU.data(), ipiv.data()) != 0)
+		{
+			throw(math::ExceptionDegenerateMatrix("inverse: Matrix is singular!"));
+		}
+
+		Matrix<T> X(n, n, this->repr_);
+		long long blocks = static_cast<long long>((n + blas::trsm_block - 1) / blas::trsm_block);
+
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic) if (blocks > 1)
+#endif
+		for (long long blk = 0; blk < blocks; ++blk)
+		{
+			size_t c0 = static_cast<size_t>(blk) * blas::trsm_block;
+			size_t w = std::min(blas::trsm_block, n - c0);
+
+			// columns c0...c0+w of identity matrix
+			std::vector<T> B(n * w, static_cast<T>(0.0));
+			for (size_t c = 0; c < w; ++c)
 			{
-				// formula (2.16) p 71
-				X(i, j) = static_cast<T>(0.);
-				for (long long k = i + 1; k <= n; ++k)
-				{
-					X(i, j) += U(i, k) * X(k, j);
-				}
-				X(i, j) *= -static_cast<T>(1.) / U(i, i);
+				B[(c0 + c) * w + c] = static_cast<T>(1.0);
 			}
-			i = d; // return to diagonal
-			// row walk left from jj
-			for (j = d - 1; j >= 0; --j)
+			blas::getrs(n, LU.data(), ipiv.data(), w, B.data());
+
+			for (size_t i = 0; i < n; ++i)
 			{
-				// formula (2.17) p 71
-				X(i, j) = static_cast<T>(0.);
-				for (long long k = j + 1; k <= n; ++k)
-				{
-					X(i, j) -= X(i, k) * L(k, j);
-				}
+				std::copy(B.begin() + i * w, B.begin() + (i + 1) * w, X.mvec_.begin() + i * n + c0);
 			}
-			j = d; // return to diagonal
-			--d;
-			if (d < 0)
-				break; // exit cycle
-		} // while (!end)
+		}
 		return X;
 	} // Matrix<T> Matrix<T>::inverse()
 
+	template <typename T>
+	Matrix<T> &Matrix<T>::invert()
+	{
+		MATH_PROFILE_SCOPE("Matrix::invert");
+		if (this->rows_ != this->cols_)
+		{
+			throw(math::ExceptionNonSquareMatrix("invert: Inverse of non square matrix!"));
+		}
+		// see Matrix<T>::inverse() about representations
+		size_t n = this->rows_;
+		std::vector<size_t> ipiv(n);
+		if (blas::getrf(n, this->mvec_.data(), ipiv.data()) != 0)
+		{
+			throw(math::ExceptionDegenerateMatrix("invert: Matrix is singular!"));
+		}
+		blas::getri(n, this->mvec_.data(), ipiv.data());
+		return *this;
+	} // Matrix<T> &Matrix<T>::invert()
+
 	template <typename T>
 	bool Matrix<T>::compare(const Matrix<T> &M, T eps)
 	{
@@ -480,6 +480,83 @@ omp_set_num_threads(4);
 	EXPECT_EQ(m2.compare(truth, 1.e-4), true);
 }
 
+TEST(Matrix, InversePivoting)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+	// zero leading element requires pivoting
+	math::Matrix<double> m1 =
+	{
+	  {0., 1., 2.},
+	  {1., 0., 3.},
+	  {4., -3., 8.}
+	};
+	math::Matrix<double> truth =
+	{
+	  {-4.5, 7., -1.5},
+	  {-2., 4., -1.},
+	  {1.5, -2., 0.5}
+	};
+	EXPECT_EQ(m1.inverse().compare(truth, 1.e-10), true);
+
+	// several blocks of columns, column representation
+	size_t n = 150;
+	math::Matrix<double> A(n, n, math::MatRep::Column);
+	A.rfill(1);
+	math::Matrix<double> I(n, n, 0.0);
+	for (size_t i = 0; i < n; ++i)
+	{
+		I(i, i) = 1.0;
+	}
+	math::Matrix<double> A_inv = A.inverse();
+	EXPECT_EQ(A_inv.representation(), math::MatRep::Column);
+	EXPECT_EQ((A * A_inv).compare(I, 1.e-8), true);
+
+	// singular matrix
+	math::Matrix<double> m2 =
+	{
+	  {1., 2.},
+	  {2., 4.}
+	};
+	EXPECT_THROW(m2.inverse(), math::ExceptionDegenerateMatrix);
+}
+
+TEST(Matrix, Invert)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+	size_t n = 100;
+	math::Matrix<double> A(n);
+	A.rfill(1);
+	math::Matrix<double> A_inv = A;
+	A_inv.invert();
+	EXPECT_EQ(A_inv.compare(A.inverse(), 1.e-8), true);
+
+	math::Matrix<double> m1 =
+	{
+	  {0., 1., 2.},
+	  {1., 0., 3.},
+	  {4., -3., 8.}
+	};
+	math::Matrix<double> truth =
+	{
+	  {-4.5, 7., -1.5},
+	  {-2., 4., -1.},
+	  {1.5, -2., 0.5}
+	};
+	EXPECT_EQ(m1.invert().compare(truth, 1.e-10), true);
+
+	// singular matrix
+	math::Matrix<double> m2 =
+	{
+	  {1., 2.},
+	  {2., 4.}
+	};
+	EXPECT_THROW(m2.invert(), math::ExceptionDegenerateMatrix);
+}
+
 TEST(Matrix, IndexOperator)
 {
 #ifdef MATH_OMP_DEFINE
@@ -580,6 +657,51 @@ omp_set_num_threads(4);
 	EXPECT_EQ(m_cat_cols2.compare(m_truth_cols, 1.e-4), true);
 }
 
+TEST(Matrix, CatMixedRepresentation)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+	math::Matrix<double> m_row =
+	{
+	  {1.0, 2.0},
+	  {3.0, 4.0}
+	};
+	math::Matrix<double> m_col(2, 1, math::MatRep::Column);
+	m_col(0, 0) = 5.0;
+	m_col(1, 0) = 6.0;
+	math::Matrix<double> m_square(2, math::MatRep::Column);
+	m_square(0, 0) = 7.0;
+	m_square(0, 1) = 8.0;
+	m_square(1, 0) = 9.0;
+	m_square(1, 1) = 10.0;
+
+	math::Matrix<double> m_truth_cols =
+	{
+	  {1.0, 2.0, 5.0},
+	  {3.0, 4.0, 6.0}
+	};
+
+	for (math::MatRep repr : {math::MatRep::Row, math::MatRep::Column})
+	{
+		math::Matrix<double> m_cat = math::cat(
+			std::vector<math::Matrix<double>>{m_row, m_col},
+			math::Dimension::Column,
+			repr);
+		EXPECT_EQ(m_cat.representation() == repr, true);
+		EXPECT_EQ(m_cat.compare(m_truth_cols, 1.e-4), true);
+
+		math::Matrix<double> m_cat_rows = math::cat(
+			std::vector<math::Matrix<double>>{m_row, m_square},
+			math::Dimension::Row,
+			repr);
+		EXPECT_EQ(m_cat_rows.rows(), 4);
+		EXPECT_EQ(m_cat_rows(1, 0), 3.0);
+		EXPECT_EQ(m_cat_rows(2, 1), 8.0);
+		EXPECT_EQ(m_cat_rows(3, 0), 9.0);
+	}
+}
+
 TEST(Matrix, RangeIndexOperator)
 {
 #ifdef MATH_OMP_DEFINE
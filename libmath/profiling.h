@@ -0,0 +1,276 @@
+#pragma once
+
+#include <libmath/math_settings.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <fstream>
+#include <ostream>
+#include <cstddef>
+
+namespace math
+{
+	/**
+	* @brief Statistics of the last solve of numerical method
+	* @details Iterations, residual history and counters are collected always, their cost is
+	* negligible comparing with iteration of any method. Phase times are collected only if
+	* libmath built with profiling (MATH_USE_PROFILING option), otherwise phase_time stays empty.
+	*/
+	struct SolverStats
+	{
+		/// @brief Number of performed iterations
+		size_t iterations = 0;
+
+		/// @brief Residual norm after each iteration
+		std::vector<real> residuals;
+
+		/// @brief Number of evaluations of individual functions @f$ F_i @f$
+		size_t f_evals = 0;
+
+		/// @brief Number of matrix-vector products (operator applications)
+		size_t matvecs = 0;
+
+		/// @brief Accumulated wall time of solver phases in seconds
+		std::map<std::string, double> phase_time;
+
+		/// @brief Reset statistics before new solve
+		void clear()
+		{
+			iterations = 0;
+			residuals.clear();
+			f_evals = 0;
+			matvecs = 0;
+			phase_time.clear();
+		}
+	};
+}
+
+namespace math::profiling
+{
+	/**
+	* @brief Profiling event
+	*/
+	struct Event
+	{
+		/// @brief Event name
+		std::string name;
+
+		/// @brief Chrome trace phase: 'X' - complete event (timer), 'C' - counter
+		char phase = 'X';
+
+		/// @brief Start time in microseconds since profiler creation
+		double ts = 0.0;
+
+		/// @brief Duration in microseconds (timers)
+		double dur = 0.0;
+
+		/// @brief Value (counters)
+		double value = 0.0;
+
+		/// @brief Index of thread, recorded event
+		size_t tid = 0;
+	};
+
+	/**
+	* @brief Global thread-safe collector of profiling events
+	* @details Events are recorded by ScopedTimer and MATH_PROFILE_* macros. Collected events
+	* can be exported to Chrome trace JSON format (chrome://tracing, https://ui.perfetto.dev).
+	*/
+	class Profiler
+	{
+	private:
+		std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+		mutable std::mutex mutex_;
+
+		std::vector<Event> events_;
+
+		Profiler() = default;
+
+		static void writeEscaped(std::ostream& out, const std::string& str)
+		{
+			for (char c : str)
+			{
+				if (c == '"' || c == '\\')
+				{
+					out << '\\';
+				}
+				out << c;
+			}
+		}
+
+	public:
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		/// @brief Get global profiler
+		static Profiler& instance()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		/// @brief Time in microseconds since profiler creation
+		double now() const
+		{
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_).count();
+		}
+
+		/// @brief Small sequential index of calling thread
+		static size_t threadIndex()
+		{
+			static std::atomic<size_t> counter{ 0 };
+			thread_local size_t index = counter++;
+			return index;
+		}
+
+		/// @brief Record event
+		void record(Event event)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			events_.push_back(std::move(event));
+		}
+
+		/// @brief Record value of counter
+		void counter(const std::string& name, double value)
+		{
+			Event event;
+			event.name = name;
+			event.phase = 'C';
+			event.ts = now();
+			event.value = value;
+			event.tid = threadIndex();
+			record(std::move(event));
+		}
+
+		/// @brief Remove all recorded events
+		void clear()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			events_.clear();
+		}
+
+		/// @brief Copy of recorded events
+		std::vector<Event> events() const
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return events_;
+		}
+
+		/**
+		* @brief Write recorded events in Chrome trace JSON format
+		* @param out: Output stream
+		*/
+		void writeChromeTrace(std::ostream& out) const
+		{
+			std::vector<Event> events = this->events();
+			out << "{\"traceEvents\":[";
+			for (size_t i = 0; i < events.size(); ++i)
+			{
+				const Event& e = events[i];
+				out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+				writeEscaped(out, e.name);
+				out << "\",\"cat\":\"libmath\",\"ph\":\"" << e.phase << "\",\"ts\":" << e.ts
+					<< ",\"pid\":1,\"tid\":" << e.tid;
+				if (e.phase == 'X')
+				{
+					out << ",\"dur\":" << e.dur;
+				}
+				else
+				{
+					out << ",\"args\":{\"value\":" << e.value << "}";
+				}
+				out << "}";
+			}
+			out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		}
+
+		/**
+		* @brief Write recorded events in Chrome trace JSON format to file
+		* @param path: Output file path
+		* @return True on success
+		*/
+		bool writeChromeTrace(const std::string& path) const
+		{
+			std::ofstream file(path);
+			if (!file)
+			{
+				return false;
+			}
+			writeChromeTrace(file);
+			return static_cast<bool>(file);
+		}
+	};
+
+	/**
+	* @brief RAII timer: records complete event from construction to destruction
+	* @details If stats defined, duration is also added to SolverStats::phase_time[name]
+	*/
+	class ScopedTimer
+	{
+	private:
+		const char* name_;
+		SolverStats* stats_;
+		double start_;
+
+	public:
+		/**
+		* @param name: Event name. Must outlive timer (string literal)
+		* @param stats: Statistics for accumulating phase time (optional)
+		*/
+		explicit ScopedTimer(const char* name, SolverStats* stats = nullptr) :
+			name_(name), stats_(stats), start_(Profiler::instance().now())
+		{
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+		~ScopedTimer()
+		{
+			Profiler& profiler = Profiler::instance();
+			Event event;
+			event.name = name_;
+			event.phase = 'X';
+			event.ts = start_;
+			event.dur = profiler.now() - start_;
+			event.tid = Profiler::threadIndex();
+			if (stats_)
+			{
+				stats_->phase_time[name_] += event.dur * 1.e-6;
+			}
+			profiler.record(std::move(event));
+		}
+	};
+}
+
+/**
+* @defgroup Profiling Profiling macros
+* @{
+* @brief Instrumentation of hot paths, compiled out unless MATH_PROFILING_DEFINE defined
+* (MATH_USE_PROFILING CMake option)
+* - MATH_PROFILE_SCOPE(name): time current scope
+* - MATH_PROFILE_PHASE(name, stats): time current scope and add time to SolverStats phase
+* - MATH_PROFILE_COUNTER(name, value): record value of counter
+*/
+#define MATH_PROFILE_CONCAT_IMPL(a, b) a##b
+#define MATH_PROFILE_CONCAT(a, b) MATH_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef MATH_PROFILING_DEFINE
+#define MATH_PROFILE_SCOPE(name) \
+	math::profiling::ScopedTimer MATH_PROFILE_CONCAT(math_profile_timer_, __LINE__)(name)
+#define MATH_PROFILE_PHASE(name, stats) \
+	math::profiling::ScopedTimer MATH_PROFILE_CONCAT(math_profile_timer_, __LINE__)(name, &(stats))
+#define MATH_PROFILE_COUNTER(name, value) \
+	math::profiling::Profiler::instance().counter(name, static_cast<double>(value))
+#else
+#define MATH_PROFILE_SCOPE(name) ((void)0)
+#define MATH_PROFILE_PHASE(name, stats) ((void)0)
+#define MATH_PROFILE_COUNTER(name, value) ((void)0)
+#endif
+/**
+* @}
+*/
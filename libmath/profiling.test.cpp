@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <libmath/profiling.h>
+#include <sstream>
+#include <string>
+#include <thread>
+
+TEST(Profiling, ScopedTimer)
+{
+    math::profiling::Profiler::instance().clear();
+
+    math::SolverStats stats;
+    {
+        math::profiling::ScopedTimer timer("phase", &stats);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    {
+        math::profiling::ScopedTimer timer("phase", &stats);
+    }
+
+    std::vector<math::profiling::Event> events = math::profiling::Profiler::instance().events();
+
+    EXPECT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].name, "phase");
+    EXPECT_EQ(events[0].phase, 'X');
+    EXPECT_GE(events[0].dur, 2000.0);
+    EXPECT_EQ(stats.phase_time.size(), 1);
+    EXPECT_GE(stats.phase_time["phase"], 0.002);
+
+    stats.clear();
+    EXPECT_EQ(stats.phase_time.empty(), true);
+}
+
+TEST(Profiling, ChromeTrace)
+{
+    math::profiling::Profiler& profiler = math::profiling::Profiler::instance();
+    profiler.clear();
+
+    {
+        math::profiling::ScopedTimer timer("quoted \"name\"");
+    }
+    profiler.counter("counter", 42.0);
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    std::string trace = out.str();
+
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.find("quoted \\\"name\\\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(trace.find("\"value\":42"), std::string::npos);
+
+    profiler.clear();
+    EXPECT_EQ(profiler.events().empty(), true);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/solver/las/krylov.h>
+#include <libmath/math_settings.h>
+#include <libmath/math_exception.h>
+#include <libmath/boolean.h>
+#include <string>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with conjugate gradient method
+	* @details Method requires symmetric positive definite matrix A. It needs single matrix-vector product
+	* per iteration (BicGStab needs two), so it is about twice cheaper, than BicGStab for such systems.
+	*/
+	template <typename T>
+	class CG :
+		public LASsolver<T>
+	{
+	public:
+		/// @brief Default constructor
+		CG()
+		{
+			LASsolver<T>::method_ = "CG";
+		};
+
+		/**
+		* @brief CG solver constructor.
+		* @param setup: Solver settings
+		*/
+		CG(const struct LASsetup& setup)
+		{
+			LASsolver<T>::method_ = "CG";
+
+			LASsolver<T>::checkInputs(setup);
+
+			LASsolver<T>::currentSetup_ = setup;
+		}
+
+		/// @brief Copy constructor
+		CG(const CG& uss)
+		{
+			LASsolver<T>::method_ = uss.method_;
+			LASsolver<T>::currentSetup_ = uss.currentSetup_;
+		}
+
+		virtual ~CG() {};
+
+		virtual LASsolver<T>* copy() override
+		{
+			return new CG<T>(*this);
+		}
+
+		using LASsolver<T>::solve;
+
+		/**
+		* @brief LASsolver::solve
+		*/
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x, SolverStats& stats) const override
+		{
+			// check inputs
+			LASsolver<T>::checkInputs(A, b, x);
+
+			LASsolver<T>::iterate(A, b, x, stats,
+				[](const auto& op, const auto& M, size_t n, size_t k, const T* b, T* x, T tol, size_t max_iter)
+				{
+					if (k == 1)
+					{
+						return krylov::cg(op, n, b, x, tol, max_iter, M);
+					}
+					return krylov::cgBatched(op, n, k, b, x, tol, max_iter, M);
+				});
+		}
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/solver/las/krylov.h>
+#include <libmath/math_settings.h>
+#include <libmath/math_exception.h>
+#include <libmath/boolean.h>
+#include <string>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with restarted generalized minimal residual method GMRES(m)
+	* @details Krylov basis is orthogonalized with modified Gram-Schmidt process, least squares problem
+	* is updated with Givens rotations. Dimension of Krylov subspace before restart is set by LASsetup::restart.
+	* Unlike BicGStab, residual norm decreases monotonically, so method is robust for nonsymmetric systems,
+	* where BicGStab breaks down.
+	*/
+	template <typename T>
+	class GMRES :
+		public LASsolver<T>
+	{
+	public:
+		/// @brief Default constructor
+		GMRES()
+		{
+			LASsolver<T>::method_ = "GMRES";
+		};
+
+		/**
+		* @brief GMRES solver constructor.
+		* @param setup: Solver settings
+		*/
+		GMRES(const struct LASsetup& setup)
+		{
+			LASsolver<T>::method_ = "GMRES";
+
+			LASsolver<T>::checkInputs(setup);
+
+			LASsolver<T>::currentSetup_ = setup;
+		}
+
+		/// @brief Copy constructor
+		GMRES(const GMRES& uss)
+		{
+			LASsolver<T>::method_ = uss.method_;
+			LASsolver<T>::currentSetup_ = uss.currentSetup_;
+		}
+
+		virtual ~GMRES() {};
+
+		virtual LASsolver<T>* copy() override
+		{
+			return new GMRES<T>(*this);
+		}
+
+		using LASsolver<T>::solve;
+
+		/**
+		* @brief LASsolver::solve
+		*/
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x, SolverStats& stats) const override
+		{
+			// check inputs
+			LASsolver<T>::checkInputs(A, b, x);
+
+			size_t restart = LASsolver<T>::currentSetup_.restart;
+
+			LASsolver<T>::iterate(A, b, x, stats,
+				[restart](const auto& op, const auto& M, size_t n, size_t k, const T* b, T* x, T tol, size_t max_iter)
+				{
+					if (k == 1)
+					{
+						return krylov::gmres(op, n, b, x, tol, max_iter, restart, M);
+					}
+					return krylov::gmresBatched(op, n, k, b, x, tol, max_iter, restart, M);
+				});
+		}
+	};
+}
@@ -2,11 +2,15 @@
 
 #include <libmath/solver/las/lassolver.h>
 #include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <vector>
 
 namespace math
 {
 	/**
 	* @brief Class for solving LAS with Kholetsky method (via LU-decomposition)
+	* @details Several right-hand sides are solved with single factorization and blocked
+	* triangular solves (see blas::trsm)
 	*/
 	template <typename T>
 	class Kholetsky :
@@ -40,35 +44,52 @@ namespace math
 			return new Kholetsky<T>(*this);
 		}
 
+		using LASsolver<T>::solve;
+
 		/// @brief LASsolver::solve
-		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) const override
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x, SolverStats& stats) const override
 		{
 			// check inputs
 			LASsolver<T>::checkInputs(A, b, x);
 
-			// working arrays
-			Matrix<T> LUE = A.decompLU();
-			Matrix<T> Y(A.rows(), 1);
-			// first run (eq 2.11 ����������, p 68)
-			for (int i = 0; i < A.rows(); ++i)
+			stats.clear();
+			MATH_PROFILE_PHASE("solve", stats);
+
+			size_t n = A.rows();
+			size_t k = b.cols();
+
+			// single factorization for all right-hand sides
+			Matrix<T> LUE;
+			{
+				MATH_PROFILE_PHASE("factorization", stats);
+				LUE = A.decompLU();
+			}
+			bool row_major = LUE.representation() == MatRep::Row;
+
+			// right-hand sides, stored row by row (n x k)
+			std::vector<T> Y(n * k);
+			for (size_t i = 0; i < n; ++i)
 			{
-				Y(i, 0) = b(i, 0);
-				for (int k = 0; k <= i - 1; ++k)
+				for (size_t c = 0; c < k; ++c)
 				{
-					Y(i, 0) -= LUE(i, k) * Y(k, 0);
+					Y[i * k + c] = b(i, c);
 				}
 			}
-			// second run (eq 2.13 ����������, p 68)
-			// size_t i{0};
-			for (int j = static_cast<int>(A.rows() - 1); j >= 0; --j)
+
+			{
+				MATH_PROFILE_PHASE("substitution", stats);
+				// first run (eq 2.11, p 68): L Y = b
+				blas::trsm(n, LUE.data(), row_major, false, k, Y.data());
+				// second run (eq 2.13, p 68): U x = Y
+				blas::trsm(n, LUE.data(), row_major, true, k, Y.data());
+			}
+
+			for (size_t i = 0; i < n; ++i)
 			{
-				size_t i = static_cast<size_t>(j);
-				x(i, 0) = Y(i, 0);
-				for (size_t k = i + 1; k < A.rows(); ++k)
+				for (size_t c = 0; c < k; ++c)
 				{
-					x(i, 0) = x(i, 0) - LUE(i, k) * x(k, 0);
+					x(i, c) = Y[i * k + c];
 				}
-				x(i, 0) = x(i, 0) / LUE(i, i);
 			}
 		}
 	};
@@ -0,0 +1,853 @@
+#pragma once
+
+#include <libmath/blas.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace math::krylov
+{
+	/**
+	* @defgroup Krylov Matrix-free Krylov methods
+	* @{
+	* @brief Krylov subspace methods, which need only the action of operator on vector
+	* @details Operator A and preconditioner M are any callable objects with signature
+	* @code
+	* void(const T* in, T* out)
+	* @endcode
+	* computing @f$ out = A \cdot in @f$ and @f$ out = M^{-1} \cdot in @f$ respectively.
+	* Preconditioners are applied from the right, so the monitored residual is the residual of
+	* the original system @f$ \|\mathbf{b} - \mathbf{A}\mathbf{x}\| @f$.
+	* Work arrays are allocated once per call, iterations allocate only for amortized growth of
+	* residual history.
+	*/
+
+	/**
+	* @brief Result of Krylov method
+	*/
+	template <typename T>
+	struct Result
+	{
+		/// @brief Number of performed iterations (Arnoldi steps for GMRES)
+		size_t iterations = 0;
+
+		/// @brief Euclidean norm of the last residual
+		T residual = static_cast<T>(0.0);
+
+		/// @brief True if target tolerance reached
+		bool converged = false;
+
+		/// @brief Residual norm after each iteration (maximum over systems for batched methods)
+		std::vector<T> history;
+	};
+
+	/**
+	* @brief Identity preconditioner
+	*/
+	struct Identity
+	{
+	};
+
+	namespace detail
+	{
+		/// @brief Apply preconditioner, which may be Identity or callable void(const T*, T*)
+		template <typename T, typename Prec>
+		void precondition(const Prec& M, const T* in, T* out, size_t n)
+		{
+			if constexpr (std::is_same_v<Prec, Identity>)
+			{
+				blas::copy(n, in, out);
+			}
+			else
+			{
+				M(in, out);
+			}
+		}
+	}
+
+	/**
+	* @brief Restarted GMRES(m) with modified Gram-Schmidt orthogonalization and Givens rotations
+	* @param A: Operator
+	* @param n: System dimension
+	* @param b: Right-hand side
+	* @param[in,out] x: Initial guess on input, solution on output
+	* @param tol: Target absolute tolerance for residual norm
+	* @param max_iter: Maximum number of Arnoldi steps; true residual products at restarts are not counted
+	* @param restart: Dimension of Krylov subspace before restart
+	* @param M: Right preconditioner
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> gmres(
+		const Op& A,
+		size_t n,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		size_t restart = 30,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+		size_t m = std::max<size_t>(1, std::min(restart, n));
+
+		// Krylov basis (m+1 vectors of size n)
+		std::vector<T> V((m + 1) * n);
+		// Hessenberg matrix, column-major (m+1) x m
+		std::vector<T> H((m + 1) * m);
+		std::vector<T> cs(m), sn(m), g(m + 1), y(m);
+		std::vector<T> w(n), z(n);
+
+		// r = b - A x
+		A(x, w.data());
+		blas::axpby(n, static_cast<T>(1.0), b, static_cast<T>(-1.0), w.data(), V.data());
+		T beta = blas::nrm2(n, V.data());
+		res.residual = beta;
+		if (beta <= tol)
+		{
+			res.converged = true;
+			return res;
+		}
+
+		while (res.iterations < max_iter)
+		{
+			blas::scal(n, static_cast<T>(1.0) / beta, V.data());
+			std::fill(g.begin(), g.end(), static_cast<T>(0.0));
+			g[0] = beta;
+
+			size_t k = 0;
+			for (size_t j = 0; j < m; ++j)
+			{
+				T* vj = V.data() + j * n;
+				T* vj1 = V.data() + (j + 1) * n;
+				T* hj = H.data() + j * (m + 1);
+
+				detail::precondition(M, vj, z.data(), n);
+				A(z.data(), vj1);
+
+				// modified Gram-Schmidt
+				for (size_t i = 0; i <= j; ++i)
+				{
+					hj[i] = blas::dot(n, vj1, V.data() + i * n);
+					blas::axpy(n, -hj[i], V.data() + i * n, vj1);
+				}
+				hj[j + 1] = blas::nrm2(n, vj1);
+				bool breakdown = hj[j + 1] == static_cast<T>(0.0);
+				if (!breakdown)
+				{
+					blas::scal(n, static_cast<T>(1.0) / hj[j + 1], vj1);
+				}
+
+				// apply previous Givens rotations to new column
+				for (size_t i = 0; i < j; ++i)
+				{
+					T tmp = cs[i] * hj[i] + sn[i] * hj[i + 1];
+					hj[i + 1] = -sn[i] * hj[i] + cs[i] * hj[i + 1];
+					hj[i] = tmp;
+				}
+
+				// new rotation eliminating H(j+1, j)
+				T denom = std::hypot(hj[j], hj[j + 1]);
+				if (denom == static_cast<T>(0.0))
+				{
+					cs[j] = static_cast<T>(1.0);
+					sn[j] = static_cast<T>(0.0);
+				}
+				else
+				{
+					cs[j] = hj[j] / denom;
+					sn[j] = hj[j + 1] / denom;
+				}
+				hj[j] = cs[j] * hj[j] + sn[j] * hj[j + 1];
+				hj[j + 1] = static_cast<T>(0.0);
+				g[j + 1] = -sn[j] * g[j];
+				g[j] = cs[j] * g[j];
+
+				++res.iterations;
+				k = j + 1;
+				res.residual = std::abs(g[j + 1]);
+				res.history.push_back(res.residual);
+
+				if (res.residual <= tol || breakdown || res.iterations >= max_iter)
+				{
+					break;
+				}
+			}
+
+			// solve upper triangular system H y = g
+			for (long long i = static_cast<long long>(k) - 1; i >= 0; --i)
+			{
+				T sum = g[i];
+				for (size_t l = static_cast<size_t>(i) + 1; l < k; ++l)
+				{
+					sum -= H[l * (m + 1) + i] * y[l];
+				}
+				T diag = H[static_cast<size_t>(i) * (m + 1) + i];
+				y[i] = diag != static_cast<T>(0.0) ? sum / diag : static_cast<T>(0.0);
+			}
+
+			// x = x + M^{-1} V y
+			std::fill(w.begin(), w.end(), static_cast<T>(0.0));
+			for (size_t i = 0; i < k; ++i)
+			{
+				blas::axpy(n, y[i], V.data() + i * n, w.data());
+			}
+			detail::precondition(M, w.data(), z.data(), n);
+			blas::axpy(n, static_cast<T>(1.0), z.data(), x);
+
+			// true residual for restart
+			A(x, w.data());
+			blas::axpby(n, static_cast<T>(1.0), b, static_cast<T>(-1.0), w.data(), V.data());
+			beta = blas::nrm2(n, V.data());
+			res.residual = beta;
+			if (beta <= tol)
+			{
+				res.converged = true;
+				return res;
+			}
+			if (beta == static_cast<T>(0.0) || !std::isfinite(beta))
+			{
+				return res;
+			}
+		}
+
+		return res;
+	}
+
+	/**
+	* @brief Biconjugate gradient stabilized method (BiCGStab)
+	* @param A: Operator
+	* @param n: System dimension
+	* @param b: Right-hand side
+	* @param[in,out] x: Initial guess on input, solution on output
+	* @param tol: Target absolute tolerance for residual norm
+	* @param max_iter: Maximum number of iterations
+	* @param M: Right preconditioner
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> bicgstab(
+		const Op& A,
+		size_t n,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+
+		std::vector<T> r(n), r_hat(n), p(n, static_cast<T>(0.0)), v(n, static_cast<T>(0.0));
+		std::vector<T> p_hat(n), s_hat(n), t(n);
+
+		A(x, t.data());
+		blas::axpby(n, static_cast<T>(1.0), b, static_cast<T>(-1.0), t.data(), r.data());
+		blas::copy(n, r.data(), r_hat.data());
+
+		res.residual = blas::nrm2(n, r.data());
+		if (res.residual <= tol)
+		{
+			res.converged = true;
+			return res;
+		}
+
+		T rho = static_cast<T>(1.0);
+		T alpha = static_cast<T>(1.0);
+		T omega = static_cast<T>(1.0);
+
+		while (res.iterations < max_iter)
+		{
+			T rho_new = blas::dot(n, r_hat.data(), r.data());
+			if (rho_new == static_cast<T>(0.0) || omega == static_cast<T>(0.0))
+			{
+				// breakdown
+				return res;
+			}
+			T beta = (rho_new / rho) * (alpha / omega);
+			rho = rho_new;
+
+			// p = r + beta (p - omega v)
+			blas::axpy(n, -omega, v.data(), p.data());
+			blas::xpay(n, r.data(), beta, p.data());
+
+			detail::precondition(M, p.data(), p_hat.data(), n);
+			A(p_hat.data(), v.data());
+
+			T r_hat_v = blas::dot(n, r_hat.data(), v.data());
+			if (r_hat_v == static_cast<T>(0.0))
+			{
+				return res;
+			}
+			alpha = rho / r_hat_v;
+
+			// s = r - alpha v (stored in r)
+			blas::axpy(n, -alpha, v.data(), r.data());
+			blas::axpy(n, alpha, p_hat.data(), x);
+
+			++res.iterations;
+
+			res.residual = blas::nrm2(n, r.data());
+			if (res.residual <= tol)
+			{
+				res.history.push_back(res.residual);
+				res.converged = true;
+				return res;
+			}
+
+			detail::precondition(M, r.data(), s_hat.data(), n);
+			A(s_hat.data(), t.data());
+
+			T tt = blas::dot(n, t.data(), t.data());
+			omega = tt != static_cast<T>(0.0) ? blas::dot(n, t.data(), r.data()) / tt : static_cast<T>(0.0);
+
+			blas::axpy(n, omega, s_hat.data(), x);
+			blas::axpy(n, -omega, t.data(), r.data());
+
+			res.residual = blas::nrm2(n, r.data());
+			res.history.push_back(res.residual);
+			if (res.residual <= tol)
+			{
+				res.converged = true;
+				return res;
+			}
+		}
+
+		return res;
+	}
+
+	/**
+	* @brief Preconditioned conjugate gradient method (CG) for symmetric positive definite operators
+	* @details Preconditioner must be symmetric positive definite as well. Unlike GMRES and BiCGStab
+	* preconditioner is applied on the left, as in standard PCG: @f$ \mathbf{z} = \mathbf{M}\mathbf{r} @f$
+	* defines search directions, while residual of the original (unpreconditioned) system is monitored
+	* @param A: Operator
+	* @param n: System dimension
+	* @param b: Right-hand side
+	* @param[in,out] x: Initial guess on input, solution on output
+	* @param tol: Target absolute tolerance for residual norm
+	* @param max_iter: Maximum number of iterations
+	* @param M: Preconditioner
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> cg(
+		const Op& A,
+		size_t n,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+
+		std::vector<T> r(n), z(n), p(n), q(n);
+
+		A(x, q.data());
+		blas::axpby(n, static_cast<T>(1.0), b, static_cast<T>(-1.0), q.data(), r.data());
+
+		res.residual = blas::nrm2(n, r.data());
+		if (res.residual <= tol)
+		{
+			res.converged = true;
+			return res;
+		}
+
+		detail::precondition(M, r.data(), z.data(), n);
+		blas::copy(n, z.data(), p.data());
+		T rz = blas::dot(n, r.data(), z.data());
+
+		while (res.iterations < max_iter)
+		{
+			A(p.data(), q.data());
+			T pq = blas::dot(n, p.data(), q.data());
+			if (pq == static_cast<T>(0.0))
+			{
+				// breakdown
+				return res;
+			}
+			T alpha = rz / pq;
+
+			blas::axpy(n, alpha, p.data(), x);
+			blas::axpy(n, -alpha, q.data(), r.data());
+
+			++res.iterations;
+
+			res.residual = blas::nrm2(n, r.data());
+			res.history.push_back(res.residual);
+			if (res.residual <= tol)
+			{
+				res.converged = true;
+				return res;
+			}
+
+			detail::precondition(M, r.data(), z.data(), n);
+			T rz_new = blas::dot(n, r.data(), z.data());
+			T beta = rz_new / rz;
+			rz = rz_new;
+
+			// p = z + beta p
+			blas::xpay(n, z.data(), beta, p.data());
+		}
+
+		return res;
+	}
+
+	/**
+	* @brief Batched methods for k right-hand sides
+	* @details Batched methods run k independent Krylov processes in lockstep. Blocks of k vectors
+	* are stored one after another (column-major n x k), operator has signature
+	* @code
+	* void(const T* in, T* out, size_t k)
+	* @endcode
+	* and computes @f$ out_c = A \cdot in_c @f$ for all k vectors at once, so A is read from memory
+	* once per iteration for all systems. Each system has its own scalars and stops independently
+	* on convergence or breakdown. Result holds maximum number of iterations and maximum residual
+	* over all systems, converged is true only if all systems converged.
+	*/
+
+	/**
+	* @brief Batched restarted GMRES(m), see gmres
+	* @param A: Block operator
+	* @param n: System dimension
+	* @param k: Number of right-hand sides
+	* @param b: Right-hand sides (n x k)
+	* @param[in,out] x: Initial guesses on input, solutions on output (n x k)
+	* @param tol: Target absolute tolerance for residual norm of each system
+	* @param max_iter: Maximum number of block Arnoldi steps; true residual products at restarts are not counted
+	* @param restart: Dimension of Krylov subspace before restart
+	* @param M: Right preconditioner (applied to each vector)
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> gmresBatched(
+		const Op& A,
+		size_t n,
+		size_t k,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		size_t restart = 30,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+		size_t m = std::max<size_t>(1, std::min(restart, n));
+		size_t ldv = (m + 1) * n;
+		size_t ldh = (m + 1) * m;
+
+		std::vector<T> V(k * ldv), H(k * ldh);
+		std::vector<T> cs(k * m), sn(k * m), g(k * (m + 1)), y(m);
+		std::vector<T> W(n * k), Z(n * k, static_cast<T>(0.0));
+		std::vector<T> beta(k), current(k);
+		std::vector<size_t> dim(k);
+		// 0 - active, 1 - converged, 2 - stalled
+		std::vector<int> state(k, 0);
+		std::vector<bool> active(k);
+
+		auto residuals = [&]()
+		{
+			A(x, W.data(), k);
+			for (size_t c = 0; c < k; ++c)
+			{
+				if (state[c] != 0)
+				{
+					continue;
+				}
+				T* v0 = V.data() + c * ldv;
+				blas::axpby(n, static_cast<T>(1.0), b + c * n, static_cast<T>(-1.0), W.data() + c * n, v0);
+				beta[c] = blas::nrm2(n, v0);
+				if (beta[c] <= tol)
+				{
+					state[c] = 1;
+				}
+				else if (!std::isfinite(beta[c]))
+				{
+					state[c] = 2;
+				}
+			}
+			res.residual = *std::max_element(beta.begin(), beta.end());
+			current = beta;
+		};
+
+		residuals();
+
+		while (res.iterations < max_iter)
+		{
+			bool any = false;
+			for (size_t c = 0; c < k; ++c)
+			{
+				active[c] = state[c] == 0;
+				dim[c] = 0;
+				if (active[c])
+				{
+					any = true;
+					blas::scal(n, static_cast<T>(1.0) / beta[c], V.data() + c * ldv);
+					T* gc = g.data() + c * (m + 1);
+					std::fill(gc, gc + m + 1, static_cast<T>(0.0));
+					gc[0] = beta[c];
+				}
+			}
+			if (!any)
+			{
+				break;
+			}
+
+			for (size_t j = 0; j < m; ++j)
+			{
+				for (size_t c = 0; c < k; ++c)
+				{
+					if (active[c])
+					{
+						detail::precondition(M, V.data() + c * ldv + j * n, Z.data() + c * n, n);
+					}
+				}
+				A(Z.data(), W.data(), k);
+
+				any = false;
+				for (size_t c = 0; c < k; ++c)
+				{
+					if (!active[c])
+					{
+						continue;
+					}
+					T* Vc = V.data() + c * ldv;
+					T* vj1 = Vc + (j + 1) * n;
+					T* hj = H.data() + c * ldh + j * (m + 1);
+					T* csc = cs.data() + c * m;
+					T* snc = sn.data() + c * m;
+					T* gc = g.data() + c * (m + 1);
+
+					blas::copy(n, W.data() + c * n, vj1);
+
+					// modified Gram-Schmidt
+					for (size_t i = 0; i <= j; ++i)
+					{
+						hj[i] = blas::dot(n, vj1, Vc + i * n);
+						blas::axpy(n, -hj[i], Vc + i * n, vj1);
+					}
+					hj[j + 1] = blas::nrm2(n, vj1);
+					bool breakdown = hj[j + 1] == static_cast<T>(0.0);
+					if (!breakdown)
+					{
+						blas::scal(n, static_cast<T>(1.0) / hj[j + 1], vj1);
+					}
+
+					// Givens rotations
+					for (size_t i = 0; i < j; ++i)
+					{
+						T tmp = csc[i] * hj[i] + snc[i] * hj[i + 1];
+						hj[i + 1] = -snc[i] * hj[i] + csc[i] * hj[i + 1];
+						hj[i] = tmp;
+					}
+					T denom = std::hypot(hj[j], hj[j + 1]);
+					if (denom == static_cast<T>(0.0))
+					{
+						csc[j] = static_cast<T>(1.0);
+						snc[j] = static_cast<T>(0.0);
+					}
+					else
+					{
+						csc[j] = hj[j] / denom;
+						snc[j] = hj[j + 1] / denom;
+					}
+					hj[j] = csc[j] * hj[j] + snc[j] * hj[j + 1];
+					hj[j + 1] = static_cast<T>(0.0);
+					gc[j + 1] = -snc[j] * gc[j];
+					gc[j] = csc[j] * gc[j];
+
+					dim[c] = j + 1;
+					current[c] = std::abs(gc[j + 1]);
+					if (current[c] <= tol || breakdown)
+					{
+						active[c] = false;
+					}
+					any = any || active[c];
+				}
+
+				++res.iterations;
+				res.history.push_back(*std::max_element(current.begin(), current.end()));
+				if (!any || res.iterations >= max_iter)
+				{
+					break;
+				}
+			}
+
+			// x = x + M^{-1} V y for every system
+			for (size_t c = 0; c < k; ++c)
+			{
+				size_t kc = dim[c];
+				if (kc == 0)
+				{
+					continue;
+				}
+				const T* Hc = H.data() + c * ldh;
+				const T* gc = g.data() + c * (m + 1);
+				const T* Vc = V.data() + c * ldv;
+				for (long long i = static_cast<long long>(kc) - 1; i >= 0; --i)
+				{
+					T sum = gc[i];
+					for (size_t l = static_cast<size_t>(i) + 1; l < kc; ++l)
+					{
+						sum -= Hc[l * (m + 1) + i] * y[l];
+					}
+					T diag = Hc[static_cast<size_t>(i) * (m + 1) + i];
+					y[i] = diag != static_cast<T>(0.0) ? sum / diag : static_cast<T>(0.0);
+				}
+				T* wc = W.data() + c * n;
+				std::fill(wc, wc + n, static_cast<T>(0.0));
+				for (size_t i = 0; i < kc; ++i)
+				{
+					blas::axpy(n, y[i], Vc + i * n, wc);
+				}
+				T* zc = Z.data() + c * n;
+				detail::precondition(M, wc, zc, n);
+				blas::axpy(n, static_cast<T>(1.0), zc, x + c * n);
+			}
+
+			// true residuals for restart
+			residuals();
+		}
+
+		res.converged = std::all_of(state.begin(), state.end(), [](int st) { return st == 1; });
+		return res;
+	}
+
+	/**
+	* @brief Batched BiCGStab, see bicgstab
+	* @param A: Block operator
+	* @param n: System dimension
+	* @param k: Number of right-hand sides
+	* @param b: Right-hand sides (n x k)
+	* @param[in,out] x: Initial guesses on input, solutions on output (n x k)
+	* @param tol: Target absolute tolerance for residual norm of each system
+	* @param max_iter: Maximum number of iterations
+	* @param M: Right preconditioner (applied to each vector)
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> bicgstabBatched(
+		const Op& A,
+		size_t n,
+		size_t k,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+		size_t nk = n * k;
+
+		std::vector<T> r(nk), r_hat(nk), p(nk, static_cast<T>(0.0)), v(nk, static_cast<T>(0.0));
+		std::vector<T> p_hat(nk, static_cast<T>(0.0)), s_hat(nk, static_cast<T>(0.0)), t(nk);
+		std::vector<T> rho(k, static_cast<T>(1.0)), alpha(k, static_cast<T>(1.0)), omega(k, static_cast<T>(1.0));
+		std::vector<T> residual(k);
+		// 0 - active, 1 - converged, 2 - breakdown
+		std::vector<int> state(k, 0);
+
+		auto isActive = [&state]()
+		{
+			return std::any_of(state.begin(), state.end(), [](int st) { return st == 0; });
+		};
+
+		A(x, t.data(), k);
+		blas::axpby(nk, static_cast<T>(1.0), b, static_cast<T>(-1.0), t.data(), r.data());
+		blas::copy(nk, r.data(), r_hat.data());
+		for (size_t c = 0; c < k; ++c)
+		{
+			residual[c] = blas::nrm2(n, r.data() + c * n);
+			if (residual[c] <= tol)
+			{
+				state[c] = 1;
+			}
+		}
+
+		while (res.iterations < max_iter && isActive())
+		{
+			for (size_t c = 0; c < k; ++c)
+			{
+				if (state[c] != 0)
+				{
+					continue;
+				}
+				size_t off = c * n;
+				T rho_new = blas::dot(n, r_hat.data() + off, r.data() + off);
+				if (rho_new == static_cast<T>(0.0) || omega[c] == static_cast<T>(0.0))
+				{
+					state[c] = 2;
+					continue;
+				}
+				T beta = (rho_new / rho[c]) * (alpha[c] / omega[c]);
+				rho[c] = rho_new;
+
+				// p = r + beta (p - omega v)
+				blas::axpy(n, -omega[c], v.data() + off, p.data() + off);
+				blas::xpay(n, r.data() + off, beta, p.data() + off);
+
+				detail::precondition(M, p.data() + off, p_hat.data() + off, n);
+			}
+			if (!isActive())
+			{
+				break;
+			}
+			A(p_hat.data(), v.data(), k);
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				if (state[c] != 0)
+				{
+					continue;
+				}
+				size_t off = c * n;
+				T r_hat_v = blas::dot(n, r_hat.data() + off, v.data() + off);
+				if (r_hat_v == static_cast<T>(0.0))
+				{
+					state[c] = 2;
+					continue;
+				}
+				alpha[c] = rho[c] / r_hat_v;
+
+				// s = r - alpha v (stored in r)
+				blas::axpy(n, -alpha[c], v.data() + off, r.data() + off);
+				blas::axpy(n, alpha[c], p_hat.data() + off, x + off);
+
+				residual[c] = blas::nrm2(n, r.data() + off);
+				if (residual[c] <= tol)
+				{
+					state[c] = 1;
+					continue;
+				}
+				detail::precondition(M, r.data() + off, s_hat.data() + off, n);
+			}
+
+			++res.iterations;
+
+			if (!isActive())
+			{
+				res.history.push_back(*std::max_element(residual.begin(), residual.end()));
+				break;
+			}
+			A(s_hat.data(), t.data(), k);
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				if (state[c] != 0)
+				{
+					continue;
+				}
+				size_t off = c * n;
+				T tt = blas::dot(n, t.data() + off, t.data() + off);
+				omega[c] = tt != static_cast<T>(0.0) ? blas::dot(n, t.data() + off, r.data() + off) / tt : static_cast<T>(0.0);
+
+				blas::axpy(n, omega[c], s_hat.data() + off, x + off);
+				blas::axpy(n, -omega[c], t.data() + off, r.data() + off);
+
+				residual[c] = blas::nrm2(n, r.data() + off);
+				if (residual[c] <= tol)
+				{
+					state[c] = 1;
+				}
+			}
+			res.history.push_back(*std::max_element(residual.begin(), residual.end()));
+		}
+
+		res.residual = *std::max_element(residual.begin(), residual.end());
+		res.converged = std::all_of(state.begin(), state.end(), [](int st) { return st == 1; });
+		return res;
+	}
+
+	/**
+	* @brief Batched preconditioned CG, see cg
+	* @param A: Block operator
+	* @param n: System dimension
+	* @param k: Number of right-hand sides
+	* @param b: Right-hand sides (n x k)
+	* @param[in,out] x: Initial guesses on input, solutions on output (n x k)
+	* @param tol: Target absolute tolerance for residual norm of each system
+	* @param max_iter: Maximum number of iterations
+	* @param M: Preconditioner (applied to each vector)
+	*/
+	template <typename T, typename Op, typename Prec = Identity>
+	Result<T> cgBatched(
+		const Op& A,
+		size_t n,
+		size_t k,
+		const T* b,
+		T* x,
+		T tol,
+		size_t max_iter,
+		const Prec& M = Prec())
+	{
+		Result<T> res;
+		size_t nk = n * k;
+
+		std::vector<T> r(nk), z(nk), p(nk), q(nk);
+		std::vector<T> rz(k), residual(k);
+		// 0 - active, 1 - converged, 2 - breakdown
+		std::vector<int> state(k, 0);
+
+		A(x, q.data(), k);
+		blas::axpby(nk, static_cast<T>(1.0), b, static_cast<T>(-1.0), q.data(), r.data());
+		for (size_t c = 0; c < k; ++c)
+		{
+			size_t off = c * n;
+			residual[c] = blas::nrm2(n, r.data() + off);
+			if (residual[c] <= tol)
+			{
+				state[c] = 1;
+			}
+			detail::precondition(M, r.data() + off, z.data() + off, n);
+			blas::copy(n, z.data() + off, p.data() + off);
+			rz[c] = blas::dot(n, r.data() + off, z.data() + off);
+		}
+
+		while (res.iterations < max_iter &&
+			std::any_of(state.begin(), state.end(), [](int st) { return st == 0; }))
+		{
+			A(p.data(), q.data(), k);
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				if (state[c] != 0)
+				{
+					continue;
+				}
+				size_t off = c * n;
+				T pq = blas::dot(n, p.data() + off, q.data() + off);
+				if (pq == static_cast<T>(0.0))
+				{
+					state[c] = 2;
+					continue;
+				}
+				T alpha = rz[c] / pq;
+
+				blas::axpy(n, alpha, p.data() + off, x + off);
+				blas::axpy(n, -alpha, q.data() + off, r.data() + off);
+
+				residual[c] = blas::nrm2(n, r.data() + off);
+				if (residual[c] <= tol)
+				{
+					state[c] = 1;
+					continue;
+				}
+
+				detail::precondition(M, r.data() + off, z.data() + off, n);
+				T rz_new = blas::dot(n, r.data() + off, z.data() + off);
+				T beta = rz_new / rz[c];
+				rz[c] = rz_new;
+
+				// p = z + beta p
+				blas::xpay(n, z.data() + off, beta, p.data() + off);
+			}
+
+			++res.iterations;
+			res.history.push_back(*std::max_element(residual.begin(), residual.end()));
+		}
+
+		res.residual = *std::max_element(residual.begin(), residual.end());
+		res.converged = std::all_of(state.begin(), state.end(), [](int st) { return st == 1; });
+		return res;
+	}
+
+	/**
+	* @}
+	*/
+}
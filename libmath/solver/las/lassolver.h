@@ -3,12 +3,16 @@
 #include <libmath/matrix.h>
 #include <libmath/math_settings.h>
 #include <libmath/boolean.h>
+#include <libmath/blas.h>
+#include <libmath/profiling.h>
+#include <libmath/solver/las/krylov.h>
 
 #ifdef MATH_OMP_DEFINE
 #include <omp.h>
 #endif
 
 #include <string>
+#include <vector>
 
 namespace math
 {
@@ -23,6 +27,17 @@ namespace math
 		tolerance
 	};
 
+	/**
+	* @brief Types of preconditioners for iterative solvers.
+	* - none: No preconditioning
+	* - jacobi: Diagonal (Jacobi) preconditioner @f$ \mathbf{M} = diag(\mathbf{A}) @f$
+	*/
+	enum class LASPreconditionerType
+	{
+		none,
+		jacobi
+	};
+
 	/**
 	* @brief Solver settings.
 	*/
@@ -41,6 +56,12 @@ namespace math
 
 		/// @brief Target tolerance for numerical method for tolerance stopping criteria
 		real targetTolerance = math::settings::DefaultSettings.targetTolerance;
+
+		/// @brief Preconditioner for iterative methods. Ignored by direct methods
+		LASPreconditionerType preconditioner = LASPreconditionerType::none;
+
+		/// @brief Dimension of Krylov subspace before restart (GMRES)
+		size_t restart = 30;
 	};
 
 	/**
@@ -108,6 +129,10 @@ namespace math
 					throw(math::Exception(method_ + ": Invalid target tolerance. Tolerance must be greater than 0!"));
 				}
 			}
+			if (setup.restart == 0)
+			{
+				throw(math::ExceptionInvalidValue(method_ + ": Invalid restart parameter. Restart must be positive number!"));
+			}
 		};
 
 		/**
@@ -119,23 +144,153 @@ namespace math
 			{
 				throw(math::ExceptionNonSquareMatrix(method_ + ": Inconsistent linear system. Matrix A argument must be square!"));
 			}
-			if (b.cols() > 1)
+			if (b.cols() == 0)
 			{
-				throw(ExceptionIncorrectMatrix(method_ + ": Matrix b argument must be column matrix!"));
+				throw(ExceptionIncorrectMatrix(method_ + ": Matrix b argument must have at least one column!"));
 			}
 			if (b.rows() != A.rows())
 			{
 				throw(ExceptionIncorrectMatrix(method_ + ": dimensions of arguments A and b didn't agree!"));
 			}
-			if (x.cols() > 1)
+			if (x.cols() != b.cols())
 			{
-				throw(ExceptionIncorrectMatrix(method_ + ": Matrix x argument must be column matrix!"));
+				throw(ExceptionIncorrectMatrix(method_ + ": Matrix x argument must have the same number of columns as b!"));
 			}
 			if (x.rows() != A.rows())
 			{
 				throw(ExceptionIncorrectMatrix(method_ + ": dimensions of input argument A and output x didn't agree!"));
 			}
 		}
+
+		/**
+		* @brief Run Krylov method (see math::krylov) with respect to stopping criteria and preconditioner of current setup
+		* @details For tolerance criteria method is restarted from the current approximation after
+		* breakdowns until target tolerance reached, or abort_iter iterations performed.
+		* Several right-hand sides are solved together by batched methods, so matrix A is read once
+		* per iteration for all systems.
+		* @param A[in]: Coefficients matrix
+		* @param b[in]: Matrix of equations right-hands (one column per system)
+		* @param x[in,out]: Initial guess on input, solution on output
+		* @param stats[out]: Statistics of this solve
+		* @param method: Callable (op, M, n, k, b, x, tol, max_iter) -> krylov::Result<T>, where
+		* op(in, out, k) multiplies A by block of k vectors (k = 1 by default)
+		*/
+		template <typename Method>
+		void iterate(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x, SolverStats& stats, const Method& method) const
+		{
+			stats.clear();
+			MATH_PROFILE_PHASE("solve", stats);
+
+			size_t n = A.rows();
+			size_t k = b.cols();
+			bool row_major = A.representation() == MatRep::Row;
+
+			auto op = [&stats, &A, n, row_major](const T* in, T* out, size_t k = 1)
+			{
+				MATH_PROFILE_PHASE("matvec", stats);
+				stats.matvecs += k;
+				blas::gemm(n, n, A.data(), row_major, k, in, out);
+			};
+
+			auto record = [&stats](const krylov::Result<T>& res)
+			{
+				stats.iterations += res.iterations;
+				stats.residuals.insert(stats.residuals.end(), res.history.begin(), res.history.end());
+			};
+
+			// single right-hand side is contiguous in any representation, several
+			// right-hand sides are gathered into blocks of contiguous columns
+			std::vector<T> b_block, x_block;
+			const T* b_ptr = b.data();
+			T* x_ptr = x.data();
+			if (k > 1)
+			{
+				b_block.resize(n * k);
+				x_block.resize(n * k);
+				for (size_t c = 0; c < k; ++c)
+				{
+					for (size_t i = 0; i < n; ++i)
+					{
+						b_block[c * n + i] = b(i, c);
+						x_block[c * n + i] = x(i, c);
+					}
+				}
+				b_ptr = b_block.data();
+				x_ptr = x_block.data();
+			}
+
+			auto run = [&](const auto& M)
+			{
+				if (currentSetup_.criteria == LASStoppingCriteriaType::iterations)
+				{
+					record(method(op, M, n, k, b_ptr, x_ptr, static_cast<T>(0.0), currentSetup_.max_iter));
+					return true;
+				}
+
+				size_t iter_cnt = 0;
+				while (true)
+				{
+					krylov::Result<T> res = method(
+						op, M, n, k, b_ptr, x_ptr,
+						static_cast<T>(currentSetup_.targetTolerance),
+						currentSetup_.abort_iter - iter_cnt);
+					iter_cnt += res.iterations;
+					record(res);
+					if (res.converged)
+					{
+						return true;
+					}
+					if (iter_cnt >= currentSetup_.abort_iter || res.iterations == 0)
+					{
+						return false;
+					}
+				}
+			};
+
+			bool converged = false;
+			if (currentSetup_.preconditioner == LASPreconditionerType::jacobi)
+			{
+				std::vector<T> inv_diag(n);
+				for (size_t i = 0; i < n; ++i)
+				{
+					T d = A(i, i);
+					if (d == static_cast<T>(0.0))
+					{
+						throw(math::ExceptionInvalidValue(method_ + ": Jacobi preconditioner requires non-zero diagonal of matrix A!"));
+					}
+					inv_diag[i] = static_cast<T>(1.0) / d;
+				}
+				auto M = [&](const T* in, T* out)
+				{
+					MATH_PROFILE_PHASE("preconditioner", stats);
+					for (size_t i = 0; i < n; ++i)
+					{
+						out[i] = inv_diag[i] * in[i];
+					}
+				};
+				converged = run(M);
+			}
+			else
+			{
+				converged = run(krylov::Identity{});
+			}
+
+			if (k > 1)
+			{
+				for (size_t c = 0; c < k; ++c)
+				{
+					for (size_t i = 0; i < n; ++i)
+					{
+						x(i, c) = x_block[c * n + i];
+					}
+				}
+			}
+
+			if (!converged)
+			{
+				throw(math::ExceptionTooManyIterations(method_ + ".solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
+			}
+		}
 	public:
 		virtual ~LASsolver() {
 			//std::cout << "Delete lassolver" << std::endl;
@@ -144,11 +299,29 @@ namespace math
 		/**
 		* @brief Solve LAS
 		* @param A[in]: Coefficients matrix
-		* @param b[in]: Column-vector of equations right-hands
-		* @param x[out]: Column vector of solution. Initial value of x used
+		* @param b[in]: Column-vector of equations right-hands. Matrix with k columns
+		* defines k systems with the same matrix A, which are solved together
+		* @param x[out]: Column vector (or matrix of k columns) of solution. Initial value of x used
 		* as initial guess for methods, that requires initial gues values
 		*/
-		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) const = 0;
+		void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x) const
+		{
+			SolverStats stats;
+			solve(A, b, x, stats);
+		}
+
+		/**
+		* @brief Solve LAS and collect statistics of this solve
+		* @details Statistics are iterations, residual history (residual norm after each iteration) and
+		* number of matrix-vector products. Phase times are collected only if profiling is enabled
+		* (see profiling.h). Statistics are returned per call, so concurrent solves with the same
+		* solver object are independent.
+		* @param A[in]: Coefficients matrix
+		* @param b[in]: Column-vector (or matrix of k columns) of equations right-hands
+		* @param x[out]: Solution, see solve(const Matrix<T>&, const Matrix<T>&, Matrix<T>&)
+		* @param stats[out]: Solver statistics
+		*/
+		virtual void solve(const Matrix<T>& A, const Matrix<T>& b, Matrix<T>& x, SolverStats& stats) const = 0;
 
 		/**
 		* @brief Method copy current LAS solver
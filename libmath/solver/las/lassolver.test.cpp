@@ -1,9 +1,15 @@
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
+#include <cmath>
 #include <libmath/matrix.h>
 #include <libmath/solver/las/lassolver.h>
 #include <libmath/solver/las/bicgstab.h>
 #include <libmath/solver/las/kholetsky.h>
+#include <libmath/solver/las/gmres.h>
+#include <libmath/solver/las/cg.h>
+#include <libmath/solver/las/mixed_precision.h>
+#include <libmath/solver/las/tsqr.h>
 #include <libmath/boolean.h>
 
 #ifdef MATH_OMP_DEFINE
@@ -99,4 +105,347 @@ omp_set_num_threads(1);
 
     EXPECT_EQ(math::isEqual(r, 0.0), true);
 
-}
\ No newline at end of file
+}
+
+TEST(LAS, GMRES)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    size_t dim = 10;
+
+    math::Matrix<double> A(dim);
+    A.rfill(1);
+
+    math::Matrix<double> b(dim, 1);
+    b.rfill(2);
+
+    math::Matrix<double> x(dim, 1);
+    x.fill(0.0);
+
+    math::GMRES<double> gmres_solver;
+
+    gmres_solver.solve(A, b, x);
+
+    double r = (A * x - b).pnorm(2);
+
+    EXPECT_EQ(math::isEqual(r, 0.0), true);
+
+    // restarted and preconditioned (restarted GMRES may stagnate on indefinite systems,
+    // so make matrix diagonally dominant)
+    for (size_t i = 0; i < dim; ++i)
+    {
+        A(i, i) += static_cast<double>(dim);
+    }
+
+    math::LASsetup setup;
+    setup.restart = 4;
+    setup.preconditioner = math::LASPreconditionerType::jacobi;
+
+    x.fill(0.0);
+    math::GMRES<double> gmres_restarted(setup);
+    gmres_restarted.solve(A, b, x);
+
+    r = (A * x - b).pnorm(2);
+
+    EXPECT_EQ(math::isEqual(r, 0.0), true);
+}
+
+TEST(LAS, CG)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    size_t dim = 50;
+
+    // symmetric positive definite matrix
+    math::Matrix<double> B(dim);
+    B.rfill(1);
+    math::Matrix<double> A = B.getTr() * B;
+    for (size_t i = 0; i < dim; ++i)
+    {
+        A(i, i) += 1.0;
+    }
+
+    math::Matrix<double> b(dim, 1);
+    b.rfill(2);
+
+    for (auto preconditioner : { math::LASPreconditionerType::none, math::LASPreconditionerType::jacobi })
+    {
+        math::Matrix<double> x(dim, 1);
+        x.fill(0.0);
+
+        math::LASsetup setup;
+        setup.preconditioner = preconditioner;
+
+        math::CG<double> cg_solver(setup);
+
+        cg_solver.solve(A, b, x);
+
+        double r = (A * x - b).pnorm(2);
+
+        EXPECT_EQ(math::isEqual(r, 0.0), true);
+    }
+}
+
+TEST(LAS, Nonsymmetric)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    // BicGStab breaks down on this system in exact arithmetic (r_hat orthogonal to A*r)
+    math::Matrix<double> A =
+    {
+        {0., 1.},
+        {1., 0.}
+    };
+
+    math::Matrix<double> b =
+    {
+        {1.},
+        {1.}
+    };
+
+    math::Matrix<double> x(2, 1);
+    x.fill(0.0);
+
+    math::GMRES<double> gmres_solver;
+
+    gmres_solver.solve(A, b, x);
+
+    double r = (A * x - b).pnorm(2);
+
+    EXPECT_EQ(math::isEqual(r, 0.0), true);
+}
+
+TEST(LAS, MultipleRightHands)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    size_t dim = 150;
+    size_t k = 4;
+
+    // symmetric positive definite and diagonally dominant matrix suits all solvers
+    math::Matrix<double> B(dim);
+    B.rfill(1);
+    math::Matrix<double> A = B.getTr() * B;
+    for (size_t i = 0; i < dim; ++i)
+    {
+        A(i, i) += static_cast<double>(dim);
+    }
+
+    math::Matrix<double> b(dim, k);
+    b.rfill(2);
+
+    std::vector<std::unique_ptr<math::LASsolver<double>>> solvers;
+    solvers.emplace_back(new math::Kholetsky<double>());
+    solvers.emplace_back(new math::BicGStab<double>());
+    solvers.emplace_back(new math::GMRES<double>());
+    solvers.emplace_back(new math::CG<double>());
+
+    for (auto& solver : solvers)
+    {
+        math::Matrix<double> x(dim, k);
+        x.fill(0.0);
+
+        solver->solve(A, b, x);
+
+        math::Matrix<double> R = A * x - b;
+
+        // each system solved with target tolerance
+        for (size_t c = 0; c < k; ++c)
+        {
+            double r = 0.0;
+            for (size_t i = 0; i < dim; ++i)
+            {
+                r += R(i, c) * R(i, c);
+            }
+            EXPECT_EQ(math::isEqual(std::sqrt(r), 0.0), true);
+        }
+    }
+
+    // inconsistent number of columns
+    math::Matrix<double> x(dim, k - 1);
+    math::Kholetsky<double> kholetsky_solver;
+    EXPECT_THROW(kholetsky_solver.solve(A, b, x), math::ExceptionIncorrectMatrix);
+}
+
+TEST(LAS, MixedPrecision)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    size_t dim = 100;
+
+    math::Matrix<double> A(dim);
+    A.rfill(1);
+
+    math::Matrix<double> b(dim, 2);
+    b.rfill(2);
+
+    math::Matrix<double> x(dim, 2);
+    x.fill(0.0);
+
+    // target tolerance below double precision level is limited by backward stable level
+    math::LASsetup setup;
+    setup.targetTolerance = 1.e-20;
+    math::MixedPrecision mp_solver(setup);
+
+    math::SolverStats stats;
+    mp_solver.solve(A, b, x, stats);
+
+    // refined to double precision accuracy
+    double r = (A * x - b).pnorm(2);
+
+    EXPECT_EQ(math::isEqual(r, 0.0, 1.e-10), true);
+
+    // loose target tolerance takes less refinement iterations
+    math::LASsetup loose_setup;
+    loose_setup.targetTolerance = 1.e-2;
+    math::MixedPrecision loose_solver(loose_setup);
+
+    math::SolverStats loose_stats;
+    loose_solver.solve(A, b, x, loose_stats);
+
+    EXPECT_LE(loose_stats.residuals.back(), 1.e-2);
+    EXPECT_LT(loose_stats.iterations, stats.iterations);
+
+    // Hilbert matrix is too ill-conditioned for single precision factorization,
+    // solver must fall back to double precision
+    size_t h_dim = 10;
+    math::Matrix<double> H(h_dim);
+    for (size_t i = 0; i < h_dim; ++i)
+    {
+        for (size_t j = 0; j < h_dim; ++j)
+        {
+            H(i, j) = 1.0 / static_cast<double>(i + j + 1);
+        }
+    }
+    math::Matrix<double> h_b(h_dim, 1);
+    h_b.fill(1.0);
+    math::Matrix<double> h_x(h_dim, 1);
+
+    mp_solver.solve(H, h_b, h_x);
+
+    r = (H * h_x - h_b).pnorm(2);
+
+    EXPECT_EQ(math::isEqual(r, 0.0, 1.e-6), true);
+
+    // singular matrix
+    math::Matrix<double> S = { {1.0, 2.0}, {2.0, 4.0} };
+    math::Matrix<double> s_b = { {1.0}, {1.0} };
+    math::Matrix<double> s_x(2, 1);
+    EXPECT_THROW(mp_solver.solve(S, s_b, s_x), math::ExceptionDegenerateMatrix);
+}
+
+TEST(LAS, TSQR)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+    // overdetermined system with known solution and orthogonal residual
+    size_t rows = 2000;
+    size_t cols = 3;
+    math::Matrix<double> A(rows, cols);
+    math::Matrix<double> b(rows, 2);
+    for (size_t i = 0; i < rows; ++i)
+    {
+        double t = static_cast<double>(i) / static_cast<double>(rows);
+        A(i, 0) = 1.0;
+        A(i, 1) = t;
+        A(i, 2) = std::sin(10.0 * t);
+        b(i, 0) = 1.0 - 2.0 * A(i, 1) + 0.5 * A(i, 2);
+        b(i, 1) = 3.0 * A(i, 1);
+    }
+
+    math::TSQR<double> qr(cols, 2);
+    qr.add(A, b);
+    EXPECT_EQ(qr.rows(), rows);
+
+    math::Matrix<double> x = qr.solve();
+    math::Matrix<double> gold =
+    {
+        {1.0, 0.0},
+        {-2.0, 3.0},
+        {0.5, 0.0}
+    };
+    EXPECT_EQ(x.compare(gold, 1.e-10), true);
+    EXPECT_EQ(math::isEqual(qr.residualNorm(), 0.0, 1.e-10), true);
+
+    // streaming by halves with merge and parallel factorization give the same solution
+    math::TSQR<double> top(cols, 2);
+    math::TSQR<double> bottom(cols, 2);
+    top.add(rows / 2, A.data(), b.data());
+    bottom.add(rows - rows / 2, A.data() + rows / 2 * cols, b.data() + rows / 2 * 2);
+    top.merge(bottom);
+    EXPECT_EQ(top.rows(), rows);
+    EXPECT_EQ(top.solve().compare(gold, 1.e-10), true);
+
+    math::TSQR<double> par = math::TSQR<double>::factorize(rows, cols, 2, [&](size_t i, double* row)
+        {
+            for (size_t j = 0; j < cols; ++j)
+            {
+                row[j] = A(i, j);
+            }
+            row[cols] = b(i, 0);
+            row[cols + 1] = b(i, 1) + (i % 2 == 0 ? 1.0 : -1.0);
+        });
+    math::Matrix<double> x_par = par.solve();
+    EXPECT_EQ(math::isEqual(x_par(0, 0), 1.0, 1.e-10), true);
+    EXPECT_EQ(std::abs(x_par(1, 1) - 3.0) < 1.e-2, true);
+    EXPECT_EQ(std::abs(par.residualNorm() - std::sqrt(static_cast<double>(rows))) < 1.e-1, true);
+
+    // rank deficient
+    math::TSQR<double> deficient(2, 1);
+    deficient.add(math::Matrix<double>{ {1.0, 2.0}, {2.0, 4.0}, {3.0, 6.0} }, math::Matrix<double>{ {1.0}, {2.0}, {3.0} });
+    EXPECT_THROW(deficient.solve(), math::ExceptionDegenerateMatrix);
+}
+
+TEST(LAS, SolverStats)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(1);
+#endif
+
+    size_t dim = 10;
+
+    math::Matrix<double> A(dim);
+    A.rfill(1);
+
+    math::Matrix<double> b(dim, 1);
+    b.rfill(2);
+
+    math::Matrix<double> x(dim, 1);
+    x.fill(0.0);
+
+    math::BicGStab<double> bicgstab_solver;
+
+    math::SolverStats stats;
+    bicgstab_solver.solve(A, b, x, stats);
+
+    EXPECT_GT(stats.iterations, 0);
+    EXPECT_EQ(stats.residuals.size(), stats.iterations);
+    EXPECT_LE(stats.residuals.back(), math::settings::CurrentSettings.targetTolerance);
+    // BicGStab needs two products per iteration plus initial residual
+    EXPECT_GE(stats.matvecs, stats.iterations + 1);
+    EXPECT_EQ(stats.f_evals, 0);
+#ifndef MATH_PROFILING_DEFINE
+    EXPECT_EQ(stats.phase_time.empty(), true);
+#else
+    EXPECT_GT(stats.phase_time.count("matvec"), 0);
+#endif
+
+    // statistics are reset by each solve
+    math::Kholetsky<double> kholetsky_solver;
+    kholetsky_solver.solve(A, b, x, stats);
+
+    EXPECT_EQ(stats.iterations, 0);
+    EXPECT_EQ(stats.residuals.empty(), true);
+}
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <libmath/solver/las/lassolver.h>
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace math
+{
+	/**
+	* @brief Class for solving LAS with mixed precision iterative refinement
+	* @details Matrix A is factored with pivoted LU in single precision (half of memory and about
+	* twice of throughput of double factorization). Solution is then refined in double precision:
+	* @f[
+	* \mathbf{r}_k = \mathbf{b} - \mathbf{A}\mathbf{x}_k, \quad
+	* \mathbf{L}\mathbf{U}\mathbf{d}_k = \mathbf{P}\mathbf{r}_k, \quad
+	* \mathbf{x}_{k+1} = \mathbf{x}_k + \mathbf{d}_k,
+	* @f]
+	* where residuals are evaluated in double and corrections are solved with single precision factors.
+	* For tolerance stopping criteria refinement continues until residual of each system reaches
+	* targetTolerance, but not below level of double precision backward stable solver:
+	* @f$ \|\mathbf{r}\|_\infty \le \max(tol, \sqrt{n} \varepsilon \|\mathbf{A}\|_\infty \|\mathbf{x}\|_\infty) @f$.
+	* If refinement diverges (matrix is too ill-conditioned for single precision), or doesn't reach
+	* this level within abort_iter iterations, system is solved with double precision factorization.
+	* For iterations stopping criteria exactly max_iter refinement iterations are performed.
+	*
+	* Initial value of x is not used.
+	*/
+	class MixedPrecision :
+		public LASsolver<double>
+	{
+	public:
+		MixedPrecision()
+		{
+			LASsolver<double>::method_ = "MixedPrecision";
+		};
+
+		/**
+		* @brief MixedPrecision solver constructor.
+		* @param setup: Solver settings
+		*/
+		MixedPrecision(const struct LASsetup& setup)
+		{
+			LASsolver<double>::method_ = "MixedPrecision";
+
+			LASsolver<double>::checkInputs(setup);
+
+			LASsolver<double>::currentSetup_ = setup;
+		}
+
+		virtual ~MixedPrecision() {};
+
+		virtual LASsolver<double>* copy() override
+		{
+			return new MixedPrecision(*this);
+		}
+
+		using LASsolver<double>::solve;
+
+		/// @brief LASsolver::solve
+		virtual void solve(const Matrix<double>& A, const Matrix<double>& b, Matrix<double>& x, SolverStats& stats) const override
+		{
+			// check inputs
+			LASsolver<double>::checkInputs(A, b, x);
+
+			stats.clear();
+			MATH_PROFILE_PHASE("solve", stats);
+
+			size_t n = A.rows();
+			size_t k = b.cols();
+			bool row_major = A.representation() == MatRep::Row;
+
+			// single precision factorization
+			std::vector<float> LU(n * n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t j = 0; j < n; ++j)
+				{
+					LU[i * n + j] = static_cast<float>(A(i, j));
+				}
+			}
+			std::vector<size_t> ipiv(n);
+			size_t info = 0;
+			{
+				MATH_PROFILE_PHASE("factorization", stats);
+				info = blas::getrf(n, LU.data(), ipiv.data());
+			}
+
+			// solutions and residuals, stored by columns (n x k)
+			std::vector<double> X(n * k, 0.0), R(n * k), AX(n * k);
+			for (size_t c = 0; c < k; ++c)
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					R[c * n + i] = b(i, c);
+				}
+			}
+			const std::vector<double> B = R;
+
+			// single precision corrections, stored by rows (n x k)
+			std::vector<float> D(n * k);
+
+			double A_norm = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				double row_sum = 0.0;
+				for (size_t j = 0; j < n; ++j)
+				{
+					row_sum += std::abs(A(i, j));
+				}
+				A_norm = std::max(A_norm, row_sum);
+			}
+			const double bound = std::sqrt(static_cast<double>(n)) * std::numeric_limits<double>::epsilon() * A_norm;
+			const double tol = static_cast<double>(currentSetup_.targetTolerance);
+
+			bool iterations = currentSetup_.criteria == LASStoppingCriteriaType::iterations;
+			size_t max_iter = iterations ? currentSetup_.max_iter : currentSetup_.abort_iter;
+
+			// residual norm of worst system relative to target tolerance, limited by backward stable level
+			auto residual = [&]()
+			{
+				MATH_PROFILE_PHASE("residual", stats);
+				stats.matvecs += k;
+				blas::gemm(n, n, A.data(), row_major, k, X.data(), AX.data());
+				blas::axpby(n * k, 1.0, B.data(), -1.0, AX.data(), R.data());
+				double worst = 0.0;
+				double r_max = 0.0;
+				for (size_t c = 0; c < k; ++c)
+				{
+					double r_norm = 0.0;
+					double x_norm = 0.0;
+					for (size_t i = 0; i < n; ++i)
+					{
+						r_norm = std::max(r_norm, std::abs(R[c * n + i]));
+						x_norm = std::max(x_norm, std::abs(X[c * n + i]));
+					}
+					worst = std::max(worst, r_norm / std::max(tol, bound * x_norm));
+					r_max = std::max(r_max, r_norm);
+				}
+				stats.residuals.push_back(static_cast<real>(r_max));
+				return worst;
+			};
+
+			bool converged = false;
+			if (info == 0)
+			{
+				double ratio = std::numeric_limits<double>::infinity();
+				for (size_t iter = 0; iter <= max_iter; ++iter)
+				{
+					if (iter > 0)
+					{
+						double ratio_new = residual();
+						if (!iterations)
+						{
+							if (ratio_new <= 1.0)
+							{
+								converged = true;
+								break;
+							}
+							if (!std::isfinite(ratio_new) || ratio_new >= ratio)
+							{
+								// refinement diverges or stagnates
+								break;
+							}
+						}
+						ratio = ratio_new;
+						if (iter == max_iter)
+						{
+							converged = iterations;
+							break;
+						}
+					}
+
+					// d = (LU)^-1 r in single precision
+					MATH_PROFILE_PHASE("correction", stats);
+					++stats.iterations;
+					for (size_t i = 0; i < n; ++i)
+					{
+						for (size_t c = 0; c < k; ++c)
+						{
+							D[i * k + c] = static_cast<float>(R[c * n + i]);
+						}
+					}
+					blas::getrs(n, LU.data(), ipiv.data(), k, D.data());
+					for (size_t i = 0; i < n; ++i)
+					{
+						for (size_t c = 0; c < k; ++c)
+						{
+							X[c * n + i] += static_cast<double>(D[i * k + c]);
+						}
+					}
+				}
+			}
+
+			if (!converged)
+			{
+				// fallback to double precision factorization
+				MATH_PROFILE_PHASE("fallback", stats);
+				std::vector<double> LUd(n * n);
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t j = 0; j < n; ++j)
+					{
+						LUd[i * n + j] = A(i, j);
+					}
+				}
+				if (blas::getrf(n, LUd.data(), ipiv.data()) != 0)
+				{
+					throw(math::ExceptionDegenerateMatrix(method_ + ".solve: Matrix A is singular!"));
+				}
+				std::vector<double> Xd(n * k);
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t c = 0; c < k; ++c)
+					{
+						Xd[i * k + c] = b(i, c);
+					}
+				}
+				blas::getrs(n, LUd.data(), ipiv.data(), k, Xd.data());
+				for (size_t i = 0; i < n; ++i)
+				{
+					for (size_t c = 0; c < k; ++c)
+					{
+						X[c * n + i] = Xd[i * k + c];
+					}
+				}
+			}
+
+			for (size_t c = 0; c < k; ++c)
+			{
+				for (size_t i = 0; i < n; ++i)
+				{
+					x(i, c) = X[c * n + i];
+				}
+			}
+		}
+	};
+}
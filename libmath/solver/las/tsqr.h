@@ -0,0 +1,339 @@
+#pragma once
+
+#include <libmath/matrix.h>
+#include <libmath/blas.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <string>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math
+{
+	/**
+	* @brief Tall-skinny QR factorization for linear least squares
+	* @f$ \min_{\mathbf{X}} \|\mathbf{A}\mathbf{X} - \mathbf{B}\|_F @f$
+	* @details Rows of augmented matrix @f$ [\mathbf{A} \; \mathbf{B}] @f$ (N x (n + k)) are accumulated
+	* by blocks: each block is stacked under current triangular factor and reduced back to
+	* triangular form by Householder reflections, which exploit triangular structure of factor.
+	* Only (n + k) x (n + k) factor
+	* @f[
+	* \mathbf{R} = \begin{bmatrix} \mathbf{R}_{11} & \mathbf{R}_{12} \\ 0 & \mathbf{R}_{22} \end{bmatrix}
+	* @f]
+	* and one block of rows are stored, so rows may be streamed, and cost is
+	* @f$ O(N (n + k)^2) @f$. Least squares solution is @f$ \mathbf{R}_{11}\mathbf{X} = \mathbf{R}_{12} @f$,
+	* residual norm is @f$ \|\mathbf{R}_{22}\|_F @f$.
+	*
+	* Factors of independent row blocks are combined with merge(), factorize() distributes
+	* row blocks between threads and reduces their factors.
+	*/
+	template <typename T>
+	class TSQR
+	{
+	private:
+		/// @brief Number of columns of A
+		size_t cols_ = 0;
+
+		/// @brief Number of right-hand sides
+		size_t rhs_ = 0;
+
+		/// @brief Number of accumulated rows
+		size_t rows_ = 0;
+
+		/// @brief Triangular factor of augmented matrix, row-major (cols_ + rhs_) x (cols_ + rhs_)
+		std::vector<T> R_;
+
+		/// @brief Block of rows, row-major
+		std::vector<T> work_;
+
+		/// @brief Householder products
+		std::vector<T> w_;
+
+		/// @brief Eliminate p rows of work_ against R_
+		void reduce(size_t p)
+		{
+			size_t m = cols_ + rhs_;
+			T* W = work_.data();
+			for (size_t j = 0; j < m; ++j)
+			{
+				T norm2 = static_cast<T>(0.0);
+				for (size_t i = 0; i < p; ++i)
+				{
+					norm2 += W[i * m + j] * W[i * m + j];
+				}
+				if (norm2 == static_cast<T>(0.0))
+				{
+					continue;
+				}
+
+				// reflection of (R(j,j), W(:,j)) to (alpha, 0)
+				T* R_j = R_.data() + j * m;
+				T x0 = R_j[j];
+				T alpha = -std::copysign(std::sqrt(x0 * x0 + norm2), x0);
+				T v0 = x0 - alpha;
+				T beta = static_cast<T>(2.0) / (v0 * v0 + norm2);
+
+				for (size_t l = j + 1; l < m; ++l)
+				{
+					w_[l] = v0 * R_j[l];
+				}
+				for (size_t i = 0; i < p; ++i)
+				{
+					const T* W_i = W + i * m;
+					T v_i = W_i[j];
+					for (size_t l = j + 1; l < m; ++l)
+					{
+						w_[l] += v_i * W_i[l];
+					}
+				}
+				for (size_t l = j + 1; l < m; ++l)
+				{
+					w_[l] *= beta;
+					R_j[l] -= w_[l] * v0;
+				}
+				for (size_t i = 0; i < p; ++i)
+				{
+					T* W_i = W + i * m;
+					T v_i = W_i[j];
+					for (size_t l = j + 1; l < m; ++l)
+					{
+						W_i[l] -= w_[l] * v_i;
+					}
+					W_i[j] = static_cast<T>(0.0);
+				}
+				R_j[j] = alpha;
+			}
+		}
+
+	public:
+		/// @brief Number of rows, reduced at once
+		static constexpr size_t block_rows = 256;
+
+		TSQR() {};
+
+		/**
+		* @brief TSQR constructor
+		* @param cols: Number of columns of A
+		* @param rhs: Number of right-hand sides
+		*/
+		TSQR(size_t cols, size_t rhs = 1) :
+			cols_(cols),
+			rhs_(rhs),
+			R_((cols + rhs) * (cols + rhs), static_cast<T>(0.0)),
+			w_(cols + rhs)
+		{
+		}
+
+		size_t cols() const
+		{
+			return cols_;
+		}
+
+		size_t rhs() const
+		{
+			return rhs_;
+		}
+
+		/// @brief Number of accumulated rows
+		size_t rows() const
+		{
+			return rows_;
+		}
+
+		/**
+		* @brief Accumulate rows of augmented matrix
+		* @param rows: Number of rows
+		* @param fill: Callable fill(i, row), writing cols() values of row i of A followed by
+		* rhs() values of row i of B to row
+		*/
+		template <typename RowFn>
+		void add(size_t rows, RowFn&& fill)
+		{
+			size_t m = cols_ + rhs_;
+			for (size_t first = 0; first < rows; first += block_rows)
+			{
+				size_t p = std::min(block_rows, rows - first);
+				work_.resize(p * m);
+				for (size_t i = 0; i < p; ++i)
+				{
+					fill(first + i, work_.data() + i * m);
+				}
+				reduce(p);
+			}
+			rows_ += rows;
+		}
+
+		/**
+		* @brief Accumulate rows
+		* @param rows: Number of rows
+		* @param a: Rows of A, row-major rows x cols()
+		* @param b: Rows of B, row-major rows x rhs()
+		*/
+		void add(size_t rows, const T* a, const T* b)
+		{
+			add(rows, [this, a, b](size_t i, T* row)
+				{
+					std::copy(a + i * cols_, a + (i + 1) * cols_, row);
+					std::copy(b + i * rhs_, b + (i + 1) * rhs_, row + cols_);
+				});
+		}
+
+		/**
+		* @brief Accumulate rows
+		* @param A: Rows of A
+		* @param B: Rows of B
+		* @throws math::ExceptionNonEqualRowsNum, math::ExceptionNonEqualColumnsNum
+		*/
+		void add(const Matrix<T>& A, const Matrix<T>& B)
+		{
+			if (A.rows() != B.rows())
+			{
+				throw(ExceptionNonEqualRowsNum("TSQR<T>::add: Matrices A and B have non-equal number of rows!"));
+			}
+			if (A.cols() != cols_ || B.cols() != rhs_)
+			{
+				throw(ExceptionNonEqualColumnsNum("TSQR<T>::add: Matrices A and B must have " +
+					std::to_string(cols_) + " and " + std::to_string(rhs_) + " columns!"));
+			}
+			add(A.rows(), [this, &A, &B](size_t i, T* row)
+				{
+					for (size_t j = 0; j < cols_; ++j)
+					{
+						row[j] = A(i, j);
+					}
+					for (size_t c = 0; c < rhs_; ++c)
+					{
+						row[cols_ + c] = B(i, c);
+					}
+				});
+		}
+
+		/**
+		* @brief Merge factor of other rows
+		* @details Result is factor of union of rows of both accumulators
+		* @throws math::ExceptionNonEqualColumnsNum if sizes of factors differ
+		*/
+		void merge(const TSQR<T>& other)
+		{
+			if (other.cols_ != cols_ || other.rhs_ != rhs_)
+			{
+				throw(ExceptionNonEqualColumnsNum("TSQR<T>::merge: Factors have different sizes!"));
+			}
+			size_t m = cols_ + rhs_;
+			size_t rows = rows_;
+			add(m, [&other, m](size_t i, T* row)
+				{
+					std::copy(other.R_.begin() + i * m, other.R_.begin() + (i + 1) * m, row);
+				});
+			rows_ = rows + other.rows_;
+		}
+
+		/**
+		* @brief Factorize rows in parallel
+		* @details Rows are split to contiguous ranges, one per thread. Factors of ranges are
+		* merged after that.
+		* @param rows: Number of rows
+		* @param cols: Number of columns of A
+		* @param rhs: Number of right-hand sides
+		* @param fill: Callable fill(i, row) (see add()). Called concurrently for different rows
+		*/
+		template <typename RowFn>
+		static TSQR<T> factorize(size_t rows, size_t cols, size_t rhs, RowFn&& fill)
+		{
+			int threads = 1;
+#ifdef MATH_OMP_DEFINE
+			if (static_cast<long long>(rows * (cols + rhs)) > blas::omp_threshold)
+			{
+				threads = omp_get_max_threads();
+			}
+#endif
+			std::vector<TSQR<T>> local(threads, TSQR<T>(cols, rhs));
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+			for (int t = 0; t < threads; ++t)
+			{
+				size_t first = rows * t / threads;
+				size_t last = rows * (t + 1) / threads;
+				local[t].add(last - first, [&fill, first](size_t i, T* row)
+					{
+						fill(first + i, row);
+					});
+			}
+			for (int t = 1; t < threads; ++t)
+			{
+				local[0].merge(local[t]);
+			}
+			return local[0];
+		}
+
+		/**
+		* @brief Least squares solution
+		* @return Matrix cols() x rhs()
+		* @throws math::ExceptionDegenerateMatrix if A is rank deficient
+		*/
+		Matrix<T> solve() const
+		{
+			size_t m = cols_ + rhs_;
+			T diag_max = static_cast<T>(0.0);
+			for (size_t j = 0; j < cols_; ++j)
+			{
+				diag_max = std::max(diag_max, std::abs(R_[j * m + j]));
+			}
+			T tol = static_cast<T>(m) * std::numeric_limits<T>::epsilon() * diag_max;
+
+			// R11 X = R12, row-major cols x rhs
+			std::vector<T> X(cols_ * rhs_);
+			for (size_t i = cols_; i-- > 0;)
+			{
+				T r_ii = R_[i * m + i];
+				if (std::abs(r_ii) <= tol || r_ii == static_cast<T>(0.0))
+				{
+					throw(ExceptionDegenerateMatrix("TSQR<T>::solve: Matrix A is rank deficient!"));
+				}
+				for (size_t c = 0; c < rhs_; ++c)
+				{
+					T sum = R_[i * m + cols_ + c];
+					for (size_t l = i + 1; l < cols_; ++l)
+					{
+						sum -= R_[i * m + l] * X[l * rhs_ + c];
+					}
+					X[i * rhs_ + c] = sum / r_ii;
+				}
+			}
+
+			Matrix<T> result(cols_, rhs_);
+			std::copy(X.begin(), X.end(), result.data());
+			return result;
+		}
+
+		/// @brief Norm of residual @f$ \|\mathbf{A}\mathbf{X} - \mathbf{B}\|_F @f$ of least squares solution
+		T residualNorm() const
+		{
+			size_t m = cols_ + rhs_;
+			T sum = static_cast<T>(0.0);
+			for (size_t i = cols_; i < m; ++i)
+			{
+				for (size_t j = i; j < m; ++j)
+				{
+					sum += R_[i * m + j] * R_[i * m + j];
+				}
+			}
+			return std::sqrt(sum);
+		}
+
+		/// @brief Triangular factor of augmented matrix [A B]
+		Matrix<T> R() const
+		{
+			size_t m = cols_ + rhs_;
+			Matrix<T> result(m, m);
+			std::copy(R_.begin(), R_.end(), result.data());
+			return result;
+		}
+	};
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <libmath/solver/us/unlinearsolver.h>
+#include <libmath/solver/las/krylov.h>
+#include <libmath/differential.h>
+#include <libmath/blas.h>
+#include <functional>
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math
+{
+    /**
+    * @brief Jacobian-free Newton-Krylov solver (JFNK) for systems of unlinear equations
+    * @details Each Newton step @f$ \mathbf{J} \Delta \mathbf{x} = -\mathbf{F} @f$ is solved inexactly with
+    * Krylov method (USsetup::krylov_method), which needs only Jacobian-vector products. Product is
+    * evaluated by single directional finite difference
+    * @f[
+    * \mathbf{J}\mathbf{v} \approx \frac{\mathbf{F}(\mathbf{x} + h\mathbf{v}) - \mathbf{F}(\mathbf{x})}{h}, \quad
+    * h = \frac{\sqrt{\varepsilon}(1 + \|\mathbf{x}\|)}{\|\mathbf{v}\|},
+    * @f]
+    * so Jacobian is never formed and each Krylov iteration costs one evaluation of all functions F.
+    * Accuracy of linear solving is controlled by Eisenstat-Walker forcing terms (choice 2):
+    * @f$ \|\mathbf{F} + \mathbf{J}\Delta\mathbf{x}\| \le \eta_k \|\mathbf{F}\| @f$,
+    * @f$ \eta_k = 0.9 \left( \|\mathbf{F}_k\| / \|\mathbf{F}_{k-1}\| \right)^2 @f$, bounded by USsetup::forcing_max.
+    *
+    * Perturbed point @f$ \mathbf{x} + h\mathbf{v} @f$ is kept inside of the arguments bounds: backward
+    * or shortened step is used near them, so F is evaluated only inside of the bounds, as in Secant.
+    *
+    * USsetup::linearSolver is not used by this solver. Both line_search and trust_region globalization
+    * types result in backtracking along the inexact Newton direction (trust region requires
+    * @f$ \mathbf{J}^T @f$, which isn't available without forming Jacobian).
+    */
+	template<typename T>
+	class NewtonKrylov :
+		public UnlinearSolver<T>
+	{
+	public:
+		NewtonKrylov()
+		{
+			UnlinearSolver<T>::method_ = "NewtonKrylov";
+		};
+
+		NewtonKrylov(const struct USsetup& setup)
+		{
+			UnlinearSolver<T>::method_ = "NewtonKrylov";
+
+            UnlinearSolver<T>::checkInputs(setup);
+
+            UnlinearSolver<T>::currentSetup_ = setup;
+		};
+
+        /// @brief Copy constructor
+        NewtonKrylov(const NewtonKrylov& uss)
+        {
+            UnlinearSolver<T>::method_ = uss.method_;
+            UnlinearSolver<T>::currentSetup_ = uss.currentSetup_;
+        }
+
+        virtual ~NewtonKrylov() {};
+
+        virtual UnlinearSolver<T>* copy() override
+        {
+            return new NewtonKrylov<T>(*this);
+        }
+
+        using UnlinearSolver<T>::solve;
+
+        virtual void solve(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            Matrix<T> &x,
+            SolverStats &stats,
+            const Matrix<T> &x_min = Matrix<T>(),
+            const Matrix<T> &x_max = Matrix<T>()) const override
+        {
+            // check inputs
+            if (x.cols() > 1)
+            {
+                throw(math::ExceptionIncorrectMatrix("NewtonKrylov: Matrix x argument must be column matrix!"));
+            }
+            if (x.rows() != F.size())
+            {
+                throw(math::ExceptionIncorrectMatrix("NewtonKrylov: Dimensions of input argument F and output x didn't agree!"));
+            }
+
+            const USsetup &setup = UnlinearSolver<T>::currentSetup_;
+
+            // bounds are checked once per solve, so clamping and steps of products stay inside of them
+            detail::checkBounds("NewtonKrylov", x.rows(), setup.diff_scheme, static_cast<T>(setup.diff_step), x_min, x_max);
+
+            stats.clear();
+            MATH_PROFILE_PHASE("solve", stats);
+
+            size_t n = F.size();
+
+            // residuals at current and trial points
+            std::vector<T> f(n), f_trial(n);
+
+            // Newton step and right-hand side
+            std::vector<T> dx(n), rhs(n);
+
+            // constrained arguments
+            Matrix<T> x_interm = x;
+
+            // last solution
+            Matrix<T> x_l = x_interm;
+
+            // perturbed arguments for Jacobian-vector products
+            Matrix<T> x_eval = x_interm;
+
+            // error
+            T E = static_cast<T>(1.0);
+
+            // forcing term
+            T eta = static_cast<T>(setup.forcing_max);
+
+            const T sqrt_eps = std::sqrt(std::numeric_limits<T>::epsilon());
+
+            size_t iter_cnt = 0;
+
+            // stopping criteria
+            bool stop = 0;
+
+            UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+
+            evalFunctions(F, x_interm, f, stats);
+            T f_norm = blas::nrm2(n, f.data());
+
+            while (!stop)
+            {
+                T x_norm = static_cast<T>(0.0);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    x_norm += x_interm(i, 0) * x_interm(i, 0);
+                }
+                x_norm = std::sqrt(x_norm);
+
+                // Jacobian-vector product by directional finite difference
+                auto Jv = [&](const T *v, T *out)
+                {
+                    T v_norm = blas::nrm2(n, v);
+                    if (v_norm == static_cast<T>(0.0))
+                    {
+                        std::fill(out, out + n, static_cast<T>(0.0));
+                        return;
+                    }
+                    T h = sqrt_eps * (static_cast<T>(1.0) + x_norm) / v_norm;
+                    h = stepInBounds(x_interm, v, h, x_min, x_max);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        x_eval(i, 0) = x_interm(i, 0) + h * v[i];
+                    }
+                    evalFunctions(F, x_eval, out, stats);
+                    ++stats.matvecs;
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        out[i] = (out[i] - f[i]) / h;
+                    }
+                };
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    rhs[i] = -f[i];
+                    dx[i] = static_cast<T>(0.0);
+                }
+
+                T lin_tol = eta * f_norm;
+                {
+                    MATH_PROFILE_PHASE("krylov", stats);
+                    if (setup.krylov_method == USKrylovMethod::gmres)
+                    {
+                        krylov::gmres(Jv, n, rhs.data(), dx.data(), lin_tol, setup.krylov_max_iter, setup.krylov_restart);
+                    }
+                    if (setup.krylov_method == USKrylovMethod::bicgstab)
+                    {
+                        krylov::bicgstab(Jv, n, rhs.data(), dx.data(), lin_tol, setup.krylov_max_iter);
+                    }
+                }
+
+                x_l = x_interm;
+
+                // backtracking with inexact Newton sufficient decrease condition
+                MATH_PROFILE_PHASE("line_search", stats);
+                T lambda = static_cast<T>(1.0);
+                T f_trial_norm = static_cast<T>(0.0);
+                while (true)
+                {
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        x_interm(i, 0) = x_l(i, 0) + lambda * dx[i];
+                    }
+                    UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+                    evalFunctions(F, x_interm, f_trial, stats);
+                    f_trial_norm = blas::nrm2(n, f_trial.data());
+
+                    if (setup.globalization == USGlobalizationType::none ||
+                        lambda <= static_cast<T>(setup.ls_min_step))
+                    {
+                        break;
+                    }
+                    if (std::isfinite(f_trial_norm) &&
+                        f_trial_norm <= (static_cast<T>(1.0) - static_cast<T>(setup.ls_armijo) * lambda * (static_cast<T>(1.0) - eta)) * f_norm)
+                    {
+                        break;
+                    }
+                    lambda = std::max(static_cast<T>(0.5) * lambda, static_cast<T>(setup.ls_min_step));
+                }
+
+                ++iter_cnt;
+
+                stats.iterations = iter_cnt;
+                stats.residuals.push_back(static_cast<real>(f_trial_norm));
+
+                // Eisenstat-Walker forcing term (choice 2) with safeguards
+                T eta_new = static_cast<T>(setup.forcing_max);
+                if (f_norm > static_cast<T>(0.0) && std::isfinite(f_trial_norm))
+                {
+                    T ratio = f_trial_norm / f_norm;
+                    eta_new = static_cast<T>(0.9) * ratio * ratio;
+                    T eta_safe = static_cast<T>(0.9) * eta * eta;
+                    if (eta_safe > static_cast<T>(0.1))
+                    {
+                        eta_new = std::max(eta_new, eta_safe);
+                    }
+                    if (f_trial_norm > static_cast<T>(0.0))
+                    {
+                        // avoid oversolving near the solution
+                        eta_new = std::max(eta_new, static_cast<T>(0.5) * static_cast<T>(setup.targetTolerance) / f_trial_norm);
+                    }
+                    eta_new = std::min(eta_new, static_cast<T>(setup.forcing_max));
+                }
+                eta = eta_new;
+
+                // define stopping criteria
+                if (setup.criteria == USStoppingCriteriaType::tolerance)
+                {
+                    E = static_cast<T>(0.0);
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        if (setup.tol_method == USToleranceMethod::absolute)
+                        {
+                            E = std::max(E, std::abs(f_trial[i]));
+                        }
+                        if (setup.tol_method == USToleranceMethod::relative)
+                        {
+                            E = std::max(E, std::abs((f[i] - f_trial[i]) / f_trial[i]));
+                        }
+                    }
+                }
+
+                f.swap(f_trial);
+                f_norm = f_trial_norm;
+
+                if (setup.criteria == USStoppingCriteriaType::tolerance)
+                {
+                    if (E <= static_cast<T>(setup.targetTolerance))
+                    {
+                        stop = 1;
+                        x = x_interm;
+                    }
+                    else
+                    {
+                        if (iter_cnt > setup.abort_iter)
+                        {
+                            x = x_interm;
+                            throw(math::ExceptionTooManyIterations("NewtonKrylov.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
+                        }
+                    }
+                }
+                if (setup.criteria == USStoppingCriteriaType::iterations)
+                {
+                    if (iter_cnt > setup.max_iter)
+                    {
+                        stop = 1;
+                        x = x_interm;
+                    }
+                }
+            }
+        }
+
+    private:
+        /**
+         * @brief Step of directional difference, which keeps x + h v inside of the bounds
+         * @details x is inside of the bounds (see UnlinearSolver::applyBounds()). If forward point
+         * x + h v leaves them, backward one x - h v is used, and if both leave, step is shortened
+         * to the largest feasible one in the direction with more room, so F is never sampled outside of
+         * the bounds.
+         * @return Signed step
+         */
+        static T stepInBounds(const Matrix<T> &x, const T *v, T h, const Matrix<T> &x_min, const Matrix<T> &x_max)
+        {
+            // largest feasible forward and backward steps
+            T forward = std::numeric_limits<T>::max();
+            T backward = std::numeric_limits<T>::max();
+            for (size_t i = 0; i < x.rows(); ++i)
+            {
+                if (v[i] == static_cast<T>(0.0))
+                {
+                    continue;
+                }
+                T to_lower = i < x_min.rows() ? (x(i, 0) - x_min(i, 0)) / std::abs(v[i]) : std::numeric_limits<T>::max();
+                T to_upper = i < x_max.rows() ? (x_max(i, 0) - x(i, 0)) / std::abs(v[i]) : std::numeric_limits<T>::max();
+                if (v[i] > static_cast<T>(0.0))
+                {
+                    forward = std::min(forward, to_upper);
+                    backward = std::min(backward, to_lower);
+                }
+                else
+                {
+                    forward = std::min(forward, to_lower);
+                    backward = std::min(backward, to_upper);
+                }
+            }
+            if (h <= forward)
+            {
+                return h;
+            }
+            if (h <= backward)
+            {
+                return -h;
+            }
+            return forward >= backward ? forward : -backward;
+        }
+
+        /**
+         * @brief Evaluate all functions @f$ f_i = F_i(x) @f$
+         */
+        void evalFunctions(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            const Matrix<T> &x,
+            T *f,
+            SolverStats &stats) const
+        {
+            stats.f_evals += F.size();
+            long long n = static_cast<long long>(F.size());
+            // each function reads up to n arguments
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for shared(F, x, f, n) schedule(static) if (n * n > blas::omp_threshold)
+#endif
+            for (long long i = 0; i < n; ++i)
+            {
+                f[i] = F[i](x);
+            }
+        }
+
+        void evalFunctions(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            const Matrix<T> &x,
+            std::vector<T> &f,
+            SolverStats &stats) const
+        {
+            evalFunctions(F, x, f.data(), stats);
+        }
+	};
+}
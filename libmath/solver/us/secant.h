@@ -1,9 +1,13 @@
 #pragma once
 
 #include <libmath/solver/us/unlinearsolver.h>
+#include <libmath/solver/las/tsqr.h>
 #include <libmath/differential.h>
 #include <functional>
 #include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace math
 {
@@ -11,6 +15,14 @@ namespace math
     * @brief Solver for unlinear equation with secant method (Newton)
     * @details Secant method can solve systems of unlinear equations as well
     * as single unlinear equations. See us.example.cpp
+    *
+    * Arguments bounds are checked once per solve. By default arguments are clamped to the bounds after
+    * every step. With USBoundsMethod::active_set arguments held on the bounds are frozen and the smaller
+    * system for the rest of arguments is solved.
+    *
+    * With trust region globalization solver stops, if radius reaches its minimum without decrease of merit
+    * function: solution stays at the last accepted point, and for tolerance criteria
+    * math::ExceptionTooManyIterations is thrown.
     */
 	template<typename T>
 	class Secant :
@@ -47,9 +59,12 @@ namespace math
             return new Secant<T>(*this);
         }
 
+        using UnlinearSolver<T>::solve;
+
         virtual void solve(
             const std::vector<std::function<T(const Matrix<T> &)>> &F,
             Matrix<T> &x,
+            SolverStats &stats,
             const Matrix<T> &x_min = Matrix<T>(),
             const Matrix<T> &x_max = Matrix<T>()) const override
         {
@@ -63,13 +78,24 @@ namespace math
                 throw(math::ExceptionIncorrectMatrix("Secant: Dimensions of input argument F and output x didn't agree!"));
             }
 
+            const USsetup &setup = UnlinearSolver<T>::currentSetup_;
+
+            // bounds are checked once per solve, Jacobians are evaluated without checks
+            detail::checkBounds("Secant", x.rows(), setup.diff_scheme, static_cast<T>(setup.diff_step), x_min, x_max);
+
+            stats.clear();
+            MATH_PROFILE_PHASE("solve", stats);
+
             size_t n = F.size();
-            Matrix<T> dx(n, 1, UnlinearSolver<T>::currentSetup_.diff_step);
+            Matrix<T> dx(n, 1, setup.diff_step);
             Matrix<T> df(F.size(), x.rows());
 
             // residuals column-matrix
             Matrix<T> y(n, 1, 0.0);
 
+            // residuals at the new solution
+            Matrix<T> y_new(n, 1, 0.0);
+
             // residuals
             Matrix<T> r(n, 1, 1);
 
@@ -85,114 +111,120 @@ namespace math
             // last solution
             Matrix<T> x_l = x_interm;
 
+            // trust region radius
+            T radius = static_cast<T>(setup.tr_radius);
+
             size_t iter_cnt = 0;
 
             // stopping criteria
             bool stop = 0;
 
-            // if lower bound defined
-            if (!x_min.empty())
-            {
-                for (size_t i = 0; i < x_min.rows(); ++i)
-                {
-                    x_interm(i, 0) = std::max(x_interm(i, 0), x_min(i, 0) + UnlinearSolver<T>::currentSetup_.diff_step);
-                }
-            }
-            // if upper bound defined
-            if (!x_max.empty())
-            {
-                for (size_t i = 0; i < x_max.rows(); ++i)
-                {
-                    x_interm(i, 0) = std::min(x_interm(i, 0), x_max(i, 0) - UnlinearSolver<T>::currentSetup_.diff_step);
-                }
-            }
+            // trust region can't decrease merit function any more
+            bool stagnation = false;
 
-            for (size_t i = 0; i < n; ++i)
-            {
-                y(i, 0) = -F[i](x_interm);
-            }
+            // free arguments of projected Newton step
+            std::vector<size_t> free_args;
+
+            UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+
+            evalResiduals(F, x_interm, y, stats);
 
             while (!stop)
             {
-                math::jacobi(F, x_interm, df, UnlinearSolver<T>::currentSetup_.diff_scheme, UnlinearSolver<T>::currentSetup_.diff_step, x_min, x_max);
-
-                // solve system
-                if (df.numel() > 1)
                 {
-                    UnlinearSolver<T>::currentSetup_.linearSolver->solve(df, y, dx);
+                    MATH_PROFILE_PHASE("jacobi", stats);
+                    stats.f_evals += detail::jacobi(F, x_interm, df, setup.diff_scheme, static_cast<T>(setup.diff_step), x_min, x_max);
                 }
 
-                // solve single equation
-                if (df.numel() == 1)
+                if (setup.bounds_method == USBoundsMethod::active_set &&
+                    activeSet(df, y, x_interm, x_min, x_max, free_args))
                 {
-                    dx(0, 0) = y(0, 0) / df(0, 0);
+                    MATH_PROFILE_PHASE("linear_solve", stats);
+                    reducedStep(df, y, free_args, dx);
                 }
-
-                x_l = x_interm;
-
-                for (size_t i = 0; i < n; ++i)
+                else
                 {
-                    x_interm(i, 0) += dx(i, 0);
-                }
+                    // solve system
+                    if (df.numel() > 1)
+                    {
+                        MATH_PROFILE_PHASE("linear_solve", stats);
+                        setup.linearSolver->solve(df, y, dx);
+                    }
 
-                // if lower bound defined
-                if (!x_min.empty())
-                {
-                    for (size_t i = 0; i < x_min.rows(); ++i)
+                    // solve single equation
+                    if (df.numel() == 1)
                     {
-                        x_interm(i, 0) = std::max(x_interm(i, 0), x_min(i, 0) + UnlinearSolver<T>::currentSetup_.diff_step);
+                        dx(0, 0) = y(0, 0) / df(0, 0);
                     }
                 }
-                // if upper bound defined
-                if (!x_max.empty())
+
+                x_l = x_interm;
+
+                MATH_PROFILE_PHASE("step", stats);
+                switch (setup.globalization)
                 {
-                    for (size_t i = 0; i < x_max.rows(); ++i)
+                case USGlobalizationType::none:
+                    for (size_t i = 0; i < n; ++i)
                     {
-                        x_interm(i, 0) = std::min(x_interm(i, 0), x_max(i, 0) - UnlinearSolver<T>::currentSetup_.diff_step);
+                        x_interm(i, 0) += dx(i, 0);
                     }
+                    UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+                    evalResiduals(F, x_interm, y_new, stats);
+                    break;
+                case USGlobalizationType::line_search:
+                    lineSearch(F, df, y, dx, x_l, x_interm, y_new, stats, x_min, x_max);
+                    break;
+                case USGlobalizationType::trust_region:
+                    stagnation = !trustRegion(F, df, y, dx, x_l, x_interm, y_new, radius, stats, x_min, x_max);
+                    break;
                 }
 
                 ++iter_cnt;
 
+                stats.iterations = iter_cnt;
+                stats.residuals.push_back(static_cast<real>(std::sqrt(static_cast<T>(2.0) * merit(y_new))));
+
                 // define stopping criteria
-                if (UnlinearSolver<T>::currentSetup_.criteria == USStoppingCriteriaType::tolerance)
+                if (setup.criteria == USStoppingCriteriaType::tolerance)
                 {
                     for (size_t i = 0; i < n; ++i)
                     {
                         r_l = -y(i, 0);
-                        y(i, 0) = -F[i](x_interm);
-                        if (UnlinearSolver<T>::currentSetup_.tol_method == USToleranceMethod::absolute)
+                        y(i, 0) = y_new(i, 0);
+                        if (setup.tol_method == USToleranceMethod::absolute)
                         {
                             r(i, 0) = std::abs(y(i, 0));
                         }
-                        if (UnlinearSolver<T>::currentSetup_.tol_method == USToleranceMethod::relative)
+                        if (setup.tol_method == USToleranceMethod::relative)
                         {
                             r(i, 0) = std::abs((r_l - y(i, 0)) / y(i, 0));
                         }
                     }
                     E = r.maxElement();
 
-                    if (E <= static_cast<T>(UnlinearSolver<T>::currentSetup_.targetTolerance))
+                    if (E <= static_cast<T>(setup.targetTolerance))
                     {
                         stop = 1;
                         x = x_interm;
                     }
                     else
                     {
-                        if (iter_cnt > UnlinearSolver<T>::currentSetup_.abort_iter)
+                        if (stagnation)
+                        {
+                            x = x_interm;
+                            throw(math::ExceptionTooManyIterations("Secant.solve: Solver didn't converge with choosen tolerance. Trust region radius reached its minimum!"));
+                        }
+                        if (iter_cnt > setup.abort_iter)
                         {
                             x = x_interm;
                             throw(math::ExceptionTooManyIterations("Secant.solve: Solver didn't converge with choosen tolerance. Too many iterations!"));
                         }
                     }
                 }
-                if (UnlinearSolver<T>::currentSetup_.criteria == USStoppingCriteriaType::iterations)
+                if (setup.criteria == USStoppingCriteriaType::iterations)
                 {
-                    for (size_t i = 0; i < n; ++i)
-                    {
-                        y(i, 0) = -F[i](x_interm);
-                    }
-                    if (iter_cnt > UnlinearSolver<T>::currentSetup_.max_iter)
+                    y = y_new;
+                    if (iter_cnt > setup.max_iter || stagnation)
                     {
                         stop = 1;
                         x = x_interm;
@@ -200,5 +232,343 @@ namespace math
                 }
             }
         }
+
+    private:
+        /**
+         * @brief Find free arguments of projected Newton step
+         * @details Argument is frozen, if it's clamped to the bound (see UnlinearSolver::applyBounds()) and gradient
+         * @f$ \nabla\phi = J^T F @f$ of merit function points inside, so descent direction leaves the box.
+         * @param[out] free_args: Indices of free arguments
+         * @return True if any argument is frozen
+         */
+        bool activeSet(
+            const Matrix<T> &df,
+            const Matrix<T> &y,
+            const Matrix<T> &x,
+            const Matrix<T> &x_min,
+            const Matrix<T> &x_max,
+            std::vector<size_t> &free_args) const
+        {
+            const USsetup &setup = UnlinearSolver<T>::currentSetup_;
+            size_t n = x.rows();
+            free_args.clear();
+            for (size_t i = 0; i < n; ++i)
+            {
+                bool lower = i < x_min.rows() && x(i, 0) <= x_min(i, 0) + setup.diff_step;
+                bool upper = i < x_max.rows() && x(i, 0) >= x_max(i, 0) - setup.diff_step;
+                if (lower || upper)
+                {
+                    // y = -F
+                    T g = static_cast<T>(0.0);
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        g -= df(j, i) * y(j, 0);
+                    }
+                    if ((lower && g > static_cast<T>(0.0)) || (upper && g < static_cast<T>(0.0)))
+                    {
+                        continue;
+                    }
+                }
+                free_args.push_back(i);
+            }
+            return free_args.size() < n;
+        }
+
+        /**
+         * @brief Newton step for free arguments only
+         * @details Called only if any argument is frozen (see activeSet()), so system is overdetermined and
+         * step of free arguments is least squares solution of @f$ J_F \Delta x_F = -F @f$ of size equal to
+         * number of free arguments. It's found by QR factorization (see TSQR), which, unlike normal equations,
+         * doesn't square condition number of @f$ J_F @f$.
+         * Columns of frozen arguments in df are zeroed, so globalization keeps them on the bounds.
+         * @param[in,out] df: Jacobian
+         * @param[out] dx: Step, zero for frozen arguments
+         */
+        void reducedStep(
+            Matrix<T> &df,
+            const Matrix<T> &y,
+            const std::vector<size_t> &free_args,
+            Matrix<T> &dx) const
+        {
+            size_t n = df.rows();
+            size_t k = free_args.size();
+
+            Matrix<T> d(k, 1, static_cast<T>(0.0));
+            if (k > 0)
+            {
+                d = TSQR<T>::factorize(n, k, 1, [&df, &y, &free_args, k](size_t i, T *row)
+                    {
+                        for (size_t c = 0; c < k; ++c)
+                        {
+                            row[c] = df(i, free_args[c]);
+                        }
+                        row[k] = y(i, 0);
+                    }).solve();
+            }
+
+            std::vector<bool> frozen(n, true);
+            for (size_t c = 0; c < k; ++c)
+            {
+                frozen[free_args[c]] = false;
+            }
+            for (size_t i = 0; i < n; ++i)
+            {
+                dx(i, 0) = static_cast<T>(0.0);
+                if (frozen[i])
+                {
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        df(j, i) = static_cast<T>(0.0);
+                    }
+                }
+            }
+            for (size_t c = 0; c < k; ++c)
+            {
+                dx(free_args[c], 0) = d(c, 0);
+            }
+        }
+
+        /**
+         * @brief Evaluate residuals @f$ y = -F(x) @f$
+         */
+        void evalResiduals(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            const Matrix<T> &x,
+            Matrix<T> &y,
+            SolverStats &stats) const
+        {
+            stats.f_evals += F.size();
+            for (size_t i = 0; i < F.size(); ++i)
+            {
+                y(i, 0) = -F[i](x);
+            }
+        }
+
+        /**
+         * @brief Merit function @f$ \phi = \frac{1}{2} \|F\|^2 @f$.
+         * @details Returns infinity, if any of residuals is not finite (e.g. function is undefined
+         * in the trial point), so such trial points are always rejected
+         */
+        static T merit(const Matrix<T> &y)
+        {
+            T phi = static_cast<T>(0.0);
+            for (size_t i = 0; i < y.rows(); ++i)
+            {
+                phi += y(i, 0) * y(i, 0);
+            }
+            if (!std::isfinite(phi))
+            {
+                return std::numeric_limits<T>::infinity();
+            }
+            return static_cast<T>(0.5) * phi;
+        }
+
+        /**
+         * @brief Backtracking line search along Newton direction dx
+         * @details Residuals of every trial point are kept in y_new, so accepted step
+         * doesn't require additional evaluations of F
+         */
+        void lineSearch(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            const Matrix<T> &df,
+            const Matrix<T> &y,
+            const Matrix<T> &dx,
+            const Matrix<T> &x_l,
+            Matrix<T> &x_interm,
+            Matrix<T> &y_new,
+            SolverStats &stats,
+            const Matrix<T> &x_min,
+            const Matrix<T> &x_max) const
+        {
+            const USsetup &setup = UnlinearSolver<T>::currentSetup_;
+            size_t n = x_l.rows();
+
+            T phi = merit(y);
+
+            // directional derivative of merit function: F^T J dx (y = -F)
+            Matrix<T> Jdx = df * dx;
+            T slope = static_cast<T>(0.0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                slope -= y(i, 0) * Jdx(i, 0);
+            }
+            // inexact linear solution may be not a descent direction
+            if (!(slope < static_cast<T>(0.0)))
+            {
+                slope = static_cast<T>(-2.0) * phi;
+            }
+
+            T lambda = static_cast<T>(1.0);
+            while (true)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    x_interm(i, 0) = x_l(i, 0) + lambda * dx(i, 0);
+                }
+                UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+                evalResiduals(F, x_interm, y_new, stats);
+
+                T phi_new = merit(y_new);
+
+                if (phi_new <= phi + static_cast<T>(setup.ls_armijo) * lambda * slope ||
+                    lambda <= static_cast<T>(setup.ls_min_step))
+                {
+                    break;
+                }
+
+                // minimizer of quadratic model of phi(lambda), safeguarded in [0.1*lambda, 0.5*lambda]
+                T lambda_new = static_cast<T>(0.5) * lambda;
+                if (std::isfinite(phi_new))
+                {
+                    T denom = static_cast<T>(2.0) * (phi_new - phi - lambda * slope);
+                    if (denom > static_cast<T>(0.0))
+                    {
+                        lambda_new = -slope * lambda * lambda / denom;
+                    }
+                }
+                lambda = std::max(std::min(lambda_new, static_cast<T>(0.5) * lambda), static_cast<T>(0.1) * lambda);
+                lambda = std::max(lambda, static_cast<T>(setup.ls_min_step));
+            }
+        }
+
+        /**
+         * @brief Dogleg trust-region step
+         * @details Combine Newton step dx and Cauchy step (minimizer of the linear model along steepest descent
+         * direction) within trust region of size radius. Rejected steps shrink the radius and reuse Jacobian
+         * df and Newton step dx, so only residuals are evaluated for every trial point.
+         * @return False if radius reached its minimum without decrease of merit function. Last solution
+         * x_l and its residuals y are kept in x_interm and y_new then
+         */
+        bool trustRegion(
+            const std::vector<std::function<T(const Matrix<T> &)>> &F,
+            const Matrix<T> &df,
+            const Matrix<T> &y,
+            const Matrix<T> &dx,
+            const Matrix<T> &x_l,
+            Matrix<T> &x_interm,
+            Matrix<T> &y_new,
+            T &radius,
+            SolverStats &stats,
+            const Matrix<T> &x_min,
+            const Matrix<T> &x_max) const
+        {
+            const USsetup &setup = UnlinearSolver<T>::currentSetup_;
+            size_t n = x_l.rows();
+
+            T phi = merit(y);
+
+            // gradient of merit function g = J^T F (y = -F)
+            Matrix<T> g = static_cast<T>(-1.0) * (df.getTr() * y);
+            Matrix<T> Jg = df * g;
+            T g_norm2 = static_cast<T>(0.0);
+            T Jg_norm2 = static_cast<T>(0.0);
+            T dx_norm2 = static_cast<T>(0.0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                g_norm2 += g(i, 0) * g(i, 0);
+                Jg_norm2 += Jg(i, 0) * Jg(i, 0);
+                dx_norm2 += dx(i, 0) * dx(i, 0);
+            }
+            T dx_norm = std::sqrt(dx_norm2);
+
+            // Cauchy step p_c = -(g^T g / (Jg)^T Jg) g
+            Matrix<T> p_c(n, 1, static_cast<T>(0.0));
+            if (Jg_norm2 > static_cast<T>(0.0))
+            {
+                p_c = (-g_norm2 / Jg_norm2) * g;
+            }
+            T p_c_norm = std::sqrt(g_norm2) * (Jg_norm2 > static_cast<T>(0.0) ? g_norm2 / Jg_norm2 : static_cast<T>(0.0));
+
+            Matrix<T> p(n, 1);
+            Matrix<T> step(n, 1);
+            Matrix<T> Jp(n, 1);
+
+            // smallest meaningful radius
+            T x_norm = static_cast<T>(0.0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                x_norm += x_l(i, 0) * x_l(i, 0);
+            }
+            T radius_min = std::numeric_limits<T>::epsilon() * (static_cast<T>(1.0) + std::sqrt(x_norm));
+
+            while (true)
+            {
+                if (dx_norm <= radius)
+                {
+                    p = dx;
+                }
+                else if (g_norm2 == static_cast<T>(0.0))
+                {
+                    // stationary point of merit function, follow truncated Newton step
+                    p = (radius / dx_norm) * dx;
+                }
+                else if (p_c_norm >= radius)
+                {
+                    p = (-radius / std::sqrt(g_norm2)) * g;
+                }
+                else
+                {
+                    // p = p_c + tau (dx - p_c), ||p|| = radius
+                    Matrix<T> d = dx - p_c;
+                    T a = static_cast<T>(0.0);
+                    T b = static_cast<T>(0.0);
+                    T c = -radius * radius;
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        a += d(i, 0) * d(i, 0);
+                        b += static_cast<T>(2.0) * p_c(i, 0) * d(i, 0);
+                        c += p_c(i, 0) * p_c(i, 0);
+                    }
+                    T tau = (-b + std::sqrt(std::max(b * b - static_cast<T>(4.0) * a * c, static_cast<T>(0.0)))) / (static_cast<T>(2.0) * a);
+                    p = p_c + tau * d;
+                }
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    x_interm(i, 0) = x_l(i, 0) + p(i, 0);
+                }
+                UnlinearSolver<T>::applyBounds(x_interm, x_min, x_max);
+                evalResiduals(F, x_interm, y_new, stats);
+
+                // predicted reduction of linear model by actually taken (bounded) step
+                T step_norm2 = static_cast<T>(0.0);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    step(i, 0) = x_interm(i, 0) - x_l(i, 0);
+                    step_norm2 += step(i, 0) * step(i, 0);
+                }
+                T step_norm = std::sqrt(step_norm2);
+                Jp = df * step;
+                T model = static_cast<T>(0.0);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    model += (Jp(i, 0) - y(i, 0)) * (Jp(i, 0) - y(i, 0));
+                }
+                T pred = phi - static_cast<T>(0.5) * model;
+                T ared = phi - merit(y_new);
+                T rho = pred > static_cast<T>(0.0) ? ared / pred : static_cast<T>(-1.0);
+
+                if (rho < static_cast<T>(0.25))
+                {
+                    radius = static_cast<T>(0.25) * std::max(std::min(step_norm, radius), radius_min);
+                }
+                else if (rho > static_cast<T>(0.75) && step_norm >= static_cast<T>(0.99) * radius)
+                {
+                    radius = std::min(static_cast<T>(2.0) * radius, static_cast<T>(setup.tr_max_radius));
+                }
+
+                if (rho > static_cast<T>(1.e-4))
+                {
+                    return true;
+                }
+                if (radius <= radius_min)
+                {
+                    // trial point is rejected, stay at the last solution
+                    x_interm = x_l;
+                    y_new = y;
+                    return false;
+                }
+            }
+        }
 	};
 }
\ No newline at end of file
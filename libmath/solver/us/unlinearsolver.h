@@ -3,12 +3,14 @@
 #include <libmath/matrix.h>
 #include <libmath/boolean.h>
 #include <libmath/math_settings.h>
+#include <libmath/profiling.h>
 #include <libmath/solver/las/lassolver.h>
 #include <libmath/solver/las/kholetsky.h>
 #include <libmath/solver/las/bicgstab.h>
 #include <functional>
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 #ifdef MATH_OMP_DEFINE
 #include <omp.h>
@@ -36,6 +38,41 @@ namespace math
 		relative
 	};
 
+	/**
+	 * @brief Globalization strategy of Newton steps
+	 * - none: Full Newton steps (only clamped to the arguments bounds)
+	 * - line_search: Backtracking line search with Armijo sufficient decrease condition
+	 * - trust_region: Dogleg trust-region steps
+	 */
+	enum class USGlobalizationType
+	{
+		none,
+		line_search,
+		trust_region
+	};
+
+	/**
+	 * @brief Handling of arguments bounds
+	 * - clamp: Arguments are clamped to the bounds after every step
+	 * - active_set: Projected Newton method. Arguments clamped to the bounds, for which steepest descent direction
+	 * of @f$ \frac{1}{2} \|F\|^2 @f$ points outside, are frozen, and Newton step is solved for the rest of arguments only
+	 */
+	enum class USBoundsMethod
+	{
+		clamp,
+		active_set
+	};
+
+	/**
+	 * @brief Krylov method for matrix-free solving of Newton steps
+	 * @see NewtonKrylov
+	 */
+	enum class USKrylovMethod
+	{
+		gmres,
+		bicgstab
+	};
+
 	/**
 	* @brief Solver settings.
 	*/
@@ -76,7 +113,17 @@ namespace math
 			abort_iter(new_setup.abort_iter),
 			targetTolerance(new_setup.targetTolerance),
 			diff_step(new_setup.diff_step),
-			diff_scheme(new_setup.diff_scheme)
+			diff_scheme(new_setup.diff_scheme),
+			globalization(new_setup.globalization),
+			ls_armijo(new_setup.ls_armijo),
+			ls_min_step(new_setup.ls_min_step),
+			tr_radius(new_setup.tr_radius),
+			tr_max_radius(new_setup.tr_max_radius),
+			krylov_method(new_setup.krylov_method),
+			krylov_restart(new_setup.krylov_restart),
+			krylov_max_iter(new_setup.krylov_max_iter),
+			forcing_max(new_setup.forcing_max),
+			bounds_method(new_setup.bounds_method)
 		{
 			delete linearSolver;
 			linearSolver = new_setup.linearSolver->copy();
@@ -119,6 +166,42 @@ namespace math
 		//std::unique_ptr<LASsolver<real>> linearSolver = std::make_unique<BicGStab<real>>();
 		LASsolver<real>* linearSolver = new BicGStab<real>();
 
+		/// @brief Globalization strategy of Newton steps
+		USGlobalizationType globalization = USGlobalizationType::none;
+
+		/// @brief Armijo sufficient decrease parameter @f$ c_1 @f$ for line search:
+		/// @f$ \phi(x + \lambda \Delta x) \le \phi(x) + c_1 \lambda \nabla\phi^T \Delta x @f$,
+		/// where @f$ \phi = \frac{1}{2} \|F\|^2 @f$
+		real ls_armijo = 1.e-4;
+
+		/// @brief Minimum step length for line search. If backtracking reaches this length,
+		/// step is accepted as is
+		real ls_min_step = 1.e-4;
+
+		/// @brief Initial trust region radius
+		real tr_radius = 1.0;
+
+		/// @brief Maximum trust region radius
+		real tr_max_radius = 1.e3;
+
+		/// @brief Krylov method for Jacobian-free Newton steps
+		/// @see NewtonKrylov
+		USKrylovMethod krylov_method = USKrylovMethod::gmres;
+
+		/// @brief Dimension of Krylov subspace before GMRES restart
+		size_t krylov_restart = 30;
+
+		/// @brief Maximum number of Krylov iterations per Newton step
+		size_t krylov_max_iter = 200;
+
+		/// @brief Maximum forcing term @f$ \eta_{max} @f$ of inexact Newton method.
+		/// Newton step is solved up to relative residual @f$ \eta_k \le \eta_{max} @f$
+		real forcing_max = 0.9;
+
+		/// @brief Handling of arguments bounds
+		/// @see Secant
+		USBoundsMethod bounds_method = USBoundsMethod::clamp;
+
 		/// @brief assignment operator, which correctly copy LAS solver object
 		struct USsetup& operator=(const struct USsetup& new_setup)
 		{
@@ -129,6 +212,16 @@ namespace math
 			targetTolerance = new_setup.targetTolerance;
 			diff_step = new_setup.diff_step;
 			diff_scheme = new_setup.diff_scheme;
+			globalization = new_setup.globalization;
+			ls_armijo = new_setup.ls_armijo;
+			ls_min_step = new_setup.ls_min_step;
+			tr_radius = new_setup.tr_radius;
+			tr_max_radius = new_setup.tr_max_radius;
+			krylov_method = new_setup.krylov_method;
+			krylov_restart = new_setup.krylov_restart;
+			krylov_max_iter = new_setup.krylov_max_iter;
+			forcing_max = new_setup.forcing_max;
+			bounds_method = new_setup.bounds_method;
 			delete linearSolver;
 			linearSolver = new_setup.linearSolver->copy();
 
@@ -243,7 +336,59 @@ namespace math
 					throw(math::Exception(method_ + ": Invalid target tolerance. Tolerance must be greater than 0!"));
 				}
 			}
+			if (setup.globalization == USGlobalizationType::line_search)
+			{
+				if (setup.ls_armijo <= 0.0 || setup.ls_armijo >= 0.5)
+				{
+					throw(math::ExceptionInvalidValue(method_ + ": Invalid Armijo parameter. Parameter must be in range (0, 0.5)!"));
+				}
+				if (setup.ls_min_step <= 0.0 || setup.ls_min_step > 1.0)
+				{
+					throw(math::ExceptionInvalidValue(method_ + ": Invalid minimum line search step. Step must be in range (0, 1]!"));
+				}
+			}
+			if (setup.globalization == USGlobalizationType::trust_region)
+			{
+				if (setup.tr_radius <= 0.0 || setup.tr_max_radius < setup.tr_radius)
+				{
+					throw(math::ExceptionInvalidValue(method_ + ": Invalid trust region radius. Radius must be positive and not greater, than maximum radius!"));
+				}
+			}
+			if (setup.forcing_max <= 0.0 || setup.forcing_max >= 1.0)
+			{
+				throw(math::ExceptionInvalidValue(method_ + ": Invalid maximum forcing term. Forcing term must be in range (0, 1)!"));
+			}
+			if (setup.krylov_restart == 0 || setup.krylov_max_iter == 0)
+			{
+				throw(math::ExceptionInvalidValue(method_ + ": Invalid Krylov method settings. Restart and maximum iterations must be positive!"));
+			}
 		};
+
+		/**
+		 * @brief Clamp arguments to the bounds (with diff_step margin)
+		 * @param[in,out] x: Column matrix of arguments
+		 * @param[in] x_min: Vector of arguments lower bounds
+		 * @param[in] x_max: Vector of arguments upper bounds
+		 */
+		void applyBounds(Matrix<T> &x, const Matrix<T> &x_min, const Matrix<T> &x_max) const
+		{
+			// if lower bound defined
+			if (!x_min.empty())
+			{
+				for (size_t i = 0; i < x_min.rows(); ++i)
+				{
+					x(i, 0) = std::max(x(i, 0), x_min(i, 0) + currentSetup_.diff_step);
+				}
+			}
+			// if upper bound defined
+			if (!x_max.empty())
+			{
+				for (size_t i = 0; i < x_max.rows(); ++i)
+				{
+					x(i, 0) = std::min(x(i, 0), x_max(i, 0) - currentSetup_.diff_step);
+				}
+			}
+		}
 	public:
 		/// @brief Default constructor
 		UnlinearSolver() {}
@@ -285,9 +430,32 @@ namespace math
 		 * @param[in] x_max: Vector of arguments upper bounds
 		 *
 		 */
+		void solve(const std::vector<std::function<T(
+			const Matrix<T>&)>>& F, 
+			Matrix<T>& x,
+            const Matrix<T> &x_min = Matrix<T>(),
+            const Matrix<T> &x_max = Matrix<T>()) const
+		{
+			SolverStats stats;
+			solve(F, x, stats, x_min, x_max);
+		}
+
+		/**
+		 * @brief Find roots of system @f$ F(x) = 0 @f$ and collect statistics of this solve
+		 * @details Statistics are iterations, residual history (euclidean norm of F after each iteration)
+		 * and number of evaluations of functions F. Phase times are collected only if profiling is
+		 * enabled (see profiling.h). Statistics are returned per call, so concurrent solves with the
+		 * same solver object are independent.
+		 * @param[in] F: Vector of functions, defines system of unlinear equations of type @f$ f(\mathbf{x}) = 0 @f$
+		 * @param[out] x: Column matrix of result roots. Initial value of x used as initial guess for numerical method
+		 * @param[out] stats: Solver statistics
+		 * @param[in] x_min: Vector of arguments lower bounds
+		 * @param[in] x_max: Vector of arguments upper bounds
+		 */
 		virtual void solve(const std::vector<std::function<T(
 			const Matrix<T>&)>>& F, 
 			Matrix<T>& x,
+			SolverStats& stats,
             const Matrix<T> &x_min = Matrix<T>(),
             const Matrix<T> &x_max = Matrix<T>()) const = 0;
 
@@ -3,6 +3,7 @@
 #include <libmath/matrix.h>
 #include <libmath/solver/us/unlinearsolver.h>
 #include <libmath/solver/us/secant.h>
+#include <libmath/solver/us/newton_krylov.h>
 #include <libmath/boolean.h>
 
 #ifdef MATH_OMP_DEFINE
@@ -10,6 +11,7 @@
 #endif
 
 #include <numeric>
+#include <atomic>
 
 TEST(USS, Secant)
 {
@@ -119,6 +121,78 @@ omp_set_num_threads(4);
 	EXPECT_EQ(math::isEqual(F[1](x), 0.0), true);
 }
 
+TEST(USS, SecantActiveSet)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// root (-1, 1) is outside of bounds, constrained minimum of |F|^2 is (0, 1.2)
+	std::vector<std::function<double(const math::Matrix<double>&)>> F;
+
+	F.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) + x(1, 0);
+		});
+	F.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) - 2.0 * x(1, 0) + 3.0;
+		});
+
+	math::Matrix<double> x_min = { {0.0}, {-5.0} };
+	math::Matrix<double> x_max = { {5.0}, {5.0} };
+
+	math::USsetup setup;
+	setup.criteria = math::USStoppingCriteriaType::iterations;
+	setup.max_iter = 5;
+
+	// clamped Newton steps stall at (0, 1)
+	math::Matrix<double> x_clamp = { {2.0}, {2.0} };
+	math::Secant<double> clamp_solver(setup);
+	clamp_solver.solve(F, x_clamp, x_min, x_max);
+	EXPECT_EQ(math::isEqual(x_clamp(1, 0), 1.0), true);
+
+	setup.bounds_method = math::USBoundsMethod::active_set;
+	for (auto globalization : { math::USGlobalizationType::none, math::USGlobalizationType::line_search, math::USGlobalizationType::trust_region })
+	{
+		setup.globalization = globalization;
+		math::Matrix<double> x = { {2.0}, {2.0} };
+		math::Secant<double> secant_solver(setup);
+		secant_solver.solve(F, x, x_min, x_max);
+
+		EXPECT_EQ(math::isEqual(x(0, 0), 0.0), true);
+		EXPECT_EQ(math::isEqual(x(1, 0), 1.2), true);
+	}
+
+	// interior root is found as without active set
+	std::vector<std::function<double(const math::Matrix<double>&)>> G;
+	G.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) * x(1, 0);
+		});
+	G.push_back(
+		[](const math::Matrix<double> &x)
+		{
+			return x(0, 0) + x(1, 0) + 0.2;
+		});
+
+	setup.criteria = math::USStoppingCriteriaType::tolerance;
+	setup.globalization = math::USGlobalizationType::line_search;
+	math::Matrix<double> x = { {-1.0}, {-2.0} };
+	math::Secant<double> secant_solver(setup);
+	secant_solver.solve(G, x, { {0.0}, {-1.0} }, { {1.0}, {1.0} });
+
+	EXPECT_EQ(math::isEqual(G[0](x), 0.0), true);
+	EXPECT_EQ(math::isEqual(G[1](x), 0.0), true);
+
+	// bounds are checked once per solve
+	EXPECT_THROW(secant_solver.solve(G, x, { {1.0}, {-1.0} }, { {0.0}, {1.0} }), math::ExceptionInvalidValue);
+	EXPECT_THROW(secant_solver.solve(G, x, { {0.0}, {-1.0}, {0.0} }, math::Matrix<double>()), math::ExceptionIncorrectMatrix);
+}
+
 TEST(US, Secant)
 {
 #ifdef MATH_OMP_DEFINE
@@ -179,4 +253,333 @@ omp_set_num_threads(4);
 	secant_solver.solve({ f }, x);
 
 	EXPECT_EQ(math::isEqual(f(x), 0.0), true);
-}
\ No newline at end of file
+}
+
+TEST(US, SecantLineSearch)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// full Newton steps diverge for atan(x) if |x0| > 1.39
+	std::function<double(const math::Matrix<double>&)> f(
+		[](const math::Matrix<double>& x)
+		{
+			return std::atan(x(0, 0));
+		}
+	);
+
+	math::Matrix<double> x = { {3.0} };
+
+	math::USsetup setup;
+	setup.globalization = math::USGlobalizationType::line_search;
+	setup.max_iter = 50;
+	setup.abort_iter = 50;
+
+	math::Secant<double> secant_solver(setup);
+
+	secant_solver.solve({ f }, x);
+
+	EXPECT_EQ(math::isEqual(f(x), 0.0), true);
+}
+
+TEST(US, SecantTrustRegion)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	std::function<double(const math::Matrix<double>&)> f(
+		[](const math::Matrix<double>& x)
+		{
+			return std::atan(x(0, 0));
+		}
+	);
+
+	math::Matrix<double> x = { {3.0} };
+
+	math::USsetup setup;
+	setup.globalization = math::USGlobalizationType::trust_region;
+	setup.max_iter = 50;
+	setup.abort_iter = 50;
+
+	math::Secant<double> secant_solver(setup);
+
+	secant_solver.solve({ f }, x);
+
+	EXPECT_EQ(math::isEqual(f(x), 0.0), true);
+
+	// no root, minimum of |g| at 0: trust region collapses there without accepting worse points
+	std::function<double(const math::Matrix<double>&)> g(
+		[](const math::Matrix<double>& x)
+		{
+			return x(0, 0) * x(0, 0) + 1.0;
+		}
+	);
+	setup.diff_scheme = 3;
+	setup.abort_iter = 1000;
+	secant_solver.setupSolver(setup);
+
+	math::Matrix<double> y = { {1.0} };
+	math::SolverStats stats;
+	EXPECT_THROW(secant_solver.solve({ g }, y, stats), math::ExceptionTooManyIterations);
+	EXPECT_LT(stats.iterations, setup.abort_iter);
+	for (size_t i = 1; i < stats.residuals.size(); ++i)
+	{
+		EXPECT_LE(stats.residuals[i], stats.residuals[i - 1]);
+	}
+	EXPECT_EQ(math::isEqual(g(y), 1.0, 1.e-6), true);
+}
+
+TEST(USS, SecantGlobalization)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// vector function F
+	std::vector<std::function<double(const math::Matrix<double>&)>> F;
+
+	F.push_back
+	(
+		[](const math::Matrix<double>& x)
+		{
+			return std::atan(x(0, 0) - 1.0) + 0.5 * x(1, 0);
+		}
+	);
+	F.push_back
+	(
+		[](const math::Matrix<double>& x)
+		{
+			return std::atan(x(1, 0));
+		}
+	);
+
+	for (auto globalization : { math::USGlobalizationType::line_search, math::USGlobalizationType::trust_region })
+	{
+		math::Matrix<double> x =
+		{
+			{4.0},
+			{-3.0}
+		};
+
+		math::USsetup setup
+		{
+			math::USStoppingCriteriaType::tolerance,
+			math::USToleranceMethod::absolute,
+			100,
+			100,
+			1.e-7,
+			1.e-10,
+			1,
+			new math::Kholetsky<double>()
+		};
+		setup.globalization = globalization;
+
+		math::Secant<double> secant_solver(setup);
+
+		secant_solver.solve(F, x);
+
+		EXPECT_EQ(math::isEqual(F[0](x), 0.0), true);
+		EXPECT_EQ(math::isEqual(F[1](x), 0.0), true);
+	}
+}
+
+
+TEST(USS, NewtonKrylov)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// vector function F
+	std::vector<std::function<double(const math::Matrix<double>&)>> F;
+
+	F.push_back
+	(
+		[](const math::Matrix<double>& x)
+		{
+			return (pow(x(0, 0), 2.0) + pow(x(1, 0), 2.0) - x(2, 0) - 6.0);
+		}
+	);
+	F.push_back
+	(
+		[](const math::Matrix<double>& x)
+		{
+			return (x(0, 0) + x(1, 0) * x(2, 0) - 2.0);
+		}
+	);
+	F.push_back
+	(
+		[](const math::Matrix<double>& x)
+		{
+			return (x(0, 0) + x(1, 0) + x(2, 0) - 3.0);
+		}
+	);
+
+	for (auto krylov_method : { math::USKrylovMethod::gmres, math::USKrylovMethod::bicgstab })
+	{
+		math::Matrix<double> x =
+		{
+			{1.0},
+			{1.0},
+			{1.0}
+		};
+
+		math::USsetup setup;
+		setup.krylov_method = krylov_method;
+		setup.globalization = math::USGlobalizationType::line_search;
+
+		math::NewtonKrylov<double> jfnk_solver(setup);
+
+		jfnk_solver.solve(F, x);
+
+		EXPECT_EQ(math::isEqual(F[0](x), 0.0), true);
+		EXPECT_EQ(math::isEqual(F[1](x), 0.0), true);
+		EXPECT_EQ(math::isEqual(F[2](x), 0.0), true);
+	}
+}
+
+TEST(USS, NewtonKrylovConstrained)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// F is undefined outside of bounds, root (0, -0.2) lies on the lower bound of x0
+	std::atomic<size_t> outside{ 0 };
+	auto inside = [&outside](const math::Matrix<double> &x)
+	{
+		if (x(0, 0) >= 0.0 && x(0, 0) <= 1.0 && x(1, 0) >= -1.0 && x(1, 0) <= 1.0)
+		{
+			return true;
+		}
+		++outside;
+		return false;
+	};
+
+	std::vector<std::function<double(const math::Matrix<double>&)>> F;
+	F.push_back(
+		[inside](const math::Matrix<double> &x)
+		{
+			return inside(x) ? x(0, 0) * x(1, 0) : std::numeric_limits<double>::quiet_NaN();
+		});
+	F.push_back(
+		[inside](const math::Matrix<double> &x)
+		{
+			return inside(x) ? x(0, 0) + x(1, 0) + 0.2 : std::numeric_limits<double>::quiet_NaN();
+		});
+
+	// start on the bound with margin smaller, than step of Jacobian-vector products,
+	// so perturbations of x0 below the bound are requested
+	math::Matrix<double> x =
+	{
+		{0.0},
+		{0.5}
+	};
+
+	math::USsetup setup;
+	setup.globalization = math::USGlobalizationType::line_search;
+	setup.diff_step = 1.e-12;
+
+	math::NewtonKrylov<double> jfnk_solver(setup);
+
+	jfnk_solver.solve(F, x, { {0.0}, {-1.0} }, { {1.0}, {1.0} });
+
+	EXPECT_EQ(math::isEqual(F[0](x), 0.0), true);
+	EXPECT_EQ(math::isEqual(F[1](x), 0.0), true);
+
+	// root -1 is outside of bounds, Newton direction points through the bound
+	std::function<double(const math::Matrix<double>&)> g(
+		[&outside](const math::Matrix<double> &x)
+		{
+			if (x(0, 0) < 0.0 || x(0, 0) > 1.0)
+			{
+				++outside;
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+			return x(0, 0) + 1.0;
+		});
+	setup.criteria = math::USStoppingCriteriaType::iterations;
+	setup.max_iter = 3;
+	jfnk_solver.setupSolver(setup);
+
+	math::Matrix<double> y = { {0.5} };
+	jfnk_solver.solve({ g }, y, { {0.0} }, { {1.0} });
+
+	EXPECT_EQ(outside.load(), 0);
+	EXPECT_EQ(std::isfinite(g(y)), true);
+
+	// incorrect bounds
+	EXPECT_THROW(jfnk_solver.solve({ g }, y, { {0.0}, {0.0} }, { {1.0} }), math::ExceptionIncorrectMatrix);
+	EXPECT_THROW(jfnk_solver.solve({ g }, y, { {1.0} }, { {0.0} }), math::ExceptionInvalidValue);
+	EXPECT_THROW(jfnk_solver.solve({ g }, y, { {0.0} }, { {1.5e-12} }), math::ExceptionInvalidValue);
+}
+
+TEST(USS, NewtonKrylovTridiagonal)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	// Broyden tridiagonal function
+	size_t n = 100;
+	std::vector<std::function<double(const math::Matrix<double>&)>> F;
+	for (size_t i = 0; i < n; ++i)
+	{
+		F.push_back
+		(
+			[i, n](const math::Matrix<double>& x)
+			{
+				double x_prev = i > 0 ? x(i - 1, 0) : 0.0;
+				double x_next = i < n - 1 ? x(i + 1, 0) : 0.0;
+				return (3.0 - 2.0 * x(i, 0)) * x(i, 0) - x_prev - 2.0 * x_next + 1.0;
+			}
+		);
+	}
+
+	math::Matrix<double> x(n, 1, -1.0);
+
+	math::USsetup setup;
+	setup.globalization = math::USGlobalizationType::line_search;
+
+	math::NewtonKrylov<double> jfnk_solver(setup);
+
+	jfnk_solver.solve(F, x);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		EXPECT_EQ(math::isEqual(F[i](x), 0.0), true);
+	}
+}
+
+TEST(US, SolverStats)
+{
+#ifdef MATH_OMP_DEFINE
+omp_set_num_threads(4);
+#endif
+
+	std::atomic<size_t> evals{ 0 };
+	std::function<double(const math::Matrix<double>&)> f(
+		[&evals](const math::Matrix<double>& x)
+		{
+			++evals;
+			return std::atan(x(0, 0));
+		}
+	);
+
+	math::Matrix<double> x = { {3.0} };
+
+	math::USsetup setup;
+	setup.globalization = math::USGlobalizationType::line_search;
+
+	math::Secant<double> secant_solver(setup);
+
+	math::SolverStats stats;
+	secant_solver.solve({ f }, x, stats);
+
+	EXPECT_GT(stats.iterations, 0);
+	EXPECT_EQ(stats.residuals.size(), stats.iterations);
+	EXPECT_EQ(math::isEqual(stats.residuals.back(), 0.0), true);
+	EXPECT_EQ(stats.f_evals, evals.load());
+}
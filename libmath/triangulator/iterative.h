@@ -0,0 +1,1178 @@
+#pragma once
+#include <libmath/triangulator/triangulator.h>
+#include <libmath/geometry/predicates.h>
+#include <libmath/geometry/spatial_sort.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include <memory>
+
+namespace math::detail
+{
+	/**
+	* @brief Find D + 1 affinely independent points, the first in order of array
+	* @return False if all points lie in hyperplane
+	*/
+	template <size_t D>
+	bool initialSimplex(const double* x, size_t n, uint32_t* v)
+	{
+		size_t found = 0;
+		for (uint32_t i = 0; i < n; ++i)
+		{
+			const double* p = x + static_cast<size_t>(i) * D;
+			bool independent = false;
+			switch (found)
+			{
+			case 0:
+				independent = true;
+				break;
+			case 1:
+				independent = !std::equal(p, p + D, x + static_cast<size_t>(v[0]) * D);
+				break;
+			case 2:
+			{
+				const double* a = x + static_cast<size_t>(v[0]) * D;
+				const double* b = x + static_cast<size_t>(v[1]) * D;
+				if constexpr (D == 2)
+				{
+					independent = predicates::orient2d(a, b, p) != 0.0;
+				}
+				else
+				{
+					// non-collinear if any coordinate projection is non-degenerate
+					for (size_t k = 0; k < 3 && !independent; ++k)
+					{
+						size_t k1 = (k + 1) % 3;
+						double pa[2] = { a[k], a[k1] }, pb[2] = { b[k], b[k1] }, pp[2] = { p[k], p[k1] };
+						independent = predicates::orient2d(pa, pb, pp) != 0.0;
+					}
+				}
+				break;
+			}
+			default:
+				if constexpr (D == 3)
+				{
+					independent = predicates::orient3d(x + static_cast<size_t>(v[0]) * D, x + static_cast<size_t>(v[1]) * D,
+						x + static_cast<size_t>(v[2]) * D, p) != 0.0;
+				}
+				break;
+			}
+			if (independent)
+			{
+				v[found++] = i;
+				if (found == D + 1)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/**
+	* @brief Incremental Delaunay triangulation of D-dimensional points (D = 2, 3)
+	* @details Bowyer-Watson algorithm: point is located by visibility walk from the last created
+	* cell, cells which circumspheres contain point (conflict region) are removed, and the
+	* star-shaped cavity is filled with cells connecting its boundary facets to the point.
+	*
+	* Convex hull is closed by ghost cells, sharing the infinite vertex: hull facet of ghost cell
+	* is in conflict with point on its outer side, or in its hyperplane and inside circumsphere of
+	* finite cell behind it. Cells are oriented consistently: finite cells are positively oriented,
+	* ghost cell becomes positive if infinite vertex is replaced by point beyond its hull facet.
+	* Cavity cells keep vertex positions when the point replaces a vertex, so orientation is preserved.
+	*
+	* Points are given by external array of coordinates, all predicates are exact
+	* (see predicates::orient2d). Cocircular (cospherical) points are resolved by symbolic
+	* perturbation (see predicates::incirclePerturbed), so triangulation is unique and doesn't
+	* depend on insertion order. Cells are stored in flat array: D + 1 vertices followed by D + 1
+	* neighbours (neighbour k is opposite to vertex k) per cell, removed cells are reused. New cells
+	* of cavity are linked through local numbering of cavity boundary vertices, without search.
+	*/
+	template <size_t D>
+	class BowyerWatson
+	{
+		static_assert(D == 2 || D == 3, "BowyerWatson: only 2D and 3D triangulations are supported");
+
+	public:
+		using index_type = uint32_t;
+
+		/// @brief Vertices per cell
+		static constexpr size_t V = D + 1;
+
+		/// @brief Infinite vertex of ghost cells
+		static constexpr index_type infinite = std::numeric_limits<index_type>::max();
+
+		/// @brief Invalid cell
+		static constexpr index_type none = std::numeric_limits<index_type>::max();
+
+	private:
+		/// @brief Values per cell: vertices and neighbours
+		static constexpr size_t S = 2 * V;
+
+		const double* coords_ = nullptr;
+
+		std::vector<index_type> cells_;
+		std::vector<char> alive_;
+		std::vector<index_type> free_;
+
+		/// @brief Marks of cells in conflict (stamp_) and tested out of conflict (stamp_ + 1)
+		std::vector<uint32_t> mark_;
+		uint32_t stamp_ = 0;
+
+		/// @brief Local numbers of cavity boundary vertices, valid if vertex stamp is equal to stamp_
+		std::vector<uint32_t> vertex_stamp_;
+		std::vector<uint32_t> vertex_local_;
+		uint32_t infinite_stamp_ = 0;
+		uint32_t infinite_local_ = 0;
+
+		/// @brief Cell, incident to vertex (none for vertices out of triangulation)
+		std::vector<index_type> incident_;
+
+		/// @brief Start cell of the next walk
+		index_type hint_ = none;
+
+		/// @brief State of random choice of first facet in walk
+		uint32_t rng_ = 0x9E3779B9u;
+
+		// workspace of insertion
+		std::vector<index_type> cavity_;
+		std::vector<std::pair<index_type, index_type>> boundary_;
+		std::vector<index_type> created_;
+
+		/// @brief Triangulation of star link in vertex removal
+		std::unique_ptr<BowyerWatson> link_dt_;
+		std::vector<index_type> link_;
+		std::vector<double> link_coords_;
+		std::vector<std::pair<uint64_t, uint64_t>> link_facets_;
+
+		/// @brief Unmatched facets of new cells: cell * V + facet, indexed by local numbers of D - 1 vertices
+		std::vector<uint64_t> ridges_;
+
+		const double* point(index_type v) const
+		{
+			return coords_ + static_cast<size_t>(v) * D;
+		}
+
+		index_type* vtx(index_type c)
+		{
+			return cells_.data() + static_cast<size_t>(c) * S;
+		}
+
+		const index_type* vtx(index_type c) const
+		{
+			return cells_.data() + static_cast<size_t>(c) * S;
+		}
+
+		index_type* nbr(index_type c)
+		{
+			return cells_.data() + static_cast<size_t>(c) * S + V;
+		}
+
+		const index_type* nbr(index_type c) const
+		{
+			return cells_.data() + static_cast<size_t>(c) * S + V;
+		}
+
+		static double orientation(const double* const* x)
+		{
+			if constexpr (D == 2)
+			{
+				return predicates::orient2d(x[0], x[1], x[2]);
+			}
+			else
+			{
+				return predicates::orient3d(x[0], x[1], x[2], x[3]);
+			}
+		}
+
+		/// @brief Orientation of cell c with vertex k replaced by point p
+		double orient(index_type c, size_t k, index_type p) const
+		{
+			const index_type* v = vtx(c);
+			const double* x[V];
+			for (size_t l = 0; l < V; ++l)
+			{
+				x[l] = l == k ? point(p) : point(v[l]);
+			}
+			return orientation(x);
+		}
+
+		/// @brief Perturbed in-sphere test of point p against finite cell c, never zero
+		double inSphere(index_type c, index_type p) const
+		{
+			const index_type* v = vtx(c);
+			if constexpr (D == 2)
+			{
+				return predicates::incirclePerturbed(point(v[0]), point(v[1]), point(v[2]), point(p));
+			}
+			else
+			{
+				return predicates::inspherePerturbed(point(v[0]), point(v[1]), point(v[2]), point(v[3]), point(p));
+			}
+		}
+
+		bool conflict(index_type c, index_type p) const
+		{
+			int j = ghostPosition(c);
+			if (j < 0)
+			{
+				return inSphere(c, p) > 0.0;
+			}
+			double o = orient(c, static_cast<size_t>(j), p);
+			if (o != 0.0)
+			{
+				return o > 0.0;
+			}
+			return inSphere(nbr(c)[j], p) > 0.0;
+		}
+
+		/// @brief Make at least count cells available for allocate()
+		void reserveCells(size_t count)
+		{
+			if (free_.size() >= count)
+			{
+				return;
+			}
+			size_t first = alive_.size();
+			size_t added = std::max(count - free_.size(), first / 4);
+			cells_.resize((first + added) * S);
+			alive_.resize(first + added, 0);
+			mark_.resize(first + added, 0);
+			for (size_t c = first + added; c-- > first;)
+			{
+				free_.push_back(static_cast<index_type>(c));
+			}
+		}
+
+		index_type allocate()
+		{
+			reserveCells(1);
+			index_type c = free_.back();
+			free_.pop_back();
+			alive_[c] = 1;
+			return c;
+		}
+
+		void release(index_type c)
+		{
+			alive_[c] = 0;
+			free_.push_back(c);
+		}
+
+		uint32_t random()
+		{
+			rng_ ^= rng_ << 13;
+			rng_ ^= rng_ >> 17;
+			rng_ ^= rng_ << 5;
+			return rng_;
+		}
+
+		void newStamp()
+		{
+			if (stamp_ >= std::numeric_limits<uint32_t>::max() - 4)
+			{
+				std::fill(mark_.begin(), mark_.end(), 0);
+				std::fill(vertex_stamp_.begin(), vertex_stamp_.end(), 0);
+				infinite_stamp_ = 0;
+				stamp_ = 0;
+			}
+			stamp_ += 2;
+		}
+
+		/// @brief Grow per-vertex arrays to hold vertex v
+		void growVertices(index_type v)
+		{
+			if (v < incident_.size())
+			{
+				return;
+			}
+			size_t size = std::max(static_cast<size_t>(v) + 1, 2 * incident_.size());
+			vertex_stamp_.resize(size, 0);
+			vertex_local_.resize(size, 0);
+			incident_.resize(size, none);
+		}
+
+		/// @brief Local number of vertex on cavity boundary
+		uint32_t local(index_type v, uint32_t& count)
+		{
+			uint32_t& s = v == infinite ? infinite_stamp_ : vertex_stamp_[v];
+			uint32_t& l = v == infinite ? infinite_local_ : vertex_local_[v];
+			if (s != stamp_)
+			{
+				s = stamp_;
+				l = count++;
+			}
+			return l;
+		}
+
+		/// @brief Local number of vertex, assigned by local()
+		uint32_t localOf(index_type v) const
+		{
+			return v == infinite ? infinite_local_ : vertex_local_[v];
+		}
+
+		/// @brief Link facets of all cells, sharing the same vertices (initial simplex only)
+		void linkAll()
+		{
+			for (index_type a = 0; a < alive_.size(); ++a)
+			{
+				for (index_type b = 0; b < alive_.size(); ++b)
+				{
+					if (a == b || !alive_[a] || !alive_[b])
+					{
+						continue;
+					}
+					// b is neighbour of a opposite to vertex, which isn't in b
+					for (size_t k = 0; k < V; ++k)
+					{
+						size_t shared = 0;
+						for (size_t l = 0; l < V; ++l)
+						{
+							shared += l != k && std::find(vtx(b), vtx(b) + V, vtx(a)[l]) != vtx(b) + V;
+						}
+						if (shared == D)
+						{
+							nbr(a)[k] = b;
+						}
+					}
+				}
+			}
+		}
+
+		/// @brief Cells of vertex star to cavity_, facets opposite to vertex to boundary_
+		void star(index_type v)
+		{
+			newStamp();
+			cavity_.clear();
+			boundary_.clear();
+			created_.clear();
+			index_type c = incident_[v];
+			cavity_.push_back(c);
+			mark_[c] = stamp_;
+			for (size_t i = 0; i < cavity_.size(); ++i)
+			{
+				index_type s = cavity_[i];
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (vtx(s)[k] == v)
+					{
+						boundary_.emplace_back(s, static_cast<index_type>(k));
+						continue;
+					}
+					index_type o = nbr(s)[k];
+					if (mark_[o] != stamp_)
+					{
+						mark_[o] = stamp_;
+						cavity_.push_back(o);
+					}
+				}
+			}
+		}
+
+	public:
+		BowyerWatson() {};
+
+		/**
+		* @brief Set coordinates of points
+		* @param coords: Points, row-major (D values per point). Array must outlive triangulation
+		*/
+		void setCoordinates(const double* coords)
+		{
+			coords_ = coords;
+		}
+
+		/// @brief Remove all cells
+		void clear()
+		{
+			cells_.clear();
+			alive_.clear();
+			free_.clear();
+			mark_.clear();
+			vertex_stamp_.clear();
+			vertex_local_.clear();
+			incident_.clear();
+			cavity_.clear();
+			created_.clear();
+			infinite_stamp_ = 0;
+			stamp_ = 0;
+			hint_ = none;
+		}
+
+		/**
+		* @brief Reserve storage
+		* @param points: Expected number of points
+		*/
+		void reserve(size_t points)
+		{
+			size_t cells = D == 2 ? 2 * points + 16 : 7 * points + 64;
+			cells_.reserve(cells * S);
+			alive_.reserve(cells);
+			mark_.reserve(cells);
+			free_.reserve(cells);
+			vertex_stamp_.reserve(points);
+			vertex_local_.reserve(points);
+			incident_.reserve(points);
+		}
+
+		/**
+		* @brief Start triangulation with single simplex
+		* @param v: D + 1 affinely independent points
+		*/
+		void init(const index_type* v)
+		{
+			clear();
+			index_type c = allocate();
+			std::copy(v, v + V, vtx(c));
+			const double* x[V];
+			for (size_t l = 0; l < V; ++l)
+			{
+				x[l] = point(v[l]);
+			}
+			if (orientation(x) < 0.0)
+			{
+				std::swap(vtx(c)[0], vtx(c)[1]);
+			}
+			for (size_t k = 0; k < V; ++k)
+			{
+				index_type g = allocate();
+				index_type* gv = vtx(g);
+				std::copy(vtx(c), vtx(c) + V, gv);
+				gv[k] = infinite;
+				std::swap(gv[(k + 1) % V], gv[(k + 2) % V]);
+			}
+			linkAll();
+			growVertices(*std::max_element(v, v + V));
+			for (size_t k = 0; k < V; ++k)
+			{
+				incident_[v[k]] = c;
+			}
+			hint_ = c;
+		}
+
+		/// @brief Position of infinite vertex in cell, -1 for finite cell
+		int ghostPosition(index_type c) const
+		{
+			const index_type* v = vtx(c);
+			for (size_t k = 0; k < V; ++k)
+			{
+				if (v[k] == infinite)
+				{
+					return static_cast<int>(k);
+				}
+			}
+			return -1;
+		}
+
+		/**
+		* @brief Locate point by visibility walk
+		* @param p: Point
+		* @param hint: Start cell (none for the last created cell)
+		* @return Finite cell, containing point, or ghost cell, which hull facet is visible from point
+		*/
+		index_type locate(index_type p, index_type hint = none)
+		{
+			index_type c = hint != none && hint < alive_.size() && alive_[hint] ? hint : hint_;
+			if (c == none || !alive_[c])
+			{
+				c = 0;
+				while (!alive_[c] || ghostPosition(c) >= 0)
+				{
+					++c;
+				}
+			}
+			int j = ghostPosition(c);
+			if (j >= 0)
+			{
+				c = nbr(c)[j];
+			}
+
+			index_type prev = none;
+			while (true)
+			{
+				size_t start = random() % V;
+				size_t k = 0;
+				for (; k < V; ++k)
+				{
+					size_t i = start + k < V ? start + k : start + k - V;
+					index_type n = nbr(c)[i];
+					if (n == prev)
+					{
+						continue;
+					}
+					if (orient(c, i, p) < 0.0)
+					{
+						if (ghostPosition(n) >= 0)
+						{
+							return n;
+						}
+						prev = c;
+						c = n;
+						break;
+					}
+				}
+				if (k == V)
+				{
+					return c;
+				}
+			}
+		}
+
+		/**
+		* @brief Insert point
+		* @param p: Point
+		* @param hint: Start cell of point location (none for the last created cell)
+		* @return p, if point is inserted, or index of existing vertex with the same coordinates
+		*/
+		index_type insert(index_type p, index_type hint = none)
+		{
+			cavity_.clear();
+			created_.clear();
+			index_type c = locate(p, hint);
+			if (ghostPosition(c) < 0)
+			{
+				const index_type* v = vtx(c);
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (std::equal(point(p), point(p) + D, point(v[k])))
+					{
+						return v[k];
+					}
+				}
+			}
+			growVertices(p);
+
+			// conflict region
+			newStamp();
+			boundary_.clear();
+			cavity_.push_back(c);
+			mark_[c] = stamp_;
+			for (size_t i = 0; i < cavity_.size(); ++i)
+			{
+				index_type s = cavity_[i];
+				for (size_t k = 0; k < V; ++k)
+				{
+					index_type o = nbr(s)[k];
+					if (mark_[o] == stamp_)
+					{
+						continue;
+					}
+					if (mark_[o] != stamp_ + 1 && conflict(o, p))
+					{
+						mark_[o] = stamp_;
+						cavity_.push_back(o);
+						continue;
+					}
+					mark_[o] = stamp_ + 1;
+					boundary_.emplace_back(s, static_cast<index_type>(k));
+				}
+			}
+
+			// cells of boundary facets and the point
+			reserveCells(boundary_.size());
+			uint32_t locals = 0;
+			for (const auto& [s, k] : boundary_)
+			{
+				index_type n = allocate();
+				created_.push_back(n);
+				index_type* nv = vtx(n);
+				index_type* na = nbr(n);
+				const index_type* sv = vtx(s);
+				std::copy(sv, sv + V, nv);
+				nv[k] = p;
+				for (size_t l = 0; l < V; ++l)
+				{
+					if (l != k)
+					{
+						local(nv[l], locals);
+						if (nv[l] != infinite)
+						{
+							incident_[nv[l]] = n;
+						}
+					}
+				}
+
+				index_type o = nbr(s)[k];
+				na[k] = o;
+				index_type* oa = nbr(o);
+				for (size_t l = 0; l < V; ++l)
+				{
+					if (oa[l] == s)
+					{
+						oa[l] = n;
+						break;
+					}
+				}
+				if (nv[0] != infinite && nv[1] != infinite && nv[2] != infinite && (D == 2 || nv[D] != infinite))
+				{
+					hint_ = n;
+				}
+			}
+
+			// facets through the point are shared by pairs of new cells with the same D - 1 other vertices
+			constexpr uint64_t empty = std::numeric_limits<uint64_t>::max();
+			size_t table = D == 2 ? locals : static_cast<size_t>(locals) * locals;
+			if (ridges_.size() < table)
+			{
+				ridges_.resize(table, empty);
+			}
+			size_t open = 0;
+			for (size_t i = 0; i < created_.size(); ++i)
+			{
+				index_type n = created_[i];
+				size_t k = boundary_[i].second;
+				const index_type* nv = vtx(n);
+				for (size_t l = 0; l < V; ++l)
+				{
+					if (l == k)
+					{
+						continue;
+					}
+					size_t key;
+					if constexpr (D == 2)
+					{
+						key = localOf(nv[3 - k - l]);
+					}
+					else
+					{
+						size_t q[2];
+						size_t m = 0;
+						for (size_t r = 0; r < V; ++r)
+						{
+							if (r != k && r != l)
+							{
+								q[m++] = localOf(nv[r]);
+							}
+						}
+						key = q[0] < q[1] ? q[0] * locals + q[1] : q[1] * locals + q[0];
+					}
+					uint64_t& r = ridges_[key];
+					if (r == empty)
+					{
+						r = static_cast<uint64_t>(n) * V + l;
+						++open;
+						continue;
+					}
+					index_type m = static_cast<index_type>(r / V);
+					nbr(n)[l] = m;
+					nbr(m)[r % V] = n;
+					r = empty;
+					--open;
+				}
+			}
+			if (open != 0)
+			{
+				std::fill(ridges_.begin(), ridges_.begin() + table, empty);
+				throw(ExceptionInvalidValue("BowyerWatson: Cavity of point " + std::to_string(p) + " isn't star-shaped!"));
+			}
+
+			for (index_type s : cavity_)
+			{
+				release(s);
+			}
+			incident_[p] = created_.front();
+			return p;
+		}
+
+		/**
+		* @brief Check if triangulation stays Delaunay after vertex is moved
+		* @details Coordinates of vertex must be already changed. Cells of vertex star must stay
+		* positively oriented, and all facets of the star must stay locally Delaunay, which is
+		* enough for the whole triangulation (Delaunay lemma). Vertices on convex hull aren't checked.
+		* @param v: Vertex in triangulation
+		* @return True if triangulation is valid and Delaunay
+		*/
+		bool starDelaunay(index_type v)
+		{
+			star(v);
+			for (index_type s : cavity_)
+			{
+				if (ghostPosition(s) >= 0)
+				{
+					return false;
+				}
+			}
+			for (index_type s : cavity_)
+			{
+				const index_type* sv = vtx(s);
+				if (orient(s, 0, sv[0]) <= 0.0)
+				{
+					return false;
+				}
+				for (size_t k = 0; k < V; ++k)
+				{
+					index_type o = nbr(s)[k];
+					if (sv[k] == v)
+					{
+						// link facet: v mustn't be in conflict with outer cell
+						if (conflict(o, v))
+						{
+							return false;
+						}
+						continue;
+					}
+					// facet through v: vertex of neighbour behind it mustn't be inside circumsphere
+					const index_type* ov = vtx(o);
+					for (size_t l = 0; l < V; ++l)
+					{
+						if (nbr(o)[l] == s)
+						{
+							if (inSphere(s, ov[l]) > 0.0)
+							{
+								return false;
+							}
+							break;
+						}
+					}
+				}
+			}
+			return true;
+		}
+
+		/**
+		* @brief Remove vertex
+		* @details Star of vertex is replaced by cells of Delaunay triangulation of its link
+		* vertices, which lie inside the star (O. Devillers, "On deletion in Delaunay
+		* triangulations", 2002). Cost is proportional to the star size. Triangulation isn't
+		* changed if link is degenerate (link vertices lie in hyperplane, or boundary facets of
+		* the star aren't in Delaunay triangulation of link).
+		* @param v: Vertex in triangulation
+		* @return False if vertex can't be removed locally
+		*/
+		bool remove(index_type v)
+		{
+			star(v);
+
+			// link vertices with local numbers, the infinite vertex has number link_.size()
+			newStamp();
+			link_.clear();
+			for (index_type s : cavity_)
+			{
+				const index_type* sv = vtx(s);
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (sv[k] != v && sv[k] != infinite && vertex_stamp_[sv[k]] != stamp_)
+					{
+						vertex_stamp_[sv[k]] = stamp_;
+						vertex_local_[sv[k]] = static_cast<uint32_t>(link_.size());
+						link_.push_back(sv[k]);
+					}
+				}
+			}
+			size_t m = link_.size();
+			link_coords_.resize(m * D);
+			for (size_t i = 0; i < m; ++i)
+			{
+				std::copy(point(link_[i]), point(link_[i]) + D, link_coords_.data() + i * D);
+			}
+			index_type first[V];
+			if (!initialSimplex<D>(link_coords_.data(), m, first))
+			{
+				return false;
+			}
+			if (!link_dt_)
+			{
+				link_dt_ = std::make_unique<BowyerWatson>();
+			}
+			BowyerWatson& dt = *link_dt_;
+			dt.setCoordinates(link_coords_.data());
+			dt.init(first);
+			for (index_type i = 0; i < m; ++i)
+			{
+				if (std::find(first, first + V, i) == first + V)
+				{
+					dt.insert(i);
+				}
+			}
+
+			// facets of link triangulation by sorted local vertices
+			auto key = [m](const index_type* f)
+			{
+				uint64_t q[D];
+				for (size_t l = 0; l < D; ++l)
+				{
+					q[l] = f[l] == infinite ? m : f[l];
+				}
+				std::sort(q, q + D);
+				uint64_t k = 0;
+				for (size_t l = 0; l < D; ++l)
+				{
+					k = k * (m + 1) + q[l];
+				}
+				return k;
+			};
+			link_facets_.clear();
+			index_type f[D];
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (!dt.alive(c))
+				{
+					continue;
+				}
+				for (size_t k = 0; k < V; ++k)
+				{
+					for (size_t l = 0, i = 0; l < V; ++l)
+					{
+						if (l != k)
+						{
+							f[i++] = dt.vertices(c)[l];
+						}
+					}
+					link_facets_.emplace_back(key(f), static_cast<uint64_t>(c) * V + k);
+				}
+			}
+			std::sort(link_facets_.begin(), link_facets_.end());
+
+			// boundary facets of the star in link triangulation: both sides are marked by boundary index
+			std::vector<index_type> side(dt.capacity() * V, none);
+			index_type seed = none;
+			for (size_t b = 0; b < boundary_.size(); ++b)
+			{
+				auto [s, k] = boundary_[b];
+				const index_type* sv = vtx(s);
+				for (size_t l = 0, i = 0; l < V; ++l)
+				{
+					if (l != k)
+					{
+						f[i++] = sv[l] == infinite ? infinite : vertex_local_[sv[l]];
+					}
+				}
+				auto it = std::lower_bound(link_facets_.begin(), link_facets_.end(), std::make_pair(key(f), uint64_t(0)));
+				if (link_facets_.end() - it < 2 || it[0].first != key(f) || it[1].first != key(f))
+				{
+					return false;
+				}
+				for (size_t i = 0; i < 2; ++i)
+				{
+					side[it[i].second] = static_cast<index_type>(b);
+				}
+
+				// cell of link triangulation on the side of v: positive with v replaced by its opposite vertex
+				if (seed == none && ghostPosition(s) < 0)
+				{
+					for (size_t i = 0; i < 2 && seed == none; ++i)
+					{
+						index_type c = static_cast<index_type>(it[i].second / V);
+						index_type w = dt.vertices(c)[it[i].second % V];
+						if (w != infinite && orient(s, k, link_[w]) > 0.0)
+						{
+							seed = c;
+						}
+					}
+					// otherwise v is on the side of ghost cell
+					for (size_t i = 0; i < 2 && seed == none; ++i)
+					{
+						index_type c = static_cast<index_type>(it[i].second / V);
+						if (dt.vertices(c)[it[i].second % V] == infinite)
+						{
+							seed = c;
+						}
+					}
+					if (seed == none)
+					{
+						return false;
+					}
+				}
+			}
+			if (seed == none)
+			{
+				return false;
+			}
+
+			// cells of link triangulation inside the star
+			std::vector<index_type> inside(dt.capacity(), none);
+			std::vector<index_type> fill{ seed };
+			inside[seed] = 0;
+			for (size_t i = 0; i < fill.size(); ++i)
+			{
+				for (size_t k = 0; k < V; ++k)
+				{
+					index_type o = dt.neighbours(fill[i])[k];
+					if (side[static_cast<size_t>(fill[i]) * V + k] == none && inside[o] == none)
+					{
+						inside[o] = static_cast<index_type>(fill.size());
+						fill.push_back(o);
+					}
+				}
+			}
+			std::vector<char> attached(boundary_.size(), 0);
+			for (index_type c : fill)
+			{
+				for (size_t k = 0; k < V; ++k)
+				{
+					index_type b = side[static_cast<size_t>(c) * V + k];
+					if (b != none)
+					{
+						if (attached[b])
+						{
+							return false;
+						}
+						attached[b] = 1;
+					}
+				}
+			}
+			if (std::find(attached.begin(), attached.end(), 0) != attached.end())
+			{
+				return false;
+			}
+
+			// replace the star
+			reserveCells(fill.size());
+			created_.clear();
+			for (index_type c : fill)
+			{
+				index_type n = allocate();
+				created_.push_back(n);
+				const index_type* cv = dt.vertices(c);
+				index_type* nv = vtx(n);
+				for (size_t k = 0; k < V; ++k)
+				{
+					nv[k] = cv[k] == infinite ? infinite : link_[cv[k]];
+				}
+			}
+			for (size_t i = 0; i < fill.size(); ++i)
+			{
+				index_type n = created_[i];
+				for (size_t k = 0; k < V; ++k)
+				{
+					index_type b = side[static_cast<size_t>(fill[i]) * V + k];
+					if (b == none)
+					{
+						nbr(n)[k] = created_[inside[dt.neighbours(fill[i])[k]]];
+						continue;
+					}
+					auto [s, j] = boundary_[b];
+					index_type o = nbr(s)[j];
+					nbr(n)[k] = o;
+					index_type* oa = nbr(o);
+					for (size_t l = 0; l < V; ++l)
+					{
+						if (oa[l] == s)
+						{
+							oa[l] = n;
+							break;
+						}
+					}
+				}
+				const index_type* nv = vtx(n);
+				bool finite = true;
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (nv[k] != infinite)
+					{
+						incident_[nv[k]] = n;
+					}
+					else
+					{
+						finite = false;
+					}
+				}
+				if (finite)
+				{
+					hint_ = n;
+				}
+			}
+			for (index_type s : cavity_)
+			{
+				release(s);
+			}
+			if (!alive_[hint_])
+			{
+				hint_ = none;
+			}
+			incident_[v] = none;
+			return true;
+		}
+
+		/// @brief Cell, incident to vertex, or none if vertex isn't in triangulation
+		index_type incident(index_type v) const
+		{
+			return v < incident_.size() ? incident_[v] : none;
+		}
+
+		/// @brief Cells, created by the last insert or remove
+		const std::vector<index_type>& created() const
+		{
+			return created_;
+		}
+
+		/// @brief Cells, removed by the last insert or remove
+		const std::vector<index_type>& removed() const
+		{
+			return cavity_;
+		}
+
+		/// @brief Number of cell slots (alive and removed)
+		size_t capacity() const
+		{
+			return alive_.size();
+		}
+
+		bool alive(index_type c) const
+		{
+			return alive_[c] != 0;
+		}
+
+		/// @brief Vertices of cell
+		const index_type* vertices(index_type c) const
+		{
+			return vtx(c);
+		}
+
+		/// @brief Neighbours of cell, neighbour k is opposite to vertex k
+		const index_type* neighbours(index_type c) const
+		{
+			return nbr(c);
+		}
+	};
+}
+
+
+namespace math
+{
+	/**
+	* @brief Incremental Delaunay triangulator
+	* @details Points are inserted one by one in biased randomized order along Hilbert curve
+	* (see brioOrder) by Bowyer-Watson algorithm (see detail::BowyerWatson) with visibility walk
+	* point location, so expected cost is O(N log N) and the walk from the previous point is short.
+	* Orientation and in-sphere tests are exact, so triangulation is valid for degenerate inputs
+	* (cocircular, cospherical and collinear points). Ties of cocircular (cospherical) points are
+	* broken by symbolic perturbation (see predicates::incirclePerturbed), so the set of simplices
+	* doesn't depend on insertion order. Of duplicate points the copy with the lowest index is
+	* kept, the others aren't vertices of triangulation.
+	*
+	* Coordinates are converted to double for predicates.
+	*/
+	template <typename T>
+	class IterativeTriangulator :
+		public Triangulator<T>
+	{
+	public:
+		using index_type = typename Triangulator<T>::index_type;
+
+	protected:
+		/// @brief Seed of insertion order
+		unsigned seed_ = 0;
+
+		IterativeTriangulator(const std::string& method) : Triangulator<T>(method) {};
+
+		IterativeTriangulator(const std::string& method, const Matrix<T>& points) : Triangulator<T>(method, points) {};
+
+		/// @brief Serial triangulation of all points
+		template <size_t D>
+		void run()
+		{
+			constexpr size_t V = D + 1;
+			const std::vector<T>& points = Triangulator<T>::points_;
+			size_t n = Triangulator<T>::size();
+
+			// coordinates are copied in insertion order, so vertices of neighbouring cells are close in memory
+			std::vector<index_type> order;
+			brioOrder(points.data(), n, D, order, seed_);
+			std::vector<double> x(n * D);
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t k = 0; k < D; ++k)
+				{
+					x[i * D + k] = static_cast<double>(points[static_cast<size_t>(order[i]) * D + k]);
+				}
+			}
+
+			index_type first[V];
+			if (!detail::initialSimplex<D>(x.data(), n, first))
+			{
+				throw(ExceptionInvalidValue("IterativeTriangulator<T>::triangulate: Points are degenerate (lie in hyperplane)!"));
+			}
+
+			// duplicate point is replaced by the vertex of its copy, which keeps the lowest index
+			detail::BowyerWatson<D> dt;
+			dt.setCoordinates(x.data());
+			dt.init(first);
+			for (index_type i = 0; i < n; ++i)
+			{
+				if (std::find(first, first + V, i) == first + V)
+				{
+					index_type v = dt.insert(i);
+					order[v] = std::min(order[v], order[i]);
+				}
+			}
+
+			// finite cells to output
+			std::vector<index_type> id(dt.capacity(), Triangulator<T>::no_neighbour);
+			index_type count = 0;
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (dt.alive(c) && dt.ghostPosition(c) < 0)
+				{
+					id[c] = count++;
+				}
+			}
+			std::vector<index_type>& simplices = Triangulator<T>::simplices_;
+			std::vector<index_type>& neighbours = Triangulator<T>::neighbours_;
+			simplices.resize(static_cast<size_t>(count) * V);
+			neighbours.resize(static_cast<size_t>(count) * V);
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (id[c] == Triangulator<T>::no_neighbour)
+				{
+					continue;
+				}
+				const index_type* v = dt.vertices(c);
+				const index_type* a = dt.neighbours(c);
+				for (size_t k = 0; k < V; ++k)
+				{
+					simplices[static_cast<size_t>(id[c]) * V + k] = order[v[k]];
+					neighbours[static_cast<size_t>(id[c]) * V + k] = id[a[k]];
+				}
+			}
+		}
+
+	public:
+		IterativeTriangulator() : Triangulator<T>("Iterative") {};
+
+		/**
+		* @brief IterativeTriangulator constructor
+		* @param points: Points, one per row (2 or 3 columns)
+		*/
+		IterativeTriangulator(const Matrix<T>& points) : Triangulator<T>("Iterative", points) {};
+
+		virtual ~IterativeTriangulator() {};
+
+		/**
+		* @brief Set seed of randomized insertion order
+		* @details Set of simplices doesn't depend on seed, seed changes only their order
+		*/
+		void setSeed(unsigned seed)
+		{
+			seed_ = seed;
+		}
+
+		/**
+		* @brief Build Delaunay triangulation
+		* @throws math::ExceptionInvalidValue if points lie in hyperplane (all collinear in 2D,
+		* all coplanar in 3D)
+		*/
+		virtual void triangulate() override
+		{
+			Triangulator<T>::clear();
+			if (Triangulator<T>::dim_ == 2)
+			{
+				run<2>();
+			}
+			else if (Triangulator<T>::dim_ == 3)
+			{
+				run<3>();
+			}
+			else
+			{
+				throw(ExceptionInvalidValue("IterativeTriangulator<T>::triangulate: Points aren't set!"));
+			}
+		}
+	};
+}
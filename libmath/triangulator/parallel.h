@@ -0,0 +1,633 @@
+#pragma once
+#include <libmath/triangulator/iterative.h>
+#include <libmath/geometry/predicates.h>
+#include <libmath/geometry/spatial_sort.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+
+#ifdef MATH_OMP_DEFINE
+#include <omp.h>
+#endif
+
+namespace math::detail
+{
+	/**
+	* @brief Check if circumball of simplex lies strictly inside box
+	* @details Circumcenter is computed in floating point, so the test is conservative: flat
+	* simplices and balls near box faces are reported as not inside
+	* @param x: D + 1 vertices of simplex
+	* @param lo, hi: Box bounds, may be infinite
+	*/
+	template <size_t D>
+	bool ballInside(const double* const* x, const double* lo, const double* hi)
+	{
+		double e[D][D];
+		double b[D];
+		double len2 = 0.0;
+		for (size_t i = 0; i < D; ++i)
+		{
+			b[i] = 0.0;
+			for (size_t k = 0; k < D; ++k)
+			{
+				e[i][k] = x[i + 1][k] - x[0][k];
+				b[i] += e[i][k] * e[i][k];
+			}
+			b[i] *= 0.5;
+			len2 = std::max(len2, 2.0 * b[i]);
+		}
+
+		// center relative to x[0]: e c = b
+		double c[D];
+		double det;
+		if constexpr (D == 2)
+		{
+			det = e[0][0] * e[1][1] - e[0][1] * e[1][0];
+			c[0] = (b[0] * e[1][1] - b[1] * e[0][1]) / det;
+			c[1] = (e[0][0] * b[1] - e[1][0] * b[0]) / det;
+		}
+		else
+		{
+			double n[3][3];
+			for (size_t i = 0; i < 3; ++i)
+			{
+				const double* u = e[(i + 1) % 3];
+				const double* v = e[(i + 2) % 3];
+				n[i][0] = u[1] * v[2] - u[2] * v[1];
+				n[i][1] = u[2] * v[0] - u[0] * v[2];
+				n[i][2] = u[0] * v[1] - u[1] * v[0];
+			}
+			det = e[0][0] * n[0][0] + e[0][1] * n[0][1] + e[0][2] * n[0][2];
+			for (size_t k = 0; k < 3; ++k)
+			{
+				c[k] = (b[0] * n[0][k] + b[1] * n[1][k] + b[2] * n[2][k]) / det;
+			}
+		}
+		double len = std::sqrt(len2);
+		if (!(std::abs(det) > 1.e-4 * std::pow(len, static_cast<double>(D))))
+		{
+			return false;
+		}
+
+		double r2 = 0.0;
+		for (size_t k = 0; k < D; ++k)
+		{
+			r2 += c[k] * c[k];
+		}
+		double r = std::sqrt(r2);
+		double margin = r + 1.e-8 * (r + len);
+		for (size_t k = 0; k < D; ++k)
+		{
+			double center = x[0][k] + c[k];
+			if (!(center - margin > lo[k] && center + margin < hi[k]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+namespace math
+{
+	/**
+	* @brief Parallel Delaunay triangulator
+	* @details Points are split by k-d tree at medians into parts, which are triangulated
+	* concurrently (see IterativeTriangulator). Simplex of a part is final if its circumball lies
+	* strictly inside the part cell: no point of other parts can be inside the ball, so the
+	* simplex is Delaunay for all points. Vertices of other simplices form the seam, which is
+	* triangulated serially. Seam simplices, which fill the region not covered by final simplices,
+	* are found by flood fill through the seam triangulation, bounded by facets of final simplices.
+	*
+	* Set of simplices is the same as of serial triangulation for any number of parts (order of
+	* simplices differs): parts, the seam and serial triangulation break ties of cocircular
+	* (cospherical) points by the same symbolic perturbation (see predicates::incirclePerturbed),
+	* which makes Delaunay triangulation unique. Duplicate points on part boundaries are vertices
+	* of the seam only, so the copy with the lowest index is kept as in serial triangulation.
+	* Triangulation falls back to serial only if a part or the seam is degenerate (e.g. all its
+	* points lie in hyperplane).
+	*/
+	template <typename T>
+	class ParallelTriangulator :
+		public IterativeTriangulator<T>
+	{
+	public:
+		using index_type = typename Triangulator<T>::index_type;
+
+	private:
+		static constexpr index_type none = Triangulator<T>::no_neighbour;
+
+		/// @brief Minimal number of points per part for automatic number of parts
+		static constexpr size_t min_part = 16384;
+
+		/// @brief Number of parts, 0 for number of threads
+		size_t parts_ = 0;
+
+		template <size_t D>
+		struct Part
+		{
+			std::vector<index_type> points;
+			std::array<double, D> lo;
+			std::array<double, D> hi;
+
+			/// @brief Final simplices (global point indices) and neighbours (final simplices of part)
+			std::vector<index_type> simplices;
+			std::vector<index_type> neighbours;
+
+			bool degenerate = false;
+		};
+
+		/// @brief Facet as sorted point indices
+		template <size_t D>
+		using Facet = std::array<index_type, D>;
+
+		template <size_t D>
+		static Facet<D> facet(const index_type* v, size_t k)
+		{
+			Facet<D> f;
+			for (size_t l = 0, i = 0; l < D + 1; ++l)
+			{
+				if (l != k)
+				{
+					f[i++] = v[l];
+				}
+			}
+			std::sort(f.begin(), f.end());
+			return f;
+		}
+
+		/// @brief Number of parts (power of 2) for n points
+		size_t partCount(size_t n, size_t dim) const
+		{
+			size_t wanted = parts_;
+			size_t min_points = 16 * (dim + 1);
+			if (wanted == 0)
+			{
+				wanted = 1;
+#ifdef MATH_OMP_DEFINE
+				wanted = static_cast<size_t>(omp_get_max_threads());
+#endif
+				min_points = min_part;
+			}
+			size_t parts = 1;
+			while (parts < wanted)
+			{
+				parts *= 2;
+			}
+			while (parts > 1 && n / parts < min_points)
+			{
+				parts /= 2;
+			}
+			return parts;
+		}
+
+		/// @brief Split points at medians along the longest side of their bounding box
+		template <size_t D>
+		static void split(const std::vector<double>& x, std::vector<Part<D>>& parts, size_t count)
+		{
+			while (parts.size() < count)
+			{
+				std::vector<Part<D>> next;
+				for (Part<D>& part : parts)
+				{
+					std::vector<index_type>& p = part.points;
+					std::array<double, D> bmin, bmax;
+					bmin.fill(std::numeric_limits<double>::infinity());
+					bmax.fill(-std::numeric_limits<double>::infinity());
+					for (index_type i : p)
+					{
+						for (size_t k = 0; k < D; ++k)
+						{
+							bmin[k] = std::min(bmin[k], x[static_cast<size_t>(i) * D + k]);
+							bmax[k] = std::max(bmax[k], x[static_cast<size_t>(i) * D + k]);
+						}
+					}
+					size_t axis = 0;
+					for (size_t k = 1; k < D; ++k)
+					{
+						if (bmax[k] - bmin[k] > bmax[axis] - bmin[axis])
+						{
+							axis = k;
+						}
+					}
+					auto middle = p.begin() + static_cast<std::ptrdiff_t>(p.size() / 2);
+					std::nth_element(p.begin(), middle, p.end(), [&x, axis](index_type a, index_type b)
+						{
+							double xa = x[static_cast<size_t>(a) * D + axis];
+							double xb = x[static_cast<size_t>(b) * D + axis];
+							return xa < xb || (xa == xb && a < b);
+						});
+					double value = x[static_cast<size_t>(*middle) * D + axis];
+
+					Part<D> left, right;
+					left.points.assign(p.begin(), middle);
+					right.points.assign(middle, p.end());
+					left.lo = right.lo = part.lo;
+					left.hi = right.hi = part.hi;
+					left.hi[axis] = value;
+					right.lo[axis] = value;
+					next.push_back(std::move(left));
+					next.push_back(std::move(right));
+				}
+				parts.swap(next);
+			}
+		}
+
+		/// @brief Triangulate part, keep final simplices and mark vertices of the others as seam
+		template <size_t D>
+		static void triangulatePart(const std::vector<double>& x, Part<D>& part, unsigned seed, std::vector<char>& seam)
+		{
+			constexpr size_t V = D + 1;
+			size_t m = part.points.size();
+			std::vector<double> local(m * D);
+			for (size_t i = 0; i < m; ++i)
+			{
+				std::copy(x.begin() + static_cast<size_t>(part.points[i]) * D, x.begin() + static_cast<size_t>(part.points[i] + 1) * D,
+					local.begin() + i * D);
+			}
+			std::vector<index_type> order;
+			brioOrder(local.data(), m, D, order, seed);
+			std::vector<index_type> global(m);
+			std::vector<double> ordered(m * D);
+			for (size_t i = 0; i < m; ++i)
+			{
+				global[i] = part.points[order[i]];
+				std::copy(local.begin() + static_cast<size_t>(order[i]) * D, local.begin() + static_cast<size_t>(order[i] + 1) * D,
+					ordered.begin() + i * D);
+			}
+
+			index_type first[V];
+			if (!detail::initialSimplex<D>(ordered.data(), m, first))
+			{
+				part.degenerate = true;
+				return;
+			}
+			detail::BowyerWatson<D> dt;
+			dt.setCoordinates(ordered.data());
+			dt.reserve(m);
+			dt.init(first);
+			for (index_type i = 0; i < m; ++i)
+			{
+				if (std::find(first, first + V, i) == first + V)
+				{
+					index_type v = dt.insert(i);
+					global[v] = std::min(global[v], global[i]);
+				}
+			}
+
+			std::vector<index_type> id(dt.capacity(), none);
+			index_type count = 0;
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (!dt.alive(c))
+				{
+					continue;
+				}
+				const index_type* v = dt.vertices(c);
+				bool final = false;
+				if (dt.ghostPosition(c) < 0)
+				{
+					const double* p[V];
+					for (size_t k = 0; k < V; ++k)
+					{
+						p[k] = ordered.data() + static_cast<size_t>(v[k]) * D;
+					}
+					final = detail::ballInside<D>(p, part.lo.data(), part.hi.data());
+				}
+				if (final)
+				{
+					id[c] = count++;
+					continue;
+				}
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (v[k] != detail::BowyerWatson<D>::infinite)
+					{
+						seam[global[v[k]]] = 1;
+					}
+				}
+			}
+
+			part.simplices.resize(static_cast<size_t>(count) * V);
+			part.neighbours.resize(static_cast<size_t>(count) * V);
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (id[c] == none)
+				{
+					continue;
+				}
+				const index_type* v = dt.vertices(c);
+				const index_type* a = dt.neighbours(c);
+				for (size_t k = 0; k < V; ++k)
+				{
+					part.simplices[static_cast<size_t>(id[c]) * V + k] = global[v[k]];
+					part.neighbours[static_cast<size_t>(id[c]) * V + k] = id[a[k]];
+				}
+			}
+		}
+
+		/**
+		* @brief Triangulate parts concurrently and merge them through the seam
+		* @return False if parts or seam are degenerate, triangulation must be built serially
+		*/
+		template <size_t D>
+		bool runParallel(size_t count)
+		{
+			constexpr size_t V = D + 1;
+			const std::vector<T>& points = Triangulator<T>::points_;
+			size_t n = Triangulator<T>::size();
+			std::vector<double> x(points.begin(), points.end());
+
+			std::vector<Part<D>> parts(1);
+			parts[0].points.resize(n);
+			for (size_t i = 0; i < n; ++i)
+			{
+				parts[0].points[i] = static_cast<index_type>(i);
+			}
+			parts[0].lo.fill(-std::numeric_limits<double>::infinity());
+			parts[0].hi.fill(std::numeric_limits<double>::infinity());
+			split<D>(x, parts, count);
+
+			std::vector<char> seam(n, 0);
+			long long parts_num = static_cast<long long>(parts.size());
+#ifdef MATH_OMP_DEFINE
+#pragma omp parallel for schedule(dynamic)
+#endif
+			for (long long i = 0; i < parts_num; ++i)
+			{
+				triangulatePart<D>(x, parts[i], IterativeTriangulator<T>::seed_ + static_cast<unsigned>(i), seam);
+			}
+			for (const Part<D>& part : parts)
+			{
+				if (part.degenerate)
+				{
+					return false;
+				}
+			}
+
+			// final simplices to output, facets without final neighbour are interface to seam
+			std::vector<index_type>& simplices = Triangulator<T>::simplices_;
+			std::vector<index_type>& neighbours = Triangulator<T>::neighbours_;
+			for (const Part<D>& part : parts)
+			{
+				index_type offset = static_cast<index_type>(simplices.size() / V);
+				simplices.insert(simplices.end(), part.simplices.begin(), part.simplices.end());
+				for (index_type a : part.neighbours)
+				{
+					neighbours.push_back(a == none ? none : a + offset);
+				}
+			}
+			size_t final_count = simplices.size() / V;
+			std::vector<std::pair<Facet<D>, uint64_t>> interface;
+			for (size_t s = 0; s < final_count; ++s)
+			{
+				for (size_t k = 0; k < V; ++k)
+				{
+					if (neighbours[s * V + k] == none)
+					{
+						interface.emplace_back(facet<D>(simplices.data() + s * V, k), s * V + k);
+					}
+				}
+			}
+			std::sort(interface.begin(), interface.end());
+
+			// seam triangulation
+			std::vector<index_type> seam_points;
+			for (size_t i = 0; i < n; ++i)
+			{
+				if (seam[i])
+				{
+					seam_points.push_back(static_cast<index_type>(i));
+				}
+			}
+			size_t m = seam_points.size();
+			std::vector<double> local(m * D);
+			for (size_t i = 0; i < m; ++i)
+			{
+				std::copy(x.begin() + static_cast<size_t>(seam_points[i]) * D, x.begin() + static_cast<size_t>(seam_points[i] + 1) * D,
+					local.begin() + i * D);
+			}
+			std::vector<index_type> order;
+			brioOrder(local.data(), m, D, order, IterativeTriangulator<T>::seed_);
+			std::vector<index_type> global(m);
+			std::vector<double> ordered(m * D);
+			for (size_t i = 0; i < m; ++i)
+			{
+				global[i] = seam_points[order[i]];
+				std::copy(local.begin() + static_cast<size_t>(order[i]) * D, local.begin() + static_cast<size_t>(order[i] + 1) * D,
+					ordered.begin() + i * D);
+			}
+			index_type first[V];
+			if (!detail::initialSimplex<D>(ordered.data(), m, first))
+			{
+				return false;
+			}
+			detail::BowyerWatson<D> dt;
+			dt.setCoordinates(ordered.data());
+			dt.reserve(m);
+			dt.init(first);
+			for (index_type i = 0; i < m; ++i)
+			{
+				if (std::find(first, first + V, i) == first + V)
+				{
+					index_type v = dt.insert(i);
+					global[v] = std::min(global[v], global[i]);
+				}
+			}
+
+			// components of seam cells, separated by interface facets
+			constexpr uint64_t unmatched = std::numeric_limits<uint64_t>::max();
+			std::vector<uint64_t> matched(dt.capacity() * V, unmatched);
+			std::vector<index_type> id(dt.capacity(), none);
+			std::vector<char> visited(dt.capacity(), 0);
+			std::vector<char> found(interface.size(), 0);
+			std::vector<char> hull(interface.size(), 0);
+			std::vector<index_type> component;
+			index_type seam_count = 0;
+			for (index_type c0 = 0; c0 < dt.capacity(); ++c0)
+			{
+				if (!dt.alive(c0) || dt.ghostPosition(c0) >= 0 || visited[c0])
+				{
+					continue;
+				}
+				component.assign(1, c0);
+				visited[c0] = 1;
+				int inside = -1;
+				for (size_t i = 0; i < component.size(); ++i)
+				{
+					index_type c = component[i];
+					index_type v[V];
+					for (size_t k = 0; k < V; ++k)
+					{
+						v[k] = global[dt.vertices(c)[k]];
+					}
+					for (size_t k = 0; k < V; ++k)
+					{
+						index_type o = dt.neighbours(c)[k];
+						Facet<D> f = facet<D>(v, k);
+						auto it = std::lower_bound(interface.begin(), interface.end(), std::make_pair(f, uint64_t(0)));
+						if (it == interface.end() || it->first != f)
+						{
+							if (dt.ghostPosition(o) < 0 && !visited[o])
+							{
+								visited[o] = 1;
+								component.push_back(o);
+							}
+							continue;
+						}
+						size_t e = static_cast<size_t>(it - interface.begin());
+						found[e] = 1;
+						hull[e] = dt.ghostPosition(o) >= 0;
+						matched[static_cast<size_t>(c) * V + k] = it->second;
+
+						// cell is outside of final simplex if its vertex is on the other side of facet
+						size_t s = static_cast<size_t>(it->second / V);
+						size_t j = static_cast<size_t>(it->second % V);
+						const double* p[V];
+						for (size_t l = 0; l < V; ++l)
+						{
+							p[l] = x.data() + static_cast<size_t>(l == j ? v[k] : simplices[s * V + l]) * D;
+						}
+						double side;
+						if constexpr (D == 2)
+						{
+							side = predicates::orient2d(p[0], p[1], p[2]);
+						}
+						else
+						{
+							side = predicates::orient3d(p[0], p[1], p[2], p[3]);
+						}
+						int outer = side < 0.0 ? 1 : 0;
+						if (inside >= 0 && inside != outer)
+						{
+							return false;
+						}
+						inside = outer;
+					}
+				}
+				if (inside < 0)
+				{
+					inside = final_count == 0 ? 1 : 0;
+				}
+				if (inside == 1)
+				{
+					for (index_type c : component)
+					{
+						id[c] = static_cast<index_type>(final_count) + seam_count++;
+					}
+				}
+			}
+
+			// seam simplices to output
+			std::vector<char> attached(interface.size(), 0);
+			simplices.resize((final_count + seam_count) * V);
+			neighbours.resize((final_count + seam_count) * V);
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (id[c] == none)
+				{
+					continue;
+				}
+				size_t s = static_cast<size_t>(id[c]);
+				const index_type* v = dt.vertices(c);
+				const index_type* a = dt.neighbours(c);
+				for (size_t k = 0; k < V; ++k)
+				{
+					simplices[s * V + k] = global[v[k]];
+				}
+				for (size_t k = 0; k < V; ++k)
+				{
+					uint64_t f = matched[static_cast<size_t>(c) * V + k];
+					if (f == unmatched)
+					{
+						neighbours[s * V + k] = id[a[k]];
+						continue;
+					}
+					neighbours[s * V + k] = static_cast<index_type>(f / V);
+					neighbours[f] = id[c];
+
+					// facet between final and seam simplices must be locally Delaunay
+					const double* p[V + 1];
+					for (size_t l = 0; l < V; ++l)
+					{
+						p[l] = x.data() + static_cast<size_t>(simplices[s * V + l]) * D;
+					}
+					p[V] = x.data() + static_cast<size_t>(simplices[f]) * D;
+					double in;
+					if constexpr (D == 2)
+					{
+						in = predicates::incirclePerturbed(p[0], p[1], p[2], p[3]);
+					}
+					else
+					{
+						in = predicates::inspherePerturbed(p[0], p[1], p[2], p[3], p[4]);
+					}
+					size_t e = static_cast<size_t>(std::lower_bound(interface.begin(), interface.end(),
+						std::make_pair(facet<D>(simplices.data() + (f / V) * V, static_cast<size_t>(f % V)), uint64_t(0))) - interface.begin());
+					if (in > 0.0 || attached[e]++)
+					{
+						return false;
+					}
+				}
+			}
+
+			// every interface facet inside convex hull must be shared with seam simplex
+			for (size_t e = 0; e < interface.size(); ++e)
+			{
+				if (!found[e] || (!hull[e] && !attached[e]))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+	public:
+		ParallelTriangulator() : IterativeTriangulator<T>("Parallel") {};
+
+		/**
+		* @brief ParallelTriangulator constructor
+		* @param points: Points, one per row (2 or 3 columns)
+		*/
+		ParallelTriangulator(const Matrix<T>& points) : IterativeTriangulator<T>("Parallel", points) {};
+
+		virtual ~ParallelTriangulator() {};
+
+		/**
+		* @brief Set number of parts
+		* @param parts: Number of parts, rounded up to power of 2. 0 (default) for number of
+		* OpenMP threads, if there are enough points
+		*/
+		void setParts(size_t parts)
+		{
+			parts_ = parts;
+		}
+
+		/**
+		* @brief Build Delaunay triangulation
+		* @throws math::ExceptionInvalidValue if points lie in hyperplane (all collinear in 2D,
+		* all coplanar in 3D)
+		*/
+		virtual void triangulate() override
+		{
+			Triangulator<T>::clear();
+			size_t dim = Triangulator<T>::dim_;
+			if (dim != 2 && dim != 3)
+			{
+				throw(ExceptionInvalidValue("ParallelTriangulator<T>::triangulate: Points aren't set!"));
+			}
+			size_t count = partCount(Triangulator<T>::size(), dim);
+			bool merged = count > 1 && (dim == 2 ? runParallel<2>(count) : runParallel<3>(count));
+			if (!merged)
+			{
+				Triangulator<T>::clear();
+				dim == 2 ? IterativeTriangulator<T>::template run<2>() : IterativeTriangulator<T>::template run<3>();
+			}
+		}
+	};
+}
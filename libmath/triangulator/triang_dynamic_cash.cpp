@@ -0,0 +1,4 @@
+#include <libmath/triangulator/triang_dynamic_cash.h>
+
+template class math::TriangDynamicCash<float>;
+template class math::TriangDynamicCash<double>;
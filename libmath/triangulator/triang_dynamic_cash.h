@@ -0,0 +1,461 @@
+#pragma once
+#include <libmath/triangulator/triangulator.h>
+#include <libmath/triangulator/iterative.h>
+#include <libmath/geometry/spatial_sort.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <vector>
+#include <algorithm>
+#include <string>
+
+namespace math
+{
+	/**
+	* @brief Delaunay triangulation, cached between updates of points
+	* @details Triangulation core (see detail::BowyerWatson) is kept after triangulate(), so
+	* points can be added or moved between timesteps without rebuild:
+	* - added point is inserted into the cavity of cells, which circumspheres contain it;
+	* - moved point keeps its star if the star stays positively oriented and locally Delaunay,
+	* otherwise point is removed (its star is retriangulated) and inserted at the new position.
+	*
+	* Point location starts from the cells, changed by the previous update, and output arrays
+	* (simplices and neighbours) are patched only for changed simplices, so cost of small update
+	* is proportional to the number of changed simplices. Order of simplices isn't preserved
+	* between updates. Triangulation is rebuilt if vertex can't be removed locally (degenerate
+	* star link). Duplicate points are out of triangulation while their copy is in it.
+	*/
+	template <typename T>
+	class TriangDynamicCash :
+		public Triangulator<T>
+	{
+	public:
+		using index_type = typename Triangulator<T>::index_type;
+
+	private:
+		static constexpr index_type none = Triangulator<T>::no_neighbour;
+
+		/// @brief Seed of insertion order
+		unsigned seed_ = 0;
+
+		/// @brief Coordinates of points in double, by point index
+		std::vector<double> coords_;
+
+		/// @brief Triangulation cores, only one of them is used
+		detail::BowyerWatson<2> dt2_;
+		detail::BowyerWatson<3> dt3_;
+
+		/// @brief Core is valid for current points
+		bool built_ = false;
+
+		/// @brief Output simplex of core cell and core cell of output simplex
+		std::vector<index_type> slot_;
+		std::vector<index_type> cell_;
+
+		/// @brief Points, which are out of triangulation (duplicates)
+		std::vector<index_type> absent_;
+
+		/// @brief Number of simplices, created by the last update
+		size_t changed_ = 0;
+
+		/// @brief Cells to rewrite neighbours, workspace of patch()
+		std::vector<index_type> dirty_;
+
+		template <size_t D>
+		detail::BowyerWatson<D>& core()
+		{
+			if constexpr (D == 2)
+			{
+				return dt2_;
+			}
+			else
+			{
+				return dt3_;
+			}
+		}
+
+		/// @brief Apply changes of the last core operation to output arrays
+		template <size_t D>
+		void patch()
+		{
+			constexpr size_t V = D + 1;
+			detail::BowyerWatson<D>& dt = core<D>();
+			std::vector<index_type>& simplices = Triangulator<T>::simplices_;
+			std::vector<index_type>& neighbours = Triangulator<T>::neighbours_;
+			dirty_.clear();
+
+			for (index_type c : dt.removed())
+			{
+				index_type s = slot_[c];
+				if (s == none)
+				{
+					continue;
+				}
+				// the last simplex fills the slot
+				index_type last = static_cast<index_type>(cell_.size() - 1);
+				index_type moved = cell_[last];
+				std::copy(simplices.begin() + static_cast<size_t>(last) * V, simplices.begin() + static_cast<size_t>(last + 1) * V,
+					simplices.begin() + static_cast<size_t>(s) * V);
+				cell_[s] = moved;
+				slot_[moved] = s;
+				slot_[c] = none;
+				cell_.pop_back();
+				simplices.resize(simplices.size() - V);
+				neighbours.resize(neighbours.size() - V);
+				if (moved != c)
+				{
+					dirty_.push_back(moved);
+					const index_type* a = dt.neighbours(moved);
+					dirty_.insert(dirty_.end(), a, a + V);
+				}
+			}
+
+			slot_.resize(dt.capacity(), none);
+			for (index_type c : dt.created())
+			{
+				const index_type* a = dt.neighbours(c);
+				dirty_.insert(dirty_.end(), a, a + V);
+				if (dt.ghostPosition(c) >= 0)
+				{
+					continue;
+				}
+				slot_[c] = static_cast<index_type>(cell_.size());
+				cell_.push_back(c);
+				const index_type* v = dt.vertices(c);
+				simplices.insert(simplices.end(), v, v + V);
+				neighbours.resize(neighbours.size() + V);
+				dirty_.push_back(c);
+				++changed_;
+			}
+
+			for (index_type c : dirty_)
+			{
+				if (!dt.alive(c) || slot_[c] == none)
+				{
+					continue;
+				}
+				const index_type* a = dt.neighbours(c);
+				for (size_t k = 0; k < V; ++k)
+				{
+					neighbours[static_cast<size_t>(slot_[c]) * V + k] = slot_[a[k]];
+				}
+			}
+		}
+
+		/// @brief Insert point into core
+		template <size_t D>
+		void insert(index_type p)
+		{
+			if (core<D>().insert(p) != p)
+			{
+				absent_.push_back(p);
+				return;
+			}
+			patch<D>();
+		}
+
+		template <size_t D>
+		void build()
+		{
+			constexpr size_t V = D + 1;
+			size_t n = Triangulator<T>::size();
+			detail::BowyerWatson<D>& dt = core<D>();
+			std::vector<index_type> order;
+			brioOrder(coords_.data(), n, D, order, seed_);
+			std::vector<double> x(n * D);
+			for (size_t i = 0; i < n; ++i)
+			{
+				std::copy(coords_.begin() + static_cast<size_t>(order[i]) * D, coords_.begin() + static_cast<size_t>(order[i] + 1) * D,
+					x.begin() + i * D);
+			}
+			index_type first[V];
+			if (!detail::initialSimplex<D>(x.data(), n, first))
+			{
+				throw(ExceptionInvalidValue("TriangDynamicCash<T>::triangulate: Points are degenerate (lie in hyperplane)!"));
+			}
+			for (size_t k = 0; k < V; ++k)
+			{
+				first[k] = order[first[k]];
+			}
+
+			dt.setCoordinates(coords_.data());
+			dt.reserve(n);
+			dt.init(first);
+			for (index_type p : order)
+			{
+				if (std::find(first, first + V, p) == first + V && dt.insert(p) != p)
+				{
+					absent_.push_back(p);
+				}
+			}
+
+			// output arrays from scratch
+			std::vector<index_type>& simplices = Triangulator<T>::simplices_;
+			std::vector<index_type>& neighbours = Triangulator<T>::neighbours_;
+			slot_.assign(dt.capacity(), none);
+			cell_.clear();
+			for (index_type c = 0; c < dt.capacity(); ++c)
+			{
+				if (dt.alive(c) && dt.ghostPosition(c) < 0)
+				{
+					slot_[c] = static_cast<index_type>(cell_.size());
+					cell_.push_back(c);
+					simplices.insert(simplices.end(), dt.vertices(c), dt.vertices(c) + V);
+				}
+			}
+			neighbours.resize(simplices.size());
+			for (size_t s = 0; s < cell_.size(); ++s)
+			{
+				const index_type* a = dt.neighbours(cell_[s]);
+				for (size_t k = 0; k < V; ++k)
+				{
+					neighbours[s * V + k] = slot_[a[k]];
+				}
+			}
+			changed_ = cell_.size();
+		}
+
+		/// @brief Move points, returns false if triangulation must be rebuilt
+		template <size_t D>
+		bool move(const std::vector<index_type>& indices, const Matrix<T>& points)
+		{
+			detail::BowyerWatson<D>& dt = core<D>();
+			double old[D];
+			bool local = true;
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				index_type p = indices[i];
+				double* x = coords_.data() + static_cast<size_t>(p) * D;
+				std::copy(x, x + D, old);
+				for (size_t k = 0; k < D; ++k)
+				{
+					Triangulator<T>::points_[static_cast<size_t>(p) * D + k] = points(i, k);
+					x[k] = static_cast<double>(points(i, k));
+				}
+				if (!local || dt.incident(p) == detail::BowyerWatson<D>::none || dt.starDelaunay(p))
+				{
+					continue;
+				}
+
+				// star is removed with old coordinates of point
+				std::copy(old, old + D, x);
+				if (!dt.remove(p))
+				{
+					local = false;
+				}
+				else
+				{
+					patch<D>();
+				}
+				for (size_t k = 0; k < D; ++k)
+				{
+					x[k] = static_cast<double>(points(i, k));
+				}
+				if (local)
+				{
+					insert<D>(p);
+				}
+			}
+			return local;
+		}
+
+		/// @brief Insert points, which were out of triangulation
+		template <size_t D>
+		void retryAbsent()
+		{
+			std::vector<index_type> absent;
+			absent.swap(absent_);
+			for (index_type p : absent)
+			{
+				insert<D>(p);
+			}
+		}
+
+		/// @brief Check that point matrix matches dimension
+		void checkColumns(const Matrix<T>& points, const std::string& method) const
+		{
+			if (points.cols() != Triangulator<T>::dim_)
+			{
+				throw(ExceptionNonEqualColumnsNum("TriangDynamicCash<T>::" + method + ": Points must have " +
+					std::to_string(Triangulator<T>::dim_) + " columns, but " + std::to_string(points.cols()) + " are given!"));
+			}
+		}
+
+	public:
+		TriangDynamicCash() : Triangulator<T>("DynamicCash") {};
+
+		/**
+		* @brief TriangDynamicCash constructor
+		* @param points: Points, one per row (2 or 3 columns)
+		*/
+		TriangDynamicCash(const Matrix<T>& points) : Triangulator<T>("DynamicCash", points) {};
+
+		virtual ~TriangDynamicCash() {};
+
+		/**
+		* @brief Set points to triangulate, cached triangulation is dropped
+		* @param points: Points, one per row. Number of columns (2 or 3) defines dimension
+		*/
+		virtual void setPoints(const Matrix<T>& points) override
+		{
+			Triangulator<T>::setPoints(points);
+			built_ = false;
+		}
+
+		/**
+		* @brief Set seed of randomized insertion order of triangulate()
+		*/
+		void setSeed(unsigned seed)
+		{
+			seed_ = seed;
+		}
+
+		/**
+		* @brief Build Delaunay triangulation from scratch
+		* @throws math::ExceptionInvalidValue if points lie in hyperplane
+		*/
+		virtual void triangulate() override
+		{
+			Triangulator<T>::clear();
+			built_ = false;
+			absent_.clear();
+			coords_.assign(Triangulator<T>::points_.begin(), Triangulator<T>::points_.end());
+			if (Triangulator<T>::dim_ == 2)
+			{
+				build<2>();
+			}
+			else if (Triangulator<T>::dim_ == 3)
+			{
+				build<3>();
+			}
+			else
+			{
+				throw(ExceptionInvalidValue("TriangDynamicCash<T>::triangulate: Points aren't set!"));
+			}
+			built_ = true;
+		}
+
+		/**
+		* @brief Add points to triangulation
+		* @details Points get indices after existing ones. Without cached triangulation points are
+		* appended and triangulation is built
+		* @param points: Points, one per row
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns isn't equal to dimension
+		*/
+		void insertPoints(const Matrix<T>& points)
+		{
+			if (Triangulator<T>::dim_ == 0)
+			{
+				setPoints(points);
+				triangulate();
+				return;
+			}
+			checkColumns(points, "insertPoints");
+			size_t dim = Triangulator<T>::dim_;
+			size_t n = Triangulator<T>::size();
+			if (n + points.rows() >= static_cast<size_t>(none))
+			{
+				throw(ExceptionInvalidValue("TriangDynamicCash<T>::insertPoints: Too many points!"));
+			}
+			for (size_t i = 0; i < points.rows(); ++i)
+			{
+				for (size_t k = 0; k < dim; ++k)
+				{
+					Triangulator<T>::points_.push_back(points(i, k));
+				}
+			}
+			if (!built_)
+			{
+				triangulate();
+				return;
+			}
+
+			coords_.resize(Triangulator<T>::points_.size());
+			std::copy(Triangulator<T>::points_.begin() + n * dim, Triangulator<T>::points_.end(), coords_.begin() + n * dim);
+			std::vector<index_type> order(points.rows());
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				order[i] = static_cast<index_type>(n + i);
+			}
+			// spatial order of new points keeps walks short
+			hilbertSort(coords_.data(), dim, order.data(), order.data() + order.size());
+
+			Triangulator<T>::clearTopology();
+			changed_ = 0;
+			if (dim == 2)
+			{
+				dt2_.setCoordinates(coords_.data());
+				for (index_type p : order)
+				{
+					insert<2>(p);
+				}
+			}
+			else
+			{
+				dt3_.setCoordinates(coords_.data());
+				for (index_type p : order)
+				{
+					insert<3>(p);
+				}
+			}
+		}
+
+		/**
+		* @brief Move points to new positions
+		* @param indices: Indices of points
+		* @param points: New positions, one per row in order of indices
+		* @throws math::ExceptionIndexOutOfBounds if index is out of points
+		* @throws math::ExceptionNonEqualRowsNum if number of rows isn't equal to number of indices
+		* @throws math::ExceptionNonEqualColumnsNum if number of columns isn't equal to dimension
+		*/
+		void movePoints(const std::vector<index_type>& indices, const Matrix<T>& points)
+		{
+			checkColumns(points, "movePoints");
+			if (points.rows() != indices.size())
+			{
+				throw(ExceptionNonEqualRowsNum("TriangDynamicCash<T>::movePoints: Number of points isn't equal to number of indices!"));
+			}
+			for (index_type p : indices)
+			{
+				if (p >= Triangulator<T>::size())
+				{
+					throw(ExceptionIndexOutOfBounds("TriangDynamicCash<T>::movePoints: Point index " + std::to_string(p) + " out of bounds!"));
+				}
+			}
+			if (!built_)
+			{
+				for (size_t i = 0; i < indices.size(); ++i)
+				{
+					for (size_t k = 0; k < Triangulator<T>::dim_; ++k)
+					{
+						Triangulator<T>::points_[static_cast<size_t>(indices[i]) * Triangulator<T>::dim_ + k] = points(i, k);
+					}
+				}
+				triangulate();
+				return;
+			}
+
+			Triangulator<T>::clearTopology();
+			changed_ = 0;
+			bool local = Triangulator<T>::dim_ == 2 ? move<2>(indices, points) : move<3>(indices, points);
+			if (!local)
+			{
+				triangulate();
+				return;
+			}
+			if (Triangulator<T>::dim_ == 2)
+			{
+				retryAbsent<2>();
+			}
+			else
+			{
+				retryAbsent<3>();
+			}
+		}
+
+		/// @brief Number of simplices, created by the last update (all simplices after rebuild)
+		size_t changedCount() const
+		{
+			return changed_;
+		}
+	};
+}
@@ -1,13 +1,219 @@
 #pragma once
 #include <libmath/math_settings.h>
 #include <libmath/boolean.h>
+#include <libmath/matrix.h>
+#include <libmath/math_exception.h>
+#include <libmath/geometry/node.h>
+#include <libmath/geometry/edge.h>
+#include <libmath/geometry/polygone.h>
+#include <libmath/geometry/mesh.h>
 #include <type_traits>
+#include <vector>
+#include <memory>
+#include <string>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
 
 namespace math
 {
+	/**
+	* @brief Base class for triangulators of point sets
+	* @details Triangulator splits convex hull of 2D or 3D points into simplices (triangles or
+	* tetrahedrons) with vertices in points. Result is stored in flat arrays: dim() + 1 point
+	* indices per simplex, all simplices are positively oriented (see predicates::orient2d,
+	* predicates::orient3d), and dim() + 1 neighbours per simplex, where neighbour k is opposite
+	* to vertex k. Topology of Node, Edge and Polygone objects is built on request by
+	* buildTopology().
+	*/
 	template <typename T, typename = typename std::enable_if<isNumeric<T>>::type>
 	class Triangulator
 	{
+	public:
+		/// @brief Type of point and simplex indices
+		using index_type = uint32_t;
 
+		/// @brief Neighbour of simplex facet on convex hull
+		static constexpr index_type no_neighbour = std::numeric_limits<index_type>::max();
+
+	protected:
+		/// @brief Triangulation method
+		std::string method_ = "";
+
+		/// @brief Dimension of points
+		size_t dim_ = 0;
+
+		/// @brief Points, row-major
+		std::vector<T> points_;
+
+		/// @brief Point indices of simplices, dim_ + 1 per simplex
+		std::vector<index_type> simplices_;
+
+		/// @brief Neighbours of simplices, dim_ + 1 per simplex
+		std::vector<index_type> neighbours_;
+
+		/// @brief Topology, built by buildTopology()
+		Mesh<T> mesh_;
+		std::vector<std::unique_ptr<Node<T>>> nodes_;
+		std::vector<std::unique_ptr<Edge<T>>> edges_;
+		std::vector<std::unique_ptr<Polygone<T>>> polygones_;
+
+		Triangulator(const std::string& method) : method_(method) {};
+
+		Triangulator(const std::string& method, const Matrix<T>& points) : method_(method)
+		{
+			setPoints(points);
+		};
+
+		/// @brief Clear topology, built by buildTopology()
+		void clearTopology()
+		{
+			polygones_.clear();
+			edges_.clear();
+			nodes_.clear();
+			mesh_ = Mesh<T>();
+		}
+
+		/// @brief Clear triangulation and topology
+		void clear()
+		{
+			simplices_.clear();
+			neighbours_.clear();
+			clearTopology();
+		}
+
+	public:
+		Triangulator(const Triangulator&) = delete;
+		Triangulator& operator=(const Triangulator&) = delete;
+
+		virtual ~Triangulator() {};
+
+		/**
+		* @brief Set points to triangulate
+		* @param points: Points, one per row. Number of columns (2 or 3) defines dimension
+		* @throws math::ExceptionInvalidValue if dimension isn't 2 or 3 or there are too many points
+		*/
+		virtual void setPoints(const Matrix<T>& points)
+		{
+			if (points.cols() != 2 && points.cols() != 3)
+			{
+				throw(ExceptionInvalidValue("Triangulator<T> (" + method_ + ")::setPoints: Points must be 2D or 3D, but " +
+					std::to_string(points.cols()) + " columns are given!"));
+			}
+			if (points.rows() >= static_cast<size_t>(no_neighbour))
+			{
+				throw(ExceptionInvalidValue("Triangulator<T> (" + method_ + ")::setPoints: Too many points!"));
+			}
+			clear();
+			dim_ = points.cols();
+			points_.resize(points.rows() * dim_);
+			for (size_t i = 0; i < points.rows(); ++i)
+			{
+				for (size_t k = 0; k < dim_; ++k)
+				{
+					points_[i * dim_ + k] = points(i, k);
+				}
+			}
+		}
+
+		/**
+		* @brief Triangulate points
+		*/
+		virtual void triangulate() = 0;
+
+		/// @brief Dimension of points
+		size_t dim() const
+		{
+			return dim_;
+		}
+
+		/// @brief Number of points
+		size_t size() const
+		{
+			return dim_ == 0 ? 0 : points_.size() / dim_;
+		}
+
+		/// @brief Number of simplices
+		size_t simplexCount() const
+		{
+			return dim_ == 0 ? 0 : simplices_.size() / (dim_ + 1);
+		}
+
+		/**
+		* @brief Get simplices
+		* @param[out] simplices: Point indices, dim() + 1 per simplex
+		*/
+		void getSimplices(std::vector<index_type>& simplices) const
+		{
+			simplices = simplices_;
+		}
+
+		/**
+		* @brief Get neighbours of simplices
+		* @param[out] neighbours: dim() + 1 simplex indices per simplex, neighbour k is opposite
+		* to vertex k, no_neighbour on convex hull
+		*/
+		void getNeighbours(std::vector<index_type>& neighbours) const
+		{
+			neighbours = neighbours_;
+		}
+
+		/**
+		* @brief Build mesh and Node, Edge and Polygone topology of triangulation
+		* @details One node is created per point (duplicate points are not connected), one edge per
+		* unique simplex edge and one polygone per simplex, in order of simplices (see Mesh<T>)
+		*/
+		void buildTopology()
+		{
+			mesh_.build(points_.data(), size(), dim_, simplices_);
+			mesh_.makeTopology(nodes_, edges_, polygones_);
+		}
+
+		/**
+		* @brief Mesh of triangulation, built by buildTopology()
+		*/
+		const Mesh<T>& mesh() const
+		{
+			return mesh_;
+		}
+
+		/**
+		* @brief Get nodes of topology
+		* @param[out] nodes: Nodes, one per point
+		*/
+		void getNodes(std::vector<Node<T>*>& nodes) const
+		{
+			nodes.clear();
+			for (const auto& n : nodes_)
+			{
+				nodes.push_back(n.get());
+			}
+		}
+
+		/**
+		* @brief Get edges of topology
+		* @param[out] edges: Edges
+		*/
+		void getEdges(std::vector<Edge<T>*>& edges) const
+		{
+			edges.clear();
+			for (const auto& e : edges_)
+			{
+				edges.push_back(e.get());
+			}
+		}
+
+		/**
+		* @brief Get polygones of topology
+		* @param[out] polygones: Polygones, one per simplex
+		*/
+		void getPolygones(std::vector<Polygone<T>*>& polygones) const
+		{
+			polygones.clear();
+			for (const auto& p : polygones_)
+			{
+				polygones.push_back(p.get());
+			}
+		}
 	};
-}
\ No newline at end of file
+}
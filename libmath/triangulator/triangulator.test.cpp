@@ -1,6 +1,387 @@
 #include <gtest/gtest.h>
+#include <libmath/triangulator/iterative.h>
+#include <libmath/triangulator/triang_dynamic_cash.h>
+#include <libmath/triangulator/parallel.h>
+#include <libmath/geometry/predicates.h>
+#include <libmath/matrix.h>
+#include <vector>
+#include <cmath>
+#include <random>
 
+namespace
+{
+	/// @brief Check orientation, neighbours symmetry and empty circumsphere property
+	template <typename T>
+	void checkDelaunay(const math::Triangulator<T>& tr, const math::Matrix<double>& points)
+	{
+		using index_type = typename math::Triangulator<T>::index_type;
+		size_t dim = tr.dim();
+		size_t v = dim + 1;
+		std::vector<index_type> simplices, neighbours;
+		tr.getSimplices(simplices);
+		tr.getNeighbours(neighbours);
+		size_t count = tr.simplexCount();
+		ASSERT_EQ(simplices.size(), count * v);
+
+		auto p = [&](index_type i)
+		{
+			return points.data() + static_cast<size_t>(i) * dim;
+		};
+
+		for (size_t s = 0; s < count; ++s)
+		{
+			const index_type* sv = simplices.data() + s * v;
+			double o = dim == 2 ? math::predicates::orient2d(p(sv[0]), p(sv[1]), p(sv[2])) :
+				math::predicates::orient3d(p(sv[0]), p(sv[1]), p(sv[2]), p(sv[3]));
+			EXPECT_GT(o, 0.0);
+
+			for (size_t k = 0; k < v; ++k)
+			{
+				index_type n = neighbours[s * v + k];
+				if (n == math::Triangulator<T>::no_neighbour)
+				{
+					continue;
+				}
+				const index_type* na = neighbours.data() + static_cast<size_t>(n) * v;
+				EXPECT_NE(std::find(na, na + v, static_cast<index_type>(s)), na + v);
+			}
+
+			for (size_t i = 0; i < points.rows(); ++i)
+			{
+				double in = dim == 2 ? math::predicates::incircle(p(sv[0]), p(sv[1]), p(sv[2]), p(static_cast<index_type>(i))) :
+					math::predicates::insphere(p(sv[0]), p(sv[1]), p(sv[2]), p(sv[3]), p(static_cast<index_type>(i)));
+				EXPECT_LE(in, 0.0);
+			}
+		}
+	}
+
+	/// @brief Sum of simplex measures
+	double measure(const math::Triangulator<double>& tr, const math::Matrix<double>& points)
+	{
+		std::vector<math::Triangulator<double>::index_type> simplices;
+		tr.getSimplices(simplices);
+		size_t dim = tr.dim();
+		double sum = 0.0;
+		for (size_t s = 0; s < tr.simplexCount(); ++s)
+		{
+			const auto* sv = simplices.data() + s * (dim + 1);
+			const double* a = points.data() + sv[0] * dim;
+			const double* b = points.data() + sv[1] * dim;
+			const double* c = points.data() + sv[2] * dim;
+			if (dim == 2)
+			{
+				sum += 0.5 * ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]));
+			}
+			else
+			{
+				const double* d = points.data() + sv[3] * dim;
+				sum += math::predicates::orient3d(a, b, c, d) / 6.0;
+			}
+		}
+		return sum;
+	}
+
+	/// @brief Simplices with sorted vertices in sorted order
+	std::vector<std::vector<uint32_t>> canonical(const math::Triangulator<double>& tr)
+	{
+		std::vector<uint32_t> simplices;
+		tr.getSimplices(simplices);
+		size_t v = tr.dim() + 1;
+		std::vector<std::vector<uint32_t>> out;
+		for (size_t s = 0; s < tr.simplexCount(); ++s)
+		{
+			out.emplace_back(simplices.begin() + s * v, simplices.begin() + (s + 1) * v);
+			std::sort(out.back().begin(), out.back().end());
+		}
+		std::sort(out.begin(), out.end());
+		return out;
+	}
+
+	/// @brief Check dynamic triangulation against triangulation from scratch
+	void checkDynamic(const math::TriangDynamicCash<double>& tr, const math::Matrix<double>& points)
+	{
+		checkDelaunay(tr, points);
+		math::IterativeTriangulator<double> gold(points);
+		gold.triangulate();
+		EXPECT_EQ(canonical(tr) == canonical(gold), true);
+	}
+}
 
 TEST(Triangulator, DynamicCash)
 {
-}
\ No newline at end of file
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> u(0.0, 1.0);
+	std::normal_distribution<double> jitter(0.0, 0.002);
+	for (size_t dim = 2; dim <= 3; ++dim)
+	{
+		size_t n = dim == 2 ? 200 : 100;
+		math::Matrix<double> points(n, dim, math::MatRep::Row);
+		for (size_t i = 0; i < n * dim; ++i)
+		{
+			points.data()[i] = u(gen);
+		}
+		math::TriangDynamicCash<double> tr(points);
+		tr.triangulate();
+		checkDynamic(tr, points);
+
+		// added points, inside and outside of convex hull
+		size_t added = 40;
+		math::Matrix<double> extra(added, dim, math::MatRep::Row);
+		for (size_t i = 0; i < added * dim; ++i)
+		{
+			extra.data()[i] = 1.4 * u(gen) - 0.2;
+		}
+		tr.insertPoints(extra);
+		math::Matrix<double> all(n + added, dim, math::MatRep::Row);
+		std::copy(points.data(), points.data() + n * dim, all.data());
+		std::copy(extra.data(), extra.data() + added * dim, all.data() + n * dim);
+		ASSERT_EQ(tr.size(), n + added);
+		checkDynamic(tr, all);
+
+		// small moves touch few simplices
+		for (size_t step = 0; step < 5; ++step)
+		{
+			std::vector<uint32_t> indices{ 3, 17, static_cast<uint32_t>(n + 5) };
+			math::Matrix<double> moved(indices.size(), dim, math::MatRep::Row);
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				for (size_t k = 0; k < dim; ++k)
+				{
+					moved(i, k) = all(indices[i], k) + jitter(gen);
+					all(indices[i], k) = moved(i, k);
+				}
+			}
+			tr.movePoints(indices, moved);
+			checkDynamic(tr, all);
+			EXPECT_LT(tr.changedCount(), dim == 2 ? 60 : 400);
+		}
+
+		// large moves, including points on convex hull
+		std::vector<uint32_t> indices;
+		for (uint32_t i = 0; i < all.rows(); i += 7)
+		{
+			indices.push_back(i);
+		}
+		math::Matrix<double> moved(indices.size(), dim, math::MatRep::Row);
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			for (size_t k = 0; k < dim; ++k)
+			{
+				moved(i, k) = u(gen);
+				all(indices[i], k) = moved(i, k);
+			}
+		}
+		tr.movePoints(indices, moved);
+		checkDynamic(tr, all);
+	}
+
+	// duplicate point appears when its copy moves away
+	math::Matrix<double> square = { {0., 0.}, {1., 0.}, {1., 1.}, {0., 1.}, {0.5, 0.4} };
+	math::TriangDynamicCash<double> tr(square);
+	tr.triangulate();
+	tr.insertPoints(math::Matrix<double>{ {0.5, 0.4} });
+	EXPECT_EQ(tr.simplexCount(), 4);
+	tr.movePoints({ 4 }, math::Matrix<double>{ {0.3, 0.6} });
+	EXPECT_EQ(tr.simplexCount(), 6);
+	math::Matrix<double> gold = { {0., 0.}, {1., 0.}, {1., 1.}, {0., 1.}, {0.3, 0.6}, {0.5, 0.4} };
+	checkDynamic(tr, gold);
+
+	EXPECT_THROW(tr.movePoints({ 6 }, math::Matrix<double>{ {0.5, 0.5} }), math::ExceptionIndexOutOfBounds);
+	EXPECT_THROW(tr.insertPoints(math::Matrix<double>(1, 3)), math::ExceptionNonEqualColumnsNum);
+}
+
+TEST(Triangulator, Delaunay2D)
+{
+	// random points in general position
+	std::mt19937 gen(3);
+	std::uniform_real_distribution<double> u(0.0, 1.0);
+	size_t n = 300;
+	math::Matrix<double> points(n, 2, math::MatRep::Row);
+	for (size_t i = 0; i < points.rows() * 2; ++i)
+	{
+		points.data()[i] = u(gen);
+	}
+	math::IterativeTriangulator<double> tr(points);
+	tr.triangulate();
+	checkDelaunay(tr, points);
+
+	// Euler formula: 2n - 2 - h triangles, h points on hull
+	std::vector<math::Triangulator<double>::index_type> neighbours;
+	tr.getNeighbours(neighbours);
+	size_t hull = std::count(neighbours.begin(), neighbours.end(), math::Triangulator<double>::no_neighbour);
+	EXPECT_EQ(tr.simplexCount(), 2 * n - 2 - hull);
+
+	// cocircular points of regular grid with duplicates
+	size_t m = 12;
+	math::Matrix<double> grid(2 * m * m, 2, math::MatRep::Row);
+	for (size_t i = 0; i < m; ++i)
+	{
+		for (size_t j = 0; j < m; ++j)
+		{
+			for (size_t c = 0; c < 2; ++c)
+			{
+				grid(c * m * m + i * m + j, 0) = static_cast<double>(i) / static_cast<double>(m - 1);
+				grid(c * m * m + i * m + j, 1) = static_cast<double>(j) / static_cast<double>(m - 1);
+			}
+		}
+	}
+	math::IterativeTriangulator<double> grid_tr(grid);
+	grid_tr.triangulate();
+	checkDelaunay(grid_tr, grid);
+	EXPECT_EQ(grid_tr.simplexCount(), 2 * (m - 1) * (m - 1));
+	EXPECT_EQ(math::isEqual(measure(grid_tr, grid), 1.0, 1.e-12), true);
+
+	// copies with the lowest index are kept, ties don't depend on insertion order
+	std::vector<uint32_t> grid_simplices;
+	grid_tr.getSimplices(grid_simplices);
+	EXPECT_LT(*std::max_element(grid_simplices.begin(), grid_simplices.end()), m * m);
+	math::IterativeTriangulator<double> seed_tr(grid);
+	seed_tr.setSeed(17);
+	seed_tr.triangulate();
+	EXPECT_EQ(canonical(seed_tr) == canonical(grid_tr), true);
+
+	// collinear points
+	math::Matrix<double> line = { {0., 0.}, {1., 1.}, {2., 2.}, {3., 3.} };
+	math::IterativeTriangulator<double> line_tr(line);
+	EXPECT_THROW(line_tr.triangulate(), math::ExceptionInvalidValue);
+	EXPECT_THROW(math::IterativeTriangulator<double>(math::Matrix<double>(4, 4)), math::ExceptionInvalidValue);
+}
+
+TEST(Triangulator, Delaunay3D)
+{
+	std::mt19937 gen(5);
+	std::uniform_real_distribution<double> u(0.0, 1.0);
+	size_t n = 200;
+	math::Matrix<double> points(n, 3, math::MatRep::Row);
+	for (size_t i = 0; i < points.rows() * 3; ++i)
+	{
+		points.data()[i] = u(gen);
+	}
+	math::IterativeTriangulator<double> tr(points);
+	tr.triangulate();
+	checkDelaunay(tr, points);
+
+	// cospherical points of cubic grid
+	size_t m = 5;
+	math::Matrix<double> grid(m * m * m, 3, math::MatRep::Row);
+	for (size_t i = 0; i < m * m * m; ++i)
+	{
+		grid(i, 0) = static_cast<double>(i % m) / static_cast<double>(m - 1);
+		grid(i, 1) = static_cast<double>((i / m) % m) / static_cast<double>(m - 1);
+		grid(i, 2) = static_cast<double>(i / (m * m)) / static_cast<double>(m - 1);
+	}
+	math::IterativeTriangulator<double> grid_tr(grid);
+	grid_tr.triangulate();
+	checkDelaunay(grid_tr, grid);
+	EXPECT_EQ(math::isEqual(measure(grid_tr, grid), 1.0, 1.e-12), true);
+	math::IterativeTriangulator<double> seed_tr(grid);
+	seed_tr.setSeed(17);
+	seed_tr.triangulate();
+	EXPECT_EQ(canonical(seed_tr) == canonical(grid_tr), true);
+
+	// coplanar points
+	math::Matrix<double> plane = { {0., 0., 1.}, {1., 0., 1.}, {0., 1., 1.}, {1., 1., 1.} };
+	math::IterativeTriangulator<double> plane_tr(plane);
+	EXPECT_THROW(plane_tr.triangulate(), math::ExceptionInvalidValue);
+}
+
+TEST(Triangulator, Parallel)
+{
+	std::mt19937 gen(11);
+	std::uniform_real_distribution<double> u(0.0, 1.0);
+	std::normal_distribution<double> cluster(0.0, 0.05);
+	for (size_t dim = 2; dim <= 3; ++dim)
+	{
+		// uniform points and a dense cluster, which shifts medians
+		size_t n = dim == 2 ? 1500 : 500;
+		math::Matrix<double> points(n, dim, math::MatRep::Row);
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t k = 0; k < dim; ++k)
+			{
+				points(i, k) = i % 3 == 0 ? 0.3 + cluster(gen) : u(gen);
+			}
+		}
+		math::IterativeTriangulator<double> serial(points);
+		serial.triangulate();
+		for (size_t parts : { 2, 8 })
+		{
+			math::ParallelTriangulator<double> tr(points);
+			tr.setParts(parts);
+			tr.triangulate();
+			checkDelaunay(tr, points);
+			EXPECT_EQ(canonical(tr) == canonical(serial), true);
+		}
+	}
+
+	// cospherical points of cubic grid: valid Delaunay triangulation, filling the cube,
+	// the same as serial one
+	size_t m = 6;
+	math::Matrix<double> grid(m * m * m, 3, math::MatRep::Row);
+	for (size_t i = 0; i < m * m * m; ++i)
+	{
+		grid(i, 0) = static_cast<double>(i % m) / static_cast<double>(m - 1);
+		grid(i, 1) = static_cast<double>((i / m) % m) / static_cast<double>(m - 1);
+		grid(i, 2) = static_cast<double>(i / (m * m)) / static_cast<double>(m - 1);
+	}
+	math::ParallelTriangulator<double> grid_tr(grid);
+	grid_tr.setParts(4);
+	grid_tr.triangulate();
+	checkDelaunay(grid_tr, grid);
+	EXPECT_EQ(math::isEqual(measure(grid_tr, grid), 1.0, 1.e-12), true);
+
+	math::IterativeTriangulator<double> serial_grid(grid);
+	serial_grid.triangulate();
+	EXPECT_EQ(canonical(grid_tr) == canonical(serial_grid), true);
+
+	// cocircular points of square grid with duplicates, which lie on part boundaries: the same
+	// ties and kept copies as in serial triangulation
+	size_t m2 = 20;
+	math::Matrix<double> grid2(2 * m2 * m2, 2, math::MatRep::Row);
+	for (size_t i = 0; i < 2 * m2 * m2; ++i)
+	{
+		size_t j = i % (m2 * m2);
+		grid2(i, 0) = static_cast<double>(j % m2) / static_cast<double>(m2 - 1);
+		grid2(i, 1) = static_cast<double>(j / m2) / static_cast<double>(m2 - 1);
+	}
+	math::IterativeTriangulator<double> serial_grid2(grid2);
+	serial_grid2.triangulate();
+	for (size_t parts : { 4, 8 })
+	{
+		math::ParallelTriangulator<double> grid2_tr(grid2);
+		grid2_tr.setParts(parts);
+		grid2_tr.triangulate();
+		checkDelaunay(grid2_tr, grid2);
+		EXPECT_EQ(canonical(grid2_tr) == canonical(serial_grid2), true);
+		std::vector<uint32_t> grid2_simplices;
+		grid2_tr.getSimplices(grid2_simplices);
+		EXPECT_LT(*std::max_element(grid2_simplices.begin(), grid2_simplices.end()), m2 * m2);
+	}
+}
+
+TEST(Triangulator, Topology)
+{
+	math::Matrix<float> points = { {0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}, {0.5f, 0.4f} };
+	math::IterativeTriangulator<float> tr(points);
+	tr.triangulate();
+	EXPECT_EQ(tr.simplexCount(), 4);
+
+	tr.buildTopology();
+	std::vector<math::Node<float>*> nodes;
+	std::vector<math::Edge<float>*> edges;
+	std::vector<math::Polygone<float>*> polygones;
+	tr.getNodes(nodes);
+	tr.getEdges(edges);
+	tr.getPolygones(polygones);
+	EXPECT_EQ(nodes.size(), 5);
+	EXPECT_EQ(edges.size(), 8);
+	EXPECT_EQ(polygones.size(), 4);
+
+	// central node is shared by all triangles
+	std::vector<math::Polygone<float>*> central;
+	nodes[4]->getPolygones(central);
+	EXPECT_EQ(central.size(), 4);
+	std::vector<math::Edge<float>*> central_edges;
+	nodes[4]->getEdges(central_edges);
+	EXPECT_EQ(central_edges.size(), 4);
+}
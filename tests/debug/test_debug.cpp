@@ -11,6 +11,7 @@ TEST(US, constructor)
 	math::USsetup setup1
 	{
 		math::USStoppingCriteriaType::tolerance,
+		math::USToleranceMethod::absolute,
 		100,
 		1000,
 		1.e-7,